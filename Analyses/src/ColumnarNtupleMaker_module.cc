@@ -0,0 +1,345 @@
+//
+// Write selected fields of reconstruction and simulation products to a
+// columnar file (see Mu2eUtilities/inc/ColumnarFile.hh), one table per
+// configured product and one row per object.  Every row starts with the
+// run, subRun, event and the index of the object in its collection, so
+// that tables can be joined offline.
+//
+// The fields are chosen by name in the configuration; an empty list writes
+// all the fields known for the product type.  The known fields are listed
+// by setting printFields to true.
+//
+// Example:
+//   physics.analyzers.nt : {
+//     module_type : ColumnarNtupleMaker
+//     fileName : "nts.owner.description.version.sequencer.col"
+//     tables : [ { name : "dem"   product : "KalSeed"     tag : "KKDeM"              fields : [ "t0", "mom", "momerr", "nactive" ] },
+//                { name : "calo"  product : "CaloCluster" tag : "CaloClusterMaker"   fields : [] } ]
+//   }
+//
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Offline/Mu2eUtilities/inc/ColumnarFile.hh"
+#include "Offline/RecoDataProducts/inc/KalSeed.hh"
+#include "Offline/RecoDataProducts/inc/CaloCluster.hh"
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/CrvCoincidenceCluster.hh"
+#include "Offline/MCDataProducts/inc/SimParticle.hh"
+
+namespace mu2e {
+
+  namespace {
+
+    // A named field of a product: its column type and how to fill it
+    template <class OBJ> struct FieldDef {
+      std::string name;
+      ColumnType  type;
+      std::function<void(ColumnarWriter::Table&, std::size_t, const OBJ&)> fill;
+    };
+
+    template <class T, class OBJ, class F> FieldDef<OBJ> field(const std::string& name, F f) {
+      return FieldDef<OBJ>{name, ColumnTypeOf<T>::value,
+          [f](ColumnarWriter::Table& table, std::size_t column, const OBJ& obj) { table.fill<T>(column, static_cast<T>(f(obj))); }};
+    }
+
+    // The fields known for each product type.  Add here to export more.
+    template <class OBJ> const std::vector<FieldDef<OBJ>>& knownFields();
+
+    template <> const std::vector<FieldDef<KalSeed>>& knownFields<KalSeed>() {
+      // the momentum is taken from the segment nearest to t0
+      static const auto segment = [](const KalSeed& ks) {
+        auto iseg = ks.nearestSegment(ks.t0().t0());
+        return iseg == ks.segments().end() ? nullptr : &*iseg;
+      };
+      static const std::vector<FieldDef<KalSeed>> fields {
+        field<int32_t,KalSeed>("pdg",       [](const KalSeed& ks) { return ks.particle(); }),
+        field<int32_t,KalSeed>("converged", [](const KalSeed& ks) { return ks.status().hasAllProperties(TrkFitFlag::kalmanConverged); }),
+        field<float,KalSeed>  ("t0",        [](const KalSeed& ks) { return ks.t0().t0(); }),
+        field<float,KalSeed>  ("t0err",     [](const KalSeed& ks) { return ks.t0().t0Err(); }),
+        field<float,KalSeed>  ("chisq",     [](const KalSeed& ks) { return ks.chisquared(); }),
+        field<float,KalSeed>  ("fitcon",    [](const KalSeed& ks) { return ks.fitConsistency(); }),
+        field<int32_t,KalSeed>("nhits",     [](const KalSeed& ks) { return ks.hits().size(); }),
+        field<int32_t,KalSeed>("nactive",   [](const KalSeed& ks) {
+            int n(0);
+            for(auto const& hit : ks.hits()) if(hit.flag().hasAllProperties(StrawHitFlag::active)) ++n;
+            return n; }),
+        field<int32_t,KalSeed>("hasCalo",   [](const KalSeed& ks) { return ks.hasCaloCluster(); }),
+        field<float,KalSeed>  ("mom",       [](const KalSeed& ks) { auto s = segment(ks); return s ? s->mom()    : -1.; }),
+        field<float,KalSeed>  ("momerr",    [](const KalSeed& ks) { auto s = segment(ks); return s ? s->momerr() : -1.; }),
+        field<float,KalSeed>  ("px",        [](const KalSeed& ks) { auto s = segment(ks); return s ? s->momentum3().X() : 0.; }),
+        field<float,KalSeed>  ("py",        [](const KalSeed& ks) { auto s = segment(ks); return s ? s->momentum3().Y() : 0.; }),
+        field<float,KalSeed>  ("pz",        [](const KalSeed& ks) { auto s = segment(ks); return s ? s->momentum3().Z() : 0.; }),
+        field<float,KalSeed>  ("x",         [](const KalSeed& ks) { auto s = segment(ks); return s ? s->position3().X() : 0.; }),
+        field<float,KalSeed>  ("y",         [](const KalSeed& ks) { auto s = segment(ks); return s ? s->position3().Y() : 0.; }),
+        field<float,KalSeed>  ("z",         [](const KalSeed& ks) { auto s = segment(ks); return s ? s->position3().Z() : 0.; }),
+      };
+      return fields;
+    }
+
+    template <> const std::vector<FieldDef<CaloCluster>>& knownFields<CaloCluster>() {
+      static const std::vector<FieldDef<CaloCluster>> fields {
+        field<int32_t,CaloCluster>("disk",    [](const CaloCluster& c) { return c.diskID(); }),
+        field<int32_t,CaloCluster>("size",    [](const CaloCluster& c) { return c.size(); }),
+        field<int32_t,CaloCluster>("isSplit", [](const CaloCluster& c) { return c.isSplit(); }),
+        field<float,CaloCluster>  ("time",    [](const CaloCluster& c) { return c.time(); }),
+        field<float,CaloCluster>  ("timeErr", [](const CaloCluster& c) { return c.timeErr(); }),
+        field<float,CaloCluster>  ("edep",    [](const CaloCluster& c) { return c.energyDep(); }),
+        field<float,CaloCluster>  ("edepErr", [](const CaloCluster& c) { return c.energyDepErr(); }),
+        field<float,CaloCluster>  ("x",       [](const CaloCluster& c) { return c.cog3Vector().x(); }),
+        field<float,CaloCluster>  ("y",       [](const CaloCluster& c) { return c.cog3Vector().y(); }),
+        field<float,CaloCluster>  ("z",       [](const CaloCluster& c) { return c.cog3Vector().z(); }),
+      };
+      return fields;
+    }
+
+    template <> const std::vector<FieldDef<ComboHit>>& knownFields<ComboHit>() {
+      static const std::vector<FieldDef<ComboHit>> fields {
+        field<uint32_t,ComboHit>("strawId",  [](const ComboHit& ch) { return ch.strawId().asUint16(); }),
+        field<int32_t,ComboHit> ("nsh",      [](const ComboHit& ch) { return ch.nStrawHits(); }),
+        field<int32_t,ComboHit> ("ncombo",   [](const ComboHit& ch) { return ch.nCombo(); }),
+        field<float,ComboHit>   ("x",        [](const ComboHit& ch) { return ch.pos().x(); }),
+        field<float,ComboHit>   ("y",        [](const ComboHit& ch) { return ch.pos().y(); }),
+        field<float,ComboHit>   ("z",        [](const ComboHit& ch) { return ch.pos().z(); }),
+        field<float,ComboHit>   ("time",     [](const ComboHit& ch) { return ch.time(); }),
+        field<float,ComboHit>   ("ctime",    [](const ComboHit& ch) { return ch.correctedTime(); }),
+        field<float,ComboHit>   ("edep",     [](const ComboHit& ch) { return ch.energyDep(); }),
+        field<float,ComboHit>   ("wdist",    [](const ComboHit& ch) { return ch.wireDist(); }),
+        field<float,ComboHit>   ("wres",     [](const ComboHit& ch) { return ch.wireRes(); }),
+        field<float,ComboHit>   ("tres",     [](const ComboHit& ch) { return ch.transRes(); }),
+        field<float,ComboHit>   ("qual",     [](const ComboHit& ch) { return ch.qual(); }),
+      };
+      return fields;
+    }
+
+    template <> const std::vector<FieldDef<CrvCoincidenceCluster>>& knownFields<CrvCoincidenceCluster>() {
+      static const std::vector<FieldDef<CrvCoincidenceCluster>> fields {
+        field<int32_t,CrvCoincidenceCluster>("sectorType", [](const CrvCoincidenceCluster& c) { return c.GetCrvSectorType(); }),
+        field<int32_t,CrvCoincidenceCluster>("npulses",    [](const CrvCoincidenceCluster& c) { return c.GetCrvRecoPulses().size(); }),
+        field<int32_t,CrvCoincidenceCluster>("nlayers",    [](const CrvCoincidenceCluster& c) { return c.GetLayers().size(); }),
+        field<float,CrvCoincidenceCluster>  ("x",          [](const CrvCoincidenceCluster& c) { return c.GetAvgCounterPos().x(); }),
+        field<float,CrvCoincidenceCluster>  ("y",          [](const CrvCoincidenceCluster& c) { return c.GetAvgCounterPos().y(); }),
+        field<float,CrvCoincidenceCluster>  ("z",          [](const CrvCoincidenceCluster& c) { return c.GetAvgCounterPos().z(); }),
+        field<float,CrvCoincidenceCluster>  ("startTime",  [](const CrvCoincidenceCluster& c) { return c.GetStartTime(); }),
+        field<float,CrvCoincidenceCluster>  ("endTime",    [](const CrvCoincidenceCluster& c) { return c.GetEndTime(); }),
+        field<float,CrvCoincidenceCluster>  ("PEs",        [](const CrvCoincidenceCluster& c) { return c.GetPEs(); }),
+        field<float,CrvCoincidenceCluster>  ("slope",      [](const CrvCoincidenceCluster& c) { return c.GetSlope(); }),
+      };
+      return fields;
+    }
+
+    template <> const std::vector<FieldDef<SimParticle>>& knownFields<SimParticle>() {
+      static const std::vector<FieldDef<SimParticle>> fields {
+        field<int64_t,SimParticle>("id",           [](const SimParticle& s) { return s.id().asInt(); }),
+        field<int64_t,SimParticle>("parentId",     [](const SimParticle& s) { return s.parentId().asInt(); }),
+        field<int32_t,SimParticle>("pdg",          [](const SimParticle& s) { return s.pdgId(); }),
+        field<int32_t,SimParticle>("simStage",     [](const SimParticle& s) { return s.simStage(); }),
+        field<int32_t,SimParticle>("creationCode", [](const SimParticle& s) { return s.creationCode().id(); }),
+        field<int32_t,SimParticle>("stoppingCode", [](const SimParticle& s) { return s.stoppingCode().id(); }),
+        field<int32_t,SimParticle>("genIndex",     [](const SimParticle& s) { return s.generatorIndex(); }),
+        field<float,SimParticle>  ("startX",       [](const SimParticle& s) { return s.startPosXYZ().x(); }),
+        field<float,SimParticle>  ("startY",       [](const SimParticle& s) { return s.startPosXYZ().y(); }),
+        field<float,SimParticle>  ("startZ",       [](const SimParticle& s) { return s.startPosXYZ().z(); }),
+        field<float,SimParticle>  ("startT",       [](const SimParticle& s) { return s.startGlobalTime(); }),
+        field<float,SimParticle>  ("startPx",      [](const SimParticle& s) { return s.startMomXYZT().px(); }),
+        field<float,SimParticle>  ("startPy",      [](const SimParticle& s) { return s.startMomXYZT().py(); }),
+        field<float,SimParticle>  ("startPz",      [](const SimParticle& s) { return s.startMomXYZT().pz(); }),
+        field<float,SimParticle>  ("startE",       [](const SimParticle& s) { return s.startMomXYZT().e(); }),
+        field<float,SimParticle>  ("endX",         [](const SimParticle& s) { return s.endPosXYZ().x(); }),
+        field<float,SimParticle>  ("endY",         [](const SimParticle& s) { return s.endPosXYZ().y(); }),
+        field<float,SimParticle>  ("endZ",         [](const SimParticle& s) { return s.endPosXYZ().z(); }),
+        field<float,SimParticle>  ("endT",         [](const SimParticle& s) { return s.endGlobalTime(); }),
+        field<float,SimParticle>  ("endKE",        [](const SimParticle& s) { return s.endKineticEnergy(); }),
+      };
+      return fields;
+    }
+
+    template <class OBJ> std::string fieldList() {
+      std::string list;
+      for(auto const& f : knownFields<OBJ>()) list += " " + f.name + "(" + columnTypeName(f.type) + ")";
+      return list;
+    }
+
+    //================================================================
+    // One output table: the columns of one product
+    class TableWriterBase {
+    public:
+      virtual ~TableWriterBase() = default;
+      virtual void fill(const art::Event& event) = 0;
+    };
+
+    template <class OBJ> class TableWriter : public TableWriterBase {
+    public:
+      TableWriter(ColumnarWriter::Table& table, const art::InputTag& tag, const std::vector<std::string>& names) :
+        _table(table), _tag(tag)
+      {
+        _run    = _table.addColumn("run",    ColumnType::UInt32);
+        _subRun = _table.addColumn("subRun", ColumnType::UInt32);
+        _event  = _table.addColumn("event",  ColumnType::UInt32);
+        _index  = _table.addColumn("index",  ColumnType::Int32);
+        auto const& known = knownFields<OBJ>();
+        if(names.empty()) {
+          for(auto const& f : known) add(f);
+        }
+        for(auto const& name : names) {
+          auto it = std::find_if(known.begin(), known.end(), [&name](const FieldDef<OBJ>& f) { return f.name == name; });
+          if(it == known.end()) {
+            throw cet::exception("CONFIG") << "ColumnarNtupleMaker: unknown field " << name << " for table " << table.name()
+                                           << "; the known fields are" << fieldList<OBJ>() << "\n";
+          }
+          add(*it);
+        }
+      }
+
+      void fill(const art::Event& event) override;
+
+    private:
+      void add(const FieldDef<OBJ>& f) {
+        _fields.push_back(&f);
+        _columns.push_back(_table.addColumn(f.name, f.type));
+      }
+      void fillRow(const art::Event& event, int32_t index, const OBJ& obj) {
+        _table.fill<uint32_t>(_run,    event.run());
+        _table.fill<uint32_t>(_subRun, event.subRun());
+        _table.fill<uint32_t>(_event,  event.event());
+        _table.fill<int32_t> (_index,  index);
+        for(std::size_t i=0; i<_fields.size(); ++i) {
+          _fields[i]->fill(_table, _columns[i], obj);
+        }
+        _table.endRow();
+      }
+
+      ColumnarWriter::Table&              _table;
+      art::InputTag                       _tag;
+      std::size_t                         _run, _subRun, _event, _index;
+      std::vector<const FieldDef<OBJ>*>   _fields;
+      std::vector<std::size_t>            _columns;
+    };
+
+    // The product type holding the objects
+    template <class OBJ> struct CollectionOf          { typedef std::vector<OBJ>     type; };
+    template <>          struct CollectionOf<ComboHit> { typedef ComboHitCollection    type; };
+
+    template <class OBJ> void TableWriter<OBJ>::fill(const art::Event& event) {
+      auto const& coll = *event.getValidHandle<typename CollectionOf<OBJ>::type>(_tag);
+      for(std::size_t i=0; i<coll.size(); ++i) {
+        fillRow(event, i, coll[i]);
+      }
+    }
+
+    // The SimParticleCollection is a map_vector: the index is the position in the map
+    template <> void TableWriter<SimParticle>::fill(const art::Event& event) {
+      auto const& coll = *event.getValidHandle<SimParticleCollection>(_tag);
+      int32_t i(0);
+      for(auto const& sp : coll) {
+        fillRow(event, i++, sp.second);
+      }
+    }
+
+  } // end anonymous namespace
+
+  //================================================================
+  class ColumnarNtupleMaker : public art::EDAnalyzer {
+  public:
+
+    struct TableConfig {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+      fhicl::Atom<std::string>              name   { Name("name"),    Comment("Name of the output table") };
+      fhicl::Atom<std::string>              product{ Name("product"), Comment("Product type: KalSeed, CaloCluster, ComboHit, CrvCoincidenceCluster or SimParticle") };
+      fhicl::Atom<art::InputTag>            tag    { Name("tag"),     Comment("Input collection") };
+      fhicl::Sequence<std::string>          fields { Name("fields"),  Comment("Fields to write; empty for all the known fields"), std::vector<std::string>() };
+    };
+
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+      fhicl::Atom<std::string>                   fileName           { Name("fileName"),            Comment("Output columnar file") };
+      fhicl::Atom<int>                           compressionSettings{ Name("compressionSettings"), Comment("100*algorithm + level, as TFile::SetCompressionSettings; 0 for no compression"), 505 };
+      fhicl::Atom<unsigned>                      batchRows          { Name("batchRows"),           Comment("Rows per table buffered before each compressed write"), 4096 };
+      fhicl::Atom<bool>                          printFields        { Name("printFields"),         Comment("Print the known fields of each product type"), false };
+      fhicl::Sequence<fhicl::Table<TableConfig>> tables             { Name("tables"),              Comment("Output tables") };
+    };
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+    explicit ColumnarNtupleMaker(const Parameters& conf);
+
+    void beginJob() override;
+    void analyze(const art::Event& event) override;
+    void endJob() override;
+
+  private:
+    Config                                        _conf;
+    std::unique_ptr<ColumnarWriter>               _writer;
+    std::vector<std::unique_ptr<TableWriterBase>> _tables;
+  };
+
+  //================================================================
+  ColumnarNtupleMaker::ColumnarNtupleMaker(const Parameters& conf) :
+    art::EDAnalyzer(conf),
+    _conf(conf())
+  {
+    for(auto const& t : _conf.tables()) {
+      auto const& product = t.product();
+      if(product == "KalSeed")                    consumes<KalSeedCollection>(t.tag());
+      else if(product == "CaloCluster")           consumes<CaloClusterCollection>(t.tag());
+      else if(product == "ComboHit")              consumes<ComboHitCollection>(t.tag());
+      else if(product == "CrvCoincidenceCluster") consumes<CrvCoincidenceClusterCollection>(t.tag());
+      else if(product == "SimParticle")           consumes<SimParticleCollection>(t.tag());
+      else {
+        throw cet::exception("CONFIG") << "ColumnarNtupleMaker: unknown product type " << product << " for table " << t.name() << "\n";
+      }
+    }
+    if(_conf.printFields()) {
+      mf::LogInfo log("ColumnarNtupleMaker");
+      log << "KalSeed:"               << fieldList<KalSeed>()               << "\n";
+      log << "CaloCluster:"           << fieldList<CaloCluster>()           << "\n";
+      log << "ComboHit:"              << fieldList<ComboHit>()              << "\n";
+      log << "CrvCoincidenceCluster:" << fieldList<CrvCoincidenceCluster>() << "\n";
+      log << "SimParticle:"           << fieldList<SimParticle>()           << "\n";
+    }
+  }
+
+  void ColumnarNtupleMaker::beginJob() {
+    _writer = std::make_unique<ColumnarWriter>(_conf.fileName(), _conf.compressionSettings(), _conf.batchRows());
+    for(auto const& t : _conf.tables()) {
+      auto& table = _writer->addTable(t.name());
+      auto const& product = t.product();
+      if(product == "KalSeed")                    _tables.emplace_back(new TableWriter<KalSeed>(table, t.tag(), t.fields()));
+      else if(product == "CaloCluster")           _tables.emplace_back(new TableWriter<CaloCluster>(table, t.tag(), t.fields()));
+      else if(product == "ComboHit")              _tables.emplace_back(new TableWriter<ComboHit>(table, t.tag(), t.fields()));
+      else if(product == "CrvCoincidenceCluster") _tables.emplace_back(new TableWriter<CrvCoincidenceCluster>(table, t.tag(), t.fields()));
+      else                                        _tables.emplace_back(new TableWriter<SimParticle>(table, t.tag(), t.fields()));
+    }
+  }
+
+  void ColumnarNtupleMaker::analyze(const art::Event& event) {
+    for(auto& t : _tables) {
+      t->fill(event);
+    }
+  }
+
+  void ColumnarNtupleMaker::endJob() {
+    _writer->close();
+    mf::LogInfo("ColumnarNtupleMaker") << "Wrote " << _conf.fileName() << ": "
+                                       << _writer->rawBytes() << " bytes of columns stored in "
+                                       << _writer->storedBytes() << " bytes";
+  }
+
+} // end namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::ColumnarNtupleMaker);
@@ -0,0 +1,98 @@
+// Enable the hot-path Profiler (GeneralUtilities/inc/Profiler.hh) for
+// the job and write its per-job summary at endJob: a printed table, an
+// optional JSON file for trend tracking, and histograms of the total
+// time, calls and mean time per probe.
+//
+// Add this analyzer to an end path; profiling is active from module
+// construction onwards, so the first events are included.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "TH1D.h"
+
+#include "fhiclcpp/types/Atom.h"
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art_root_io/TFileService.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
+
+namespace mu2e {
+
+  class ProfileSummary : public art::EDAnalyzer {
+  public:
+    struct Config {
+      using Name=fhicl::Name;
+      using Comment=fhicl::Comment;
+      fhicl::Atom<bool> enabled{Name("enabled"), Comment("Turn profiling on for this job"), true};
+      fhicl::Atom<std::string> jsonFile{Name("jsonFile"), Comment("Write the summary as JSON to this file; no file if empty"), ""};
+      fhicl::Atom<bool> makeHistograms{Name("makeHistograms"), Comment("Save the summary as histograms in the TFileService file"), true};
+      fhicl::Atom<bool> print{Name("print"), Comment("Print the summary table at endJob"), true};
+    };
+
+    using Parameters = art::EDAnalyzer::Table<Config>;
+    explicit ProfileSummary(const Parameters& conf);
+
+    void analyze(const art::Event&) override {}
+    void endJob() override;
+
+  private:
+    std::string jsonFile_;
+    bool makeHistograms_;
+    bool print_;
+  };
+
+  //================================================================
+  ProfileSummary::ProfileSummary(const Parameters& conf)
+    : art::EDAnalyzer(conf)
+    , jsonFile_(conf().jsonFile())
+    , makeHistograms_(conf().makeHistograms())
+    , print_(conf().print())
+  {
+    Profiler::setEnabled(conf().enabled());
+  }
+
+  //================================================================
+  void ProfileSummary::endJob() {
+    if(!Profiler::enabled()) return;
+    Profiler::setEnabled(false);
+
+    if(print_) Profiler::print(std::cout);
+
+    if(!jsonFile_.empty()) {
+      std::ofstream os(jsonFile_);
+      if(os) {
+        Profiler::writeJSON(os);
+      }
+      else {
+        mf::LogWarning("ProfileSummary") << "cannot write " << jsonFile_;
+      }
+    }
+
+    if(makeHistograms_) {
+      const auto summary = Profiler::summary();
+      const int n = summary.size();
+      art::ServiceHandle<art::TFileService> tfs;
+      TH1D* htot  = tfs->make<TH1D>("totalTime", "Total time per probe [ms]", n, 0., n);
+      TH1D* hcall = tfs->make<TH1D>("calls", "Timed calls per probe", n, 0., n);
+      TH1D* hmean = tfs->make<TH1D>("meanTime", "Mean time per call [us]", n, 0., n);
+      TH1D* hcnt  = tfs->make<TH1D>("counts", "Counter per probe", n, 0., n);
+      for(int i=0; i<n; ++i) {
+        const auto& [name, st] = summary[i];
+        for(TH1D* h : {htot, hcall, hmean, hcnt}) {
+          h->GetXaxis()->SetBinLabel(i+1, name.c_str());
+        }
+        htot->SetBinContent(i+1, st.ns*1.e-6);
+        hcall->SetBinContent(i+1, st.calls);
+        hmean->SetBinContent(i+1, st.calls > 0 ? st.ns*1.e-3/st.calls : 0.);
+        hcnt->SetBinContent(i+1, st.count);
+      }
+    }
+  }
+
+}
+
+DEFINE_ART_MODULE(mu2e::ProfileSummary);
@@ -0,0 +1,115 @@
+/*
+Read-only CRV photon lookup table in a single contiguous block:
+
+  CrvLookupTableHeader    constants, array sizes
+  double[]                Cerenkov photons per mm vs. beta (scintillator: beta, photons; fiber: beta, photons)
+  double[]                bin edges (x, y, z, beta, theta, phi, r)
+  CrvLookupBin[]          all bins of the three tables (scintillation in scintillator,
+                          Cerenkov in scintillator, Cerenkov in fiber), 16 bytes each
+  unsigned char[]         time delay and fiber emission probabilities of all bins
+
+Tables in this layout (made with convertCrvLookupTable) are memory mapped: they are
+not read at construction, and all the modules and processes on a node share their
+pages.  Tables in the original format (LookupConstants, LookupCerenkov,
+LookupBinDefinitions, LookupBin) are converted to the same layout in memory.
+CrvLookupTable::Get() shares one table per file between all the users in the process.
+*/
+
+#ifndef CrvLookupTable_hh
+#define CrvLookupTable_hh
+
+#include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
+#include "Offline/GeneralUtilities/inc/MappedFile.hh"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mu2eCrv
+{
+
+struct CrvLookupTableHeader
+{
+  static constexpr char     magicWord[8]={'M','U','2','E','C','R','V','L'};
+  static constexpr uint32_t currentVersion=1;
+
+  char            magic[8];
+  uint32_t        version;
+  uint32_t        headerSize;            //sizeof(CrvLookupTableHeader)
+  LookupConstants constants;
+  uint64_t        nCerenkovScintillator;  //entries of the Cerenkov photon arrays
+  uint64_t        nCerenkovFiber;
+  uint64_t        nBinEdges[7];           //x, y, z, beta, theta, phi, r
+  uint64_t        nBins[3];               //scintillation in scintillator, Cerenkov in scintillator, Cerenkov in fiber
+  uint64_t        nBytes;                 //probability bytes of all bins
+};
+
+//one bin of the lookup tables, replaces LookupBin
+struct CrvLookupBin
+{
+  float    arrivalProbability;
+  uint32_t offset;                          //first time delay byte; followed by the fiber emission bytes
+  uint16_t probabilityScaleTimeDelays;      //sum of the time delay bytes
+  uint16_t probabilityScaleFiberEmissions;  //sum of the fiber emission bytes
+  uint8_t  nTimeDelays;                     //without the trailing zeros
+  uint8_t  nFiberEmissions;
+  uint16_t unused;
+};
+
+class CrvLookupTable
+{
+  public:
+
+  enum BinEdges {X=0, Y, Z, BETA, THETA, PHI, R};
+
+  explicit CrvLookupTable(const std::string &filename);
+
+  //the table of filename, shared by all its users in the process
+  static std::shared_ptr<const CrvLookupTable> Get(const std::string &filename);
+
+  //writes a table of the original format in the layout that can be memory mapped
+  static void Convert(const std::string &inputFilename, const std::string &outputFilename);
+
+  const std::string     &GetFileName() const  {return _fileName;}
+  bool                   IsMapped() const     {return _mappedFile!=nullptr;}
+  const LookupConstants &GetConstants() const {return _header->constants;}
+
+  size_t        GetNBinEdges(BinEdges e) const {return _header->nBinEdges[e];}
+  const double *GetBinEdges(BinEdges e) const  {return _edges[e];}
+
+  //table 0: scintillation in scintillator, 1: Cerenkov in scintillator, 2: Cerenkov in fiber
+  size_t               GetNBins(int table) const                         {return _header->nBins[table];}
+  const CrvLookupBin  *GetBin(int table, unsigned int i) const           {return _bins[table]+i;}
+  const unsigned char *GetTimeDelays(const CrvLookupBin *bin) const      {return _bytes+bin->offset;}
+  const unsigned char *GetFiberEmissions(const CrvLookupBin *bin) const  {return _bytes+bin->offset+bin->nTimeDelays;}
+
+  //bin numbers as in LookupBinDefinitions, -1 outside of the table
+  int FindScintillatorScintillationBin(double x, double y, double z) const;
+  int FindScintillatorCerenkovBin(double x, double y, double z, double beta) const;
+  int FindFiberCerenkovBin(double beta, double theta, double phi, double r, double z) const;
+
+  //average number of Cerenkov photons per mm
+  double GetAverageNumberOfCerenkovPhotons(double beta, double charge, bool fiber) const;
+
+  private:
+
+  void   Index(const char *data, size_t size);
+  bool   FindBin(BinEdges e, double x, unsigned int &bin) const;
+  static void ReadOriginal(const std::string &filename, std::vector<char> &buffer);
+
+  std::string                        _fileName;
+  std::unique_ptr<mu2e::MappedFile>  _mappedFile;
+  std::vector<char>                  _buffer;      //tables converted in memory
+
+  const CrvLookupTableHeader *_header;
+  const double               *_cerenkovBeta[2];     //scintillator, fiber
+  const double               *_cerenkovPhotons[2];
+  const double               *_edges[7];
+  const CrvLookupBin         *_bins[3];
+  const unsigned char        *_bytes;
+};
+
+} //namespace mu2eCrv
+
+#endif
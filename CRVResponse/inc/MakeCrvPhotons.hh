@@ -8,6 +8,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <ostream>
 #include <sstream>
 
@@ -88,13 +89,15 @@ struct LookupBin
 };
 
 
+class CrvLookupTable;
+struct CrvLookupBin;
 
 class MakeCrvPhotons
 {
   public:
 
     MakeCrvPhotons(CLHEP::RandFlat &randFlat, CLHEP::RandGaussQ &randGaussQ, CLHEP::RandPoissonQ &randPoissonQ) :
-                                                      _randFlat(randFlat), _randGaussQ(randGaussQ), _randPoissonQ(randPoissonQ) {}
+                                                      _binnedArrivals(false), _randFlat(randFlat), _randGaussQ(randGaussQ), _randPoissonQ(randPoissonQ) {}
 
     ~MakeCrvPhotons();
 
@@ -111,6 +114,9 @@ class MakeCrvPhotons
     int                       GetNumberOfPhotons(int SiPM);
     const std::vector<double> &GetArrivalTimes(int SiPM);
     void                      SetScintillationYield(double yield) {_scintillationYield=yield;}
+    //fill the expected arrival time distribution of each SiPM in 1ns bins, and draw the number
+    //of arriving photons per time bin, instead of drawing the arrival and the time of each photon
+    void                      SetBinnedArrivals(bool binnedArrivals) {_binnedArrivals=binnedArrivals;}
 
   private:
 
@@ -119,11 +125,22 @@ class MakeCrvPhotons
 
     std::vector<double>       _arrivalTimes[4];
     double                    _scintillationYield;
-
-    LookupConstants           _LC;
-    LookupCerenkov            _LCerenkov;
-    LookupBinDefinitions      _LBD;
-    std::vector<LookupBin>    _bins[3];   //scintillation in scintillator (0), Cerenkov in scintillator (1), Cerenkov in fiber (2)
+    bool                      _binnedArrivals;
+
+    //binned arrivals: expected number of arriving photons per SiPM, number of fiber emissions and time bin;
+    //the time bins have the width of the time delay bins of the lookup tables (1ns), bin 0 is centered at the start time
+    struct PendingArrivals
+    {
+      const CrvLookupBin *bin;
+      double              nArriving;   //expected number of photons of consecutive points in this lookup bin
+      double              timeSum;     //their times weighted by the expected number
+    };
+    static constexpr double   _arrivalTimeBin = 1.0;  //ns
+    std::vector<double>       _arrivalHistograms[4][LookupBin::maxFiberEmissions];
+    double                    _arrivalHistogramStart;
+
+    LookupConstants                        _LC;
+    std::shared_ptr<const CrvLookupTable>  _table;   //shared by all MakeCrvPhotons using the same file
 
     CLHEP::RandFlat           &_randFlat;
     CLHEP::RandGaussQ         &_randGaussQ;
@@ -131,10 +148,13 @@ class MakeCrvPhotons
 
     bool   IsInsideScintillator(const CLHEP::Hep3Vector &p);
     bool   IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3Vector &dir, double &r, double &phi);
-    double GetRandomTime(const LookupBin *theBin);
-    int    GetRandomFiberEmissions(const LookupBin *theBin);
-    double GetAverageNumberOfCerenkovPhotons(double beta, double charge, std::map<double,double> &photons);
+    double GetRandomTime(const CrvLookupBin *theBin);
+    int    GetRandomFiberEmissions(const CrvLookupBin *theBin);
     int    GetNumberOfPhotonsFromAverage(double average, int nSteps);
+    void   AddArrivingPhoton(const CrvLookupBin *theBin, double t, int SiPM, int reflector);
+    void   FillArrivalHistograms(const PendingArrivals &pending, int SiPM, int reflector);
+    void   AddFiberDecay(std::vector<double> &histogram);
+    void   SampleArrivalHistograms();
 
     public:
     void   DrawHistograms();
@@ -91,9 +91,17 @@ namespace mu2eCrv
     double GetVoltage(const Pixel &pixel, double time);
     void   FillQueue(const std::vector<std::pair<double,size_t> > &photons, double startTime, double endTime);
 
+    long   GetBinomial(long n, double p);
+    long   GetCrossTalkPixels(long nPixels);
+    long   GetFiredPixels(long nAvalanches, double nPixels);
+    void   AddAfterPulses(long nPixels, double time, size_t photonIndex, bool darkNoise, std::vector<SiPMresponse> &SiPMresponseVector, double endTime);
+
     CLHEP::RandFlat     &_randFlat;
     CLHEP::RandPoissonQ &_randPoissonQ;
     double               _avalancheProbFullyChargedPixel;
+    double               _crossTalkProbSinglePixel;    //cross talk probability for each of the 4 neighboring pixels
+    double               _fiberPhotonsActiveFraction;  //fraction of the fiber photons which hit active pixels (binned mode)
+    double               _fiberPhotonsEffectivePixels; //effective number of pixels hit by fiber photons (binned mode)
 
     TFile *_photonMapFile;
     TH2F  *_photonMap;
@@ -108,6 +116,16 @@ namespace mu2eCrv
                           const std::vector<std::pair<int,int> > &inactivePixels);
     void Simulate(const std::vector<std::pair<double,size_t> > &photons,
                   std::vector<SiPMresponse> &SiPMresponseVector, double startTime, double endTime);
+
+    //Binned PE mode: instead of following every photon through the pixels, the photons are
+    //histogrammed in time bins of width timeBin, and the number of fired pixels (incl. cross talk)
+    //is sampled for each bin. Each bin gives one SiPMresponse with the sum of its PEs at the
+    //average time of its photons, which refers to the first photon of the bin.
+    //Pixel saturation is approximated with the effective number of pixels under the fiber,
+    //and the recharging of the pixels fired in the preceeding bins.
+    //Dark noise and after pulses remain individual charges.
+    void SimulateBinned(const std::vector<std::pair<double,size_t> > &photons,
+                        std::vector<SiPMresponse> &SiPMresponseVector, double startTime, double endTime, double timeBin);
   };
 
 }
@@ -23,6 +23,7 @@ class MakeCrvWaveforms
                       double startTime, double digitizationInterval);
     void AddElectronicNoise(std::vector<double> &waveform, double noise, CLHEP::RandGaussQ &randGaussQ);
     double GetSinglePEMaxVoltage() {return _singlePEMaxVoltage;}
+    double GetSinglePEReferenceCharge() {return _singlePEReferenceCharge;}
 
   private:
     std::vector<double> _singlePEWaveform;
@@ -0,0 +1,249 @@
+#include "Offline/CRVResponse/inc/CrvLookupTable.hh"
+
+#include "CLHEP/Units/GlobalSystemOfUnits.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace mu2eCrv
+{
+
+static_assert(sizeof(CrvLookupTableHeader)%8==0, "the arrays after the header need to stay 8-byte aligned");
+static_assert(sizeof(CrvLookupBin)==16, "unexpected padding in CrvLookupBin");
+
+CrvLookupTable::CrvLookupTable(const std::string &filename) : _fileName(filename)
+{
+  char magic[8]={};
+  std::ifstream lookupfile(filename,std::ios::binary);
+  if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
+  lookupfile.read(magic,sizeof(magic));
+  lookupfile.close();
+
+  if(std::memcmp(magic,CrvLookupTableHeader::magicWord,sizeof(magic))==0)
+  {
+    _mappedFile = std::make_unique<mu2e::MappedFile>(filename,true);
+    Index(_mappedFile->data(),_mappedFile->size());
+  }
+  else
+  {
+    ReadOriginal(filename,_buffer);
+    Index(_buffer.data(),_buffer.size());
+  }
+}
+
+std::shared_ptr<const CrvLookupTable> CrvLookupTable::Get(const std::string &filename)
+{
+  static std::mutex mutex;
+  static std::map<std::string,std::weak_ptr<const CrvLookupTable> > tables;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  std::shared_ptr<const CrvLookupTable> table = tables[filename].lock();
+  if(!table)
+  {
+    table = std::make_shared<const CrvLookupTable>(filename);
+    tables[filename] = table;
+  }
+  return table;
+}
+
+void CrvLookupTable::Index(const char *data, size_t size)
+{
+  if(size<sizeof(CrvLookupTableHeader)) throw std::logic_error("Corrupt lookup table "+_fileName);
+  _header = reinterpret_cast<const CrvLookupTableHeader*>(data);
+  if(_header->version!=CrvLookupTableHeader::currentVersion || _header->headerSize!=sizeof(CrvLookupTableHeader))
+    throw std::logic_error("Lookup table "+_fileName+" was written by a different version of Offline.");
+  if(_header->constants.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
+  if(_header->constants.reflector!=0 && _header->constants.reflector!=1 && _header->constants.reflector!=2)
+    throw std::logic_error("Lookup tables can have either no reflector/absorber, or a reflector/absorber on the +z side.");
+
+  uint64_t nDoubles = 2*_header->nCerenkovScintillator + 2*_header->nCerenkovFiber;
+  for(int e=0; e<7; ++e) nDoubles += _header->nBinEdges[e];
+  uint64_t nBins = _header->nBins[0] + _header->nBins[1] + _header->nBins[2];
+  if(size != sizeof(CrvLookupTableHeader) + nDoubles*sizeof(double) + nBins*sizeof(CrvLookupBin) + _header->nBytes)
+    throw std::logic_error("Corrupt lookup table "+_fileName);
+
+  const double *d = reinterpret_cast<const double*>(data+sizeof(CrvLookupTableHeader));
+  _cerenkovBeta[0]    = d; d += _header->nCerenkovScintillator;
+  _cerenkovPhotons[0] = d; d += _header->nCerenkovScintillator;
+  _cerenkovBeta[1]    = d; d += _header->nCerenkovFiber;
+  _cerenkovPhotons[1] = d; d += _header->nCerenkovFiber;
+  for(int e=0; e<7; ++e)
+  {
+    _edges[e] = d;
+    d += _header->nBinEdges[e];
+  }
+  const CrvLookupBin *b = reinterpret_cast<const CrvLookupBin*>(d);
+  for(int table=0; table<3; ++table)
+  {
+    _bins[table] = b;
+    b += _header->nBins[table];
+  }
+  _bytes = reinterpret_cast<const unsigned char*>(b);
+}
+
+//Reads the original format with the Lookup* structures, one bin at a time,
+//and packs it into buffer
+void CrvLookupTable::ReadOriginal(const std::string &filename, std::vector<char> &buffer)
+{
+  std::ifstream lookupfile(filename,std::ios::binary);
+  if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
+
+  CrvLookupTableHeader header{};
+  std::memcpy(header.magic,CrvLookupTableHeader::magicWord,sizeof(header.magic));
+  header.version=CrvLookupTableHeader::currentVersion;
+  header.headerSize=sizeof(CrvLookupTableHeader);
+
+  LookupCerenkov       LCerenkov;
+  LookupBinDefinitions LBD;
+  header.constants.Read(lookupfile);
+  if(header.constants.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
+  LCerenkov.Read(lookupfile);
+  LBD.Read(lookupfile);
+
+  std::vector<double> doubles;
+  for(const std::map<double,double> *m : {&LCerenkov.photonsScintillator, &LCerenkov.photonsFiber})
+  {
+    for(const auto &entry : *m) doubles.push_back(entry.first);
+    for(const auto &entry : *m) doubles.push_back(entry.second);
+  }
+  header.nCerenkovScintillator=LCerenkov.photonsScintillator.size();
+  header.nCerenkovFiber=LCerenkov.photonsFiber.size();
+  const std::vector<double> *edges[7]={&LBD.xBins, &LBD.yBins, &LBD.zBins, &LBD.betaBins, &LBD.thetaBins, &LBD.phiBins, &LBD.rBins};
+  for(int e=0; e<7; ++e)
+  {
+    doubles.insert(doubles.end(),edges[e]->begin(),edges[e]->end());
+    header.nBinEdges[e]=edges[e]->size();
+  }
+
+  header.nBins[0]=LBD.getNScintillatorScintillationBins();
+  header.nBins[1]=LBD.getNScintillatorCerenkovBins();
+  header.nBins[2]=LBD.getNFiberCerenkovBins();
+
+  std::vector<CrvLookupBin>  bins;
+  std::vector<unsigned char> bytes;
+  bins.reserve(header.nBins[0]+header.nBins[1]+header.nBins[2]);
+  LookupBin lookupBin;
+  for(int table=0; table<3; ++table)
+  {
+    for(unsigned int i=0; i<header.nBins[table]; ++i)
+    {
+      lookupBin.Read(lookupfile,i);
+      if(!lookupfile.good()) throw std::logic_error("Corrupt lookup table.");
+
+      //trailing zero probabilities never get picked by MakeCrvPhotons::GetRandomTime/GetRandomFiberEmissions
+      std::vector<unsigned char> &t=lookupBin.timeDelays;
+      std::vector<unsigned char> &f=lookupBin.fiberEmissions;
+      while(!t.empty() && t.back()==0) t.pop_back();
+      while(!f.empty() && f.back()==0) f.pop_back();
+      if(t.size()>255 || f.size()>255 ||
+         lookupBin.probabilityScaleTimeDelays>65535 || lookupBin.probabilityScaleFiberEmissions>65535 ||
+         bytes.size()+t.size()+f.size()>UINT32_MAX)
+        throw std::logic_error("Lookup table "+filename+" does not fit into the compact layout.");
+
+      CrvLookupBin bin{};
+      bin.arrivalProbability=lookupBin.arrivalProbability;
+      bin.offset=bytes.size();
+      bin.probabilityScaleTimeDelays=lookupBin.probabilityScaleTimeDelays;
+      bin.probabilityScaleFiberEmissions=lookupBin.probabilityScaleFiberEmissions;
+      bin.nTimeDelays=t.size();
+      bin.nFiberEmissions=f.size();
+      bins.push_back(bin);
+      bytes.insert(bytes.end(),t.begin(),t.end());
+      bytes.insert(bytes.end(),f.begin(),f.end());
+    }
+  }
+  header.nBytes=bytes.size();
+
+  buffer.resize(sizeof(header)+doubles.size()*sizeof(double)+bins.size()*sizeof(CrvLookupBin)+bytes.size());
+  char *p=buffer.data();
+  std::memcpy(p,&header,sizeof(header));                               p+=sizeof(header);
+  std::memcpy(p,doubles.data(),doubles.size()*sizeof(double));         p+=doubles.size()*sizeof(double);
+  std::memcpy(p,bins.data(),bins.size()*sizeof(CrvLookupBin));         p+=bins.size()*sizeof(CrvLookupBin);
+  std::memcpy(p,bytes.data(),bytes.size());
+}
+
+void CrvLookupTable::Convert(const std::string &inputFilename, const std::string &outputFilename)
+{
+  std::vector<char> buffer;
+  ReadOriginal(inputFilename,buffer);
+  std::ofstream outputfile(outputFilename,std::ios::binary|std::ios::trunc);
+  outputfile.write(buffer.data(),buffer.size());
+  outputfile.close();
+  if(!outputfile) throw std::logic_error("Could not write lookup table file "+outputFilename);
+}
+
+//same result as LookupBinDefinitions::findBin, by bisection:
+//the first bin with edges[bin]<=x<=edges[bin+1]
+bool CrvLookupTable::FindBin(BinEdges e, double x, unsigned int &bin) const
+{
+  const double *begin=_edges[e];
+  const double *end=begin+_header->nBinEdges[e];
+  if(end-begin<2) return false;
+  const double *upper=std::lower_bound(begin,end,x);
+  if(upper==end) return false;
+  if(upper==begin)
+  {
+    if(!(*begin==x)) return false;
+    ++upper;
+  }
+  bin=upper-begin-1;
+  return true;
+}
+
+int CrvLookupTable::FindScintillatorScintillationBin(double x, double y, double z) const
+{
+  unsigned int xBin, yBin, zBin;
+  if(!FindBin(X,x,xBin) || !FindBin(Y,y,yBin) || !FindBin(Z,z,zBin)) return(-1);
+
+  unsigned int nYBins = _header->nBinEdges[Y]-1;
+  unsigned int nZBins = _header->nBinEdges[Z]-1;
+  return(zBin + yBin*nZBins + xBin*nYBins*nZBins);
+}
+
+int CrvLookupTable::FindScintillatorCerenkovBin(double x, double y, double z, double beta) const
+{
+  unsigned int xBin, yBin, zBin, betaBin;
+  if(!FindBin(X,x,xBin) || !FindBin(Y,y,yBin) || !FindBin(Z,z,zBin) || !FindBin(BETA,beta,betaBin)) return(-1);
+
+  unsigned int nYBins = _header->nBinEdges[Y]-1;
+  unsigned int nZBins = _header->nBinEdges[Z]-1;
+  unsigned int nBetaBins = _header->nBinEdges[BETA]-1;
+  return(betaBin + zBin*nBetaBins + yBin*nZBins*nBetaBins + xBin*nYBins*nZBins*nBetaBins);
+}
+
+int CrvLookupTable::FindFiberCerenkovBin(double beta, double theta, double phi, double r, double z) const
+{
+  unsigned int betaBin, thetaBin, phiBin, rBin, zBin;
+  if(!FindBin(BETA,beta,betaBin) || !FindBin(THETA,theta,thetaBin) || !FindBin(PHI,phi,phiBin) ||
+     !FindBin(R,r,rBin) || !FindBin(Z,z,zBin)) return(-1);
+
+  unsigned int nThetaBins = _header->nBinEdges[THETA]-1;
+  unsigned int nPhiBins = _header->nBinEdges[PHI]-1;
+  unsigned int nRBins = _header->nBinEdges[R]-1;
+  unsigned int nZBins = _header->nBinEdges[Z]-1;
+  return(zBin + rBin*nZBins + phiBin*nRBins*nZBins + thetaBin*nPhiBins*nRBins*nZBins + betaBin*nThetaBins*nPhiBins*nRBins*nZBins);
+}
+
+//The interpolation starts from the first entry of the table, as the std::map version did
+double CrvLookupTable::GetAverageNumberOfCerenkovPhotons(double beta, double charge, bool fiber) const
+{
+  if(charge==0) return 0;
+
+  const double *betas=_cerenkovBeta[fiber?1:0];
+  const double *photons=_cerenkovPhotons[fiber?1:0];
+  const size_t n=fiber?_header->nCerenkovFiber:_header->nCerenkovScintillator;
+  if(n==0) return 0;
+
+  const size_t i=std::lower_bound(betas,betas+n,beta)-betas;
+  if(i==n) return photons[n-1]*fabs(charge/eplus); //this shouldn't happen
+  if(i==0) return 0; //this shouldn't happen
+  double numberPhotons=photons[0]+(photons[i]-photons[0])/(betas[i]-betas[0])*(beta-betas[0]);
+  return numberPhotons*fabs(charge/eplus);
+}
+
+} //namespace mu2eCrv
@@ -81,6 +81,8 @@ namespace mu2e
       fhicl::Atom<art::InputTag> eventWindowMarkerTag{ Name("eventWindowMarkerTag"), Comment("EventWindowMarker producer"),"EWMProducer" };
       fhicl::Atom<art::InputTag> protonBunchTimeMCTag{ Name("protonBunchTimeMCTag"), Comment("ProtonBunchTimeMC producer"),"EWMProducer" };
       fhicl::Sequence<art::InputTag> timeOffsets { Name("timeOffsets"), Comment("Sim Particle Time Offset Maps")};
+      fhicl::Atom<bool> binnedPE{ Name("binnedPE"),
+                                  Comment("draw the number of photons arriving at the SiPMs per 1ns bin of their arrival times instead of per photon"), false};
     };
     using Parameters = art::EDProducer::Table<Config>;
     explicit CrvPhotonGenerator(const Parameters& conf);
@@ -100,6 +102,7 @@ namespace mu2e
     std::vector<std::string>                                   _lookupTableFileNames;
     std::vector<double>                                        _scintillationYields;
     std::vector<boost::shared_ptr<mu2eCrv::MakeCrvPhotons> >   _makeCrvPhotons;
+    bool                                                       _binnedPE;
 
     double      _scintillationYieldScaleFactor;
     double      _scintillationYieldVariation;
@@ -164,6 +167,7 @@ namespace mu2e
     _reflectors(conf().reflectors()),
     _lookupTableFileNames(conf().lookupTableFileNames()),
     _scintillationYields(conf().scintillationYields()),
+    _binnedPE(conf().binnedPE()),
     _scintillationYieldScaleFactor(conf().scintillationYieldScaleFactor()),
     _scintillationYieldVariation(conf().scintillationYieldVariation()),
     _scintillationYieldVariationCutoffLow(conf().scintillationYieldVariationCutoffLow()),
@@ -220,6 +224,7 @@ namespace mu2e
       filedirs.insert( std::filesystem::path(filespec).parent_path() );
       photonMaker->LoadLookupTable(filespec,_debug);
       photonMaker->SetScintillationYield(_scintillationYields[i]);
+      photonMaker->SetBinnedArrivals(_binnedPE);
       if(_debug>0) std::cout<<"CRV sector "<<i<<" ("<<_CRVSectors[i]<<") uses "<<_makeCrvPhotons.back()->GetFileName()<<" with scintillation yield of "<<_scintillationYields[i]<<" photons/MeV"<<std::endl;
     }
 
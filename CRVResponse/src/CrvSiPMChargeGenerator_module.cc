@@ -55,6 +55,8 @@ namespace mu2e
     double      _digitizationStart, _digitizationEnd, _digitizationStartMargin;
     std::string _eventWindowMarkerLabel;
     std::string _protonBunchTimeMCLabel;
+    bool        _binnedPE;
+    double      _binnedPETimeBin;
 
     mu2eCrv::MakeCrvSiPMCharges::ProbabilitiesStruct _probabilities;
     std::vector<std::pair<int,int> >   _inactivePixels;
@@ -83,6 +85,8 @@ namespace mu2e
     _digitizationStartMargin(pset.get<double>("digitizationStartMargin")),  //50ns
     _eventWindowMarkerLabel(pset.get<std::string>("eventWindowMarker","EWMProducer")),
     _protonBunchTimeMCLabel(pset.get<std::string>("protonBunchTimeMC","EWMProducer")),
+    _binnedPE(pset.get<bool>("binnedPE",false)),                     //sample the PEs per time bin instead of simulating every photon
+    _binnedPETimeBin(pset.get<double>("binnedPETimeBin",1.0)),       //1.0ns
     _inactivePixels(pset.get<std::vector<std::pair<int,int> > >("inactivePixels")),      //{18,18},....,{21,21}
     _engine{createEngine(art::ServiceHandle<SeedService>()->getSeed())},
     _randFlat{_engine},
@@ -172,7 +176,8 @@ namespace mu2e
         }
 
         std::vector<mu2eCrv::SiPMresponse> SiPMresponseVector;
-        _makeCrvSiPMCharges->Simulate(photonTimesNew, SiPMresponseVector, startTime, endTime);
+        if(_binnedPE) _makeCrvSiPMCharges->SimulateBinned(photonTimesNew, SiPMresponseVector, startTime, endTime, _binnedPETimeBin);
+        else _makeCrvSiPMCharges->Simulate(photonTimesNew, SiPMresponseVector, startTime, endTime);
 
         if(SiPMresponseVector.size()>0)
         {
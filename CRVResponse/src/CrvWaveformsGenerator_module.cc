@@ -187,7 +187,11 @@ namespace mu2e
       for(size_t iCluster=0; iCluster<chargeClusters.size(); ++iCluster)
       {
         //if the number of charges in this cluster cannot achieve the minimum voltage, skip this cluster
-        if(chargeClusters[iCluster].timesAndCharges.size()*_makeCrvWaveforms->GetSinglePEMaxVoltage()<_minVoltage) continue;
+        //charges can hold several PEs (binned PE mode of the SiPM charge generator)
+        double nPEs=0;
+        for(const auto &timeAndCharge : chargeClusters[iCluster].timesAndCharges)
+          nPEs+=std::max(1.0,timeAndCharge.second/_makeCrvWaveforms->GetSinglePEReferenceCharge());
+        if(nPEs*_makeCrvWaveforms->GetSinglePEMaxVoltage()<_minVoltage) continue;
 
         //find the TDC time when the first charge occurs (adjusted for this FEB)
         double firstChargeTime=chargeClusters[iCluster].timesAndCharges.front().first;
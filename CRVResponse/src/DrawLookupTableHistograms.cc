@@ -1,4 +1,5 @@
 #include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
+#include "Offline/CRVResponse/inc/CrvLookupTable.hh"
 
 #include <TStyle.h>
 #include <TMarker.h>
@@ -16,18 +17,20 @@ void MakeCrvPhotons::DrawHistograms()
   gStyle->SetOptStat(0);
   gStyle->SetPalette(kRainBow);
 
+  std::vector<double> yBins(_table->GetBinEdges(CrvLookupTable::Y),_table->GetBinEdges(CrvLookupTable::Y)+_table->GetNBinEdges(CrvLookupTable::Y));
+  std::vector<double> zBins(_table->GetBinEdges(CrvLookupTable::Z),_table->GetBinEdges(CrvLookupTable::Z)+_table->GetNBinEdges(CrvLookupTable::Z));
+
   TCanvas c1("ArrivalProbabilities1","",600,800);
-  TH2F h1("HistArrivalProbabilities1","",_LBD.yBins.size()-1,_LBD.yBins.data(),_LBD.zBins.size()-1,_LBD.zBins.data());
+  TH2F h1("HistArrivalProbabilities1","",yBins.size()-1,yBins.data(),zBins.size()-1,zBins.data());
 
-  for(unsigned int iy=1; iy<_LBD.yBins.size(); iy++)
-  for(unsigned int iz=1; iz<_LBD.zBins.size(); iz++)
+  for(unsigned int iy=1; iy<yBins.size(); iy++)
+  for(unsigned int iz=1; iz<zBins.size(); iz++)
   {
-    double y=(_LBD.yBins[iy-1]+_LBD.yBins[iy])/2.0;
-    double z=(_LBD.zBins[iz-1]+_LBD.zBins[iz])/2.0;
-    int i=_LBD.findScintillatorScintillationBin(0.0,y,z);
+    double y=(yBins[iy-1]+yBins[iy])/2.0;
+    double z=(zBins[iz-1]+zBins[iz])/2.0;
+    int i=_table->FindScintillatorScintillationBin(0.0,y,z);
     if(i<0) continue;
-    const LookupBin &bin = _bins[0][i];
-    float p = bin.arrivalProbability;
+    float p = _table->GetBin(0,i)->arrivalProbability;
     if(!std::isnan(p)) h1.Fill(y,z,p);
   }
 
@@ -38,7 +41,7 @@ void MakeCrvPhotons::DrawHistograms()
   h1.SetContour(100);
   h1.Draw("COLZ");
 
-  TMarker marker(-13,_LBD.zBins[0],0);
+  TMarker marker(-13,zBins[0],0);
   marker.SetMarkerStyle(20);
   marker.SetMarkerSize(2);
   marker.SetMarkerColor(2);
@@ -52,17 +55,16 @@ void MakeCrvPhotons::DrawHistograms()
   {
     std::stringstream s;
     s<<"HistArrivalProbabilities2_"<<x+10;
-    TH1F *h2Tmp=new TH1F(s.str().c_str(),"",_LBD.zBins.size()-1,_LBD.zBins.data());
+    TH1F *h2Tmp=new TH1F(s.str().c_str(),"",zBins.size()-1,zBins.data());
     h2Tmp->SetMinimum(0);
     h2Tmp->SetLineWidth(4);
 
-    for(unsigned int iz=1; iz<_LBD.zBins.size(); iz++)
+    for(unsigned int iz=1; iz<zBins.size(); iz++)
     {
-      double z=(_LBD.zBins[iz-1]+_LBD.zBins[iz])/2.0;
-      int i=_LBD.findScintillatorScintillationBin(x,0.0,z);
+      double z=(zBins[iz-1]+zBins[iz])/2.0;
+      int i=_table->FindScintillatorScintillationBin(x,0.0,z);
       if(i<0) continue;
-      const LookupBin &bin = _bins[0][i];
-      float p = bin.arrivalProbability;
+      float p = _table->GetBin(0,i)->arrivalProbability;
       if(!std::isnan(p)) h2Tmp->Fill(z,p);
     }
     h2Tmp->Draw("same");
@@ -1,5 +1,8 @@
 #include "Offline/CRVResponse/inc/MakeCrvPhotons.hh"
+#include "Offline/CRVResponse/inc/CrvLookupTable.hh"
 
+#include <algorithm>
+#include <numeric>
 #include <sstream>
 
 #include "CLHEP/Units/GlobalSystemOfUnits.h"
@@ -249,35 +252,15 @@ void LookupBin::Read(std::ifstream &lookupfile, const unsigned int &i)
   if(i!=binNumber) throw std::logic_error("Corrupt lookup table.");
 }
 
-  void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
+void MakeCrvPhotons::LoadLookupTable(const std::string &filename, int debug)
 {
   _fileName = filename;
-  std::ifstream lookupfile(filename,std::ios::binary);
-  if(!lookupfile.good()) throw std::logic_error("Could not open lookup table file "+filename);
-
-  _LC.Read(lookupfile);
-  if(_LC.version1!=6) throw std::logic_error("This version of Offline expects a lookup table version 6.x.");
-  if(_LC.reflector!=0 && _LC.reflector!=1 && _LC.reflector!=2) throw std::logic_error("Lookup tables can have either no reflector/absorber, or a reflector/absorber on the +z side.");
-
-  _LCerenkov.Read(lookupfile);
-  _LBD.Read(lookupfile);
-
-  unsigned int nScintillatorScintillationBins = _LBD.getNScintillatorScintillationBins();
-  unsigned int nScintillatorCerenkovBins      = _LBD.getNScintillatorCerenkovBins();
-  unsigned int nFiberCerenkovBins             = _LBD.getNFiberCerenkovBins();
-
-  //0...scintillationInScintillator, 1...cerenkovInScintillator 2...cerenkovInFiber
-  _bins[0].resize(nScintillatorScintillationBins);
-  _bins[1].resize(nScintillatorCerenkovBins);
-  _bins[2].resize(nFiberCerenkovBins);
 
   if(debug>0) std::cout<<"Reading CRV lookup tables "<<filename<<" ... "<<std::flush;
-  for(unsigned int i=0; i<nScintillatorScintillationBins; i++) _bins[0][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nScintillatorCerenkovBins; i++)      _bins[1][i].Read(lookupfile,i);
-  for(unsigned int i=0; i<nFiberCerenkovBins; i++)             _bins[2][i].Read(lookupfile,i);
-  if(debug>0) std::cout<<"Done."<<std::endl;
+  _table = CrvLookupTable::Get(filename);
+  if(debug>0) std::cout<<"Done."<<(_table->IsMapped()?" (memory mapped)":"")<<std::endl;
 
-  lookupfile.close();
+  _LC = _table->GetConstants();  //version and reflector are checked by CrvLookupTable
 }
 
 MakeCrvPhotons::~MakeCrvPhotons()
@@ -296,6 +279,7 @@ void MakeCrvPhotons::MakePhotons(const CLHEP::Hep3Vector &stepStartTmp,   //they
   if(_LC.reflector!=std::abs(reflector)) throw std::logic_error("Expected reflector/absorber doesn't match lookup table.");
 
   for(int SiPM=0; SiPM<4; SiPM++) _arrivalTimes[SiPM].clear();
+  _arrivalHistogramStart = std::floor(std::min(timeStart,timeEnd));
 
   //coordinates are in local coordinates of the scintillator (x:thickness, y:width, z:length)
   CLHEP::Hep3Vector stepStart[4];
@@ -338,14 +322,17 @@ static int nPCerenkov=0;
 
     double avgNPhotonsScintillation = _scintillationYield*visibleEnergyDeposited;
     double avgNPhotonsCerenkovInScintillator
-           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov.photonsScintillator)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
+           = _table->GetAverageNumberOfCerenkovPhotons(beta, charge, false)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
     double avgNPhotonsCerenkovInFiber
-           = GetAverageNumberOfCerenkovPhotons(beta, charge, _LCerenkov.photonsFiber)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
+           = _table->GetAverageNumberOfCerenkovPhotons(beta, charge, true)*trueTotalStepLength;  //use the true path, since it  may be longer due to curved paths
 
     int nPhotonsScintillationPerStep          = GetNumberOfPhotonsFromAverage(avgNPhotonsScintillation,nSteps);
     int nPhotonsCerenkovInScintillatorPerStep = GetNumberOfPhotonsFromAverage(avgNPhotonsCerenkovInScintillator,nSteps);
     int nPhotonsCerenkovInFiberPerStep        = GetNumberOfPhotonsFromAverage(avgNPhotonsCerenkovInFiber,nSteps);
 
+    //binned arrivals of the scintillation and Cerenkov photons
+    PendingArrivals pending[2]={{NULL,0,0},{NULL,0,0}};
+
     for(int step=0; step<nSteps; step++)
     {
       double stepFraction = (step+0.5)/nSteps;
@@ -358,31 +345,31 @@ static int nPCerenkov=0;
                      //0...+pi due to symmetry
       bool isInFiber = IsInsideFiber(p,distanceVector, r,phi);
 
-      const LookupBin *scintillationBin=NULL;
-      const LookupBin *cerenkovBin=NULL;
+      const CrvLookupBin *scintillationBin=NULL;
+      const CrvLookupBin *cerenkovBin=NULL;
       int nPhotonsScintillation=0;
       int nPhotonsCerenkov=0;
       if(isInScintillator)
       {
-        int binNumberS=_LBD.findScintillatorScintillationBin(fabs(p.x()),p.y(),p.z());  //use only positive x values due to symmetry in x
+        int binNumberS=_table->FindScintillatorScintillationBin(fabs(p.x()),p.y(),p.z());  //use only positive x values due to symmetry in x
         if(binNumberS>=0)
         {
-          scintillationBin = &_bins[0][binNumberS];   //lookup table number for scintillation in scintillator is 0
+          scintillationBin = _table->GetBin(0,binNumberS);   //lookup table number for scintillation in scintillator is 0
           nPhotonsScintillation = nPhotonsScintillationPerStep;
         }
-        int binNumberC=_LBD.findScintillatorCerenkovBin(fabs(p.x()),p.y(),p.z(),beta);  //use only positive x values due to symmetry in x
+        int binNumberC=_table->FindScintillatorCerenkovBin(fabs(p.x()),p.y(),p.z(),beta);  //use only positive x values due to symmetry in x
         if(binNumberC>=0)
         {
-          cerenkovBin = &_bins[1][binNumberC];   //lookup table number for cerenkov in scintillator is 1
+          cerenkovBin = _table->GetBin(1,binNumberC);   //lookup table number for cerenkov in scintillator is 1
           nPhotonsCerenkov = nPhotonsCerenkovInScintillatorPerStep;
         }
       }
       else if(isInFiber)
       {
-        int binNumber=_LBD.findFiberCerenkovBin(beta,theta,phi,r,p.z());
+        int binNumber=_table->FindFiberCerenkovBin(beta,theta,phi,r,p.z());
         if(binNumber>=0)
         {
-          cerenkovBin = &_bins[2][binNumber];   //lookup table number for cerenkov in fiber is 2
+          cerenkovBin = _table->GetBin(2,binNumber);   //lookup table number for cerenkov in fiber is 2
           nPhotonsCerenkov = nPhotonsCerenkovInFiberPerStep;
         }
       }
@@ -390,41 +377,161 @@ static int nPCerenkov=0;
 nPScintillation+=nPhotonsScintillation;
 nPCerenkov+=nPhotonsCerenkov;
 
+      if(_binnedArrivals)
+      {
+        //consecutive points in the same lookup bin have the same arrival time distribution:
+        //their expected numbers of arriving photons are added, and filled at their mean time
+        const CrvLookupBin *bins[2]={scintillationBin,cerenkovBin};
+        int nPhotonsBins[2]={nPhotonsScintillation,nPhotonsCerenkov};
+        for(int i=0; i<2; i++)
+        {
+          if(bins[i]!=pending[i].bin)
+          {
+            FillArrivalHistograms(pending[i], SiPM, reflector);
+            pending[i]={bins[i],0,0};
+          }
+          if(bins[i]==NULL) continue;
+          double probability = std::min(bins[i]->arrivalProbability,1.0f);
+          if(!(probability>0)) continue;  //also for probabilities of NaN (bins without entries)
+          pending[i].nArriving+=nPhotonsBins[i]*probability;
+          pending[i].timeSum+=nPhotonsBins[i]*probability*t;
+        }
+        continue;
+      }
+
       //loop over all photons created at this point
       int nPhotons = nPhotonsScintillation + nPhotonsCerenkov;
       for(int i=0; i<nPhotons; i++)
       {
         //get the right bin
-        const LookupBin *theBin=cerenkovBin;
+        const CrvLookupBin *theBin=cerenkovBin;
         if(i<nPhotonsScintillation) theBin=scintillationBin;
         if(theBin==NULL) continue;  //this can't actually happen
 
         //photon arrival probability at SiPM
         double probability = theBin->arrivalProbability;
-        if(_randFlat.fire()<=probability)  //a photon arrives at the SiPM --> calculate arrival time
-        {
-          //start time of photons
-          double arrivalTime = t;
-
-          //add fiber decay times depending on the number of emissions
-          int nEmissions = GetRandomFiberEmissions(theBin);
-          for(int iEmission=0; iEmission<nEmissions; iEmission++) arrivalTime+=-_LC.WLSfiberDecayTime*log(_randFlat.fire());
-
-          //add additional time delay due to the photons bouncing around
-          arrivalTime+=GetRandomTime(theBin);
-
-          if(reflector!=-1 && reflector!=-2) _arrivalTimes[SiPM].push_back(arrivalTime);
-          else _arrivalTimes[SiPM+1].push_back(arrivalTime);
-
-        }// if a photon was created
+        if(_randFlat.fire()<=probability) AddArrivingPhoton(theBin, t, SiPM, reflector);  //a photon arrives at the SiPM
       }//loop over all SiPMs
     }//loop over all photons at this point
+
+    if(_binnedArrivals) for(int i=0; i<2; i++) FillArrivalHistograms(pending[i], SiPM, reflector);
   }//loop over all points along the track
 
+  if(_binnedArrivals) SampleArrivalHistograms();
+
 //std::cout<<"Lookup tables:  total scintillation: "<<nPScintillation<<"  total Cerenkov: "<<nPCerenkov<<std::endl;
 
 }
 
+//calculates the arrival time of a photon which arrives at the SiPM
+void MakeCrvPhotons::AddArrivingPhoton(const CrvLookupBin *theBin, double t, int SiPM, int reflector)
+{
+  //start time of photons
+  double arrivalTime = t;
+
+  //add fiber decay times depending on the number of emissions
+  int nEmissions = GetRandomFiberEmissions(theBin);
+  for(int iEmission=0; iEmission<nEmissions; iEmission++) arrivalTime+=-_LC.WLSfiberDecayTime*log(_randFlat.fire());
+
+  //add additional time delay due to the photons bouncing around
+  arrivalTime+=GetRandomTime(theBin);
+
+  if(reflector!=-1 && reflector!=-2) _arrivalTimes[SiPM].push_back(arrivalTime);
+  else _arrivalTimes[SiPM+1].push_back(arrivalTime);
+}
+
+//adds the time delay and fiber emission distributions of the lookup bin at the mean time of the pending photons,
+//split between the two time bins around it, so that the mean time is kept
+void MakeCrvPhotons::FillArrivalHistograms(const PendingArrivals &pending, int SiPM, int reflector)
+{
+  if(pending.bin==NULL || !(pending.nArriving>0)) return;
+  int index = (reflector!=-1 && reflector!=-2)?SiPM:SiPM+1;
+
+  double x = (pending.timeSum/pending.nArriving-_arrivalHistogramStart)/_arrivalTimeBin;
+  size_t timeBin = static_cast<size_t>(std::max(x,0.0));
+  double fraction = std::max(x,0.0)-timeBin;
+
+  //as in GetRandomTime and GetRandomFiberEmissions, an empty distribution gives 0
+  static const unsigned char certain=1;
+  const unsigned char *timeDelays=_table->GetTimeDelays(pending.bin);
+  size_t nTimeDelays=pending.bin->nTimeDelays;
+  double scaleTimeDelays=pending.bin->probabilityScaleTimeDelays;
+  if(nTimeDelays==0 || scaleTimeDelays==0) {timeDelays=&certain; nTimeDelays=1; scaleTimeDelays=1;}
+  const unsigned char *fiberEmissions=_table->GetFiberEmissions(pending.bin);
+  size_t nFiberEmissions=std::min<size_t>(pending.bin->nFiberEmissions,LookupBin::maxFiberEmissions);
+  double scaleFiberEmissions=pending.bin->probabilityScaleFiberEmissions;
+  if(nFiberEmissions==0 || scaleFiberEmissions==0) {fiberEmissions=&certain; nFiberEmissions=1; scaleFiberEmissions=1;}
+
+  for(size_t emissions=0; emissions<nFiberEmissions; ++emissions)
+  {
+    if(fiberEmissions[emissions]==0) continue;
+    double weight = pending.nArriving*fiberEmissions[emissions]/scaleFiberEmissions/scaleTimeDelays;
+    std::vector<double> &histogram = _arrivalHistograms[index][emissions];
+    if(histogram.size()<timeBin+nTimeDelays+1) histogram.resize(timeBin+nTimeDelays+1,0);
+    for(size_t timeDelay=0; timeDelay<nTimeDelays; ++timeDelay)
+    {
+      double w = weight*timeDelays[timeDelay];
+      histogram[timeBin+timeDelay]  +=w*(1.0-fraction);
+      histogram[timeBin+timeDelay+1]+=w*fraction;
+    }
+  }
+}
+
+//convolution with the exponential decay time of one fiber emission, for photons spread uniformly over
+//their time bin: a fraction stays in the bin, the others move by k>0 bins with a probability falling as r^(k-1)
+void MakeCrvPhotons::AddFiberDecay(std::vector<double> &histogram)
+{
+  double tau = _LC.WLSfiberDecayTime/_arrivalTimeBin;
+  if(!(tau>0)) return;
+  double r = exp(-1.0/tau);
+  double stay = 1.0-tau*(1.0-r);
+  double move = tau*(1.0-r)*(1.0-r);
+  double total = std::accumulate(histogram.begin(),histogram.end(),0.0);
+
+  //the tail is extended until the photons left to distribute are negligible
+  double carry = 0;  //sum of r^(k-1) times the content k bins before
+  for(size_t i=0; i<histogram.size() || move*carry/(1.0-r)>1e-6*total; ++i)
+  {
+    if(i==histogram.size()) histogram.push_back(0);
+    double content = histogram[i];
+    histogram[i] = stay*content+move*carry;
+    carry = content+r*carry;
+  }
+}
+
+//the photons with n fiber emissions are delayed by n fiber decay times: the histograms are combined
+//starting from the largest number of emissions, adding one decay time at a time;
+//the number of arriving photons is drawn from a Poisson distribution per time bin, which replaces the
+//binomial distribution of the photons of a point, since the arrival probabilities are small
+void MakeCrvPhotons::SampleArrivalHistograms()
+{
+  for(int index=0; index<4; index++)
+  {
+    std::vector<double> arrivals;
+    for(int emissions=LookupBin::maxFiberEmissions-1; emissions>=0; --emissions)
+    {
+      if(!arrivals.empty()) AddFiberDecay(arrivals);
+      std::vector<double> &histogram = _arrivalHistograms[index][emissions];
+      if(arrivals.size()<histogram.size()) arrivals.resize(histogram.size(),0);
+      for(size_t i=0; i<histogram.size(); ++i) arrivals[i]+=histogram[i];
+      histogram.clear();
+    }
+
+    //total number of photons, distributed over the time bins
+    double expected = std::accumulate(arrivals.begin(),arrivals.end(),0.0);
+    if(!(expected>0)) continue;
+    long nPhotons = _randPoissonQ.fire(expected);
+    for(size_t i=0; i<arrivals.size() && nPhotons>0; ++i)
+    {
+      long n = nPhotons;
+      if(i+1<arrivals.size() && arrivals[i]<expected) n = CLHEP::RandBinomial::shoot(&_randFlat.engine(),nPhotons,arrivals[i]/expected);
+      expected-=arrivals[i];
+      nPhotons-=n;
+      for(long j=0; j<n; ++j) _arrivalTimes[index].push_back(_arrivalHistogramStart+(i-0.5+_randFlat.fire())*_arrivalTimeBin);
+    }
+  }
+}
+
 bool MakeCrvPhotons::IsInsideScintillator(const CLHEP::Hep3Vector &p)
 {
   if(fabs(p.x())>=_LC.halfThickness) return false;
@@ -475,7 +582,7 @@ bool MakeCrvPhotons::IsInsideFiber(const CLHEP::Hep3Vector &p, const CLHEP::Hep3
   return true;
 }
 
-double MakeCrvPhotons::GetRandomTime(const LookupBin *theBin)
+double MakeCrvPhotons::GetRandomTime(const CrvLookupBin *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
@@ -485,17 +592,19 @@ double MakeCrvPhotons::GetRandomTime(const LookupBin *theBin)
   size_t timeDelay=0;
   double rand=_randFlat.fire()*theBin->probabilityScaleTimeDelays;
   double sumProb=0;
-  size_t maxTimeDelay=theBin->timeDelays.size();
+  //trailing zero probabilities are not stored in the table; they can't be picked
+  const unsigned char *timeDelays=_table->GetTimeDelays(theBin);
+  size_t maxTimeDelay=theBin->nTimeDelays;
   for(timeDelay=0; timeDelay<maxTimeDelay; ++timeDelay)
   {
-    sumProb+=theBin->timeDelays[timeDelay];
+    sumProb+=timeDelays[timeDelay];
     if(rand<=sumProb) break;
   }
 
   return static_cast<double>(timeDelay);
 }
 
-int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBin *theBin)
+int MakeCrvPhotons::GetRandomFiberEmissions(const CrvLookupBin *theBin)
 {
   //The lookup tables encodes probabilities as probability*mu2eCrv::LookupBin::probabilityScale(255),
   //so that the probabilities can be stored as integers. For example, the probability of 1 is stored as 255.
@@ -505,10 +614,11 @@ int MakeCrvPhotons::GetRandomFiberEmissions(const LookupBin *theBin)
   size_t emissions=0;
   double rand=_randFlat.fire()*theBin->probabilityScaleFiberEmissions;
   double sumProb=0;
-  size_t maxEmissions=theBin->fiberEmissions.size();
+  const unsigned char *fiberEmissions=_table->GetFiberEmissions(theBin);
+  size_t maxEmissions=theBin->nFiberEmissions;
   for(emissions=0; emissions<maxEmissions; ++emissions)
   {
-    sumProb+=theBin->fiberEmissions[emissions];
+    sumProb+=fiberEmissions[emissions];
     if(rand<=sumProb) break;
   }
 
@@ -540,32 +650,4 @@ const std::vector<double> &MakeCrvPhotons::GetArrivalTimes(int SiPM)
   return _arrivalTimes[SiPM];
 }
 
-//average number of cerenkov photons per millimeter
-double MakeCrvPhotons::GetAverageNumberOfCerenkovPhotons(double beta, double charge, std::map<double,double> &photons)
-{
-  if(charge==0) return 0;
-
-  bool first=true;
-  double prevBeta=0;
-  double prevNumberPhotons=0;
-  std::map<double,double>::const_iterator i;
-  for(i=photons.begin(); i!=photons.end(); i++)
-  {
-    if(beta<=i->first)
-    {
-      if(first) return 0; //this shouldn't happen
-      double numberPhotons=prevNumberPhotons+(i->second-prevNumberPhotons)/(i->first-prevBeta)*(beta-prevBeta);
-      numberPhotons*=fabs(charge/eplus);
-      return numberPhotons;
-    }
-    if(first)
-    {
-      prevBeta=i->first;
-      prevNumberPhotons=i->second;
-      first=false;
-    }
-  }
-  return photons.rbegin()->second*fabs(charge/eplus); //this shouldn't happen
-}
-
 } //namespace mu2e
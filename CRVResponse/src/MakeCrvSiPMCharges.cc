@@ -137,6 +137,27 @@ void MakeCrvSiPMCharges::SetSiPMConstants(int nPixelsX, int nPixelsY, double ove
   _inactivePixels = inactivePixels;
 
   _avalancheProbFullyChargedPixel = GetAvalancheProbability(overvoltage);
+
+  //see GenerateAvalanche: the production probability of cross talk times the avalanche probability of a fully charged pixel
+  _crossTalkProbSinglePixel = 1.0-pow(1.0-_probabilities._crossTalkProb,1.0/4.0);
+
+  //for the binned mode: fraction of the fiber photons which hit active pixels,
+  //and the number of equally likely pixels which gives the same probability that two photons hit the same pixel
+  double sumActive=0, sumActive2=0, sumAll=0;
+  for(int ix=1; ix<=_photonMap->GetNbinsX(); ++ix)
+  for(int iy=1; iy<=_photonMap->GetNbinsY(); ++iy)
+  {
+    double w=_photonMap->GetBinContent(ix,iy);
+    if(w<=0) continue;
+    sumAll+=w;
+    std::pair<int,int> pixelId(_photonMap->GetXaxis()->GetBinLowEdge(ix),_photonMap->GetYaxis()->GetBinLowEdge(iy));
+    if(pixelId.first<0 || pixelId.first>=_nPixelsX || pixelId.second<0 || pixelId.second>=_nPixelsY) continue;
+    if(IsInactivePixelId(pixelId)) continue;
+    sumActive+=w;
+    sumActive2+=w*w;
+  }
+  _fiberPhotonsActiveFraction  = (sumAll>0?sumActive/sumAll:0);
+  _fiberPhotonsEffectivePixels = (sumActive2>0?sumActive*sumActive/sumActive2:1);
 }
 
 void MakeCrvSiPMCharges::FillQueue(const std::vector<std::pair<double,size_t> > &photons, double startTime, double endTime)
@@ -203,8 +224,144 @@ void MakeCrvSiPMCharges::Simulate(const std::vector<std::pair<double,size_t> > &
   } //while(1)
 }
 
+long MakeCrvSiPMCharges::GetBinomial(long n, double p)
+{
+  if(n<=0 || !(p>0)) return 0;
+  if(p>=1) return n;
+  return CLHEP::RandBinomial::shoot(&_randFlat.engine(),n,p);
+}
+
+//number of pixels fired by cross talk of nPixels fired pixels,
+//incl. the cross talk of the cross talk (as in GenerateAvalanche)
+long MakeCrvSiPMCharges::GetCrossTalkPixels(long nPixels)
+{
+  long total=0;
+  while(nPixels>0)
+  {
+    nPixels=GetBinomial(4*nPixels,_crossTalkProbSinglePixel);
+    total+=nPixels;
+  }
+  return total;
+}
+
+//number of different pixels out of nPixels hit by nAvalanches avalanches,
+//i.e. avalanches in the same pixel fire it only once
+long MakeCrvSiPMCharges::GetFiredPixels(long nAvalanches, double nPixels)
+{
+  long fired=0;
+  for(long i=0; i<nAvalanches; ++i)
+  {
+    if(_randFlat.fire()*nPixels>=fired) ++fired;
+  }
+  return fired;
+}
+
+//after pulses of nPixels fully charged pixels fired at time (see GenerateAvalanche)
+void MakeCrvSiPMCharges::AddAfterPulses(long nPixels, double time, size_t photonIndex, bool darkNoise,
+                                         std::vector<SiPMresponse> &SiPMresponseVector, double endTime)
+{
+  const double trapProb[2]={_probabilities._trapType0Prob, _probabilities._trapType1Prob};
+  const double trapLifetime[2]={_probabilities._trapType0Lifetime, _probabilities._trapType1Lifetime};
+  for(int trapType=0; trapType<2; ++trapType)
+  {
+    long nTraps=GetBinomial(nPixels,trapProb[trapType]/_avalancheProbFullyChargedPixel);
+    for(long i=0; i<nTraps; ++i)
+    {
+      double traptime = -trapLifetime[trapType] * log10(_randFlat.fire());
+      if(time+traptime>endTime) continue;
+      double v = _overvoltage * (1.0-exp(-traptime/_timeConstant));  //the pixel is recharging
+      if(_randFlat.fire() < GetAvalancheProbability(v))
+        SiPMresponseVector.emplace_back(time+traptime, _capacitance*v, v/_overvoltage, photonIndex, darkNoise);
+    }
+  }
+}
+
+void MakeCrvSiPMCharges::SimulateBinned(const std::vector<std::pair<double,size_t> > &photons,   //pair of photon time and index in the original photon vector
+                                         std::vector<SiPMresponse> &SiPMresponseVector, double startTime, double endTime, double timeBin)
+{
+  size_t firstResponse = SiPMresponseVector.size();
+  double chargeFullyChargedPixel = _capacitance*_overvoltage;
+
+  std::vector<std::pair<double,size_t> > sortedPhotons(photons);
+  std::sort(sortedPhotons.begin(), sortedPhotons.end());
+
+  //pixels under the fiber which were fired by the preceeding bins and are still recharging, with the time when they were fired
+  std::vector<std::pair<double,double> > rechargingPixels;
+  for(size_t i=0; i<sortedPhotons.size(); )
+  {
+    double bin=floor((sortedPhotons[i].first-startTime)/timeBin);
+    size_t j=i;
+    double sumTime=0;
+    for(; j<sortedPhotons.size() && floor((sortedPhotons[j].first-startTime)/timeBin)==bin; ++j) sumTime+=sortedPhotons[j].first;
+    long   nPhotons=j-i;
+    double time=sumTime/nPhotons;
+    size_t photonIndex=sortedPhotons[i].second;
+    i=j;
+
+    if(time>endTime) break;
+
+    //pixels which are (almost) fully recharged are available again
+    rechargingPixels.erase(std::remove_if(rechargingPixels.begin(), rechargingPixels.end(),
+                                          [&](const std::pair<double,double> &r){return time-r.first>10.0*_timeConstant;}),
+                           rechargingPixels.end());
+
+    //the photons hit the pixels under the fiber (the effective number of pixels) at random:
+    //first the photons which hit recharging pixels, the remaining photons hit fully charged pixels
+    long   nPhotonsRemaining=GetBinomial(nPhotons,_fiberPhotonsActiveFraction);
+    double fractionRemaining=1.0;
+    double nPEs=0;
+    double firedPixels=0;
+    for(auto &recharging : rechargingPixels)
+    {
+      double fraction=recharging.second/_fiberPhotonsEffectivePixels;
+      long   nHits=GetBinomial(nPhotonsRemaining,fraction/fractionRemaining);
+      nPhotonsRemaining-=nHits;
+      fractionRemaining-=fraction;
+      if(nHits==0) continue;
+
+      //these pixels are at a lower voltage: lower avalanche probability and lower charge
+      double v=_overvoltage*(1.0-exp(-(time-recharging.first)/_timeConstant));
+      long   nAvalanches=GetBinomial(nHits,GetAvalancheProbability(v));
+      double fired=GetFiredPixels(nAvalanches,recharging.second);
+      recharging.second-=fired;
+      firedPixels+=fired;
+      nPEs+=fired*v/_overvoltage;
+    }
+    double chargedPixels=std::max(_fiberPhotonsEffectivePixels*fractionRemaining,1.0);
+    long   nAvalanches=GetBinomial(nPhotonsRemaining,_avalancheProbFullyChargedPixel);
+    double fired=GetFiredPixels(nAvalanches,chargedPixels);
+    firedPixels+=fired;
+    nPEs+=fired;
+    if(firedPixels==0) continue;
+    rechargingPixels.emplace_back(time,firedPixels);
+
+    //cross talk into the (mostly fully charged) neighboring pixels
+    long nCrossTalk=GetCrossTalkPixels(lrint(firedPixels));
+    nPEs+=nCrossTalk;
+    SiPMresponseVector.emplace_back(time, nPEs*chargeFullyChargedPixel, nPEs, photonIndex, false);
+    AddAfterPulses(lrint(firedPixels)+nCrossTalk, time, photonIndex, false, SiPMresponseVector, endTime);
+  }
+
+  //dark noise: the thermally created charges of FillQueue times the avalanche probability; inactive pixels don't fire
+  double timeWindow = endTime-startTime;
+  double activePixelFraction = 1.0-static_cast<double>(_inactivePixels.size())/(_nPixelsX*_nPixelsY);
+  int numberThermalCharges = _randPoissonQ.fire(_probabilities._thermalRate*activePixelFraction*timeWindow);
+  for(int i=0; i<numberThermalCharges; i++)
+  {
+    double time = startTime + timeWindow * _randFlat.fire();
+    long nPEs=1+GetCrossTalkPixels(1);
+    SiPMresponseVector.emplace_back(time, nPEs*chargeFullyChargedPixel, nPEs, 0, true);
+    AddAfterPulses(nPEs, time, 0, true, SiPMresponseVector, endTime);
+  }
+
+  //the waveform generator expects the charges in time order, as in Simulate
+  std::stable_sort(SiPMresponseVector.begin()+firstResponse, SiPMresponseVector.end(),
+                   [](const SiPMresponse &a, const SiPMresponse &b){return a._time<b._time;});
+}
+
 MakeCrvSiPMCharges::MakeCrvSiPMCharges(CLHEP::RandFlat &randFlat, CLHEP::RandPoissonQ &randPoissonQ, const std::string &photonMapFileName) :
-                                       _randFlat(randFlat), _randPoissonQ(randPoissonQ), _avalancheProbFullyChargedPixel(0)
+                                       _randFlat(randFlat), _randPoissonQ(randPoissonQ), _avalancheProbFullyChargedPixel(0),
+                                       _crossTalkProbSinglePixel(0), _fiberPhotonsActiveFraction(0), _fiberPhotonsEffectivePixels(1)
 {
   _photonMapFile = new TFile(photonMapFileName.c_str());
   if(_photonMapFile==NULL) throw std::logic_error("Could not open photon map file.");
@@ -0,0 +1,35 @@
+/*
+Writes a CRV photon lookup table in the layout of CrvLookupTable, which is memory mapped
+and shared between the processes instead of being read bin by bin in every job.
+
+Usage:
+  convertCrvLookupTable <input lookup table> <output lookup table>
+*/
+
+#include "Offline/CRVResponse/inc/CrvLookupTable.hh"
+
+#include <exception>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+  if(argc!=3)
+  {
+    std::cerr<<"Usage: "<<argv[0]<<" <input lookup table> <output lookup table>"<<std::endl;
+    return 1;
+  }
+
+  try
+  {
+    mu2eCrv::CrvLookupTable::Convert(argv[1],argv[2]);
+    mu2eCrv::CrvLookupTable table(argv[2]);
+    std::cout<<"Wrote "<<argv[2]<<" with "
+             <<table.GetNBins(0)<<"/"<<table.GetNBins(1)<<"/"<<table.GetNBins(2)<<" bins."<<std::endl;
+  }
+  catch(const std::exception &e)
+  {
+    std::cerr<<e.what()<<std::endl;
+    return 1;
+  }
+  return 0;
+}
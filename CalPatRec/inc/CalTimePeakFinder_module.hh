@@ -22,6 +22,7 @@ namespace art {
 #include "Offline/RecoDataProducts/inc/HelixVal.hh"
 
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 
@@ -90,6 +91,7 @@ namespace mu2e {
     std::string      _shfLabel;
     // std::string      _shpLabel;
     std::string      _ccmLabel; // caloClusterModuleLabel
+    std::string      _htiLabel; // ComboHitTimeIndex of the ComboHits, built here if empty
 
     StrawHitFlag     _hsel;
     StrawHitFlag     _bkgsel;
@@ -110,6 +112,8 @@ namespace mu2e {
 // cache of event objects
 //-----------------------------------------------------------------------------
     art::Handle<CaloClusterCollection>    _ccH; // data member, as used from different places
+    const ComboHitTimeIndex*              _hti;
+    ComboHitTimeIndex                     _localhti;
 
     // const StrawHitCollection*             _shcol;
     // const StrawHitFlagCollection*         _shfcol;
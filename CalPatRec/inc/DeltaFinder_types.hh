@@ -157,6 +157,8 @@ namespace mu2e {
 
       void InitEvent(const art::Event* Evt, int DebugLevel);
       void InitGeometry();
+                                        // same, without the geometry service
+      void InitGeometry(const Tracker* Tracker);
 
       int  nSeedsTot();
 
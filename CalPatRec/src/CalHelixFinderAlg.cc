@@ -52,6 +52,7 @@
 
 #include "Offline/CalPatRec/inc/CalHelixFinderAlg.hh"
 #include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 
 using CLHEP::HepVector;
 using CLHEP::Hep3Vector;
@@ -233,6 +234,7 @@ namespace mu2e {
 //2016-12-26 gianipez added the following function to make CalHelixFinderAlg compatible with TimeCluster obj
 //-----------------------------------------------------------------------------
   bool CalHelixFinderAlg::findHelix(CalHelixFinderData& Helix) {
+    MU2E_PROFILE_SCOPE("CalHelixFinderAlg::findHelix");
 
     // fTimeCluster = TimePeak;
     //check presence of a cluster
@@ -273,6 +275,7 @@ namespace mu2e {
 // called internally; in the diagnostics mode save several states of _xyzp
 //-----------------------------------------------------------------------------
   bool CalHelixFinderAlg::fitHelix(CalHelixFinderData& Helix) {
+    MU2E_PROFILE_SCOPE("CalHelixFinderAlg::fitHelix");
     bool retval(false);
                                         // initialize internal array of hits, print if requested
     //    fillXYZP(Helix); //2019-01-18: gianipez moved this into the CalHelixFinder_module to exploit the helicity loop-search
@@ -33,6 +33,8 @@
 
 #include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
 
+#include <algorithm>
+
 using namespace std;
 
 using CLHEP::HepVector;
@@ -52,6 +54,7 @@ namespace mu2e {
     _shLabel         (pset.get<string>         ("StrawHitCollectionLabel"        )),
     _shfLabel        (pset.get<string>         ("StrawHitFlagCollectionLabel"    )),
     _ccmLabel        (pset.get<string>         ("caloClusterModuleLabel"         )),
+    _htiLabel        (pset.get<string>         ("hitTimeIndexLabel"            ,"")),
     _hsel            (pset.get<vector<string> >("HitSelectionBits"               )),
     _bkgsel          (pset.get<vector<string> >("BackgroundSelectionBits"        )),
     _mindt           (pset.get<double>         ("DtMin"                          )),
@@ -65,6 +68,7 @@ namespace mu2e {
   {
     consumes<ComboHitCollection>(_shLabel);
     consumes<CaloClusterCollection>(_ccmLabel);
+    if (!_htiLabel.empty()) consumes<ComboHitTimeIndex>(_htiLabel);
     produces<TimeClusterCollection>();
     // produces<CalTimePeakCollection>();
 
@@ -119,6 +123,21 @@ namespace mu2e {
              _shLabel.data());
     }
 
+//-----------------------------------------------------------------------------
+// time-sorted hits (no hit selection), shared with the other time cluster finders if available
+//-----------------------------------------------------------------------------
+    if (_data.chcol != 0) {
+      if (!_htiLabel.empty()) {
+        _hti = evt.getValidHandle<ComboHitTimeIndex>(_htiLabel).product();
+        if (_hti->nHits() != _data.chcol->size() || _hti->findSelection(StrawHitFlag(),StrawHitFlag()) != 0)
+          throw cet::exception("RECO")<<"CalTimePeakFinder: time index " << _htiLabel << " does not match the hit collection" << std::endl;
+      }
+      else {
+        _localhti = ComboHitTimeIndex(*_data.chcol, nullptr, {StrawHitFlag()}, {StrawHitFlag()});
+        _hti      = &_localhti;
+      }
+    }
+
     if (evt.getByLabel(_ccmLabel, _ccH)) {
       _data.ccCollection = _ccH.product();
     }
@@ -235,7 +254,18 @@ namespace mu2e {
             printf("[CalTimePeakFinder::findTimePeaks] nComboHits=%i\n",  nch);
             printf("[CalTimePeakFinder::findTimePeaks]     TOF      Dt\n");
           }
-          for(int istr=0; istr<nch;++istr) {
+//-----------------------------------------------------------------------------
+// only the hits in the time window allowed by the time-of-flight range of the
+// hits need to be tested, the index is sorted in corrected time
+//-----------------------------------------------------------------------------
+          double tof1    = (zcl-_hti->zmin(0))/_sinPitch/(CLHEP::c_light*_beta);
+          double tof2    = (zcl-_hti->zmax(0))/_sinPitch/(CLHEP::c_light*_beta);
+          auto   entries = _hti->window(0, cl_time-std::max(tof1,tof2)-_maxdt-1., cl_time-std::min(tof1,tof2)-_mindt+1.);
+          vector<StrawHitIndex> candidates;
+          for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) candidates.push_back(_hti->hit(ientry));
+          std::sort(candidates.begin(),candidates.end());
+
+          for(int istr : candidates) {
 
             hit    = &_data.chcol->at(istr);
             time   = hit->correctedTime();
@@ -4,6 +4,7 @@
 #include "Offline/CalPatRec/inc/DeltaFinderAlg.hh"
 
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 
 namespace mu2e {
 
@@ -564,6 +565,7 @@ namespace mu2e {
 // TODO: update the time as more hits are added
 //-----------------------------------------------------------------------------
   void DeltaFinderAlg::findSeeds() {
+    MU2E_PROFILE_SCOPE("DeltaFinderAlg::findSeeds");
 
     for (int s=0; s<kNStations; ++s) {
       for (int face=0; face<kNFaces-1; face++) {
@@ -1120,6 +1122,7 @@ namespace mu2e {
 
 //-----------------------------------------------------------------------------
   void  DeltaFinderAlg::run() {
+    MU2E_PROFILE_SCOPE("DeltaFinderAlg::run");
     orderHits();
 //-----------------------------------------------------------------------------
 // loop over all stations and find delta seeds - 2-3-4 combo hit stubs
@@ -113,7 +113,12 @@ namespace mu2e {
 //-----------------------------------------------------------------------------
     void Data_t::InitGeometry() {
       mu2e::GeomHandle<mu2e::Tracker> tH;
-      tracker     = tH.get();
+      InitGeometry(tH.get());
+    }
+
+//-----------------------------------------------------------------------------
+    void Data_t::InitGeometry(const Tracker* Tracker) {
+      tracker     = Tracker;
 
       // mu2e::GeomHandle<mu2e::DiskCalorimeter> cH;
       // calorimeter = cH.get();
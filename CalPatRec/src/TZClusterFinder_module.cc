@@ -13,6 +13,9 @@
 #include "art_root_io/TFileService.h"
 #include "art/Utilities/make_tool.h"
 
+#include "fhiclcpp/types/OptionalAtom.h"
+
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
 #include "Offline/RecoDataProducts/inc/IntensityInfoTimeCluster.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
@@ -52,6 +55,7 @@ namespace mu2e {
       fhicl::Atom<art::InputTag>     tcCollLabel      {Name("tcCollLabel"      ), Comment("time cluster coll label"     ) };
       fhicl::Atom<art::InputTag>     shfCollLabel     {Name("shfCollLabel"     ), Comment("straw hit flag coll label"   ) };
       fhicl::Atom<art::InputTag>     ccCollLabel      {Name("ccCollLabel"      ), Comment("Calo Cluster coll label"     ) };
+      fhicl::OptionalAtom<art::InputTag> htiLabel     {Name("hitTimeIndex"     ), Comment("time index of the combo hits, built here if not set") };
       fhicl::Sequence<std::string>   hitBkgBits       {Name("hitBkgBits"       ), Comment("background bits"             ) };
       fhicl::Atom<int>               chunkSep         {Name("chunkSep"         ), Comment("max # of planes for chunk"   ) };
       fhicl::Atom<double>            chunkWindow      {Name("chunkWindow"      ), Comment("time window in ns"           ) };
@@ -101,6 +105,8 @@ namespace mu2e {
     art::InputTag   _tcLabel ;
     art::InputTag   _shfLabel;
     art::InputTag   _ccLabel;
+    art::InputTag   _htiLabel;
+    bool            _useHTI;
     StrawHitFlag    _hbkg;
 
     //-----------------------------------------------------------------------------
@@ -134,6 +140,8 @@ namespace mu2e {
     //-----------------------------------------------------------------------------
     Data_t                                 _data;
     art::Handle<CaloClusterCollection>     _ccHandle;
+    const ComboHitTimeIndex*               _hti;      // all the combo hits, sorted by time
+    ComboHitTimeIndex                      _localhti;
     facilitateVars                         _f;
     std::unique_ptr<ModuleHistToolBase>    _hmanager;
     TCanvas*                               _c1;
@@ -192,6 +200,7 @@ namespace mu2e {
     _tcLabel                (config().tcCollLabel()                             ),
     _shfLabel               (config().shfCollLabel()                            ),
     _ccLabel                (config().ccCollLabel()                             ),
+    _useHTI                 (config().htiLabel(_htiLabel)                       ),
     _hbkg                   (config().hitBkgBits()                              ),
     _chunkSep               (config().chunkSep()                                ),
     _chunkWindow            (config().chunkWindow()                             ),
@@ -219,6 +228,7 @@ namespace mu2e {
 
       consumes<ComboHitCollection>(_chLabel);
       consumes<CaloClusterCollection>(_ccLabel);
+      if (_useHTI) consumes<ComboHitTimeIndex>(_htiLabel);
       produces<TimeClusterCollection>();
       produces<IntensityInfoTimeCluster>();
 
@@ -293,6 +303,17 @@ namespace mu2e {
     if(_data._shfColl->size() != _data._chColl->size())
       throw cet::exception("RECO")<<"TimeClusterFinder: inconsistent flag collection length " << std::endl;
 
+    // time-sorted hits, shared with the other time cluster finders if available
+    if (_useHTI) {
+      _hti = evt.getValidHandle<ComboHitTimeIndex>(_htiLabel).product();
+      if (_hti->nHits() != _data._chColl->size() || _hti->findSelection(StrawHitFlag(),StrawHitFlag()) != 0)
+        throw cet::exception("RECO")<<"TZClusterFinder: time index " << _htiLabel << " does not match the hit collection" << std::endl;
+    }
+    else {
+      _localhti = ComboHitTimeIndex(*_data._chColl, nullptr, {StrawHitFlag()}, {StrawHitFlag()});
+      _hti      = &_localhti;
+    }
+
     return (_data._chColl != 0);
   }
 
@@ -344,8 +365,11 @@ namespace mu2e {
   void TZClusterFinder::cHitsFill() {
 
     const mu2e::ComboHit* hit;
-    // fill cHits indexed by pln, each column being a vector housing cHit info
-    for (size_t i=0; i<_data._chColl->size(); i++) {
+    // fill cHits indexed by pln, each column being a vector housing cHit info.  The hits
+    // are taken by descending time from the time index, so the plnHits are time ordered
+    auto entries = _hti->range(0);
+    for (unsigned ientry=entries.second; ientry-- > entries.first; ) {
+      size_t i = _hti->hit(ientry);
       if ((*_data._shfColl)[i].hasAnyProperty(StrawHitFlag::energysel)) { if (bkgHit((*_data._shfColl)[i])) {continue;} }
       hit = &_data._chColl->at(i);
       int plnID = hit->strawId().plane();
@@ -358,13 +382,6 @@ namespace mu2e {
       comboHit.hIsUsed = 0;
       _f.cHits[plnID].plnHits.push_back(comboHit);
     }
-
-    // order the plnHits in each pln by descending time
-    for (size_t i=0; i<_f.cHits.size(); i++) {
-      std::sort(_f.cHits[i].plnHits.begin(), _f.cHits[i].plnHits.end(),
-                [](const cHit &a, const cHit &b) -> bool
-                { return a.hTime > b.hTime;});
-    }
   }
 
 
@@ -923,7 +940,12 @@ namespace mu2e {
           _f._chunkInfo.nHits = 0;
           _f._chunkInfo.nStrawHits = 0;
           _f._chunkInfo.caloIndex = i;
-          for (size_t k=0; k<_data._chColl->size(); k++) {
+          // hits in time with the cluster, in collection order
+          auto entries = _hti->window(0, ccTime - _caloDtMax, ccTime + _caloDtMax);
+          std::vector<StrawHitIndex> candidates;
+          for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) candidates.push_back(_hti->hit(ientry));
+          std::sort(candidates.begin(), candidates.end());
+          for (size_t k : candidates) {
             if (bkgHit((*_data._shfColl)[k])) {continue;}
             if (!(*_data._shfColl)[k].hasAnyProperty(StrawHitFlag::energysel)) {continue;}
             hit = &_data._chColl->at(k);
@@ -1,14 +1,16 @@
 #ifndef CaloCluster_ClusterFinder_HH_
 #define CaloCluster_ClusterFinder_HH_
 //
-// Class to find cluster of simply connected crystals
+// Class to find cluster of simply connected crystals among a set of hits (typically one disk)
+//
+// The hits are kept in flat arrays: their indices bucketed by crystal (CSR offsets), a flag per hit
+// set once it is clustered or removed, and a visit stamp per crystal, so forming a cluster neither
+// allocates nor erases.
 //
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
-#include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
+#include "Offline/CaloCluster/inc/CrystalNeighbors.hh"
 
 #include <vector>
-#include <queue>
-#include <list>
 
 namespace mu2e {
 
@@ -16,25 +18,35 @@ namespace mu2e {
     class ClusterFinder
     {
          public:
-             using CaloCrystalList = std::list<const CaloHit*>;
              using CaloCrystalVec  = std::vector<const CaloHit*>;
 
-             ClusterFinder(const Calorimeter&, const CaloHit*, double, double, bool addSecondRing);
+             ClusterFinder(const CrystalNeighbors&, double deltaTime, double ExpandCut);
+
+             // hitIds are indices into hits, in increasing order; hit i below is hits[hitIds[i]]
+             void                   initialize(const CaloHitCollection& hits, const std::vector<unsigned>& hitIds);
+
+             unsigned               nHits()               const {return hitIds_.size();}
+             const CaloHit&         hit(unsigned i)       const {return (*hits_)[hitIds_[i]];}
+             unsigned               hitIndex(unsigned i)  const {return hitIds_[i];}
+             bool                   isUsed(unsigned i)    const {return used_[i];}
+             void                   remove(unsigned i)          {used_[i] = true;}
 
-             void                   formCluster(std::vector<CaloCrystalList>&);
-             const CaloCrystalList& clusterList() const {return clusterList_;}
+             // cluster the unused hits connected to the unused seed hit i, sorted by energy
+             void                   formCluster(unsigned i, CaloCrystalVec& cluster);
 
 
          private:
-             const Calorimeter*   cal_;
-             const CaloHit*       crystalSeed_;
-             double               seedTime_;
-             CaloCrystalList      clusterList_;
-             std::queue<int>      crystalToVisit_;
-             std::vector<bool>    isVisited_;
-             double               deltaTime_;
-             double               ExpandCut_;
-             bool                 addSecondRing_;
+             const CrystalNeighbors*  neighbors_;
+             double                   deltaTime_;
+             double                   ExpandCut_;
+             const CaloHitCollection* hits_;
+             std::vector<unsigned>    hitIds_;
+             std::vector<unsigned>    crystalOffset_;  // hits of crystal c are byCrystal_[crystalOffset_[c]..crystalOffset_[c+1])
+             std::vector<unsigned>    byCrystal_;
+             std::vector<bool>        used_;
+             std::vector<unsigned>    visited_;
+             unsigned                 stamp_;
+             std::vector<int>         crystalToVisit_;
     };
 
 
@@ -0,0 +1,29 @@
+#ifndef CaloCluster_CrystalNeighbors_HH_
+#define CaloCluster_CrystalNeighbors_HH_
+//
+// Flat (CSR) table of the crystal neighbors used to grow clusters: the first ring, optionally
+// followed by the second ring, of every crystal in one contiguous array
+//
+#include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
+
+#include <vector>
+
+namespace mu2e {
+
+    class CrystalNeighbors
+    {
+         public:
+             CrystalNeighbors(const Calorimeter& cal, bool addSecondRing);
+
+             int         nCrystal()        const {return offsets_.size()-1;}
+             const int*  begin(int crId)   const {return ids_.data() + offsets_[crId];}
+             const int*  end(int crId)     const {return ids_.data() + offsets_[crId+1];}
+
+         private:
+             std::vector<unsigned> offsets_;
+             std::vector<int>      ids_;
+    };
+
+}
+
+#endif
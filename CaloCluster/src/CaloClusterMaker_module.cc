@@ -17,6 +17,7 @@
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 #include "Offline/CaloCluster/inc/ClusterAssociator.hh"
 #include "Offline/CaloCluster/inc/ClusterUtils.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
@@ -80,6 +81,7 @@ namespace mu2e {
   //---------------------------------------------------------------------------------------------------------------
   void CaloClusterMaker::produce(art::Event& event)
   {
+      MU2E_PROFILE_SCOPE("CaloClusterMaker::produce");
       const auto& caloClustersMain  = *event.getValidHandle(mainToken_);
       const auto& caloClustersSplit = *event.getValidHandle(splitToken_);
 
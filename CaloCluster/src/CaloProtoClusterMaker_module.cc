@@ -13,24 +13,32 @@
 // Note 1: Seed do not need to be ordered by energy
 // Note 2: The cluster time is taken as that of the most energetic hit -> potential for improvement (have fun)
 // Note 3: Several optimization obscured the code for little gain, so I sticked to simplicity
+// Note 4: Clusters never cross disks, so each disk is clustered by its own ClusterFinder (flat arrays, see
+//         ClusterFinder.hh), in parallel. Only the split-off time filter needs the main clusters of all disks.
+//         Clusters are merged in order of their seed index, as if the disks had been processed together.
 //
 
 #include "art/Framework/Core/EDProducer.h"
 #include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
 #include "cetlib_except/exception.h"
 #include "fhiclcpp/types/Atom.h"
 
 #include "Offline/CaloCluster/inc/ClusterFinder.hh"
+#include "Offline/CaloCluster/inc/CrystalNeighbors.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/GeometryService/inc/GeometryService.hh"
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 #include "Offline/RecoDataProducts/inc/CaloProtoCluster.hh"
 
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <string>
-#include <list>
-#include <set>
 #include <vector>
 
 
@@ -40,7 +48,6 @@ namespace mu2e {
   {
      public:
         typedef std::vector<const CaloHit*>  CaloCrystalVec;
-        typedef std::list<const CaloHit*>    CaloCrystalList;
 
         struct Config
         {
@@ -69,6 +76,7 @@ namespace mu2e {
            produces<CaloProtoClusterCollection>("split");
         }
 
+        void beginRun(art::Run& run) override;
         void produce(art::Event& e) override;
 
      private:
@@ -79,16 +87,36 @@ namespace mu2e {
         bool                                 addSecondRing_;
         double                               deltaTime_;
         int                                  diagLevel_;
+        std::unique_ptr<CrystalNeighbors>    neighbors_;
+        std::vector<ClusterFinder>           finders_;
+
+        // clusters of one disk and the index of their seed hit
+        struct DiskClusters
+        {
+            std::vector<CaloCrystalVec> clusters;
+            std::vector<unsigned>       seeds;
+        };
 
         void makeProtoClusters (CaloProtoClusterCollection&,CaloProtoClusterCollection&, const art::Handle<CaloHitCollection>&);
-        void filterByTime      (CaloCrystalList&, const std::vector<double>&);
-        void fillCluster       (CaloProtoClusterCollection&, const CaloCrystalList&,const art::Handle<CaloHitCollection>&);
-        void dump              (const std::string&, const std::vector<CaloCrystalList>&, std::set<const CaloHit*>);
+        void formClusters      (ClusterFinder&, DiskClusters&, bool seedsOnly);
+        void filterByTime      (ClusterFinder&, const std::vector<double>&);
+        void fillClusters      (CaloProtoClusterCollection&, const std::vector<DiskClusters>&, const art::Handle<CaloHitCollection>&);
+        void fillCluster       (CaloProtoClusterCollection&, const CaloCrystalVec&,const art::Handle<CaloHitCollection>&);
+        void dump              (const std::string&, const std::vector<ClusterFinder>&, bool seedsOnly);
   };
 
 
+  void CaloProtoClusterMaker::beginRun(art::Run&)
+  {
+      const Calorimeter& cal = *(GeomHandle<Calorimeter>());
+      neighbors_ = std::make_unique<CrystalNeighbors>(cal, addSecondRing_);
+      finders_.assign(cal.nDisk(), ClusterFinder(*neighbors_, deltaTime_, ExpandCut_));
+  }
+
+
   void CaloProtoClusterMaker::produce(art::Event& event)
   {
+      MU2E_PROFILE_SCOPE("CaloProtoClusterMaker::produce");
       art::Handle<CaloHitCollection> CaloHitsHandle = event.getHandle<CaloHitCollection>(caloCrystalToken_);
 
       auto caloProtoClustersMain  = std::make_unique<CaloProtoClusterCollection>();
@@ -110,60 +138,37 @@ namespace mu2e {
       if (CaloHits.empty()) return;
 
 
-      //declare and fill the hash map crystal_id -> list of CaloHits
-      std::vector<CaloCrystalList> mainClusterList, splitClusterList, caloIdHitMap(cal.nCrystal());
-      std::set<const CaloHit*> seedList;
-      std::vector<double>      clusterTime;
-
-      //fill data structures
-      for (const auto& hit : CaloHits)
+      //split the hits above the noise cut by disk, keeping the collection order
+      std::vector<std::vector<unsigned>> diskHits(finders_.size());
+      for (unsigned i=0; i<CaloHits.size(); ++i)
       {
+          const CaloHit& hit = CaloHits[i];
           if (hit.energyDep() < EnoiseCut_) continue;
-          caloIdHitMap[hit.crystalID()].push_back(&hit);
-          if (hit.energyDep() > EminSeed_ ) seedList.insert(&hit);
+          diskHits[cal.crystal(hit.crystalID()).diskID()].push_back(i);
       }
 
-      if (diagLevel_ > 2) dump("Init", caloIdHitMap,seedList);
-
-
+      const unsigned nDisk = finders_.size();
+      for (unsigned idisk=0; idisk<nDisk; ++idisk) finders_[idisk].initialize(CaloHits, diskHits[idisk]);
+      if (diagLevel_ > 2) dump("Init", finders_, true);
 
       //produce main clusters
-      while( !seedList.empty() )
-      {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal, crystalSeed, deltaTime_, ExpandCut_, addSecondRing_);
-          finder.formCluster(caloIdHitMap);
-
-          mainClusterList.push_back(finder.clusterList());
-          clusterTime.push_back(crystalSeed->time());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
-      }
-
-
-      //filter unneeded hits and fill new seeds
-      for (unsigned i=0; i < caloIdHitMap.size(); ++i ) filterByTime(caloIdHitMap[i], clusterTime);
-      for (const auto& liste: caloIdHitMap) {for (const auto& ptr : liste) seedList.insert(ptr);}
-      if (diagLevel_ > 2) dump("Post filtering", caloIdHitMap,seedList);
-
+      std::vector<DiskClusters> mainClusters(nDisk), splitClusters(nDisk);
+      tbb::parallel_for(0u, nDisk, [&](unsigned idisk) {formClusters(finders_[idisk], mainClusters[idisk], true);});
 
+      std::vector<double> clusterTime;
+      for (const auto& disk : mainClusters)
+         for (unsigned seed : disk.seeds) clusterTime.push_back(CaloHits[seed].time());
 
+      //filter unneeded hits, the remaining ones are the new seeds
+      tbb::parallel_for(0u, nDisk, [&](unsigned idisk) {filterByTime(finders_[idisk], clusterTime);});
+      if (diagLevel_ > 2) dump("Post filtering", finders_, false);
 
       //produce split-offs clusters
-      while (!seedList.empty())
-      {
-          const CaloHit* crystalSeed = *seedList.begin();
-          ClusterFinder finder(cal,crystalSeed,deltaTime_, ExpandCut_, addSecondRing_);
-
-          finder.formCluster(caloIdHitMap);
-          splitClusterList.push_back(finder.clusterList());
-
-          for (const auto& hit: finder.clusterList()) seedList.erase(hit);
-      }
+      tbb::parallel_for(0u, nDisk, [&](unsigned idisk) {formClusters(finders_[idisk], splitClusters[idisk], false);});
 
       //save the main and split clusters
-      for (auto cluster : mainClusterList)  fillCluster(caloProtoClustersMain,cluster,CaloHitsHandle);
-      for (auto cluster : splitClusterList) fillCluster(caloProtoClustersSplit,cluster,CaloHitsHandle);
+      fillClusters(caloProtoClustersMain,  mainClusters,  CaloHitsHandle);
+      fillClusters(caloProtoClustersSplit, splitClusters, CaloHitsHandle);
 
       //sort these guys
       std::sort(caloProtoClustersMain.begin(),  caloProtoClustersMain.end(), [](const CaloProtoCluster& a, const CaloProtoCluster& b) {return a.time() < b.time();});
@@ -181,7 +186,7 @@ namespace mu2e {
 
   //----------------------------------------------------------------------------------------------------------
   void CaloProtoClusterMaker::fillCluster(CaloProtoClusterCollection& caloProtoClustersColl,
-                                          const CaloCrystalList& clusterPtrList,
+                                          const CaloCrystalVec& clusterPtrList,
                                           const art::Handle<CaloHitCollection>& CaloHitsHandle)
   {
       const CaloHitCollection& CaloHits(*CaloHitsHandle);
@@ -224,38 +229,86 @@ namespace mu2e {
 
 
   //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::filterByTime(CaloCrystalList& liste, const std::vector<double>& clusterTime)
+  void CaloProtoClusterMaker::formClusters(ClusterFinder& finder, DiskClusters& result, bool seedsOnly)
   {
-      auto it = liste.begin();
-      while (it != liste.end())
+      for (unsigned i=0; i<finder.nHits(); ++i)
       {
-          const CaloHit* hit = *it;
+          if (finder.isUsed(i)) continue;
+          if (seedsOnly && !(finder.hit(i).energyDep() > EminSeed_)) continue;
+
+          result.clusters.emplace_back();
+          finder.formCluster(i, result.clusters.back());
+          result.seeds.push_back(finder.hitIndex(i));
+      }
+  }
+
+
+
+  //----------------------------------------------------------------------------------------------------------
+  void CaloProtoClusterMaker::filterByTime(ClusterFinder& finder, const std::vector<double>& clusterTime)
+  {
+      for (unsigned i=0; i<finder.nHits(); ++i)
+      {
+          if (finder.isUsed(i)) continue;
+          const double time = finder.hit(i).time();
 
           auto itTime = clusterTime.begin();
-          while (itTime != clusterTime.end()){if ( (*itTime - hit->time()) < deltaTime_) break; ++itTime;}
+          while (itTime != clusterTime.end()){if ( (*itTime - time) < deltaTime_) break; ++itTime;}
 
-          if (itTime == clusterTime.end() ) it = liste.erase(it);
-          else ++it;
+          if (itTime == clusterTime.end() ) finder.remove(i);
       }
   }
 
 
 
   //----------------------------------------------------------------------------------------------------------
-  void CaloProtoClusterMaker::dump(const std::string& title, const std::vector<CaloCrystalList>& caloIdHitMap,
-                                            std::set<const CaloHit*> seedList)
+  void CaloProtoClusterMaker::fillClusters(CaloProtoClusterCollection& caloProtoClustersColl,
+                                           const std::vector<DiskClusters>& diskClusters,
+                                           const art::Handle<CaloHitCollection>& CaloHitsHandle)
+  {
+      std::vector<std::pair<unsigned,const CaloCrystalVec*>> bySeed;
+      for (const auto& disk : diskClusters)
+         for (unsigned i=0; i<disk.clusters.size(); ++i) bySeed.emplace_back(disk.seeds[i], &disk.clusters[i]);
+      std::sort(bySeed.begin(), bySeed.end(), [](const auto& a, const auto& b) {return a.first < b.first;});
+
+      caloProtoClustersColl.reserve(bySeed.size());
+      for (const auto& cluster : bySeed) fillCluster(caloProtoClustersColl, *cluster.second, CaloHitsHandle);
+  }
+
+
+
+  //----------------------------------------------------------------------------------------------------------
+  void CaloProtoClusterMaker::dump(const std::string& title, const std::vector<ClusterFinder>& finders, bool seedsOnly)
   {
       std::cout<<title<<std::endl;
       std::cout<<"Cache content"<<std::endl;
-      for (unsigned i=0;i<caloIdHitMap.size();++i)
+      std::vector<std::vector<const CaloHit*>> byCrystal;
+      for (const auto& finder : finders)
+      {
+         for (unsigned i=0; i<finder.nHits(); ++i)
+         {
+            if (finder.isUsed(i)) continue;
+            unsigned crId = finder.hit(i).crystalID();
+            if (byCrystal.size() <= crId) byCrystal.resize(crId+1);
+            byCrystal[crId].push_back(&finder.hit(i));
+         }
+      }
+      for (unsigned i=0;i<byCrystal.size();++i)
       {
-         if (caloIdHitMap[i].empty()) continue;
+         if (byCrystal[i].empty()) continue;
          std::cout<<"Crystal idx "<<i<<std::endl;
-         for (auto& ptr : caloIdHitMap[i]) std::cout<<ptr<<" "<<ptr->energyDep()<<"  ";
+         for (auto& ptr : byCrystal[i]) std::cout<<ptr<<" "<<ptr->energyDep()<<"  ";
          std::cout<<std::endl;
       }
       std::cout<<"Seeds  "<<std::endl;
-      for (auto& ptr :seedList) std::cout<<ptr<<" ";
+      for (const auto& finder : finders)
+      {
+         for (unsigned i=0; i<finder.nHits(); ++i)
+         {
+            if (finder.isUsed(i) || (seedsOnly && !(finder.hit(i).energyDep() > EminSeed_))) continue;
+            std::cout<<&finder.hit(i)<<" ";
+         }
+      }
       std::cout<<std::endl;
   }
 
@@ -11,9 +11,11 @@
 #include "Offline/RecoDataProducts/inc/CaloDigi.hh"
 #include "Offline/RecoDataProducts/inc/CaloTrigSeed.hh"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <queue>
+#include <vector>
 
 
 namespace {
@@ -53,7 +55,8 @@ namespace mu2e {
       diagLevel_(          pset.get<int>("diagLevel",0)),
       DNTBINs_(          pset.get<int>("dntbins",1)),
       window_(2*windowPeak_+1),
-      hitList_()
+      hits_(),
+      binOffset_()
     {
       produces<CaloTrigSeedCollection>();
       seeds_.reserve(100);
@@ -81,8 +84,11 @@ namespace mu2e {
     int DNTBINs_;
     unsigned     window_;
 
-    std::vector<std::list<FastHit>> hitList_;
-    std::vector<FastHit*> seeds_;
+    // peaks of all digis, sorted by time bin: the peaks of bin i are hits_[binOffset_[i]..binOffset_[i+1])
+    std::vector<FastHit>  found_;
+    std::vector<FastHit>  hits_;
+    std::vector<unsigned> binOffset_;
+    std::vector<unsigned> seeds_;  // indices into hits_, in the order they were found
     std::vector<CaloTrigSeed> trigseeds_;
     int mbtime_;
 
@@ -142,9 +148,7 @@ namespace mu2e {
     unsigned nBinTime  = unsigned (mbtime_ - blindTime_ + endTimeBuffer_) / digiSampling_;
     unsigned winOffsetT0_ = windowPeak_+offsetT0_ ;
 
-    if (hitList_.size() < nBinTime ) hitList_ = std::vector<std::list<FastHit>>(nBinTime,std::list<FastHit>());
-    else for (auto& hl : hitList_) hl.clear();
-
+    found_.clear();
     seeds_.clear();
 
     for (const auto& caloDigi : caloDigis){
@@ -167,8 +171,10 @@ namespace mu2e {
         else{
           if (deque_.front()> minAmp_ && deque_.front()== *std::prev(it,windowPeak_) && *std::prev(it,windowPeak_) != *std::prev(it,windowPeak_-1)){
             int index = int(t0/digiSampling_) + nCount - winOffsetT0_;
-            hitList_[index].push_back(FastHit(crId,index,deque_.front()));
-            if (deque_.front()> minSeedAmp_) seeds_.emplace_back(&(hitList_[index].back()));
+            if (index >= 0 && unsigned(index) < nBinTime){
+              if (deque_.front()> minSeedAmp_) seeds_.emplace_back(found_.size());
+              found_.emplace_back(crId,index,deque_.front());
+            }
           }
           if (*tail == deque_.front()) deque_.pop_front();
           ++tail;
@@ -177,9 +183,26 @@ namespace mu2e {
       }
     }
     if (seeds_.empty()) return;
+
+    // counting sort of the peaks by time bin, keeping the order within a bin
+    binOffset_.assign(nBinTime+2,0);
+    for (const auto& hit : found_) ++binOffset_[hit.index_+2];
+    for (unsigned i=2; i<binOffset_.size(); ++i) binOffset_[i] += binOffset_[i-1];
+    std::vector<unsigned> position(found_.size());
+    hits_.resize(found_.size(),FastHit(0,0,0));
+    for (unsigned i=0; i<found_.size(); ++i){
+      position[i] = binOffset_[found_[i].index_+1]++;
+      hits_[position[i]] = found_[i];
+    }
+    for (auto& seed : seeds_) seed = position[seed];
+
     trigSeeds.clear();
     if (diagLevel_ > 1) std::cout << "Seed SIZE=" << seeds_.size() << std::endl;
-    for (auto& seed : seeds_){
+    for (unsigned iseed : seeds_){
+      const FastHit* seed = &hits_[iseed];
+      // the peaks within DNTBINs_ of the seed time bin
+      unsigned first = binOffset_[std::max(seed->index_-DNTBINs_,0)];
+      unsigned last  = binOffset_[std::min(seed->index_+DNTBINs_+1,int(nBinTime))];
       if (diagLevel_ > 1) std::cout << "Seed val=" << seed->val_ << " cryId=" << seed->crId_ << std::endl;
       if (seed->val_ < 1) continue;
       int      cluEnergy(0);
@@ -197,17 +220,16 @@ namespace mu2e {
       for (const auto& nid : cal->neighbors(seed->crId_)) crystalRing1.push(nid);
       while (!crystalRing1.empty()){
         int nid = crystalRing1.front();
-        for (int itimebin= seed->index_-DNTBINs_;itimebin<=seed->index_+DNTBINs_;++itimebin){
-          for (auto& hit : hitList_[itimebin]){
-            if (hit.crId_ != nid) continue;
-            if (hit.val_>ring1max){
-              ring1max2=ring1max;
-              ring1max=hit.val_;
-            }
-            else{
-              if (hit.val_>ring1max2){
-                ring1max2=hit.val_;
-              }
+        for (unsigned ihit=first; ihit<last; ++ihit){
+          const FastHit& hit = hits_[ihit];
+          if (hit.crId_ != nid) continue;
+          if (hit.val_>ring1max){
+            ring1max2=ring1max;
+            ring1max=hit.val_;
+          }
+          else{
+            if (hit.val_>ring1max2){
+              ring1max2=hit.val_;
             }
           }
         }
@@ -219,12 +241,11 @@ namespace mu2e {
       for (const auto& nid : cal->nextNeighbors(seed->crId_)) crystalRing2.push(nid);
       while (!crystalRing2.empty()){
         int nid = crystalRing2.front();
-        for (int itimebin= seed->index_-DNTBINs_;itimebin<=seed->index_+DNTBINs_;++itimebin){
-          for (auto& hit : hitList_[itimebin]){
-            if (hit.crId_ != nid) continue;
-            if (hit.val_>ring2max){
-              ring2max=hit.val_;
-            }
+        for (unsigned ihit=first; ihit<last; ++ihit){
+          const FastHit& hit = hits_[ihit];
+          if (hit.crId_ != nid) continue;
+          if (hit.val_>ring2max){
+            ring2max=hit.val_;
           }
         }
         crystalRing2.pop();
@@ -242,24 +263,21 @@ namespace mu2e {
         int nid = crystalToVisit.front();
         if (diagLevel_ > 1)  std::cout << " visiting: " << nid << std::endl;
 
-        for (int itimebin= seed->index_-DNTBINs_;itimebin<=seed->index_+DNTBINs_;++itimebin){
-          for (auto& hit : hitList_[itimebin]){
-            if (hit.crId_ != nid || hit.val_ <0.5) continue;
-            cluEnergy += hit.val_;
-            xc += cal->crystal(nid).localPosition().x()*hit.val_;
-            yc += cal->crystal(nid).localPosition().y()*hit.val_;
-            hit.val_=-abs(hit.val_);
-            if (diagLevel_ > 1)  std::cout << " index add close to: " << nid << std::endl;
-            for (const auto& neighbor : cal->neighbors(nid)) crystalToVisit.push(neighbor);
-            if (extendSecond_) for (const auto& nneighbor : cal->nextNeighbors(nid)) crystalToVisit.push(nneighbor);
-          }
+        for (unsigned ihit=first; ihit<last; ++ihit){
+          FastHit& hit = hits_[ihit];
+          if (hit.crId_ != nid || hit.val_ <0.5) continue;
+          cluEnergy += hit.val_;
+          xc += cal->crystal(nid).localPosition().x()*hit.val_;
+          yc += cal->crystal(nid).localPosition().y()*hit.val_;
+          hit.val_=-abs(hit.val_);
+          if (diagLevel_ > 1)  std::cout << " index add close to: " << nid << std::endl;
+          for (const auto& neighbor : cal->neighbors(nid)) crystalToVisit.push(neighbor);
+          if (extendSecond_) for (const auto& nneighbor : cal->nextNeighbors(nid)) crystalToVisit.push(nneighbor);
         }
         crystalToVisit.pop();
       }
 
-      for (int itimebin= seed->index_-DNTBINs_;itimebin<=seed->index_+DNTBINs_;++itimebin){
-        for (auto& hit : hitList_[itimebin]) hit.val_=abs(hit.val_);
-      }
+      for (unsigned ihit=first; ihit<last; ++ihit) hits_[ihit].val_=abs(hits_[ihit].val_);
       float eDep = cluEnergy*adcToEnergy_;
       if (eDep > minEnergy_){
         xc /= cluEnergy;
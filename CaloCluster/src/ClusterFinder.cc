@@ -1,73 +1,84 @@
 #include "Offline/CaloCluster/inc/ClusterFinder.hh"
-#include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
-#include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 
-#include <iostream>
-#include <vector>
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 
 namespace mu2e {
 
-        ClusterFinder::ClusterFinder(const Calorimeter& cal, const CaloHit* crystalSeed, double deltaTime, double ExpandCut, bool addSecondRing) :
-          cal_(&cal), crystalSeed_(crystalSeed), seedTime_(crystalSeed->time()), clusterList_(), crystalToVisit_(), isVisited_(cal.nCrystal()),
-          deltaTime_(deltaTime), ExpandCut_(ExpandCut), addSecondRing_(addSecondRing)
+        ClusterFinder::ClusterFinder(const CrystalNeighbors& neighbors, double deltaTime, double ExpandCut) :
+          neighbors_(&neighbors), deltaTime_(deltaTime), ExpandCut_(ExpandCut), hits_(nullptr), hitIds_(),
+          crystalOffset_(neighbors.nCrystal()+2), byCrystal_(), used_(), visited_(neighbors.nCrystal(),0), stamp_(0),
+          crystalToVisit_()
         {}
 
 
-        void ClusterFinder::formCluster(std::vector<CaloCrystalList>& idHitVec)
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::initialize(const CaloHitCollection& hits, const std::vector<unsigned>& hitIds)
         {
-            std::fill(isVisited_.begin(), isVisited_.end(), false);
+            hits_   = &hits;
+            hitIds_ = hitIds;
+            used_.assign(hitIds_.size(), false);
 
-            clusterList_.clear();
-            clusterList_.push_front(crystalSeed_);
-            crystalToVisit_.push(crystalSeed_->crystalID());
+            // counting sort by crystal, keeping the collection order within a crystal
+            std::fill(crystalOffset_.begin(), crystalOffset_.end(), 0);
+            for (unsigned idx : hitIds_) ++crystalOffset_[hits[idx].crystalID()+2];
+            for (unsigned c=2; c<crystalOffset_.size(); ++c) crystalOffset_[c] += crystalOffset_[c-1];
 
-            CaloCrystalList& liste = idHitVec[crystalSeed_->crystalID()];
-            liste.erase(std::find(liste.begin(), liste.end(), crystalSeed_));
+            byCrystal_.resize(hitIds_.size());
+            for (unsigned i=0; i<hitIds_.size(); ++i) byCrystal_[crystalOffset_[hit(i).crystalID()+1]++] = i;
+        }
 
-            while (!crystalToVisit_.empty())
-            {
-                 int visitId         = crystalToVisit_.front();
-                 isVisited_[visitId] = true;
 
-                 std::vector<int>  neighborsId = cal_->crystal(visitId).neighbors();
-                 if (addSecondRing_) neighborsId.insert(neighborsId.end(), cal_->nextNeighbors(visitId).begin(), cal_->nextNeighbors(visitId).end());
+        //----------------------------------------------------------------------------------------------------------
+        void ClusterFinder::formCluster(unsigned iseed, CaloCrystalVec& cluster)
+        {
+            if (++stamp_ == 0) {std::fill(visited_.begin(), visited_.end(), 0); stamp_ = 1;}
+
+            const CaloHit& seed = hit(iseed);
+            const double seedTime = seed.time();
 
-                 for (auto& iId : neighborsId)
+            cluster.clear();
+            cluster.push_back(&seed);
+            used_[iseed] = true;
+
+            crystalToVisit_.clear();
+            crystalToVisit_.push_back(seed.crystalID());
+
+            for (unsigned ivisit=0; ivisit < crystalToVisit_.size(); ++ivisit)
+            {
+                 int visitId       = crystalToVisit_[ivisit];
+                 visited_[visitId] = stamp_;
+
+                 for (const int* it = neighbors_->begin(visitId); it != neighbors_->end(visitId); ++it)
                  {
-                     if (isVisited_[iId]) continue;
-                     isVisited_[iId] = true;
-                     CaloCrystalList& list = idHitVec[iId];
+                     int iId = *it;
+                     if (visited_[iId] == stamp_) continue;
+                     visited_[iId] = stamp_;
 
-                     auto it=list.begin();
-                     while(it != list.end())
+                     bool expand(false);
+                     for (unsigned j=crystalOffset_[iId]; j<crystalOffset_[iId+1]; ++j)
                      {
-                         CaloHit const* hit = *it;
-                         if (std::abs(hit->time() - seedTime_) < deltaTime_)
+                         unsigned ihit = byCrystal_[j];
+                         if (used_[ihit]) continue;
+
+                         const CaloHit& hitj = hit(ihit);
+                         if (std::abs(hitj.time() - seedTime) < deltaTime_)
                          {
-                             if (hit->energyDep() > ExpandCut_) crystalToVisit_.push(iId);
-                             clusterList_.push_front(hit);
-                             it = list.erase(it);
+                             if (hitj.energyDep() > ExpandCut_) expand = true;
+                             cluster.push_back(&hitj);
+                             used_[ihit] = true;
                          }
-                         else ++it;
                      }
+                     if (expand) crystalToVisit_.push_back(iId);
                  }
-
-                 crystalToVisit_.pop();
             }
 
-            // make sure to sort proto0cluster by energy
-            clusterList_.sort([](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
+            // make sure to sort proto-cluster by energy; ties keep the latest added hit first
+            std::reverse(cluster.begin(), cluster.end());
+            std::stable_sort(cluster.begin(), cluster.end(), [](const CaloHit* lhs, const CaloHit* rhs) {return lhs->energyDep() > rhs->energyDep();});
        }
 
 }
-
-
-
-
-
-
-
-
@@ -0,0 +1,23 @@
+#include "Offline/CaloCluster/inc/CrystalNeighbors.hh"
+
+
+namespace mu2e {
+
+        CrystalNeighbors::CrystalNeighbors(const Calorimeter& cal, bool addSecondRing) :
+          offsets_(1,0), ids_()
+        {
+            offsets_.reserve(cal.nCrystal()+1);
+            for (int i=0; i<cal.nCrystal(); ++i)
+            {
+                const auto& first = cal.crystal(i).neighbors();
+                ids_.insert(ids_.end(), first.begin(), first.end());
+                if (addSecondRing)
+                {
+                    const auto& second = cal.nextNeighbors(i);
+                    ids_.insert(ids_.end(), second.begin(), second.end());
+                }
+                offsets_.push_back(ids_.size());
+            }
+        }
+
+}
@@ -50,6 +50,8 @@ namespace mu2e {
         CaloTemplateWFProcessor(const Config& config);
 
         virtual void     initialize  () override;
+        // with the pulse shape histogram given instead of read from the conditions
+        void             initialize  (const TH1& pulseShape);
         virtual void     reset       () override;
         virtual void     extract     (const std::vector<double>& xInput, const std::vector<double>& yInput) override;
         virtual void     plot        (const std::string& pname) const override;
@@ -14,6 +14,7 @@ namespace mu2e {
         CaloTemplateWFUtil(double minPeakAmplitude, double digiSampling, double minDTPeaks, int printLevel=-1);
 
         void                        initialize    ();
+        void                        initialize    (const TH1& pulseShape);
         void                        setXYVector   (const std::vector<double>& xvec, const std::vector<double>& yvec);
         void                        setPar        (const std::vector<double>& par);
         void                        reset         ();
@@ -44,6 +44,11 @@ namespace mu2e {
        fmutil_.initialize();
    }
 
+   void CaloTemplateWFProcessor::initialize(const TH1& pulseShape)
+   {
+       fmutil_.initialize(pulseShape);
+   }
+
 
    void CaloTemplateWFProcessor::extract(const std::vector<double>& xInput, const std::vector<double>& yInput)
    {
@@ -80,6 +80,7 @@ namespace mu2e {
 
    //-----------------------------------------------------------------------------------------------------
    void   CaloTemplateWFUtil::initialize ()                                                                 {pulseCache_.buildShapes();}
+   void   CaloTemplateWFUtil::initialize (const TH1& pulseShape)                                            {pulseCache_.buildShapes(pulseShape);}
    void   CaloTemplateWFUtil::reset      ()                                                                 {param_.clear(); paramErr_.clear(); nParTot_=0; npTot_ = 0;}
    void   CaloTemplateWFUtil::setXYVector(const std::vector<double>& xvec, const std::vector<double>& yvec) {xvec_ = xvec; yvec_ = yvec; x0_=0; x1_ = xvec_.size();}
    void   CaloTemplateWFUtil::setPar     (const std::vector<double>& par)                                   {param_ = par; nParTot_ = npTot_ = par.size();}
@@ -33,6 +33,7 @@
 #include "Offline/RecoDataProducts/inc/CrvDigi.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/CrvCoincidenceCluster.hh"
 #include "Offline/RecoDataProducts/inc/RecoCount.hh"
 // Utilities
@@ -42,6 +43,7 @@
 #include "Offline/TrackerGeom/inc/Straw.hh"
 #include "Offline/Mu2eUtilities/inc/SimParticleTimeOffset.hh"
 #include "Offline/TrkDiag/inc/TrkMCTools.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 #include "Offline/GeometryService/inc/GeomHandle.hh"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 #include "Offline/ConditionsService/inc/ConditionsHandle.hh"
@@ -145,6 +147,7 @@ namespace mu2e {
       consumes<CaloClusterCollection>(_ccc);
       consumes<CrvDigiCollection>(_crvdc);
       consumesMany<KalSeedCollection>();
+      consumesMany<ComboHitStrawIndex>(); // for the StrawHits of the seed hits
       consumes<CrvCoincidenceClusterCollection>(_crvccc);
       consumes<PrimaryParticle>(_pp);
       consumes<StrawDigiMCCollection>(_sdmcc);
@@ -419,25 +422,30 @@ namespace mu2e {
         }
       }
     }
-    // get straw indices from all helices too
-    for (auto const& hsc : _hscs) {
-      // get all products from this
-      art::ModuleLabelSelector hscsel(hsc);
-      std::vector< art::Handle<HelixSeedCollection> > seedhs = event.getMany<HelixSeedCollection>(hscsel);
-      if(_debug > 1) std::cout << "Found " << seedhs.size() << " collections from module " << hsc << std::endl;
-      // loop over the HelixSeeds and the hits inside them
-      for(auto const& seedh : seedhs) {
-        auto const& seedc = *seedh;
-        if(_debug > 1) std::cout << "Found " << seedc.size() << " seeds from collection " << hsc << std::endl;
-        for(auto iseed=seedc.begin(); iseed!=seedc.end(); ++iseed){
-          auto const& seed = *iseed;
-          // go back to StrawHit indices (== digi indices for reco)
-          std::vector<StrawHitIndex> shids;
-          for(size_t ihit = 0; ihit < seed.hits().size(); ihit++)
-            seed.hits().fillStrawHitIndices(event,ihit,shids);
-          // add these to the set (duplicates are suppressed)
-          for(auto shid : shids)
-            shindices.insert(shid);
+    // get straw indices from all helices too.  The helix hits all reference the same few event
+    // collections, which are indexed once
+    {
+      MU2E_PROFILE_SCOPE("SelectRecoMC::helixStrawHits");
+      ComboHitStrawIndexCache shindexcache(event);
+      for (auto const& hsc : _hscs) {
+        // get all products from this
+        art::ModuleLabelSelector hscsel(hsc);
+        std::vector< art::Handle<HelixSeedCollection> > seedhs = event.getMany<HelixSeedCollection>(hscsel);
+        if(_debug > 1) std::cout << "Found " << seedhs.size() << " collections from module " << hsc << std::endl;
+        // loop over the HelixSeeds and the hits inside them
+        for(auto const& seedh : seedhs) {
+          auto const& seedc = *seedh;
+          if(_debug > 1) std::cout << "Found " << seedc.size() << " seeds from collection " << hsc << std::endl;
+          for(auto iseed=seedc.begin(); iseed!=seedc.end(); ++iseed){
+            auto const& seed = *iseed;
+            // go back to StrawHit indices (== digi indices for reco)
+            std::vector<StrawHitIndex> shids;
+            for(size_t ihit = 0; ihit < seed.hits().size(); ihit++)
+              shindexcache.fillStrawHitIndices(seed.hits(),ihit,shids);
+            // add these to the set (duplicates are suppressed)
+            for(auto shid : shids)
+              shindices.insert(shid);
+          }
         }
       }
     }
@@ -0,0 +1,92 @@
+#ifndef DAQ_FragmentSpans_hh
+#define DAQ_FragmentSpans_hh
+//
+// Shared, zero-copy access to the detector payloads of the artdaq
+// fragments in an event, and an in-order parallel decoding helper.
+//
+// FragmentSpans collects read-only views (pointer, size) of every
+// tracker and calorimeter payload, looking inside MU2EEVENT
+// containers.  CRV fragments are decoded from the Fragment itself
+// (CRVFragment) and are not collected.  No Fragment is copied; the views are valid as long as
+// the fragment products of the event.  The detector overlays
+// (TrackerFragment, CalorimeterFragment, ...) are built directly on a
+// view.
+//
+// decodeInOrder decodes each payload into its own result, in parallel
+// if requested, and then merges the results in payload order, so the
+// output does not depend on the thread scheduling.
+//
+
+#include "art/Framework/Principal/Event.h"
+#include <artdaq-core/Data/Fragment.hh>
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mu2e {
+
+  struct FragmentSpan {
+    const void* data;
+    size_t      size; // bytes
+    std::pair<const void*, size_t> pair() const { return {data, size}; }
+  };
+
+  class FragmentSpans {
+  public:
+    enum Subsystem { trk = 0, cal, nSubsystems };
+
+    // collect the tracker and/or calorimeter payloads of all fragment products in the event
+    void collect(art::Event const& event, bool useTrk, bool useCal);
+
+    // add the payloads of all fragments of one product
+    void add(Subsystem sub, artdaq::Fragments const& frags);
+
+    std::vector<FragmentSpan> const& spans(Subsystem sub) const { return spans_[sub]; }
+    size_t totalBytes(Subsystem sub) const;
+    void clear();
+
+  private:
+    std::array<std::vector<FragmentSpan>, nSubsystems> spans_;
+  };
+
+  // Sum of the packet counts in the block headers of a detector fragment.  Each hit
+  // needs at least one packet, so this bounds the number of hits it holds.
+  template <class DetFragment>
+  size_t packetCount(DetFragment const& frag) {
+    size_t npackets(0);
+    for (size_t iblock = 0; iblock < frag.block_count(); ++iblock) {
+      auto block = frag.dataAtBlockIndex(iblock);
+      if (block != nullptr) npackets += block->GetHeader()->GetPacketCount();
+    }
+    return npackets;
+  }
+
+  // decode(i, result) is called once for every i in [0, n), merge(result) once for
+  // every result in increasing i.  decode must only touch its own result.
+  template <class Result, class Decode, class Merge>
+  void decodeInOrder(size_t n, bool parallel, Decode const& decode, Merge const& merge) {
+    std::vector<Result> results(n);
+    if (parallel && n > 1) {
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, n), [&](tbb::blocked_range<size_t> const& range) {
+        for (size_t i = range.begin(); i != range.end(); ++i) decode(i, results[i]);
+      });
+    } else {
+      for (size_t i = 0; i < n; ++i) decode(i, results[i]);
+    }
+    for (auto& result : results) merge(result);
+  }
+
+  // append src to dst, moving the elements
+  template <class Coll>
+  void appendCollection(Coll& dst, Coll& src) {
+    dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end()));
+  }
+
+} // namespace mu2e
+
+#endif /* DAQ_FragmentSpans_hh */
@@ -11,8 +11,6 @@
 
 #include "art/Framework/Principal/Handle.h"
 #include "artdaq-core-mu2e/Overlays/CalorimeterFragment.hh"
-#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
-#include "artdaq-core-mu2e/Overlays/Mu2eEventFragment.hh"
 
 #include "Offline/RecoDataProducts/inc/CaloHit.hh"
 #include "Offline/RecoDataProducts/inc/IntensityInfoCalo.hh"
@@ -20,6 +18,7 @@
 #include <artdaq-core/Data/Fragment.hh>
 
 #include "Offline/DAQ/inc/CaloDAQUtilities.hh"
+#include "Offline/DAQ/inc/FragmentSpans.hh"
 
 #include <iostream>
 
@@ -200,39 +199,17 @@ void art::CaloHitsFromFragments::produce(Event& event) {
   size_t         totalSize(0), numCalFrags(0);
   unsigned short evtEnergy(0);
 
-  std::vector<art::Handle<artdaq::Fragments>> fragmentHandles = event.getMany<std::vector<artdaq::Fragment>>();
-
-  for (const auto& handle : fragmentHandles) {
-    if (!handle.isValid() || handle->empty()) {
-      continue;
-    }
-
-    if (diagLevel_ > 1) {
-      std::cout << "[CaloHitsFromFragments::produce] Fragment type of first Fragment in handle: " << static_cast<int>(handle->front().type()) << std::endl;
-    }
-    if (handle->front().type() == mu2e::detail::FragmentType::MU2EEVENT) {
-      for (const auto& cont : *handle) {
-        mu2e::Mu2eEventFragment mef(cont);
-        for (size_t ii = 0; ii < mef.calorimeter_block_count(); ++ii) {
-          auto pair = mef.calorimeterAtPtr(ii);
-          mu2e::CalorimeterFragment cc(pair);
-          analyze_calorimeter_(cc, calo_hits, caphri_hits, evtEnergy);
-
-          totalSize += pair.second;
-          numCalFrags++;
-        }
-      }
-    } else {
-      if (handle->front().type() == mu2e::detail::FragmentType::CAL) {
-        for (auto frag : *handle) {
-          mu2e::CalorimeterFragment cc(frag.dataBegin(), frag.dataSizeBytes());
-          analyze_calorimeter_(cc, calo_hits, caphri_hits, evtEnergy);
-
-          totalSize += frag.dataSizeBytes();
-          numCalFrags++;
-        }
-      }
-    }
+  // calorimeter payloads, including those inside MU2EEVENT containers, without copying the
+  // fragments.  They are decoded serially: the pulses of the two SiPMs of a crystal are
+  // paired across fragments.
+  mu2e::FragmentSpans spans;
+  spans.collect(event, false, true);
+  for (const auto& span : spans.spans(mu2e::FragmentSpans::cal)) {
+    mu2e::CalorimeterFragment cc(span.pair());
+    analyze_calorimeter_(cc, calo_hits, caphri_hits, evtEnergy);
+
+    totalSize += span.size;
+    numCalFrags++;
   }
 
   if (numCalFrags == 0) {
@@ -104,7 +104,7 @@ void art::CaloRecoFromFragments::produce(Event& event) {
       }
     } else {
       if (handle->front().type() == mu2e::detail::FragmentType::CAL) {
-        for (auto frag : *handle) {
+        for (const auto& frag : *handle) {
           mu2e::CalorimeterFragment cc(frag.dataBegin(), frag.dataSizeBytes());
           analyze_calorimeter_(calodaqconds, cc, calo_digis);
 
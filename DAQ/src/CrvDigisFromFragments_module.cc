@@ -14,6 +14,7 @@
 #include "Offline/RecoDataProducts/inc/CaloDigi.hh"
 #include "Offline/RecoDataProducts/inc/CrvDigi.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+#include "Offline/DAQ/inc/FragmentSpans.hh"
 #include <artdaq-core/Data/Fragment.hh>
 
 #include <iostream>
@@ -39,6 +40,9 @@ public:
     fhicl::Atom<int> diagLevel{fhicl::Name("diagLevel"), fhicl::Comment("diagnostic Level")};
     fhicl::Atom<art::InputTag> crvFragmentsTag{fhicl::Name("crvTag"),
                                                fhicl::Comment("crv Fragments Tag")};
+    fhicl::Atom<bool> parallelDecode{
+        fhicl::Name("parallelDecode"),
+        fhicl::Comment("decode the fragments in parallel (only with diagLevel <= 1)"), true};
   };
 
   // --- C'tor/d'tor:
@@ -51,8 +55,11 @@ public:
 private:
 //  int decompressCrvDigi(uint8_t adc);
   int16_t decompressCrvDigi(int16_t adc);
+  void analyze_crv_(const artdaq::Fragment& fragment, art::EventNumber_t eventNumber,
+                    mu2e::CrvDigiCollection& crv_digis);
 
   int diagLevel_;
+  bool parallelDecode_;
 
   art::InputTag crvFragmentsTag_;
 
@@ -62,6 +69,7 @@ private:
 
 CrvDigisFromFragments::CrvDigisFromFragments(const art::EDProducer::Table<Config>& config) :
     art::EDProducer{config}, diagLevel_(config().diagLevel()),
+    parallelDecode_(config().parallelDecode()),
     crvFragmentsTag_(config().crvFragmentsTag()) {
   produces<EventNumber_t>();
   produces<mu2e::CrvDigiCollection>();
@@ -74,82 +82,91 @@ int16_t CrvDigisFromFragments::decompressCrvDigi(int16_t adc)
   return adc;
 }
 
-void CrvDigisFromFragments::produce(Event& event) {
-
-  art::EventNumber_t eventNumber = event.event();
-
-  auto crvFragments = event.getValidHandle<artdaq::Fragments>(crvFragmentsTag_);
-  size_t numCrvFrags = crvFragments->size();
+void CrvDigisFromFragments::analyze_crv_(const artdaq::Fragment& fragment,
+                                         art::EventNumber_t eventNumber,
+                                         mu2e::CrvDigiCollection& crv_digis) {
+  mu2e::CRVFragment cc(fragment);
 
   if (diagLevel_ > 1) {
-    std::cout << std::dec << "Producer: Run " << event.run() << ", subrun " << event.subRun()
-              << ", event " << eventNumber << " has " << std::endl;
-    std::cout << crvFragments->size() << " CRV fragments." << std::endl;
-
-    size_t totalSize = 0;
-    for (size_t idx = 0; idx < crvFragments->size(); ++idx) {
-      auto size = ((*crvFragments)[idx]).size() * sizeof(artdaq::RawDataType);
-      totalSize += size;
-      //      std::cout << "\tCRV Fragment " << idx << " has size " << size << std::endl;
+    std::cout << std::endl;
+    std::cout << "ArtFragmentReader: ";
+    std::cout << "\tBlock Count: " << std::dec << cc.block_count() << std::endl;
+    std::cout << "\tByte Count: " << fragment.dataSizeBytes() << std::endl;
+    std::cout << std::endl;
+    std::cout << "\t"
+              << "====== Example Block Sizes ======" << std::endl;
+    for (size_t i = 0; i < 10; i++) {
+      if (i < cc.block_count()) {
+        std::cout << "\t" << i << "\t" << cc.blockSizeBytes(i) << std::endl;
+      }
     }
-
-    std::cout << "\tTotal Size: " << (int)totalSize << " bytes." << std::endl;
+    std::cout << "\t"
+              << "=========================" << std::endl;
   }
 
-  // Collection of CaloDigis for the event
-  std::unique_ptr<mu2e::CrvDigiCollection> crv_digis(new mu2e::CrvDigiCollection);
+  for (size_t curBlockIdx = 0; curBlockIdx < cc.block_count(); curBlockIdx++) {
 
-  // Loop over the CRV fragments
-  for (size_t idx = 0; idx < numCrvFrags; ++idx) {
-
-    const auto& fragment((*crvFragments)[idx]);
-    mu2e::CRVFragment cc(fragment);
-
-    if (diagLevel_ > 1) {
-      std::cout << std::endl;
-      std::cout << "ArtFragmentReader: ";
-      std::cout << "\tBlock Count: " << std::dec << cc.block_count() << std::endl;
-      std::cout << "\tByte Count: " << fragment.dataSizeBytes() << std::endl;
-      std::cout << std::endl;
-      std::cout << "\t"
-                << "====== Example Block Sizes ======" << std::endl;
-      for (size_t i = 0; i < 10; i++) {
-        if (i < cc.block_count()) {
-          std::cout << "\t" << i << "\t" << cc.blockSizeBytes(i) << std::endl;
-        }
-      }
-      std::cout << "\t"
-                << "=========================" << std::endl;
+    auto block = cc.dataAtBlockIndex(curBlockIdx);
+    if (block == nullptr) {
+      std::cerr << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
+      continue;
     }
+    auto hdr = block->GetHeader();
 
-    for (size_t curBlockIdx = 0; curBlockIdx < cc.block_count(); curBlockIdx++) {
+    if (hdr->GetSubsystemID() != 2) {
+      throw cet::exception("DATA") << " CRV packet does not have system ID 2";
+    }
 
-      auto block = cc.dataAtBlockIndex(curBlockIdx);
-      if (block == nullptr) {
-        std::cerr << "Unable to retrieve block " << curBlockIdx << "!" << std::endl;
+    // Parse phyiscs information from the CRV packets
+    if (hdr->GetPacketCount() > 0) {
+      auto crvRocHdr = cc.GetCRVROCStatusPacket(curBlockIdx);
+      if (crvRocHdr == nullptr) {
+        std::cerr << "Error retrieving CRV ROC Status Packet from DataBlock " << curBlockIdx
+                  << "!" << std::endl;
         continue;
       }
-      auto hdr = block->GetHeader();
 
-      if (hdr->GetSubsystemID() != 2) {
-        throw cet::exception("DATA") << " CRV packet does not have system ID 2";
-      }
-
-      // Parse phyiscs information from the CRV packets
-      if (hdr->GetPacketCount() > 0) {
-        auto crvRocHdr = cc.GetCRVROCStatusPacket(curBlockIdx);
-        if (crvRocHdr == nullptr) {
-          std::cerr << "Error retrieving CRV ROC Status Packet from DataBlock " << curBlockIdx
-                    << "!" << std::endl;
+      auto crvHits = cc.GetCRVHitReadoutPackets(curBlockIdx);
+      for (auto const& crvHit : crvHits) {
+
+        // Fill the CrvDigiCollection
+        // CrvDigi(const std::array<unsigned int, NSamples> &ADCs, unsigned int startTDC,
+        //         mu2e::CRSScintillatorBarIndex scintillatorBarIndex, int SiPMNumber) :
+        // TODO: This is a temporary implementation.
+        // There will be a major change on the barIndex+SiPMNumber system,
+        // which will be replaced by a channel ID system
+        // Only a toy model is used here. The real implementation will follow.
+        int channel = crvHit.SiPMID & 0x7F; // right 7 bits
+        int FEB = crvHit.SiPMID >> 7;
+        int crvBarIndex = (FEB * 64 + channel) / 4;
+        int SiPMNumber = (FEB * 64 + channel) % 4;
+
+        // TODO: This is a temporary implementation.
+        if(crvHit.NumSamples!=8)
+        {
+          std::cerr<<"Number of samples is not 8!"<<std::endl;
           continue;
         }
 
-        auto crvHits = cc.GetCRVHitReadoutPackets(curBlockIdx);
+        // TODO: This is a temporary implementation.
+        std::array<int16_t, 8> adc;
+        for (int j = 0; j < 8; j++)
+          adc[j] = decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
+        crv_digis.emplace_back(adc, crvHit.HitTime, mu2e::CRSScintillatorBarIndex(crvBarIndex),
+                                SiPMNumber);
+      }
+
+      if (diagLevel_ > 1) {
+
         for (auto const& crvHit : crvHits) {
 
-          // Fill the CrvDigiCollection
-          // CrvDigi(const std::array<unsigned int, NSamples> &ADCs, unsigned int startTDC,
-          //         mu2e::CRSScintillatorBarIndex scintillatorBarIndex, int SiPMNumber) :
+          // TODO: This is a temporary implementation.
+          if(crvHit.NumSamples!=8)
+          {
+            std::cerr<<"Number of samples is not 8!"<<std::endl;
+            continue;
+          }
+            #if LONG_FORM_CRV
           // TODO: This is a temporary implementation.
           // There will be a major change on the barIndex+SiPMNumber system,
           // which will be replaced by a channel ID system
@@ -159,84 +176,83 @@ void CrvDigisFromFragments::produce(Event& event) {
           int crvBarIndex = (FEB * 64 + channel) / 4;
           int SiPMNumber = (FEB * 64 + channel) % 4;
 
+          std::cout << "MAKEDIGI: " << SiPMNumber << " " << crvBarIndex << " " << crvHit.HitTime
+                    << " " << crvHits.size() << " ";
+
+          std::cout << "timestamp: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << std::endl;
+          std::cout << "hdr->SubsystemID: " << hdr->GetSubsystemID() << std::endl;
+          std::cout << "hdr->DTCID: " << hdr->GetID() << std::endl;
+          std::cout << "rocID: " << hdr->GetLinkID() << std::endl;
+          std::cout << "packetCount: " << hdr->GetPacketCount() << std::endl;
+          std::cout << "EVB mode: " << hdr->GetEVBMode() << std::endl;
+
+          std::cout << "SiPMNumber: " << crvHit.SiPMID % 4 << std::endl;
+          std::cout << "scintillatorBarIndex: " << crvHit.SiPMID / 4 << std::endl;
+          std::cout << "TDC: " << crvHit.HitTime << std::endl;
+          std::cout << "Waveform: {";
           // TODO: This is a temporary implementation.
-          if(crvHit.NumSamples!=8)
+          for (size_t j = 0; j < 8; j++)
           {
-            std::cerr<<"Number of samples is not 8!"<<std::endl;
-            continue;
+            std::cout << decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
+            if (j+1 < 8) std::cout << " ";
           }
-
+          std::cout << "}" << std::endl;
+          #else
+          // Text format: timestamp sipmID tdc nsamples sample_list
+          std::cout << "GREPMECRV: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " ";
+          std::cout << crvHit.SiPMID << " ";
+          std::cout << crvHit.HitTime << " ";
           // TODO: This is a temporary implementation.
-          std::array<int16_t, 8> adc;
-          for (int j = 0; j < 8; j++)
-            adc[j] = decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
-          crv_digis->emplace_back(adc, crvHit.HitTime, mu2e::CRSScintillatorBarIndex(crvBarIndex),
-                                  SiPMNumber);
+          for (size_t j = 0; j < 8; j++)
+          {
+            std::cout << decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
+            if (j+1 < 8) std::cout << " ";
+          }
+          std::cout << std::endl;
+          #endif
         }
 
-        if (diagLevel_ > 1) {
-
-          for (auto const& crvHit : crvHits) {
-
-            // TODO: This is a temporary implementation.
-            if(crvHit.NumSamples!=8)
-            {
-              std::cerr<<"Number of samples is not 8!"<<std::endl;
-              continue;
-            }
-              #if LONG_FORM_CRV
-            // TODO: This is a temporary implementation.
-            // There will be a major change on the barIndex+SiPMNumber system,
-            // which will be replaced by a channel ID system
-            // Only a toy model is used here. The real implementation will follow.
-            int channel = crvHit.SiPMID & 0x7F; // right 7 bits
-            int FEB = crvHit.SiPMID >> 7;
-            int crvBarIndex = (FEB * 64 + channel) / 4;
-            int SiPMNumber = (FEB * 64 + channel) % 4;
-
-            std::cout << "MAKEDIGI: " << SiPMNumber << " " << crvBarIndex << " " << crvHit.HitTime
-                      << " " << crvHits.size() << " ";
-
-            std::cout << "timestamp: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << std::endl;
-            std::cout << "hdr->SubsystemID: " << hdr->GetSubsystemID() << std::endl;
-            std::cout << "hdr->DTCID: " << hdr->GetID() << std::endl;
-            std::cout << "rocID: " << hdr->GetLinkID() << std::endl;
-            std::cout << "packetCount: " << hdr->GetPacketCount() << std::endl;
-            std::cout << "EVB mode: " << hdr->GetEVBMode() << std::endl;
-
-            std::cout << "SiPMNumber: " << crvHit.SiPMID % 4 << std::endl;
-            std::cout << "scintillatorBarIndex: " << crvHit.SiPMID / 4 << std::endl;
-            std::cout << "TDC: " << crvHit.HitTime << std::endl;
-            std::cout << "Waveform: {";
-            // TODO: This is a temporary implementation.
-            for (size_t j = 0; j < 8; j++)
-            {
-              std::cout << decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
-              if (j+1 < 8) std::cout << " ";
-            }
-            std::cout << "}" << std::endl;
-            #else
-            // Text format: timestamp sipmID tdc nsamples sample_list
-            std::cout << "GREPMECRV: " << hdr->GetEventWindowTag().GetEventWindowTag(true) << " ";
-            std::cout << crvHit.SiPMID << " ";
-            std::cout << crvHit.HitTime << " ";
-            // TODO: This is a temporary implementation.
-            for (size_t j = 0; j < 8; j++)
-            {
-              std::cout << decompressCrvDigi(crvHit.WaveformSamples[j].ADC);
-              if (j+1 < 8) std::cout << " ";
-            }
-            std::cout << std::endl;
-            #endif
-          }
+        std::cout << "LOOP: " << eventNumber << " " << curBlockIdx << " "
+                  << "(" << hdr->GetEventWindowTag().GetEventWindowTag(true) << ")" << std::endl;
+
+      } // End debug output
+    }   // End parsing CRV packets
+  }     // End loop over DataBlocks within fragment
+}
+
+void CrvDigisFromFragments::produce(Event& event) {
+
+  art::EventNumber_t eventNumber = event.event();
+
+  auto crvFragments = event.getValidHandle<artdaq::Fragments>(crvFragmentsTag_);
+  size_t numCrvFrags = crvFragments->size();
 
-          std::cout << "LOOP: " << eventNumber << " " << curBlockIdx << " "
-                    << "(" << hdr->GetEventWindowTag().GetEventWindowTag(true) << ")" << std::endl;
+  if (diagLevel_ > 1) {
+    std::cout << std::dec << "Producer: Run " << event.run() << ", subrun " << event.subRun()
+              << ", event " << eventNumber << " has " << std::endl;
+    std::cout << crvFragments->size() << " CRV fragments." << std::endl;
+
+    size_t totalSize = 0;
+    for (size_t idx = 0; idx < crvFragments->size(); ++idx) {
+      auto size = ((*crvFragments)[idx]).size() * sizeof(artdaq::RawDataType);
+      totalSize += size;
+      //      std::cout << "\tCRV Fragment " << idx << " has size " << size << std::endl;
+    }
+
+    std::cout << "\tTotal Size: " << (int)totalSize << " bytes." << std::endl;
+  }
+
+  // Collection of CaloDigis for the event
+  std::unique_ptr<mu2e::CrvDigiCollection> crv_digis(new mu2e::CrvDigiCollection);
 
-        } // End debug output
-      }   // End parsing CRV packets
-    }     // End loop over DataBlocks within fragment
-  }       // Close loop over fragments
+  // Decode the CRV fragments, in parallel unless the hits are printed
+  bool parallel = parallelDecode_ && diagLevel_ <= 1;
+  mu2e::decodeInOrder<mu2e::CrvDigiCollection>(
+      numCrvFrags, parallel,
+      [&](size_t idx, mu2e::CrvDigiCollection& digis) {
+        analyze_crv_((*crvFragments)[idx], eventNumber, digis);
+      },
+      [&](mu2e::CrvDigiCollection& digis) { mu2e::appendCollection(*crv_digis, digis); });
 
   if (diagLevel_ > 0) {
     std::cout << "mu2e::CrvDigisFromFragments::produce exiting eventNumber=" << (int)(event.event())
@@ -168,7 +168,7 @@ void FragmentAna::analyze(const art::Event& event) {
       }
     } else {
       if (handle->front().type() == mu2e::detail::FragmentType::TRK && parseTRK_) {
-        for (auto frag : *handle) {
+        for (const auto& frag : *handle) {
           mu2e::TrackerFragment cc(frag.dataBegin(), frag.dataSizeBytes());
           analyze_tracker_(cc);
 
@@ -176,7 +176,7 @@ void FragmentAna::analyze(const art::Event& event) {
           numTrkFrags++;
         }
       } else if (handle->front().type() == mu2e::detail::FragmentType::CAL && parseCAL_) {
-        for (auto frag : *handle) {
+        for (const auto& frag : *handle) {
           mu2e::CalorimeterFragment cc(frag.dataBegin(), frag.dataSizeBytes());
           analyze_calorimeter_(cc);
 
@@ -0,0 +1,58 @@
+#include "Offline/DAQ/inc/FragmentSpans.hh"
+
+#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
+#include "artdaq-core-mu2e/Overlays/Mu2eEventFragment.hh"
+
+namespace mu2e {
+
+  void FragmentSpans::collect(art::Event const& event, bool useTrk, bool useCal) {
+    auto fragmentHandles = event.getMany<std::vector<artdaq::Fragment>>();
+
+    for (const auto& handle : fragmentHandles) {
+      if (!handle.isValid() || handle->empty()) {
+        continue;
+      }
+
+      auto type = handle->front().type();
+      if (type == detail::FragmentType::MU2EEVENT) {
+        for (const auto& cont : *handle) {
+          Mu2eEventFragment mef(cont);
+          if (useTrk) {
+            for (size_t ii = 0; ii < mef.tracker_block_count(); ++ii) {
+              auto pair = mef.trackerAtPtr(ii);
+              spans_[trk].push_back(FragmentSpan{pair.first, pair.second});
+            }
+          }
+          if (useCal) {
+            for (size_t ii = 0; ii < mef.calorimeter_block_count(); ++ii) {
+              auto pair = mef.calorimeterAtPtr(ii);
+              spans_[cal].push_back(FragmentSpan{pair.first, pair.second});
+            }
+          }
+        }
+      } else if (type == detail::FragmentType::TRK && useTrk) {
+        add(trk, *handle);
+      } else if (type == detail::FragmentType::CAL && useCal) {
+        add(cal, *handle);
+      }
+    }
+  }
+
+  void FragmentSpans::add(Subsystem sub, artdaq::Fragments const& frags) {
+    spans_[sub].reserve(spans_[sub].size() + frags.size());
+    for (const auto& frag : frags) {
+      spans_[sub].push_back(FragmentSpan{frag.dataBegin(), frag.dataSizeBytes()});
+    }
+  }
+
+  size_t FragmentSpans::totalBytes(Subsystem sub) const {
+    size_t total(0);
+    for (const auto& span : spans_[sub]) total += span.size;
+    return total;
+  }
+
+  void FragmentSpans::clear() {
+    for (auto& spans : spans_) spans.clear();
+  }
+
+} // namespace mu2e
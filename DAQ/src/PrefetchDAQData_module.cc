@@ -144,14 +144,14 @@ namespace mu2e {
     if (_cfcol) {
       int ncf = _cfcol->size();
       for(int i=0;i<ncf;++i){
-        auto frag = _cfcol->at(i);
+        const auto& frag = _cfcol->at(i);
          fake_access(frag);
       }
     }
     if (_tfcol) {
       int ntf = _tfcol->size();
       for(int i=0;i<ntf;++i){
-        auto frag = _tfcol->at(i);
+        const auto& frag = _tfcol->at(i);
          fake_access(frag);
       }
     }
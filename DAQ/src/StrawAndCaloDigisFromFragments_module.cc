@@ -11,10 +11,10 @@
 
 #include "art/Framework/Principal/Handle.h"
 #include "artdaq-core-mu2e/Overlays/CalorimeterFragment.hh"
-#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
-#include "artdaq-core-mu2e/Overlays/Mu2eEventFragment.hh"
 #include "artdaq-core-mu2e/Overlays/TrackerFragment.hh"
 
+#include "Offline/DAQ/inc/FragmentSpans.hh"
+
 #include "Offline/DataProducts/inc/TrkTypes.hh"
 #include "Offline/RecoDataProducts/inc/CaloDigi.hh"
 #include "Offline/RecoDataProducts/inc/ProtonBunchTime.hh"
@@ -22,6 +22,8 @@
 
 #include <artdaq-core/Data/Fragment.hh>
 
+#include "tbb/parallel_invoke.h"
+
 #include <iostream>
 
 #include <string>
@@ -43,6 +45,9 @@ public:
     fhicl::Atom<int> parseTRK{fhicl::Name("parseTRK"), fhicl::Comment("parseTRK")};
     fhicl::Atom<int> useTrkADC{fhicl::Name("useTrkADC"),
                                fhicl::Comment("parse tracker ADC waveforms")};
+    fhicl::Atom<bool> parallelDecode{
+        fhicl::Name("parallelDecode"),
+        fhicl::Comment("decode the fragment payloads in parallel (only with diagLevel 0)"), true};
     fhicl::Atom<art::InputTag> caloTag{fhicl::Name("caloTag"), fhicl::Comment("caloTag")};
     fhicl::Atom<art::InputTag> trkTag{fhicl::Name("trkTag"), fhicl::Comment("trkTag")};
   };
@@ -55,18 +60,23 @@ public:
   virtual void produce(Event&);
 
 private:
-  void
-  analyze_tracker_(const mu2e::TrackerFragment& cc,
-                   std::unique_ptr<mu2e::StrawDigiCollection> const& straw_digis,
-                   std::unique_ptr<mu2e::StrawDigiADCWaveformCollection> const& straw_digi_adcs);
+  // Digis decoded from one tracker payload
+  struct TrackerResult {
+    mu2e::StrawDigiCollection digis;
+    mu2e::StrawDigiADCWaveformCollection adcs;
+  };
+
+  void analyze_tracker_(const mu2e::TrackerFragment& cc, mu2e::StrawDigiCollection& straw_digis,
+                        mu2e::StrawDigiADCWaveformCollection& straw_digi_adcs);
   void analyze_calorimeter_(const mu2e::CalorimeterFragment& cc,
-                            std::unique_ptr<mu2e::CaloDigiCollection> const& calo_digis);
+                            mu2e::CaloDigiCollection& calo_digis);
 
   int diagLevel_;
 
   int parseCAL_;
   int parseTRK_;
   int useTrkADC_;
+  bool parallelDecode_;
 
   art::InputTag trkFragmentsTag_;
   art::InputTag caloFragmentsTag_;
@@ -82,6 +92,7 @@ art::StrawAndCaloDigisFromFragments::StrawAndCaloDigisFromFragments(
     art::EDProducer{config},
     diagLevel_(config().diagLevel()), parseCAL_(config().parseCAL()),
     parseTRK_(config().parseTRK()), useTrkADC_(config().useTrkADC()),
+    parallelDecode_(config().parallelDecode()),
     trkFragmentsTag_(config().trkTag()), caloFragmentsTag_(config().caloTag()) {
   if (parseTRK_) {
     produces<mu2e::StrawDigiCollection>();
@@ -115,60 +126,67 @@ void art::StrawAndCaloDigisFromFragments::produce(Event& event) {
   pbt->pbterr_ = 0;
   event.put(std::move(pbt));
 
-  size_t totalSize = 0;
-  size_t numTrkFrags = 0;
-  size_t numCalFrags = 0;
-  std::vector<art::Handle<artdaq::Fragments>> fragmentHandles =
-      event.getMany<std::vector<artdaq::Fragment>>();
-
-  for (const auto& handle : fragmentHandles) {
-    if (!handle.isValid() || handle->empty()) {
-      continue;
+  // Views of the tracker and calorimeter payloads; the fragments are not copied
+  mu2e::FragmentSpans spans;
+  spans.collect(event, parseTRK_, parseCAL_);
+  auto const& trkSpans = spans.spans(mu2e::FragmentSpans::trk);
+  auto const& calSpans = spans.spans(mu2e::FragmentSpans::cal);
+
+  size_t totalSize =
+      spans.totalBytes(mu2e::FragmentSpans::trk) + spans.totalBytes(mu2e::FragmentSpans::cal);
+  size_t numTrkFrags = trkSpans.size();
+  size_t numCalFrags = calSpans.size();
+
+  // The printout of the diagnostic levels must stay ordered, so only decode in parallel without it
+  bool parallel = parallelDecode_ && diagLevel_ == 0;
+
+  // The block headers give the number of packets, an upper bound on the number of hits
+  auto decodeTracker = [&]() {
+    size_t npackets(0);
+    for (auto const& span : trkSpans) {
+      npackets += mu2e::packetCount(mu2e::TrackerFragment(span.pair()));
     }
-
-    if (handle->front().type() == mu2e::detail::FragmentType::MU2EEVENT) {
-      for (const auto& cont : *handle) {
-        mu2e::Mu2eEventFragment mef(cont);
-        if (parseTRK_) {
-          for (size_t ii = 0; ii < mef.tracker_block_count(); ++ii) {
-            auto pair = mef.trackerAtPtr(ii);
-            mu2e::TrackerFragment cc(pair);
-            analyze_tracker_(cc, straw_digis, straw_digi_adcs);
-
-            totalSize += pair.second;
-            numTrkFrags++;
-          }
-        }
-        if (parseCAL_) {
-          for (size_t ii = 0; ii < mef.calorimeter_block_count(); ++ii) {
-            auto pair = mef.calorimeterAtPtr(ii);
-            mu2e::CalorimeterFragment cc(pair);
-            analyze_calorimeter_(cc, calo_digis);
-
-            totalSize += pair.second;
-            numTrkFrags++;
+    straw_digis->reserve(npackets);
+    if (useTrkADC_) {
+      straw_digi_adcs->reserve(npackets);
+    }
+    mu2e::decodeInOrder<TrackerResult>(
+        trkSpans.size(), parallel,
+        [&](size_t i, TrackerResult& res) {
+          mu2e::TrackerFragment cc(trkSpans[i].pair());
+          size_t npackets = mu2e::packetCount(cc);
+          res.digis.reserve(npackets);
+          if (useTrkADC_) {
+            res.adcs.reserve(npackets);
           }
-        }
-      }
-    } else {
-      if (handle->front().type() == mu2e::detail::FragmentType::TRK && parseTRK_) {
-        for (auto frag : *handle) {
-          mu2e::TrackerFragment cc(frag.dataBegin(), frag.dataSizeBytes());
-          analyze_tracker_(cc, straw_digis, straw_digi_adcs);
-
-          totalSize += frag.dataSizeBytes();
-          numTrkFrags++;
-        }
-      } else if (handle->front().type() == mu2e::detail::FragmentType::CAL && parseCAL_) {
-        for (auto frag : *handle) {
-          mu2e::CalorimeterFragment cc(frag.dataBegin(), frag.dataSizeBytes());
-          analyze_calorimeter_(cc, calo_digis);
-
-          totalSize += frag.dataSizeBytes();
-          numCalFrags++;
-        }
-      }
+          analyze_tracker_(cc, res.digis, res.adcs);
+        },
+        [&](TrackerResult& res) {
+          mu2e::appendCollection(*straw_digis, res.digis);
+          mu2e::appendCollection(*straw_digi_adcs, res.adcs);
+        });
+  };
+  auto decodeCalorimeter = [&]() {
+    size_t npackets(0);
+    for (auto const& span : calSpans) {
+      npackets += mu2e::packetCount(mu2e::CalorimeterFragment(span.pair()));
     }
+    calo_digis->reserve(npackets);
+    mu2e::decodeInOrder<mu2e::CaloDigiCollection>(
+        calSpans.size(), parallel,
+        [&](size_t i, mu2e::CaloDigiCollection& digis) {
+          mu2e::CalorimeterFragment cc(calSpans[i].pair());
+          digis.reserve(mu2e::packetCount(cc));
+          analyze_calorimeter_(cc, digis);
+        },
+        [&](mu2e::CaloDigiCollection& digis) { mu2e::appendCollection(*calo_digis, digis); });
+  };
+
+  if (parallel) {
+    tbb::parallel_invoke(decodeTracker, decodeCalorimeter);
+  } else {
+    decodeTracker();
+    decodeCalorimeter();
   }
 
   if (diagLevel_ > 1) {
@@ -199,8 +217,8 @@ void art::StrawAndCaloDigisFromFragments::produce(Event& event) {
 } // produce()
 
 void art::StrawAndCaloDigisFromFragments::analyze_tracker_(
-    const mu2e::TrackerFragment& cc, std::unique_ptr<mu2e::StrawDigiCollection> const& straw_digis,
-    std::unique_ptr<mu2e::StrawDigiADCWaveformCollection> const& straw_digi_adcs) {
+    const mu2e::TrackerFragment& cc, mu2e::StrawDigiCollection& straw_digis,
+    mu2e::StrawDigiADCWaveformCollection& straw_digi_adcs) {
 
   if (diagLevel_ > 1) {
     std::cout << std::endl;
@@ -280,9 +298,9 @@ void art::StrawAndCaloDigisFromFragments::analyze_tracker_(
         mu2e::TrkTypes::ADCValue pmp = trkDataPair.first->PMP;
 
         // Fill the StrawDigiCollection
-        straw_digis->emplace_back(sid, tdc, tot, pmp);
+        straw_digis.emplace_back(sid, tdc, tot, pmp);
         if (useTrkADC_) {
-          straw_digi_adcs->emplace_back(trkDataPair.second);
+          straw_digi_adcs.emplace_back(trkDataPair.second);
         }
 
         if (diagLevel_ > 1) {
@@ -353,8 +371,7 @@ void art::StrawAndCaloDigisFromFragments::analyze_tracker_(
 }
 
 void art::StrawAndCaloDigisFromFragments::analyze_calorimeter_(
-    const mu2e::CalorimeterFragment& cc,
-    std::unique_ptr<mu2e::CaloDigiCollection> const& calo_digis) {
+    const mu2e::CalorimeterFragment& cc, mu2e::CaloDigiCollection& calo_digis) {
 
   if (diagLevel_ > 1) {
     std::cout << std::endl;
@@ -476,8 +493,8 @@ void art::StrawAndCaloDigisFromFragments::analyze_calorimeter_(
         std::copy(hits[hitIdx].second.begin(), hits[hitIdx].second.end(),
                   std::back_inserter(caloHits));
 
-        calo_digis->emplace_back((crystalID * 2 + apdID), hits[hitIdx].first.Time, caloHits,
-                                 hits[hitIdx].first.IndexOfMaxDigitizerSample);
+        calo_digis.emplace_back((crystalID * 2 + apdID), hits[hitIdx].first.Time, caloHits,
+                                hits[hitIdx].first.IndexOfMaxDigitizerSample);
 
         if (diagLevel_ > 1) {
           // Until we have the final mapping, the BoardID is just a placeholder
@@ -38,11 +38,8 @@
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 
 #include "art/Framework/Principal/Handle.h"
-#include "artdaq-core-mu2e/Overlays/CalorimeterFragment.hh"
-#include "artdaq-core-mu2e/Overlays/FragmentType.hh"
 #include "artdaq-core-mu2e/Overlays/TrackerFragment.hh"
-#include "artdaq-core-mu2e/Overlays/Mu2eEventFragment.hh"
-#include <artdaq-core/Data/Fragment.hh>
+#include "Offline/DAQ/inc/FragmentSpans.hh"
 
 #include "TH1F.h"
 
@@ -196,31 +193,11 @@ void art::StrawHitRecoFromFragments::produce(art::Event& event)
   //_tfTag = art::InputTag("test");
 
 
-  size_t numTrkFrags = 0;
-  std::vector<art::Handle<artdaq::Fragments>> fragmentHandles =
-      event.getMany<std::vector<artdaq::Fragment>>();
-
-  for (const auto& handle : fragmentHandles) {
-      if (!handle.isValid() || handle->empty()) {
-          continue;
-      }
-
-      if (handle->front().type() == mu2e::detail::FragmentType::MU2EEVENT) {
-          for (const auto& cont : *handle) {
-              mu2e::Mu2eEventFragment mef(cont);
-              for (size_t ii = 0; ii < mef.tracker_block_count(); ++ii) {
-                  numTrkFrags++;
-              }
-          }
-      }
-      else {
-          if (handle->front().type() == mu2e::detail::FragmentType::TRK) {
-              for (auto frag : *handle) {
-                  numTrkFrags++;
-              }
-          }
-      }
-  }
+  // tracker payloads, including those inside MU2EEVENT containers, without copying the fragments
+  mu2e::FragmentSpans spans;
+  spans.collect(event, true, false);
+  auto const& trkSpans = spans.spans(mu2e::FragmentSpans::trk);
+  size_t numTrkFrags = trkSpans.size();
 
   //auto sdH = event.getValidHandle(_sdctoken);
   //const StrawDigiCollection& sdcol(*sdH);
@@ -266,29 +243,11 @@ void art::StrawHitRecoFromFragments::produce(art::Event& event)
     _diagLevel, _maxiter, _mask, nplanes, npanels, _writesh, _minT, _maxT, _minE, _maxE, _filter, _flagXT,
     _ctE, _ctMinT, _ctMaxT, _usecc, _clusterDt, numTrkFrags);
 
-  for (const auto& handle : fragmentHandles) {
-      if (!handle.isValid() || handle->empty()) {
-          continue;
-      }
-
-      if (handle->front().type() == mu2e::detail::FragmentType::MU2EEVENT) {
-          for (const auto& cont : *handle) {
-              mu2e::Mu2eEventFragment mef(cont);
-              for (size_t ii = 0; ii < mef.tracker_block_count(); ++ii) {
-                  auto pair = mef.trackerAtPtr(ii);
-                  mu2e::TrackerFragment cc(pair);
-                  analyze_tracker_(cc, shCol, chCol, shrUtils, trackerStatus, srep, caloClusters, tt);
-              }
-          }
-      }
-      else {
-          if (handle->front().type() == mu2e::detail::FragmentType::TRK) {
-              for (auto frag : *handle) {
-                  mu2e::TrackerFragment cc(frag.dataBegin(), frag.dataSizeBytes());
-                  analyze_tracker_(cc, shCol, chCol, shrUtils, trackerStatus, srep, caloClusters, tt);
-              }
-          }
-      }
+  // the hits are decoded serially: the cross-talk flagging of each block looks at
+  // all the hits made before it
+  for (const auto& span : trkSpans) {
+    mu2e::TrackerFragment cc(span.pair());
+    analyze_tracker_(cc, shCol, chCol, shrUtils, trackerStatus, srep, caloClusters, tt);
   }
 
   if(_writesh)event.put(std::move(shCol));
@@ -119,7 +119,7 @@ void art::StrawRecoFromFragmnets::produce(Event& event) {
       }
     } else {
       if (handle->front().type() == mu2e::detail::FragmentType::TRK) {
-        for (auto frag : *handle) {
+        for (const auto& frag : *handle) {
           mu2e::TrackerFragment cc(frag.dataBegin(), frag.dataSizeBytes());
           analyze_tracker_(cc, straw_digis, straw_digi_adcs);
 
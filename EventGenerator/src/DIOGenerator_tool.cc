@@ -1,14 +1,14 @@
 #include "art/Utilities/ToolMacros.h"
+#include <memory>
 
 #include "CLHEP/Random/RandPoissonQ.h"
-#include "CLHEP/Random/RandGeneral.h"
 
 #include "Offline/EventGenerator/inc/ParticleGeneratorTool.hh"
 
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/MCDataProducts/inc/GenId.hh"
 #include "Offline/Mu2eUtilities/inc/RandomUnitSphere.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
 #include "Offline/GlobalConstantsService/inc/ParticleDataList.hh"
 #include "Offline/GlobalConstantsService/inc/PhysicsParams.hh"
@@ -29,7 +29,7 @@ namespace mu2e {
     explicit DIOGenerator(Parameters const& conf) :
       _pdgId(PDGCode::e_minus),
       _mass(GlobalConstantsHandle<ParticleDataList>()->particle(_pdgId).mass()),
-      _spectrum(BinnedSpectrum(conf().spectrum.get<fhicl::ParameterSet>()))
+      _psphys(conf().spectrum.get<fhicl::ParameterSet>())
     {}
 
     std::vector<ParticleGeneratorTool::Kinematic> generate() override;
@@ -37,24 +37,24 @@ namespace mu2e {
 
     void finishInitialization(art::RandomNumberGenerator::base_engine_t& eng, const std::string&) override {
       _randomUnitSphere = new RandomUnitSphere(eng);
-      _randSpectrum = new CLHEP::RandGeneral(eng, _spectrum.getPDF(), _spectrum.getNbins());
+      _randSpectrum = std::make_unique<SpectrumSampler>(eng, _psphys);
     }
 
   private:
     PDGCode::type _pdgId;
     double _mass;
 
-    BinnedSpectrum    _spectrum;
+    fhicl::ParameterSet _psphys;
 
     RandomUnitSphere*   _randomUnitSphere;
-    CLHEP::RandGeneral* _randSpectrum;
+    std::unique_ptr<SpectrumSampler> _randSpectrum;
   };
 
 
   std::vector<ParticleGeneratorTool::Kinematic> DIOGenerator::generate() {
     std::vector<ParticleGeneratorTool::Kinematic>  res;
 
-    double energy = _spectrum.sample(_randSpectrum->fire());
+    double energy = _randSpectrum->sample();
 
     const double p = energy * sqrt(1 - std::pow(_mass/energy,2));
     CLHEP::Hep3Vector p3 = _randomUnitSphere->fire(p);
@@ -34,10 +34,9 @@
 #include "Offline/Mu2eUtilities/inc/ConversionSpectrum.hh"
 #include "Offline/MCDataProducts/inc/GenId.hh"
 #include "Offline/Mu2eUtilities/inc/RandomUnitSphere.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "fhiclcpp/types/DelegatedParameter.h"
 #include "CLHEP/Random/RandPoissonQ.h"
-#include "CLHEP/Random/RandGeneral.h"
 
 namespace mu2e {
 
@@ -74,9 +73,9 @@ namespace mu2e {
     PDGCode::type pid_;
 
     double _mass;
-    BinnedSpectrum    spectrum_;
+    fhicl::ParameterSet psphys_;
     RandomUnitSphere*   randomUnitSphere_;
-    CLHEP::RandGeneral* randSpectrum_;
+    std::unique_ptr<SpectrumSampler> randSpectrum_;
     double endPointEnergy_;
 
   };
@@ -90,7 +89,7 @@ namespace mu2e {
     , eng_{createEngine(art::ServiceHandle<SeedService>()->getSeed())}
     , randExp_{eng_}
     , pdgId_(conf().pdgId())
-    , spectrum_(BinnedSpectrum(conf().spectrum.get<fhicl::ParameterSet>()))
+    , psphys_(conf().spectrum.get<fhicl::ParameterSet>())
 
   {
     produces<mu2e::StageParticleCollection>();
@@ -107,7 +106,7 @@ namespace mu2e {
     }
 
     randomUnitSphere_ = new RandomUnitSphere(eng_);
-    randSpectrum_ = new CLHEP::RandGeneral(eng_, spectrum_.getPDF(), spectrum_.getNbins());
+    randSpectrum_ = std::make_unique<SpectrumSampler>(eng_, psphys_);
   }
 
   //================================================================
@@ -134,7 +133,7 @@ namespace mu2e {
                             double time)
   {
 
-    double energy = spectrum_.sample(randSpectrum_->fire());
+    double energy = randSpectrum_->sample();
 
     const double p = sqrt((energy + _mass) * (energy - _mass));
     CLHEP::Hep3Vector p3 = randomUnitSphere_->fire(p);
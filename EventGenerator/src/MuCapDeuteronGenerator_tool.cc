@@ -1,14 +1,14 @@
 #include "art/Utilities/ToolMacros.h"
+#include <memory>
 
 #include "CLHEP/Random/RandPoissonQ.h"
-#include "CLHEP/Random/RandGeneral.h"
 
 #include "Offline/EventGenerator/inc/ParticleGeneratorTool.hh"
 
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/MCDataProducts/inc/GenId.hh"
 #include "Offline/Mu2eUtilities/inc/RandomUnitSphere.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/Mu2eUtilities/inc/SpectrumVar.hh"
 #include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
 #include "Offline/GlobalConstantsService/inc/ParticleDataList.hh"
@@ -31,7 +31,7 @@ namespace mu2e {
     explicit MuCapDeuteronGenerator(Parameters const& conf) :
       _pdgId(PDGCode::deuteron),
       _mass(GlobalConstantsHandle<ParticleDataList>()->particle(_pdgId).mass()),
-      _spectrum(BinnedSpectrum(conf().spectrum.get<fhicl::ParameterSet>())),
+      _psphys(conf().spectrum.get<fhicl::ParameterSet>()),
       _spectrumVariable(parseSpectrumVar(conf().spectrumVariable()))
     {}
 
@@ -42,7 +42,7 @@ namespace mu2e {
       _rate = GlobalConstantsHandle<PhysicsParams>()->getCaptureDeuteronRate(material);
       _randomUnitSphere = new RandomUnitSphere(eng);
       _randomPoissonQ = new CLHEP::RandPoissonQ(eng, _rate);
-      _randSpectrum = new CLHEP::RandGeneral(eng, _spectrum.getPDF(), _spectrum.getNbins());
+      _randSpectrum = std::make_unique<SpectrumSampler>(eng, _psphys);
     }
 
   private:
@@ -50,12 +50,12 @@ namespace mu2e {
     double _mass;
     double _rate = 0.;
 
-    BinnedSpectrum    _spectrum;
+    fhicl::ParameterSet _psphys;
     SpectrumVar       _spectrumVariable;
 
     CLHEP::RandPoissonQ* _randomPoissonQ;
     RandomUnitSphere*   _randomUnitSphere;
-    CLHEP::RandGeneral* _randSpectrum;
+    std::unique_ptr<SpectrumSampler> _randSpectrum;
   };
 
 
@@ -64,7 +64,7 @@ namespace mu2e {
 
     int n_gen = _randomPoissonQ->fire();
     for (int i_gen = 0; i_gen < n_gen; ++i_gen) {
-      double energy = _spectrum.sample(_randSpectrum->fire());
+      double energy = _randSpectrum->sample();
 
       switch(_spectrumVariable) {
       case TOTAL_ENERGY  : break;
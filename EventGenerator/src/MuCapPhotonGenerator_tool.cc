@@ -1,14 +1,14 @@
 #include "art/Utilities/ToolMacros.h"
+#include <memory>
 
 #include "CLHEP/Random/RandPoissonQ.h"
-#include "CLHEP/Random/RandGeneral.h"
 
 #include "Offline/EventGenerator/inc/ParticleGeneratorTool.hh"
 
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/MCDataProducts/inc/GenId.hh"
 #include "Offline/Mu2eUtilities/inc/RandomUnitSphere.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
 #include "Offline/GlobalConstantsService/inc/PhysicsParams.hh"
 
@@ -26,7 +26,7 @@ namespace mu2e {
     typedef art::ToolConfigTable<PhysConfig> Parameters;
 
     explicit MuCapPhotonGenerator(Parameters const& conf) :
-      _spectrum(BinnedSpectrum(conf().spectrum.get<fhicl::ParameterSet>()))
+      _psphys(conf().spectrum.get<fhicl::ParameterSet>())
     {}
 
     std::vector<ParticleGeneratorTool::Kinematic> generate() override;
@@ -36,18 +36,18 @@ namespace mu2e {
       _rate = GlobalConstantsHandle<PhysicsParams>()->getCapturePhotonRate(material);
       _randomUnitSphere = new RandomUnitSphere(eng);
       _randomPoissonQ = new CLHEP::RandPoissonQ(eng, _rate);
-      _randSpectrum = new CLHEP::RandGeneral(eng, _spectrum.getPDF(), _spectrum.getNbins());
+      _randSpectrum = std::make_unique<SpectrumSampler>(eng, _psphys);
     }
 
   private:
     double _rate = 0.;
 
-    BinnedSpectrum    _spectrum;
+    fhicl::ParameterSet _psphys;
 
 
     CLHEP::RandPoissonQ* _randomPoissonQ;
     RandomUnitSphere*   _randomUnitSphere;
-    CLHEP::RandGeneral* _randSpectrum;
+    std::unique_ptr<SpectrumSampler> _randSpectrum;
   };
 
 
@@ -56,7 +56,7 @@ namespace mu2e {
 
     int n_gen = _randomPoissonQ->fire();
     for (int i_gen = 0; i_gen < n_gen; ++i_gen) {
-      double energy = _spectrum.sample(_randSpectrum->fire());
+      double energy = _randSpectrum->sample();
       const double p = energy;
       CLHEP::Hep3Vector p3 = _randomUnitSphere->fire(p);
       CLHEP::HepLorentzVector fourmom(p3, energy);
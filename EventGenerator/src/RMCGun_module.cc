@@ -14,7 +14,6 @@
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Vector/LorentzVector.h"
 #include "CLHEP/Random/RandomEngine.h"
-#include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Units/PhysicalConstants.h"
 
 // Framework includes
@@ -37,6 +36,7 @@
 #include "Offline/Mu2eUtilities/inc/MuonCaptureSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/SimpleSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/Mu2eUtilities/inc/Table.hh"
 #include "Offline/Mu2eUtilities/inc/RootTreeSampler.hh"
 #include "Offline/GeneralUtilities/inc/RSNTIO.hh"
@@ -53,7 +53,6 @@ namespace mu2e {
   class RMCGun : public art::EDProducer {
     fhicl::ParameterSet psphys_;
 
-    BinnedSpectrum spectrum_;
     static BinnedSpectrum parseSpectrumShape(const fhicl::ParameterSet& psphys,
                                              double *elow,
                                              double *ehi);
@@ -68,7 +67,7 @@ namespace mu2e {
 
     art::RandomNumberGenerator::base_engine_t& eng_;
 
-    CLHEP::RandGeneral  randSpectrum_;
+    SpectrumSampler     randSpectrum_;
     CLHEP::RandFlat     randomFlat_;
     RandomUnitSphere    randomUnitSphere_;
     MuonCaptureSpectrum muonCaptureSpectrum_;
@@ -97,7 +96,6 @@ namespace mu2e {
   RMCGun::RMCGun(const fhicl::ParameterSet& pset)
     : EDProducer{pset}
     , psphys_(pset.get<fhicl::ParameterSet>("physics"))
-    , spectrum_                  (BinnedSpectrum(psphys_))
     , verbosityLevel_            (pset.get<int>   ("verbosityLevel", 0))
     , generateInternalConversion_{psphys_.get<int>("generateIntConversion", 0)}
     , czmin_                     (pset.get<double>("czmin" , -1.0))
@@ -105,7 +103,7 @@ namespace mu2e {
     , phimin_                    (pset.get<double>("phimin",  0. ))
     , phimax_                    (pset.get<double>("phimax", CLHEP::twopi ))
     , eng_(createEngine(art::ServiceHandle<SeedService>()->getSeed()))
-    , randSpectrum_       (eng_, spectrum_.getPDF(), spectrum_.getNbins())
+    , randSpectrum_       (eng_, psphys_)
     , randomFlat_         (eng_)
     , randomUnitSphere_   (eng_, czmin_,czmax_,phimin_,phimax_)
     , muonCaptureSpectrum_(&randomFlat_,&randomUnitSphere_)
@@ -223,7 +221,7 @@ namespace mu2e {
 
   //================================================================
   double RMCGun::generateEnergy() {
-    return spectrum_.sample(randSpectrum_.fire());
+    return randSpectrum_.sample();
   }
 
   //================================================================
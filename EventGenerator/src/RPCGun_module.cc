@@ -31,7 +31,7 @@
 #include "Offline/MCDataProducts/inc/StepPointMC.hh"
 #include "Offline/MCDataProducts/inc/EventWeight.hh"
 #include "Offline/Mu2eUtilities/inc/simParticleList.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/Mu2eUtilities/inc/RandomUnitSphere.hh"
 #include "Offline/Mu2eUtilities/inc/PionCaptureSpectrum.hh"
 #include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
@@ -39,7 +39,6 @@
 #include "art_root_io/TFileService.h"
 #include "fhiclcpp/types/DelegatedParameter.h"
 #include "CLHEP/Random/RandPoissonQ.h"
-#include "CLHEP/Random/RandGeneral.h"
 
 // ROOT includes
 #include "TFile.h"
@@ -77,11 +76,10 @@ namespace mu2e {
     CLHEP::RandExponential randExp_;
     CLHEP::RandFlat     randomFlat_;
     std::string RPCType_;
-    BinnedSpectrum    spectrum_;
     bool pionDecayOff_;
     bool doHistograms_;
     RandomUnitSphere   randomUnitSphere_;
-    CLHEP::RandGeneral randSpectrum_;
+    SpectrumSampler    randSpectrum_;
 
     const double            czmin_ = -1;
     const double            czmax_ = 1;
@@ -109,11 +107,10 @@ namespace mu2e {
     , randExp_{eng_}
     , randomFlat_{eng_}
     , RPCType_{conf().RPCType()}
-    , spectrum_{BinnedSpectrum(conf().spectrum.get<fhicl::ParameterSet>())}
     , pionDecayOff_{conf().pionDecayOff()}
     , doHistograms_{conf().doHistograms()}
     , randomUnitSphere_ {eng_, czmin_,czmax_,phimin_,phimax_}
-    , randSpectrum_       {eng_, spectrum_.getPDF(),static_cast<int>(spectrum_.getNbins())}
+    , randSpectrum_       {eng_, conf().spectrum.get<fhicl::ParameterSet>()}
     , pionCaptureSpectrum_{&randomFlat_,&randomUnitSphere_}
   {
     produces<mu2e::StageParticleCollection>();
@@ -181,7 +178,7 @@ namespace mu2e {
                             art::Ptr<SimParticle> pistop)
   {
     //Photon energy and four mom:
-    double energy = spectrum_.sample(randSpectrum_.fire());
+    double energy = randSpectrum_.sample();
     const CLHEP::Hep3Vector p3 = randomUnitSphere_.fire(energy);
     const CLHEP::HepLorentzVector fourmom(p3, energy);
     if(process_ == ProcessCode::mu2eExternalRPC){
@@ -0,0 +1,138 @@
+//
+// Statistical test of the SpectrumSampler methods against CLHEP::RandGeneral,
+// for each of the configured spectra:
+//
+//  - inverseCDF must return exactly the numbers of RandGeneral fed by an
+//    identical engine;
+//  - alias must give the same distribution: two-sample chi2 of alias and
+//    RandGeneral draws from independent engines, in subBins bins per spectrum
+//    bin so that the shape inside the bins is tested too.  The job fails if
+//    the chi2 probability is below minProbability.
+//
+// The time per draw of each method is printed.  Everything is done at beginJob,
+// run it with an EmptyEvent source.
+//
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "CLHEP/Random/RandGeneral.h"
+
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
+
+#include "TMath.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class SpectrumSamplerTest : public art::EDAnalyzer {
+  public:
+    explicit SpectrumSamplerTest(const fhicl::ParameterSet& pset);
+    void beginJob() override;
+    void analyze(const art::Event&) override {}
+
+  private:
+    std::vector<fhicl::ParameterSet> spectra_;
+    unsigned long nDraws_;
+    unsigned      subBins_;
+    double        minProbability_;
+    long          seed_;
+  };
+
+  SpectrumSamplerTest::SpectrumSamplerTest(const fhicl::ParameterSet& pset) :
+    art::EDAnalyzer{pset},
+    spectra_(pset.get<std::vector<fhicl::ParameterSet> >("spectra")),
+    nDraws_(pset.get<unsigned long>("nDraws", 10000000)),
+    subBins_(pset.get<unsigned>("subBins", 4)),
+    minProbability_(pset.get<double>("minProbability", 1e-4)),
+    seed_(pset.get<long>("seed", 12345))
+  {}
+
+  void SpectrumSamplerTest::beginJob() {
+    typedef std::chrono::steady_clock Clock;
+    auto ns = [this](Clock::time_point start) {
+      return std::chrono::duration<double,std::nano>(Clock::now()-start).count()/nDraws_;
+    };
+
+    std::cout << "SpectrumSamplerTest: " << nDraws_ << " draws per method, ns per draw" << std::endl;
+    std::cout << std::setw(16) << "spectrum" << std::setw(8) << "nbins"
+              << std::setw(12) << "RandGeneral" << std::setw(12) << "inverseCDF" << std::setw(12) << "alias"
+              << std::setw(12) << "chi2/ndf" << std::setw(12) << "prob" << std::endl;
+
+    bool failed(false);
+    for(const auto& psphys : spectra_) {
+      const std::string shape = psphys.get<std::string>("spectrumShape");
+      const auto table = SpectrumTable::cached(psphys);
+      const std::size_t nbins = table->nbins();
+      const std::size_t nhist = nbins*subBins_;
+
+      // the reference, and inverseCDF from an engine in the same state
+      CLHEP::MixMaxRng engRG(seed_), engCDF(seed_), engAlias(seed_+1);
+      CLHEP::RandGeneral randGeneral(engRG, table->spectrum().getPDF(), static_cast<int>(nbins));
+      SpectrumSampler samplerCDF(engCDF, table, SpectrumSampler::inverseCDF);
+      SpectrumSampler samplerAlias(engAlias, table, SpectrumSampler::alias);
+
+      std::vector<double> reference(nDraws_), draws(nDraws_);
+      auto start = Clock::now();
+      for(auto& r : reference) r = randGeneral.fire();
+      const double tRG = ns(start);
+
+      start = Clock::now();
+      for(auto& d : draws) d = samplerCDF.fire();
+      const double tCDF = ns(start);
+
+      unsigned long nDiffer(0);
+      for(unsigned long i=0; i<nDraws_; ++i) if(draws[i] != reference[i]) ++nDiffer;
+
+      start = Clock::now();
+      samplerAlias.fireArray(nDraws_, draws.data());
+      const double tAlias = ns(start);
+
+      std::vector<double> hRG(nhist), hAlias(nhist);
+      for(unsigned long i=0; i<nDraws_; ++i) {
+        hRG   [std::min(std::size_t(reference[i]*nhist), nhist-1)] += 1;
+        hAlias[std::min(std::size_t(draws[i]*nhist),     nhist-1)] += 1;
+      }
+      double chi2(0);
+      int ndf(-1);
+      for(std::size_t i=0; i<nhist; ++i) {
+        const double n = hRG[i] + hAlias[i];
+        if(n > 0) {
+          chi2 += (hRG[i]-hAlias[i])*(hRG[i]-hAlias[i])/n;
+          ++ndf;
+        }
+      }
+      const double prob = ndf > 0 ? TMath::Prob(chi2, ndf) : 1.;
+
+      std::cout << std::setw(16) << shape << std::setw(8) << nbins << std::fixed << std::setprecision(2)
+                << std::setw(12) << tRG << std::setw(12) << tCDF << std::setw(12) << tAlias
+                << std::setw(12) << (ndf > 0 ? chi2/ndf : 0.) << std::setprecision(4) << std::setw(12) << prob
+                << std::endl;
+
+      if(nDiffer != 0) {
+        std::cout << "SpectrumSamplerTest: " << shape << ": inverseCDF differs from RandGeneral in "
+                  << nDiffer << " draws" << std::endl;
+        failed = true;
+      }
+      if(prob < minProbability_) {
+        std::cout << "SpectrumSamplerTest: " << shape << ": alias and RandGeneral distributions differ, chi2 = "
+                  << chi2 << " for " << ndf << " degrees of freedom" << std::endl;
+        failed = true;
+      }
+    }
+
+    if(failed) {
+      throw cet::exception("TEST")<<"SpectrumSamplerTest: the samplers do not reproduce CLHEP::RandGeneral\n";
+    }
+  }
+
+}
+
+DEFINE_ART_MODULE(mu2e::SpectrumSamplerTest);
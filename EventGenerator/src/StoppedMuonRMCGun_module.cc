@@ -14,7 +14,6 @@
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Vector/LorentzVector.h"
 #include "CLHEP/Random/RandomEngine.h"
-#include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Units/PhysicalConstants.h"
 
 // Framework includes
@@ -38,6 +37,7 @@
 #include "Offline/Mu2eUtilities/inc/MuonCaptureSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/SimpleSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/Mu2eUtilities/inc/Table.hh"
 #include "Offline/Mu2eUtilities/inc/RootTreeSampler.hh"
 #include "Offline/GeneralUtilities/inc/RSNTIO.hh"
@@ -65,7 +65,7 @@ namespace mu2e {
     art::RandomNumberGenerator::base_engine_t& eng_;
     const double czmax_;
     const double czmin_;
-    CLHEP::RandGeneral*  randSpectrum_;
+    std::unique_ptr<SpectrumSampler> randSpectrum_;
     RandomUnitSphere     randUnitSphere_;
     RandomUnitSphere     randUnitSphereExt_; //For photons, to limit cosz
     CLHEP::RandFlat      randFlat_;
@@ -106,7 +106,6 @@ namespace mu2e {
 
   public:
     explicit StoppedMuonRMCGun(const fhicl::ParameterSet& pset);
-    ~StoppedMuonRMCGun();
     virtual void produce(art::Event& event);
   };
 
@@ -147,7 +146,9 @@ namespace mu2e {
     // initialize binned spectrum - this needs to be done right
     parseSpectrumShape(psphys_);
 
-    randSpectrum_ = new CLHEP::RandGeneral(eng_, spectrum_.getPDF(), spectrum_.getNbins());
+    // the tables are built from the spectrum restricted above, not cached from psphys_
+    randSpectrum_ = std::make_unique<SpectrumSampler>(eng_, std::make_shared<const SpectrumTable>(spectrum_),
+                                                      SpectrumSampler::parseMethod(psphys_.get<std::string>("samplingMethod", "inverseCDF")));
 
     if ( doHistograms_ ) {
       art::ServiceHandle<art::TFileService> tfs;
@@ -166,11 +167,6 @@ namespace mu2e {
     }
   }
 
-  //================================================================
-  StoppedMuonRMCGun::~StoppedMuonRMCGun() {
-    delete randSpectrum_;
-  }
-
   //================================================================
   void StoppedMuonRMCGun::parseSpectrumShape(const fhicl::ParameterSet& psphys) {
 
@@ -250,7 +246,7 @@ namespace mu2e {
 
   //================================================================
   double StoppedMuonRMCGun::generateEnergy() {
-    return spectrum_.sample(randSpectrum_->fire());
+    return randSpectrum_->sample();
   }
 
   //================================================================
@@ -13,7 +13,6 @@
 #include "CLHEP/Vector/ThreeVector.h"
 #include "CLHEP/Vector/LorentzVector.h"
 #include "CLHEP/Random/RandomEngine.h"
-#include "CLHEP/Random/RandGeneral.h"
 #include "CLHEP/Units/PhysicalConstants.h"
 
 #include "art/Framework/Core/EDProducer.h"
@@ -34,7 +33,7 @@
 #include "Offline/Mu2eUtilities/inc/ConversionSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/SimpleSpectrum.hh"
 #include "Offline/Mu2eUtilities/inc/EjectedProtonSpectrum.hh"
-#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
 #include "Offline/Mu2eUtilities/inc/Table.hh"
 #include "Offline/Mu2eUtilities/inc/RootTreeSampler.hh"
 #include "Offline/GeneralUtilities/inc/RSNTIO.hh"
@@ -53,12 +52,11 @@ namespace mu2e {
     enum SpectrumVar  { TOTAL_ENERGY, KINETIC_ENERY, MOMENTUM };
     SpectrumVar       spectrumVariable_;
 
-    BinnedSpectrum    spectrum_;
     GenId             genId_;
     int               verbosityLevel_;
 
     art::RandomNumberGenerator::base_engine_t& eng_;
-    CLHEP::RandGeneral randSpectrum_;
+    SpectrumSampler    randSpectrum_;
     RandomUnitSphere   randomUnitSphere_;
 
     RootTreeSampler<IO::StoppedParticleF> stops_;
@@ -89,11 +87,10 @@ namespace mu2e {
     , pdgId_(PDGCode::type(psphys_.get<int>("pdgId")))
     , mass_(GlobalConstantsHandle<ParticleDataList>()->particle(pdgId_).mass())
     , spectrumVariable_(parseSpectrumVar(psphys_.get<std::string>("spectrumVariable")))
-    , spectrum_(BinnedSpectrum(psphys_))
     , genId_(GenId::findByName(psphys_.get<std::string>("genId")))
     , verbosityLevel_(pset.get<int>("verbosityLevel", 0))
     , eng_(createEngine(art::ServiceHandle<SeedService>()->getSeed()))
-    , randSpectrum_(eng_, spectrum_.getPDF(), spectrum_.getNbins())
+    , randSpectrum_(eng_, psphys_)
     , randomUnitSphere_(eng_)
     , stops_(eng_, pset.get<fhicl::ParameterSet>("muonStops"))
     , doHistograms_       (pset.get<bool>("doHistograms",false ) )
@@ -125,7 +122,7 @@ namespace mu2e {
     }
     if (verbosityLevel_ > 1){
       std::cout <<"StoppedParticleReactionGun: spectrum: " << std::endl;
-      spectrum_.print();
+      randSpectrum_.spectrum().print();
     }
 
     if ( doHistograms_ ) {
@@ -187,7 +184,7 @@ namespace mu2e {
 // energy
 //-----------------------------------------------------------------------------
   double StoppedParticleReactionGun::generateEnergy() {
-    double res = spectrum_.sample(randSpectrum_.fire());
+    double res = randSpectrum_.sample();
 
     if (res < 0.0) {
       throw cet::exception("BADE")<<"StoppedParticleReactionGun: negative energy "<< res <<"\n";
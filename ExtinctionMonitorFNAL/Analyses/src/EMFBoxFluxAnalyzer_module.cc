@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <iterator>
 #include <map>
+#include <array>
 
 #include <sys/times.h>
 #include <stdio.h>
@@ -477,44 +478,22 @@ namespace mu2e {
     } // mergeLowStatisticSrcGroups()
 
     //================================================================
-    class Metric {
+    // coordinates of the plane in which the neighbors are searched: xy, yz or zx
+    class Projection {
     public:
-      virtual ~Metric() {}
-      virtual double operator()(const InputParticle *a, const InputParticle *b) const =0;
-    };
-
-    class MetricXY : virtual public Metric {
-    public:
-      virtual double operator()(const InputParticle *a, const InputParticle *b) const {
-        const double dx = a->posExtMon.x() - b->posExtMon.x();
-        const double dy = a->posExtMon.y() - b->posExtMon.y();
-        return sqrt(dx*dx + dy*dy);
-      }
-    };
-
-    class MetricYZ : virtual public Metric {
-    public:
-      virtual double operator()(const InputParticle *a, const InputParticle *b) const {
-        const double dy = a->posExtMon.y() - b->posExtMon.y();
-        const double dz = a->posExtMon.z() - b->posExtMon.z();
-        return sqrt(dy*dy + dz*dz);
-      }
-    };
-
-    class MetricZX : virtual public Metric {
-    public:
-      virtual double operator()(const InputParticle *a, const InputParticle *b) const {
-        const double dx = a->posExtMon.x() - b->posExtMon.x();
-        const double dz = a->posExtMon.z() - b->posExtMon.z();
-        return sqrt(dx*dx + dz*dz);
+      explicit Projection(unsigned plane) : plane_(plane) {}
+      std::array<double,2> operator()(const InputParticle *a) const {
+        switch(plane_) {
+        case 0:  return {{ a->posExtMon.x(), a->posExtMon.y() }};
+        case 1:  return {{ a->posExtMon.y(), a->posExtMon.z() }};
+        default: return {{ a->posExtMon.z(), a->posExtMon.x() }};
+        }
       }
+    private:
+      unsigned plane_;
     };
 
     void EMFBoxFluxAnalyzer::computeParticleRandomizations() {
-      static MetricXY mxy; // gcc 4.6.1 does not like "static const" here
-      static MetricYZ myz; // gcc 4.6.1 does not like "static const" here
-      static MetricZX mzx; // gcc 4.6.1 does not like "static const" here
-      static const Metric *dist[] = { &mxy, &myz, &mzx };
 
       for(unsigned st = 0; st < NUM_SOURCES; ++st) {
 
@@ -533,8 +512,8 @@ namespace mu2e {
             struct tms st_cpu;
             const clock_t st_time = times(&st_cpu);
 
-            KNearestNeighbors<const InputParticle*>
-              neighbors(numNeighbors_, group, *dist[st % 3]);
+            const KNearestNeighbors<const InputParticle*>
+              neighbors(KNearestNeighbors<const InputParticle*>::euclidean(numNeighbors_, group, Projection(st % 3)));
 
             struct tms en_cpu;
             const clock_t en_time = times(&en_cpu);
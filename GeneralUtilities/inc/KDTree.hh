@@ -0,0 +1,170 @@
+// Static k-d tree over a set of points in D dimensions, for radius and
+// k-nearest-neighbor queries in O(log N) per query instead of a scan of
+// all the points.
+//
+// Distances are Euclidean in the given coordinates: to combine quantities
+// of different kinds, e.g. (x,y,t), scale them before building the tree.
+// The tree is built once; for a point set that changes while it is being
+// searched (clustering) see SpatialGrid.hh.
+//
+
+#ifndef GeneralUtilities_KDTree_hh
+#define GeneralUtilities_KDTree_hh
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mu2e {
+
+  template<std::size_t D, class T = double>
+  class KDTree {
+  public:
+    typedef std::array<T,D> Point;
+
+    struct Neighbor {
+      unsigned id;  // index of the point in the input container
+      T distance;
+    };
+
+    static constexpr unsigned noId = std::numeric_limits<unsigned>::max();
+
+    // nodes with at most leafSize points are scanned
+    explicit KDTree(std::vector<Point> points, unsigned leafSize = 8);
+
+    std::size_t size() const { return points_.size(); }
+    const Point& point(unsigned id) const { return points_[id]; }
+
+    // ids of the points within distance r of p, in no particular order
+    void radius(const Point& p, T r, std::vector<unsigned>& ids) const;
+
+    // the k points nearest to p, by increasing distance, skipping the point exclude
+    void nearest(const Point& p, unsigned k, std::vector<Neighbor>& neighbors, unsigned exclude = noId) const;
+
+  private:
+    // (squared distance, id), the farthest on top
+    typedef std::priority_queue<std::pair<T,unsigned> > Heap;
+
+    void build(unsigned lo, unsigned hi);
+    void radius (unsigned lo, unsigned hi, const Point& p, T r2, std::vector<unsigned>& ids) const;
+    void nearest(unsigned lo, unsigned hi, const Point& p, unsigned k, unsigned exclude, Heap& heap) const;
+    void visit(unsigned id, const Point& p, unsigned k, unsigned exclude, Heap& heap) const;
+
+    static T dist2(const Point& a, const Point& b) {
+      T d2(0);
+      for(std::size_t i=0; i<D; ++i) { const T d = a[i]-b[i]; d2 += d*d; }
+      return d2;
+    }
+
+    std::vector<Point>         points_;
+    std::vector<unsigned>      index_;  // points ordered as the implicit tree
+    std::vector<unsigned char> split_;  // split dimension of the node whose pivot is index_[i]
+    unsigned                   leaf_;
+  };
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T>
+  KDTree<D,T>::KDTree(std::vector<Point> points, unsigned leafSize)
+    : points_(std::move(points)), index_(points_.size()), split_(points_.size(),0), leaf_(std::max(1u,leafSize))
+  {
+    for(unsigned i=0; i<index_.size(); ++i) index_[i] = i;
+    build(0, index_.size());
+  }
+
+  // The node [lo,hi) is split at its median along the dimension of largest spread:
+  // [lo,mid) and [mid+1,hi) are the children, index_[mid] the pivot
+  template<std::size_t D, class T>
+  void KDTree<D,T>::build(unsigned lo, unsigned hi) {
+    if(hi - lo <= leaf_) return;
+    std::size_t dim(0);
+    T spread(-1);
+    for(std::size_t i=0; i<D; ++i) {
+      T vmin(std::numeric_limits<T>::max()), vmax(std::numeric_limits<T>::lowest());
+      for(unsigned j=lo; j<hi; ++j) {
+        vmin = std::min(vmin, points_[index_[j]][i]);
+        vmax = std::max(vmax, points_[index_[j]][i]);
+      }
+      if(vmax - vmin > spread) { spread = vmax - vmin; dim = i; }
+    }
+    const unsigned mid = lo + (hi - lo)/2;
+    std::nth_element(index_.begin()+lo, index_.begin()+mid, index_.begin()+hi,
+                     [this,dim](unsigned a, unsigned b) { return points_[a][dim] < points_[b][dim]; });
+    split_[mid] = dim;
+    build(lo, mid);
+    build(mid+1, hi);
+  }
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T>
+  void KDTree<D,T>::radius(const Point& p, T r, std::vector<unsigned>& ids) const {
+    radius(0, index_.size(), p, r*r, ids);
+  }
+
+  template<std::size_t D, class T>
+  void KDTree<D,T>::radius(unsigned lo, unsigned hi, const Point& p, T r2, std::vector<unsigned>& ids) const {
+    if(hi - lo <= leaf_) {
+      for(unsigned j=lo; j<hi; ++j) if(dist2(points_[index_[j]], p) <= r2) ids.push_back(index_[j]);
+      return;
+    }
+    const unsigned mid = lo + (hi - lo)/2;
+    const unsigned id = index_[mid];
+    if(dist2(points_[id], p) <= r2) ids.push_back(id);
+    const T d = p[split_[mid]] - points_[id][split_[mid]];
+    if(d <= 0 || d*d <= r2) radius(lo, mid, p, r2, ids);
+    if(d >= 0 || d*d <= r2) radius(mid+1, hi, p, r2, ids);
+  }
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T>
+  void KDTree<D,T>::nearest(const Point& p, unsigned k, std::vector<Neighbor>& neighbors, unsigned exclude) const {
+    neighbors.clear();
+    if(k == 0) return;
+    Heap heap;
+    nearest(0, index_.size(), p, k, exclude, heap);
+    neighbors.resize(heap.size());
+    for(auto in = neighbors.rbegin(); in != neighbors.rend(); ++in) {
+      *in = Neighbor{heap.top().second, std::sqrt(heap.top().first)};
+      heap.pop();
+    }
+  }
+
+  template<std::size_t D, class T>
+  void KDTree<D,T>::visit(unsigned id, const Point& p, unsigned k, unsigned exclude, Heap& heap) const {
+    if(id == exclude) return;
+    const T d2 = dist2(points_[id], p);
+    if(heap.size() < k) {
+      heap.emplace(d2, id);
+    } else if(d2 < heap.top().first) {
+      heap.pop();
+      heap.emplace(d2, id);
+    }
+  }
+
+  template<std::size_t D, class T>
+  void KDTree<D,T>::nearest(unsigned lo, unsigned hi, const Point& p, unsigned k, unsigned exclude, Heap& heap) const {
+    if(hi - lo <= leaf_) {
+      for(unsigned j=lo; j<hi; ++j) visit(index_[j], p, k, exclude, heap);
+      return;
+    }
+    const unsigned mid = lo + (hi - lo)/2;
+    const unsigned id = index_[mid];
+    visit(id, p, k, exclude, heap);
+    // the side of the query point first, the other side only if it can hold a nearer point
+    const T d = p[split_[mid]] - points_[id][split_[mid]];
+    const bool left = d < 0;
+    if(left) nearest(lo, mid, p, k, exclude, heap);
+    else     nearest(mid+1, hi, p, k, exclude, heap);
+    if(heap.size() < k || d*d < heap.top().first) {
+      if(left) nearest(mid+1, hi, p, k, exclude, heap);
+      else     nearest(lo, mid, p, k, exclude, heap);
+    }
+  }
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_KDTree_hh */
@@ -1,8 +1,9 @@
 // Find k nearest neighbors for each point in an input container
 // using the given metric.
 //
-// BEWARE: the current implementation is a naive O(N^2) algorithm.
-// There are much faster ways of doing this.
+// The constructor with an arbitrary metric is a naive O(N^2) algorithm.
+// For Euclidean distances in a few coordinates use euclidean(), which
+// searches a k-d tree in O(N log N).
 //
 //
 // Original author Andrei Gaponenko
@@ -10,7 +11,12 @@
 #ifndef GeneralUtilities_KNearestNeighbors_hh
 #define GeneralUtilities_KNearestNeighbors_hh
 
+#include "Offline/GeneralUtilities/inc/KDTree.hh"
+
+#include <algorithm>
+#include <array>
 #include <queue>
+#include <type_traits>
 #include <vector>
 
 namespace mu2e {
@@ -24,6 +30,13 @@ namespace mu2e {
                       const std::vector<Point>& group, // input points
                       const Distance& dist);
 
+    // The same with the Euclidean distance between coord(point), a
+    // std::array<double,D> for some D, computed with a k-d tree
+    template<class Coordinates>
+    static KNearestNeighbors euclidean(unsigned k,
+                                       const std::vector<Point>& group,
+                                       const Coordinates& coord);
+
     // size() == group.size()
     std::size_t size() const { return pp_.size(); }
 
@@ -50,6 +63,7 @@ namespace mu2e {
     const Points& operator[](unsigned ipoint) const { return pp_[ipoint]; }
 
   private:
+    KNearestNeighbors() {}
     std::vector<Points> pp_;
   };
 
@@ -90,6 +104,36 @@ namespace mu2e {
   } // KNearestNeighbors()
 
   //----------------------------------------------------------------
+  template<class Point> template<class Coordinates>
+  KNearestNeighbors<Point> KNearestNeighbors<Point>::euclidean(unsigned k,
+                                                               const std::vector<Point>& group,
+                                                               const Coordinates& coord)
+  {
+    typedef typename std::decay<decltype(coord(group.front()))>::type Coords;
+    typedef KDTree<std::tuple_size<Coords>::value> Tree;
+    std::vector<typename Tree::Point> points;
+    points.reserve(group.size());
+    for(const auto& point : group) {
+      const Coords c = coord(point);
+      points.emplace_back();
+      std::copy(c.begin(), c.end(), points.back().begin());
+    }
+    const Tree tree(std::move(points));
+
+    // same order as the brute force result: the farthest neighbor first
+    KNearestNeighbors result;
+    result.pp_.resize(group.size());
+    std::vector<typename Tree::Neighbor> neighbors;
+    for(unsigned i=0; i<group.size(); ++i) {
+      tree.nearest(tree.point(i), k, neighbors, i);
+      for(auto in = neighbors.rbegin(); in != neighbors.rend(); ++in) {
+        result.pp_[i].push_back(Entry(group[in->id], in->distance));
+      }
+    }
+    return result;
+  } // euclidean()
+
+  //----------------------------------------------------------------
 
 } // namespace mu2e
 
@@ -0,0 +1,41 @@
+// Read-only memory map of a whole file.  The pages are shared by all the
+// processes on a node that map the same file, and are only read from disk
+// when first touched.  The mapping lives as long as the object.
+//
+// Throws cet::exception("FILE") if the file can not be opened or mapped.
+//
+
+#ifndef GeneralUtilities_MappedFile_hh
+#define GeneralUtilities_MappedFile_hh
+
+#include <cstddef>
+#include <string>
+
+namespace mu2e {
+
+  class MappedFile {
+  public:
+    // randomAccess disables the kernel read-ahead, for files sampled at random
+    explicit MappedFile(const std::string& filename, bool randomAccess = false);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char*        data() const { return data_; }
+    std::size_t        size() const { return size_; }
+    const std::string& name() const { return name_; }
+
+  private:
+    void unmap();
+
+    std::string name_;
+    const char* data_;
+    std::size_t size_;
+  };
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_MappedFile_hh */
@@ -0,0 +1,100 @@
+#ifndef GeneralUtilities_Profiler_hh
+#define GeneralUtilities_Profiler_hh
+//
+// Lightweight, always compiled, self-profiling of hot code paths.
+//
+// Usage, inside the code to be timed:
+//
+//   MU2E_PROFILE_SCOPE("DeltaFinderAlg::findSeeds");   // time until the end of scope
+//   MU2E_PROFILE_COUNT("DeltaFinderAlg::seeds", nseeds); // add to a counter
+//
+// Each named probe is registered once (function-local static) and then
+// accumulates calls, total and maximum time, and a counter in a buffer
+// owned by the calling thread, so there is no locking in the hot path.
+// When profiling is disabled (the default) a timer costs one relaxed
+// atomic load and no clock reads.  The per-thread buffers are merged by
+// summary(), which should be called when no timed code is running,
+// e.g. at endJob.  See Analyses/src/ProfileSummary_module.cc.
+//
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class Profiler {
+  public:
+    struct Stats {
+      uint64_t calls = 0;   // number of timed scopes
+      uint64_t ns    = 0;   // total time in the timed scopes
+      uint64_t maxns = 0;   // longest single scope
+      uint64_t count = 0;   // sum of MU2E_PROFILE_COUNT increments
+    };
+    typedef std::vector<std::pair<std::string,Stats> > Summary;
+
+    // probes beyond this number are silently ignored
+    static constexpr unsigned maxProbes = 512;
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool value) { enabled_.store(value, std::memory_order_relaxed); }
+
+    // Id of the named probe, registering it on first use
+    static unsigned probe(const std::string& name);
+
+    static void addTime (unsigned id, uint64_t ns);
+    static void addCount(unsigned id, uint64_t n);
+
+    // Merged over all threads, in order of registration
+    static Summary summary();
+    static void reset();
+
+    static void print(std::ostream& os);
+    static void writeJSON(std::ostream& os);
+
+  private:
+    static std::atomic<bool> enabled_;
+  };
+
+  class ProfileTimer {
+  public:
+    typedef std::chrono::steady_clock clock;
+
+    explicit ProfileTimer(unsigned id) : id_(id), on_(Profiler::enabled()) {
+      if(on_) start_ = clock::now();
+    }
+    ~ProfileTimer() {
+      if(on_) {
+        Profiler::addTime(id_, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start_).count());
+      }
+    }
+    ProfileTimer(const ProfileTimer&) = delete;
+    ProfileTimer& operator=(const ProfileTimer&) = delete;
+
+  private:
+    unsigned id_;
+    bool on_;
+    clock::time_point start_;
+  };
+
+}
+
+#define MU2E_PROFILE_CAT2_(a,b) a##b
+#define MU2E_PROFILE_CAT_(a,b) MU2E_PROFILE_CAT2_(a,b)
+
+#define MU2E_PROFILE_SCOPE(name)                                        \
+  static const unsigned MU2E_PROFILE_CAT_(mu2eProfileId_,__LINE__) = mu2e::Profiler::probe(name); \
+  mu2e::ProfileTimer MU2E_PROFILE_CAT_(mu2eProfileTimer_,__LINE__)(MU2E_PROFILE_CAT_(mu2eProfileId_,__LINE__))
+
+#define MU2E_PROFILE_COUNT(name,n)                                      \
+  do {                                                                  \
+    if(mu2e::Profiler::enabled()) {                                     \
+      static const unsigned mu2eProfileCountId = mu2e::Profiler::probe(name); \
+      mu2e::Profiler::addCount(mu2eProfileCountId, (n));                \
+    }                                                                   \
+  } while(0)
+
+#endif /* GeneralUtilities_Profiler_hh */
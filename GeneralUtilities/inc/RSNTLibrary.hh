@@ -0,0 +1,239 @@
+// Binary "library" of the RSNTIO records, a flat alternative to the ROOT
+// ntuples read by RootTreeSampler.  The file is memory mapped read-only
+// (MappedFile) and the records are used in place, so opening a library
+// does not depend on its size and all the jobs on a node share its pages.
+//
+// Layout, native byte order:
+//
+//   RSNTLibraryHeader
+//   numRecords records, as the in-memory NtupleRecord
+//   padding to 8 bytes
+//   numEvents+1 uint64 indices of the first record of each event (only for correlated libraries)
+//
+// A correlated library keeps the grouping of the records into events that
+// the "particle in event" branch of the ntuple encodes; in an uncorrelated
+// one each record is an event.  The header holds sizeof(NtupleRecord) and
+// NtupleRecord::branchDescription(), checked when the library is opened.
+//
+// Libraries are written with RSNTLibraryWriter, see makeRSNTLibrary_main.cc
+// in Mu2eUtilities for the conversion of the ntuples.
+//
+
+#ifndef GeneralUtilities_RSNTLibrary_hh
+#define GeneralUtilities_RSNTLibrary_hh
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "cetlib_except/exception.h"
+
+#include "Offline/GeneralUtilities/inc/MappedFile.hh"
+
+namespace mu2e {
+  namespace IO {
+
+    struct RSNTLibraryHeader {
+      static constexpr char magicWord[8] = {'M','U','2','E','R','S','N','T'};
+      static constexpr uint32_t currentVersion = 1;
+
+      char     magic[8];
+      uint32_t version;
+      uint32_t recordSize;        // sizeof(NtupleRecord)
+      uint64_t numRecords;
+      uint64_t numEvents;         // correlated libraries, 0 otherwise
+      uint64_t eventIndexOffset;  // file offset of the event index, 0 if none
+      char     description[128];  // NtupleRecord::branchDescription()
+
+      static std::size_t recordsOffset() { return sizeof(RSNTLibraryHeader); }
+    };
+
+    static_assert(sizeof(RSNTLibraryHeader)%8 == 0, "RSNTLibraryHeader must keep the records 8-byte aligned");
+
+    // true if the file starts as a library, whatever its record type
+    inline bool isRSNTLibrary(const std::string& filename) {
+      char magic[8];
+      std::ifstream in(filename, std::ios::binary);
+      return in.read(magic, sizeof(magic)) && std::memcmp(magic, RSNTLibraryHeader::magicWord, sizeof(magic)) == 0;
+    }
+
+  } // IO
+
+  //================================================================
+  template<class NtupleRecord>
+  class RSNTLibrary {
+  public:
+    static_assert(std::is_trivially_copyable<NtupleRecord>::value, "RSNTLibrary records are used in place");
+
+    explicit RSNTLibrary(const std::string& filename);
+
+    const std::string& fileName() const { return file_.name(); }
+    bool        correlated() const { return events_ != nullptr; }
+    std::size_t numRecords() const { return numRecords_; }
+    std::size_t numEvents()  const { return numEvents_; }
+
+    const NtupleRecord& record(std::size_t i) const { return records_[i]; }
+
+    // the records of event ievent are [eventBegin, eventEnd)
+    const NtupleRecord* eventBegin(std::size_t ievent) const { return records_ + (events_ ? events_[ievent]   : ievent); }
+    const NtupleRecord* eventEnd  (std::size_t ievent) const { return records_ + (events_ ? events_[ievent+1] : ievent+1); }
+
+  private:
+    MappedFile            file_;
+    const NtupleRecord*   records_;
+    const uint64_t*       events_;
+    std::size_t           numRecords_;
+    std::size_t           numEvents_;
+  };
+
+  //================================================================
+  template<class NtupleRecord>
+  class RSNTLibraryWriter {
+  public:
+    static_assert(std::is_trivially_copyable<NtupleRecord>::value, "RSNTLibrary records are written as they are in memory");
+
+    RSNTLibraryWriter(const std::string& filename, bool correlated);
+    ~RSNTLibraryWriter();
+
+    // correlated libraries: the records added until the next beginEvent() form an event
+    void beginEvent();
+    void add(const NtupleRecord& rec);
+
+    // write the event index and the final header; called by the destructor if needed
+    void close();
+
+    std::size_t numRecords() const { return numRecords_; }
+
+  private:
+    std::string           filename_;
+    std::ofstream         out_;
+    bool                  correlated_;
+    uint64_t              numRecords_;
+    std::vector<uint64_t> events_;
+  };
+
+  //================================================================
+  template<class NtupleRecord>
+  RSNTLibrary<NtupleRecord>::RSNTLibrary(const std::string& filename)
+    : file_(filename, true), records_(nullptr), events_(nullptr), numRecords_(0), numEvents_(0)
+  {
+    IO::RSNTLibraryHeader hdr;
+    if(file_.size() < sizeof(hdr)) {
+      throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" is too short for a library\n";
+    }
+    std::memcpy(&hdr, file_.data(), sizeof(hdr));
+
+    if(std::memcmp(hdr.magic, IO::RSNTLibraryHeader::magicWord, sizeof(hdr.magic)) != 0) {
+      throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" is not a library\n";
+    }
+    if(hdr.version != IO::RSNTLibraryHeader::currentVersion) {
+      throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" has version "<<hdr.version
+                                      <<", expect "<<IO::RSNTLibraryHeader::currentVersion<<"\n";
+    }
+    hdr.description[sizeof(hdr.description)-1] = 0;
+    if(hdr.recordSize != sizeof(NtupleRecord) ||
+       std::strcmp(hdr.description, NtupleRecord::branchDescription()) != 0) {
+      throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" holds records \""<<hdr.description
+                                      <<"\" of size "<<hdr.recordSize<<", expect \""<<NtupleRecord::branchDescription()
+                                      <<"\" of size "<<sizeof(NtupleRecord)<<"\n";
+    }
+
+    const uint64_t recordsEnd = IO::RSNTLibraryHeader::recordsOffset() + hdr.numRecords*hdr.recordSize;
+    const uint64_t indexEnd = hdr.eventIndexOffset + (hdr.numEvents+1)*sizeof(uint64_t);
+    const bool truncated = recordsEnd > file_.size() ||
+      (hdr.eventIndexOffset != 0 && (hdr.eventIndexOffset < recordsEnd || hdr.eventIndexOffset%8 != 0 || indexEnd > file_.size()));
+    if(truncated) {
+      throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" is truncated or corrupted\n";
+    }
+
+    records_ = reinterpret_cast<const NtupleRecord*>(file_.data() + IO::RSNTLibraryHeader::recordsOffset());
+    numRecords_ = hdr.numRecords;
+    numEvents_ = hdr.numRecords;
+    if(hdr.eventIndexOffset != 0) {
+      events_ = reinterpret_cast<const uint64_t*>(file_.data() + hdr.eventIndexOffset);
+      numEvents_ = hdr.numEvents;
+      if(events_[0] != 0 || events_[numEvents_] != numRecords_) {
+        throw cet::exception("BADINPUT")<<"RSNTLibrary: file \""<<filename<<"\" has an inconsistent event index\n";
+      }
+    }
+  }
+
+  //================================================================
+  template<class NtupleRecord>
+  RSNTLibraryWriter<NtupleRecord>::RSNTLibraryWriter(const std::string& filename, bool correlated)
+    : filename_(filename), out_(filename, std::ios::binary | std::ios::trunc), correlated_(correlated), numRecords_(0)
+  {
+    if(!out_) {
+      throw cet::exception("FILE")<<"RSNTLibraryWriter: can not create \""<<filename<<"\"\n";
+    }
+    // placeholder, rewritten by close()
+    const IO::RSNTLibraryHeader hdr{};
+    out_.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+  }
+
+  template<class NtupleRecord>
+  RSNTLibraryWriter<NtupleRecord>::~RSNTLibraryWriter() {
+    if(out_.is_open()) {
+      try { close(); } catch(...) {}
+    }
+  }
+
+  template<class NtupleRecord>
+  void RSNTLibraryWriter<NtupleRecord>::beginEvent() {
+    if(!correlated_) {
+      throw cet::exception("BUG")<<"RSNTLibraryWriter: beginEvent() for the uncorrelated library \""<<filename_<<"\"\n";
+    }
+    events_.push_back(numRecords_);
+  }
+
+  template<class NtupleRecord>
+  void RSNTLibraryWriter<NtupleRecord>::add(const NtupleRecord& rec) {
+    if(correlated_ && events_.empty()) {
+      throw cet::exception("BUG")<<"RSNTLibraryWriter: record added before the first beginEvent() to \""<<filename_<<"\"\n";
+    }
+    out_.write(reinterpret_cast<const char*>(&rec), sizeof(rec));
+    ++numRecords_;
+  }
+
+  template<class NtupleRecord>
+  void RSNTLibraryWriter<NtupleRecord>::close() {
+    IO::RSNTLibraryHeader hdr{};
+    std::memcpy(hdr.magic, IO::RSNTLibraryHeader::magicWord, sizeof(hdr.magic));
+    hdr.version = IO::RSNTLibraryHeader::currentVersion;
+    hdr.recordSize = sizeof(NtupleRecord);
+    hdr.numRecords = numRecords_;
+    std::strncpy(hdr.description, NtupleRecord::branchDescription(), sizeof(hdr.description)-1);
+
+    if(correlated_) {
+      // events without records are dropped, as RootTreeSampler never produces them
+      std::vector<uint64_t> index;
+      index.reserve(events_.size()+1);
+      for(auto first : events_) {
+        if(index.empty() || first != index.back()) index.push_back(first);
+      }
+      if(!index.empty() && index.back() == numRecords_) index.pop_back();
+      index.push_back(numRecords_);
+
+      const uint64_t recordsEnd = IO::RSNTLibraryHeader::recordsOffset() + numRecords_*sizeof(NtupleRecord);
+      const char pad[8] = {};
+      out_.write(pad, (8 - recordsEnd%8)%8);
+      hdr.eventIndexOffset = recordsEnd + (8 - recordsEnd%8)%8;
+      hdr.numEvents = index.size()-1;
+      out_.write(reinterpret_cast<const char*>(index.data()), index.size()*sizeof(uint64_t));
+    }
+
+    out_.seekp(0);
+    out_.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    out_.close();
+    if(out_.fail()) {
+      throw cet::exception("FILE")<<"RSNTLibraryWriter: error writing \""<<filename_<<"\"\n";
+    }
+  }
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_RSNTLibrary_hh */
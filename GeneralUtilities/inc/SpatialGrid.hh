@@ -0,0 +1,222 @@
+// Uniform grid index over points in D dimensions, for box, radius and
+// k-nearest-neighbor queries that only visit the cells which can hold an
+// answer.  Entries can be added while the grid is being searched, and
+// clear() only touches the cells in use, so the grid can be refilled at
+// every iteration of a clustering algorithm.
+//
+// Points outside the grid are kept in the edge cells, so no entry is ever
+// lost; the grid only needs to cover the bulk of the points.  Distances are
+// Euclidean in the given coordinates: scale (x,y,t)-like coordinates before
+// inserting them.  Entries of a cell are kept in insertion order.
+//
+
+#ifndef GeneralUtilities_SpatialGrid_hh
+#define GeneralUtilities_SpatialGrid_hh
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mu2e {
+
+  template<std::size_t D, class T = double>
+  class SpatialGrid {
+  public:
+    typedef std::array<T,D>        Point;
+    typedef std::array<int,D>      Cell;
+    typedef std::array<unsigned,D> Shape;
+
+    struct Entry {
+      unsigned id;
+      Point point;
+    };
+
+    struct Neighbor {
+      unsigned id;
+      T distance;
+    };
+
+    static constexpr unsigned noId = std::numeric_limits<unsigned>::max();
+
+    // ncells[i] cells of width cellSize[i] starting at lo[i]
+    SpatialGrid(const Point& lo, const Point& cellSize, const Shape& ncells);
+
+    unsigned    ncells(std::size_t dim) const { return n_[dim]; }
+    std::size_t size() const { return nentries_; }
+    // cell number of coordinate x along dim, not clamped to the grid
+    int         bin(std::size_t dim, T x) const { return int(std::floor((x - lo_[dim])/size_[dim])); }
+
+    void clear();
+    // clear and move the grid to new cell positions and widths, keeping the number of cells
+    void reset(const Point& lo, const Point& cellSize) { clear(); lo_ = lo; size_ = cellSize; }
+    void insert(unsigned id, const Point& point);
+
+    // call f(entry) for the entries of the cells lo..hi (inclusive, clamped to the grid)
+    template<class F> void forEachInCells(Cell lo, Cell hi, F&& f) const;
+    // call f(entry) for the entries of the cells overlapping the box [lo,hi]
+    template<class F> void forEachInBox(const Point& lo, const Point& hi, F&& f) const;
+
+    // ids of the entries within distance r of p, in cell order
+    void radius(const Point& p, T r, std::vector<unsigned>& ids) const;
+    // the k entries nearest to p, by increasing distance, skipping the entry exclude
+    void nearest(const Point& p, unsigned k, std::vector<Neighbor>& neighbors, unsigned exclude = noId) const;
+
+  private:
+    int clamp(std::size_t dim, int ibin) const { return std::min(std::max(ibin,0), int(n_[dim])-1); }
+    std::size_t cellIndex(const Cell& cell) const {
+      std::size_t index(0);
+      for(std::size_t i=D; i-- > 0; ) index = index*n_[i] + cell[i];
+      return index;
+    }
+    static T dist2(const Point& a, const Point& b) {
+      T d2(0);
+      for(std::size_t i=0; i<D; ++i) { const T d = a[i]-b[i]; d2 += d*d; }
+      return d2;
+    }
+
+    Point                             lo_, size_;
+    Shape                             n_;
+    std::vector<std::vector<Entry> >  cells_;
+    std::vector<std::size_t>          used_;   // non-empty cells
+    std::size_t                       nentries_;
+  };
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T>
+  SpatialGrid<D,T>::SpatialGrid(const Point& lo, const Point& cellSize, const Shape& ncells)
+    : lo_(lo), size_(cellSize), n_(ncells), nentries_(0)
+  {
+    std::size_t ntot(1);
+    for(std::size_t i=0; i<D; ++i) {
+      n_[i] = std::max(1u, n_[i]);
+      ntot *= n_[i];
+    }
+    cells_.resize(ntot);
+  }
+
+  template<std::size_t D, class T>
+  void SpatialGrid<D,T>::clear() {
+    for(auto icell : used_) cells_[icell].clear();
+    used_.clear();
+    nentries_ = 0;
+  }
+
+  template<std::size_t D, class T>
+  void SpatialGrid<D,T>::insert(unsigned id, const Point& point) {
+    Cell cell;
+    for(std::size_t i=0; i<D; ++i) cell[i] = clamp(i, bin(i, point[i]));
+    const std::size_t icell = cellIndex(cell);
+    if(cells_[icell].empty()) used_.push_back(icell);
+    cells_[icell].push_back(Entry{id, point});
+    ++nentries_;
+  }
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T> template<class F>
+  void SpatialGrid<D,T>::forEachInCells(Cell lo, Cell hi, F&& f) const {
+    for(std::size_t i=0; i<D; ++i) {
+      lo[i] = clamp(i, lo[i]);
+      hi[i] = clamp(i, hi[i]);
+    }
+    // odometer over the cells of the block
+    Cell cell(lo);
+    while(true) {
+      for(const auto& entry : cells_[cellIndex(cell)]) f(entry);
+      std::size_t i(0);
+      for(; i<D; ++i) {
+        if(cell[i] < hi[i]) { ++cell[i]; break; }
+        cell[i] = lo[i];
+      }
+      if(i == D) break;
+    }
+  }
+
+  template<std::size_t D, class T> template<class F>
+  void SpatialGrid<D,T>::forEachInBox(const Point& lo, const Point& hi, F&& f) const {
+    Cell clo, chi;
+    for(std::size_t i=0; i<D; ++i) {
+      clo[i] = bin(i, lo[i]);
+      chi[i] = bin(i, hi[i]);
+      if(chi[i] < clo[i]) return;
+    }
+    forEachInCells(clo, chi, f);
+  }
+
+  //----------------------------------------------------------------
+  template<std::size_t D, class T>
+  void SpatialGrid<D,T>::radius(const Point& p, T r, std::vector<unsigned>& ids) const {
+    Point lo, hi;
+    for(std::size_t i=0; i<D; ++i) { lo[i] = p[i] - r; hi[i] = p[i] + r; }
+    const T r2 = r*r;
+    forEachInBox(lo, hi, [&](const Entry& entry) { if(dist2(entry.point, p) <= r2) ids.push_back(entry.id); });
+  }
+
+  // Search shells of cells at increasing (Chebyshev) cell distance from the cell of p, until the k
+  // nearest found are closer than anything outside the searched block
+  template<std::size_t D, class T>
+  void SpatialGrid<D,T>::nearest(const Point& p, unsigned k, std::vector<Neighbor>& neighbors, unsigned exclude) const {
+    neighbors.clear();
+    if(k == 0 || nentries_ == 0) return;
+    std::priority_queue<std::pair<T,unsigned> > heap;
+    Cell center;
+    for(std::size_t i=0; i<D; ++i) center[i] = clamp(i, bin(i, p[i]));
+    for(int shell=0; ; ++shell) {
+      Cell lo, hi;
+      bool covered(true);
+      for(std::size_t i=0; i<D; ++i) {
+        lo[i] = center[i] - shell;
+        hi[i] = center[i] + shell;
+        covered &= lo[i] <= 0 && hi[i] >= int(n_[i])-1;
+      }
+      // the block is visited cell by cell to pick the cells of this shell
+      Cell cell;
+      for(std::size_t i=0; i<D; ++i) cell[i] = clamp(i, lo[i]);
+      while(true) {
+        int dcell(0);
+        for(std::size_t i=0; i<D; ++i) dcell = std::max(dcell, std::abs(cell[i] - center[i]));
+        if(dcell == shell) {
+          for(const auto& entry : cells_[cellIndex(cell)]) {
+            if(entry.id == exclude) continue;
+            const T d2 = dist2(entry.point, p);
+            if(heap.size() < k) {
+              heap.emplace(d2, entry.id);
+            } else if(d2 < heap.top().first) {
+              heap.pop();
+              heap.emplace(d2, entry.id);
+            }
+          }
+        }
+        std::size_t i(0);
+        for(; i<D; ++i) {
+          if(cell[i] < clamp(i, hi[i])) { ++cell[i]; break; }
+          cell[i] = clamp(i, lo[i]);
+        }
+        if(i == D) break;
+      }
+      if(covered) break;
+      if(heap.size() == k) {
+        // distance from p to the searched block; the sides at the grid edge hold everything beyond them
+        T bound(std::numeric_limits<T>::max());
+        for(std::size_t i=0; i<D; ++i) {
+          if(lo[i] > 0) bound = std::min(bound, p[i] - (lo_[i] + lo[i]*size_[i]));
+          if(hi[i] < int(n_[i])-1) bound = std::min(bound, lo_[i] + (hi[i]+1)*size_[i] - p[i]);
+        }
+        bound = std::max(bound, T(0));
+        if(bound*bound >= heap.top().first) break;
+      }
+    }
+    neighbors.resize(heap.size());
+    for(auto in = neighbors.rbegin(); in != neighbors.rend(); ++in) {
+      *in = Neighbor{heap.top().second, std::sqrt(heap.top().first)};
+      heap.pop();
+    }
+  }
+
+} // namespace mu2e
+
+#endif /* GeneralUtilities_SpatialGrid_hh */
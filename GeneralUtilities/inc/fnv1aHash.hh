@@ -0,0 +1,23 @@
+#ifndef GeneralUtilities_fnv1aHash_hh
+#define GeneralUtilities_fnv1aHash_hh
+//
+// 64 bit FNV-1a hash of a block of bytes.  Cheap and stable across
+// platforms and releases, so it can be stored in files, eg as the
+// checksum of a binary cache.  Not a cryptographic hash.
+//
+// To hash several blocks, pass the result for the previous blocks as
+// the starting value of the next one.
+//
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mu2e {
+
+  constexpr uint64_t fnv1aOffsetBasis = 0xcbf29ce484222325ULL;
+
+  uint64_t fnv1aHash( void const* data, std::size_t nbytes, uint64_t hash = fnv1aOffsetBasis );
+
+}
+
+#endif /* GeneralUtilities_fnv1aHash_hh */
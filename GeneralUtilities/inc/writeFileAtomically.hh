@@ -0,0 +1,19 @@
+#ifndef GeneralUtilities_writeFileAtomically_hh
+#define GeneralUtilities_writeFileAtomically_hh
+//
+// Write the contents to a temporary file next to filename and rename it
+// to filename, so that concurrent jobs reading filename never see a
+// partially written file.  Returns false, after removing the temporary,
+// if the file could not be written or renamed; the caller decides
+// whether that is fatal.
+//
+
+#include <string>
+
+namespace mu2e {
+
+  bool writeFileAtomically( std::string const& filename, std::string const& contents );
+
+}
+
+#endif /* GeneralUtilities_writeFileAtomically_hh */
@@ -0,0 +1,74 @@
+#include "Offline/GeneralUtilities/inc/MappedFile.hh"
+
+#include "cetlib_except/exception.h"
+
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mu2e {
+
+  MappedFile::MappedFile(const std::string& filename, bool randomAccess)
+    : name_(filename), data_(nullptr), size_(0)
+  {
+    const int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+      throw cet::exception("FILE")<<"MappedFile: can not open \""<<filename<<"\": "<<std::strerror(errno)<<"\n";
+    }
+    struct stat st;
+    if(::fstat(fd, &st) != 0) {
+      const int err = errno;
+      ::close(fd);
+      throw cet::exception("FILE")<<"MappedFile: can not stat \""<<filename<<"\": "<<std::strerror(err)<<"\n";
+    }
+    size_ = st.st_size;
+    // an empty file can not be mapped, it is simply an empty range
+    if(size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      if(addr == MAP_FAILED) {
+        const int err = errno;
+        ::close(fd);
+        throw cet::exception("FILE")<<"MappedFile: can not map \""<<filename<<"\": "<<std::strerror(err)<<"\n";
+      }
+      data_ = static_cast<const char*>(addr);
+      if(randomAccess) ::madvise(addr, size_, MADV_RANDOM);
+    }
+    // the mapping keeps its own reference to the file
+    ::close(fd);
+  }
+
+  MappedFile::~MappedFile() {
+    unmap();
+  }
+
+  MappedFile::MappedFile(MappedFile&& other) noexcept
+    : name_(std::move(other.name_)), data_(other.data_), size_(other.size_)
+  {
+    other.data_ = nullptr;
+    other.size_ = 0;
+  }
+
+  MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this != &other) {
+      unmap();
+      name_ = std::move(other.name_);
+      data_ = other.data_;
+      size_ = other.size_;
+      other.data_ = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  void MappedFile::unmap() {
+    if(data_) ::munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+} // namespace mu2e
@@ -0,0 +1,143 @@
+//
+// Lightweight self-profiling of hot code paths.
+//
+
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+namespace mu2e {
+
+  std::atomic<bool> Profiler::enabled_{false};
+
+  namespace {
+
+    // Written only by the owning thread; atomics so that summary() may
+    // read them from another thread without a data race.
+    struct Slot {
+      std::atomic<uint64_t> calls{0};
+      std::atomic<uint64_t> ns{0};
+      std::atomic<uint64_t> maxns{0};
+      std::atomic<uint64_t> count{0};
+    };
+    typedef std::array<Slot,Profiler::maxProbes> ThreadBuffer;
+
+    struct Registry {
+      std::mutex mutex;
+      std::vector<std::string> names;
+      // shared with the owning thread so that the data survive thread exit
+      std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    };
+
+    Registry& registry() {
+      static Registry reg;
+      return reg;
+    }
+
+    ThreadBuffer& threadBuffer() {
+      thread_local std::shared_ptr<ThreadBuffer> buf;
+      if(!buf) {
+        buf = std::make_shared<ThreadBuffer>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.buffers.push_back(buf);
+      }
+      return *buf;
+    }
+
+    void add(std::atomic<uint64_t>& a, uint64_t n) {
+      a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+  }
+
+  unsigned Profiler::probe(const std::string& name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for(unsigned i=0; i<reg.names.size(); ++i) {
+      if(reg.names[i] == name) return i;
+    }
+    reg.names.push_back(name);
+    return reg.names.size() - 1;
+  }
+
+  void Profiler::addTime(unsigned id, uint64_t ns) {
+    if(id >= maxProbes) return;
+    Slot& s = threadBuffer()[id];
+    add(s.calls, 1);
+    add(s.ns, ns);
+    if(ns > s.maxns.load(std::memory_order_relaxed)) s.maxns.store(ns, std::memory_order_relaxed);
+  }
+
+  void Profiler::addCount(unsigned id, uint64_t n) {
+    if(id >= maxProbes) return;
+    add(threadBuffer()[id].count, n);
+  }
+
+  Profiler::Summary Profiler::summary() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    Summary res;
+    for(unsigned i=0; i<reg.names.size() && i<maxProbes; ++i) {
+      Stats st;
+      for(const auto& buf : reg.buffers) {
+        const Slot& s = (*buf)[i];
+        st.calls += s.calls.load(std::memory_order_relaxed);
+        st.ns    += s.ns.load(std::memory_order_relaxed);
+        st.count += s.count.load(std::memory_order_relaxed);
+        st.maxns  = std::max(st.maxns, s.maxns.load(std::memory_order_relaxed));
+      }
+      res.emplace_back(reg.names[i], st);
+    }
+    return res;
+  }
+
+  void Profiler::reset() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for(const auto& buf : reg.buffers) {
+      for(auto& s : *buf) {
+        s.calls = 0; s.ns = 0; s.maxns = 0; s.count = 0;
+      }
+    }
+  }
+
+  void Profiler::print(std::ostream& os) {
+    os << "Profiler summary:\n"
+       << std::setw(50) << std::left << "probe" << std::right
+       << std::setw(12) << "calls"
+       << std::setw(14) << "total [ms]"
+       << std::setw(14) << "mean [us]"
+       << std::setw(14) << "max [us]"
+       << std::setw(14) << "count" << "\n";
+    for(const auto& [name, st] : summary()) {
+      os << std::setw(50) << std::left << name << std::right
+         << std::setw(12) << st.calls
+         << std::setw(14) << std::fixed << std::setprecision(3) << st.ns*1.e-6
+         << std::setw(14) << (st.calls > 0 ? st.ns*1.e-3/st.calls : 0.)
+         << std::setw(14) << st.maxns*1.e-3
+         << std::setw(14) << st.count << "\n";
+    }
+    os << std::defaultfloat;
+  }
+
+  void Profiler::writeJSON(std::ostream& os) {
+    os << "{\n  \"probes\": [";
+    bool first = true;
+    for(const auto& [name, st] : summary()) {
+      os << (first ? "\n" : ",\n")
+         << "    {\"name\": \"" << name << "\""
+         << ", \"calls\": " << st.calls
+         << ", \"total_ns\": " << st.ns
+         << ", \"max_ns\": " << st.maxns
+         << ", \"count\": " << st.count << "}";
+      first = false;
+    }
+    os << "\n  ]\n}\n";
+  }
+
+}
@@ -0,0 +1,18 @@
+//
+// 64 bit FNV-1a hash of a block of bytes.
+//
+
+#include "Offline/GeneralUtilities/inc/fnv1aHash.hh"
+
+namespace mu2e {
+
+  uint64_t fnv1aHash( void const* data, std::size_t nbytes, uint64_t hash ){
+    unsigned char const* p = static_cast<unsigned char const*>(data);
+    for ( std::size_t i=0; i<nbytes; ++i ){
+      hash ^= p[i];
+      hash *= 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+}
@@ -0,0 +1,35 @@
+//
+// Write a file through a temporary and a rename.
+//
+
+#include "Offline/GeneralUtilities/inc/writeFileAtomically.hh"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+namespace mu2e {
+
+  bool writeFileAtomically( std::string const& filename, std::string const& contents ){
+    // the pid keeps the temporaries of concurrent jobs apart
+    string tmpname = filename + ".tmp" + to_string(getpid());
+    ofstream out(tmpname, ios::binary|ios::trunc);
+    out.write(contents.data(),contents.size());
+    out.close();
+    if ( !out ) {
+      cout << "writeFileAtomically: cannot write " << tmpname << endl;
+      std::remove(tmpname.c_str());
+      return false;
+    }
+    if ( std::rename(tmpname.c_str(),filename.c_str()) != 0 ) {
+      cout << "writeFileAtomically: cannot rename " << tmpname << " to " << filename << endl;
+      std::remove(tmpname.c_str());
+      return false;
+    }
+    return true;
+  }
+
+}
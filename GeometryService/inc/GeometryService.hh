@@ -59,6 +59,10 @@ public:
       fhicl::Atom<int>    configStatsVerbosity{Name("configStatsVerbosity"),false};
       fhicl::Atom<bool>   printConfig{Name("printConfig"),false};
       fhicl::Atom<bool>   printConfigTopLevel{Name("printConfigTopLevel"),false};
+      fhicl::Atom<std::string> snapshotFile{Name("snapshotFile"),
+          Comment("Binary snapshot of the built geometry, keyed by the geometry file hash and the code version.\n"
+                  "Loaded when valid, otherwise rebuilt and rewritten.  Empty disables it.\n"
+                  "It holds only the straws, which are faster to compute than to read: leave it off."),""};
       fhicl::Table<SimulatedDetector> simulatedDetector{Name("simulatedDetector")};
     };
 
@@ -118,6 +122,9 @@ private:
     bool _printConfig;
     bool _printTopLevel;
 
+    // Name of the built-geometry snapshot file; empty if not used.
+    std::string _snapshotFile;
+
     // The objects that parse the run-time configuration files.
     std::unique_ptr<SimpleConfig> _config;
     std::unique_ptr<SimpleConfig> _bfConfig;
@@ -131,6 +138,10 @@ private:
     void checkConfig();
     void checkTrackerConfig();
 
+    // Make the tracker, using the snapshot file if one is configured.
+    // Returns where the straws came from, for the timing report.
+    std::string makeTracker();
+
     typedef boost::shared_ptr<Detector> DetectorPtr;
     typedef std::map<std::string,DetectorPtr> DetMap;
 
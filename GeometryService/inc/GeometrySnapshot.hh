@@ -0,0 +1,86 @@
+#ifndef GeometryService_GeometrySnapshot_hh
+#define GeometryService_GeometrySnapshot_hh
+//
+// Versioned, checksummed binary snapshot of built geometry content.
+// The snapshot is keyed by the hash of the geometry configuration
+// (SimpleConfig::inputFileHash, which includes all nested files), so a
+// snapshot written for one geometry is never used for another, and by
+// the version of the code which computed it: the git version of Offline
+// (git describe) recorded at build time, so a snapshot is reused across
+// rebuilds of the same code but not by another release or commit.  A
+// build from a tree with uncommitted changes, or outside of git, has no
+// version and does not use the snapshot.
+//
+// File layout:
+//   header  : magic, format version, configuration hash, code version, payload size, payload checksum
+//   payload : per-straw tracker content (id, wire and straw midpoints and directions, half length)
+//
+// Currently the snapshot holds only the per-straw tracker content computed
+// by TrackerMaker::makeStraws.  The rest of the tracker and the other
+// detector objects are built from the configuration as before.
+// GeometryService logs the time of the whole geometry and of the tracker,
+// and whether the straws came from the snapshot.  Computing the 20736
+// straws takes about 0.6 ms, reading them back about 9 ms (2 MB, mostly
+// the checksum), so the snapshot does not pay for itself until it holds
+// more of the geometry.
+//
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "Offline/DataProducts/inc/StrawId.hh"
+#include "Offline/TrackerGeom/inc/Straw.hh"
+
+namespace mu2e {
+
+  class GeometrySnapshot {
+  public:
+    using StrawCollection = std::array<Straw,StrawId::_nustraws>;
+
+    // increment whenever the payload layout changes
+    static constexpr uint32_t formatVersion = 2;
+    static constexpr uint32_t magic = 0x4d324753; // "M2GS"
+
+    GeometrySnapshot( std::string const& filename, std::size_t configHash, int verbosity=0 );
+
+    // False if the code version is not known: read and write then do nothing.
+    bool enabled() const { return _codeVersion != 0; }
+
+    // Return true and fill the straws if the file exists, was written by this
+    // format version for this configuration and code version, and its payload
+    // checksum is correct.
+    bool read( StrawCollection& straws ) const;
+
+    // (Re)write the snapshot for this configuration.  Failure to write is not fatal.
+    bool write( StrawCollection const& straws ) const;
+
+    std::string const& filename() const { return _filename; }
+    std::size_t configHash() const { return _configHash; }
+    uint64_t    codeVersion() const { return _codeVersion; }
+
+  private:
+    std::string _filename;
+    std::size_t _configHash;
+    uint64_t    _codeVersion;
+    int         _verbosity;
+
+    struct Header {
+      uint32_t magic;
+      uint32_t version;
+      uint64_t configHash;
+      uint64_t codeVersion;
+      uint64_t payloadSize;
+      uint64_t checksum;
+    };
+
+    // FNV-1a over the payload bytes
+    static uint64_t checksum( std::string const& payload );
+
+    // Hash of the Offline git version of the build; 0 if unknown.
+    static uint64_t releaseVersion();
+  };
+
+}
+
+#endif /* GeometryService_GeometrySnapshot_hh */
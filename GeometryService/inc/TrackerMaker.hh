@@ -29,13 +29,21 @@ namespace mu2e {
 
     TrackerMaker( SimpleConfig const& config );
 
+    using StrawCollection = std::array<Straw,StrawId::_nustraws>;
+
+    // Use straws restored from a GeometrySnapshot instead of recomputing them;
+    // the remaining (G4 and support) content is still built from the config.
+    TrackerMaker( SimpleConfig const& config, StrawCollection const& straws );
+
     // Use compiler-generated copy c'tor, copy assignment, and d'tor
 // why use unique_ptr and then expose the bare tracker pointer????
     std::unique_ptr<Tracker> getTrackerPtr() { return std::move(_tt); }
 
-    using StrawCollection = std::array<Straw,StrawId::_nustraws>;
   private:
 
+    // Common part of the constructors
+    void construct( SimpleConfig const& config );
+
     // Extract info from the config file.
     void parseConfig( const SimpleConfig& config );
 
@@ -142,6 +150,9 @@ namespace mu2e {
 
     std::unique_ptr<Tracker> _tt;
 
+    // Straws restored from a snapshot; null if they are to be computed.
+    StrawCollection const* _snapshotStraws = nullptr;
+
     // Derived parameters.
 
     // Compute at start and compare against final result.
@@ -6,6 +6,7 @@
 //
 
 // C++ include files
+#include <chrono>
 #include <iostream>
 #include <utility>
 
@@ -21,6 +22,7 @@
 // Mu2e include files
 #include "Offline/GeometryService/inc/G4GeometryOptions.hh"
 #include "Offline/GeometryService/inc/GeometryService.hh"
+#include "Offline/GeometryService/inc/GeometrySnapshot.hh"
 #include "Offline/GeometryService/inc/DetectorSolenoidMaker.hh"
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 #include "Offline/GeometryService/inc/Mu2eHallMaker.hh"
@@ -104,6 +106,7 @@ namespace mu2e {
     _configStatsVerbosity( pars().configStatsVerbosity()),
     _printConfig(          pars().printConfig()),
     _printTopLevel(        pars().printConfigTopLevel()),
+    _snapshotFile(         pars().snapshotFile()),
     _config(nullptr),
     _simulatedDetector(    pars.get_PSet().get<fhicl::ParameterSet>("simulatedDetector")),
     _standardMu2eDetector( _simulatedDetector.get<std::string>("tool_type") == "Mu2e"),
@@ -166,6 +169,9 @@ namespace mu2e {
                                                           _messageOnReplacement,
                                                           _messageOnDefault ));
     _bfConfig->printOpen(cout,"BField");
+    auto buildStart = std::chrono::steady_clock::now();
+    double trackerms(0);
+    std::string trackerSource("not built");
 
 
     if(_printTopLevel) {
@@ -290,8 +296,9 @@ namespace mu2e {
     addDetector(std::move(tmptgt));
 
     if (_config->getBool("hasTracker",false)){
-      TrackerMaker ttm( *_config );
-      addDetector( ttm.getTrackerPtr() );
+      auto trackerStart = std::chrono::steady_clock::now();
+      trackerSource = makeTracker();
+      trackerms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-trackerStart).count();
     }
 
     if(_config->getBool("hasMBS",false)){
@@ -363,9 +370,47 @@ namespace mu2e {
       addDetector( stm.getSTMPtr() );
     }
 
+    // compare the jobs with and without the snapshot to see what it saves
+    double buildms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-buildStart).count();
+    mf::LogInfo("GEOM") << "Geometry built in " << buildms << " ms, of which the tracker "
+                        << trackerms << " ms, straws " << trackerSource;
 
   } // preBeginRun()
 
+  // The per-straw tracker content is restored from the snapshot when the snapshot
+  // matches the current geometry; otherwise it is computed and the snapshot rewritten.
+  // A build without a known code version does not use the snapshot, silently.
+  std::string GeometryService::makeTracker(){
+    std::unique_ptr<GeometrySnapshot> snapshot;
+    if ( !_snapshotFile.empty() ) {
+      snapshot = std::make_unique<GeometrySnapshot>( _snapshotFile, _config->inputFileHash(),
+                                                     _config->getInt("tracker.verbosityLevel",0) );
+      if ( !snapshot->enabled() ) snapshot.reset();
+    }
+    if ( !snapshot ) {
+      TrackerMaker ttm( *_config );
+      addDetector( ttm.getTrackerPtr() );
+      return "built";
+    }
+
+    auto straws = std::make_unique<GeometrySnapshot::StrawCollection>();
+    if ( snapshot->read(*straws) ) {
+      TrackerMaker ttm( *_config, *straws );
+      addDetector( ttm.getTrackerPtr() );
+      return "restored from the snapshot " + _snapshotFile;
+    }
+    TrackerMaker ttm( *_config );
+    std::unique_ptr<Tracker> tracker = ttm.getTrackerPtr();
+    std::string source("built");
+    if ( snapshot->write(tracker->straws()) ) {
+      source += ", snapshot " + _snapshotFile + " written";
+    } else {
+      mf::LogWarning("GEOM") << "Could not write geometry snapshot " << _snapshotFile;
+    }
+    addDetector( std::move(tracker) );
+    return source;
+  }
+
   // Check that the configuration is self consistent.
   void GeometryService::checkConfig(){
     checkTrackerConfig();
@@ -0,0 +1,122 @@
+//
+// Versioned, checksummed binary snapshot of built geometry content.
+//
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "Offline/GeometryService/inc/GeometrySnapshot.hh"
+#include "Offline/GeneralUtilities/inc/fnv1aHash.hh"
+#include "Offline/GeneralUtilities/inc/writeFileAtomically.hh"
+
+using namespace std;
+
+namespace mu2e {
+
+  namespace {
+    template <typename T> void put( ostream& os, T const& val ) {
+      os.write(reinterpret_cast<const char*>(&val),sizeof(T));
+    }
+    template <typename T> void get( istream& is, T& val ) {
+      is.read(reinterpret_cast<char*>(&val),sizeof(T));
+    }
+    void putVec( ostream& os, CLHEP::Hep3Vector const& v ) {
+      put(os,v.x()); put(os,v.y()); put(os,v.z());
+    }
+    CLHEP::Hep3Vector getVec( istream& is ) {
+      double x(0), y(0), z(0);
+      get(is,x); get(is,y); get(is,z);
+      return CLHEP::Hep3Vector(x,y,z);
+    }
+  }
+
+  GeometrySnapshot::GeometrySnapshot( std::string const& filename, std::size_t configHash, int verbosity ):
+    _filename(filename), _configHash(configHash), _codeVersion(releaseVersion()), _verbosity(verbosity) {}
+
+  uint64_t GeometrySnapshot::checksum( std::string const& payload ) {
+    return fnv1aHash(payload.data(),payload.size());
+  }
+
+  // MU2E_OFFLINE_GIT_VERSION is set by GeometryService/src/SConscript
+  uint64_t GeometrySnapshot::releaseVersion() {
+#ifdef MU2E_OFFLINE_GIT_VERSION
+    string version(MU2E_OFFLINE_GIT_VERSION);
+    if ( !version.empty() ) return checksum(version);
+#endif
+    return 0;
+  }
+
+  bool GeometrySnapshot::read( StrawCollection& straws ) const {
+    if ( !enabled() ) return false;
+    ifstream in(_filename, ios::binary);
+    if ( !in ) {
+      if ( _verbosity > 0 ) cout << "GeometrySnapshot: no snapshot file " << _filename << endl;
+      return false;
+    }
+
+    Header hdr;
+    get(in,hdr);
+    if ( !in || hdr.magic != magic || hdr.version != formatVersion || hdr.configHash != _configHash ||
+         hdr.codeVersion != _codeVersion ) {
+      if ( _verbosity > 0 ) cout << "GeometrySnapshot: " << _filename
+                                 << " is stale, from another geometry or from another build, will rebuild" << endl;
+      return false;
+    }
+
+    string payload(hdr.payloadSize,'\0');
+    in.read(payload.data(),payload.size());
+    if ( !in || checksum(payload) != hdr.checksum ) {
+      if ( _verbosity > 0 ) cout << "GeometrySnapshot: " << _filename
+                                 << " failed the checksum, will rebuild" << endl;
+      return false;
+    }
+
+    istringstream ps(payload);
+    uint32_t nstraws(0);
+    get(ps,nstraws);
+    if ( nstraws != straws.size() ) return false;
+    for ( auto& straw : straws ) {
+      uint16_t sid(0);
+      float hlen(0);
+      get(ps,sid);
+      auto wmid = getVec(ps);
+      auto smid = getVec(ps);
+      auto wdir = getVec(ps);
+      auto sdir = getVec(ps);
+      get(ps,hlen);
+      straw = Straw(StrawId(sid),wmid,smid,wdir,sdir,hlen);
+    }
+    if ( !ps ) return false;
+
+    if ( _verbosity > 0 ) cout << "GeometrySnapshot: restored " << nstraws
+                               << " straws from " << _filename << endl;
+    return true;
+  }
+
+  bool GeometrySnapshot::write( StrawCollection const& straws ) const {
+    if ( !enabled() ) return false;
+    ostringstream ps;
+    put(ps,static_cast<uint32_t>(straws.size()));
+    for ( auto const& straw : straws ) {
+      put(ps,straw.id().asUint16());
+      putVec(ps,straw.wirePosition());
+      putVec(ps,straw.strawPosition());
+      putVec(ps,straw.wireDirection());
+      putVec(ps,straw.strawDirection());
+      put(ps,straw.halfLength());
+    }
+    string payload = ps.str();
+
+    Header hdr{magic,formatVersion,_configHash,_codeVersion,payload.size(),checksum(payload)};
+
+    ostringstream out;
+    put(out,hdr);
+    out << payload;
+    if ( !writeFileAtomically(_filename,out.str()) ) return false;
+    if ( _verbosity > 0 ) cout << "GeometrySnapshot: wrote " << straws.size()
+                               << " straws to " << _filename << endl;
+    return true;
+  }
+
+} // end namespace mu2e
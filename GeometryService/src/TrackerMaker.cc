@@ -38,6 +38,16 @@ namespace mu2e {
   // Constructor that gets information from the config file instead of
   // from arguments.
   TrackerMaker::TrackerMaker( SimpleConfig const& config){
+    construct(config);
+  }
+
+  TrackerMaker::TrackerMaker( SimpleConfig const& config, StrawCollection const& straws ):
+    _snapshotStraws(&straws){
+    construct(config);
+    _snapshotStraws = nullptr;
+  }
+
+  void TrackerMaker::construct( SimpleConfig const& config){
     parseConfig(config);
 
     buildIt( );
@@ -435,8 +445,12 @@ namespace mu2e {
     _z0 = -findFirstPlaneZ0();
     computeLayerSpacingAndShift();
     computeManifoldEdgeExcessSpace();
-    // fill their content
-    makeStraws(allStraws);
+    // fill their content, unless they were restored from a snapshot
+    if ( _snapshotStraws != nullptr ) {
+      allStraws = *_snapshotStraws;
+    } else {
+      makeStraws(allStraws);
+    }
     // create an empty TrackerG4Info: this gets filled further down
     auto g4trackerptr = shared_ptr<TrackerG4Info>(new TrackerG4Info);
     // see which planes actually exist.  This is deprecated, TrackerStatus should be used instead  FIXME!
@@ -3,16 +3,34 @@
 //
 // Define a sensitive detector for Straws.
 //
+// Optionally (tracker.aggregateSteps = true) the steps of each particle in each straw
+// are aggregated during tracking into a single StepPointMC, which spans from the first
+// to the last step of that particle in the straw gas.  The per-event accumulators are
+// owned by the SD instance, which is per G4 worker thread, and their storage is reused
+// from event to event.
+//
+// MakeStrawGasSteps still runs on the aggregated steps, with one step per straw and
+// particle to group: it applies the straw status, which is a run dependent condition,
+// merges the delta-rays into their parent, which needs the SimParticles of the whole
+// event, and makes the StrawGasStep to StepPointMC associations used for the MC truth.
+//
 // Original author Rob Kutschke
 //
 
+// C++ includes
+#include <unordered_map>
+#include <vector>
+
 // Mu2e includes
 #include "Offline/Mu2eG4/inc/Mu2eG4SensitiveDetector.hh"
 #include "Offline/TrackerGeom/inc/SupportModel.hh"
+#include "Offline/DataProducts/inc/StrawId.hh"
 
 
 namespace mu2e {
 
+  class Tracker;
+
   class StrawSD : public Mu2eG4SensitiveDetector{
 
   public:
@@ -20,8 +38,35 @@ namespace mu2e {
 
     G4bool ProcessHits(G4Step*, G4TouchableHistory*) override;
 
+    void Initialize(G4HCofThisEvent*) override;
+
+    void EndOfEvent(G4HCofThisEvent*) override;
+
   private:
 
+    // Accumulated content of all steps of one particle in one straw.
+    // For the first (last) step, in time, the pre-step (post-step) quantities are kept.
+    struct StepAccumulator {
+      art::Ptr<SimParticle> simp;
+      StrawId        sid;
+      double         edep = 0.0;
+      double         nonIonizingEdep = 0.0;
+      double         pathLength = 0.0;
+      double         firstTime = 0.0;
+      double         firstProperTime = 0.0;
+      double         lastTime = 0.0;
+      CLHEP::Hep3Vector firstPosition, lastPostPosition;
+      CLHEP::Hep3Vector firstMomentum, lastPostMomentum;
+      ProcessCode    endCode;
+    };
+
+    void accumulate( StrawId const& sid, G4Step const* aStep,
+                     G4ThreeVector const& prePosTracker, G4ThreeVector const& postPosTracker,
+                     ProcessCode endCode );
+
+    // Move the accumulated steps into the output collection.
+    void flushAccumulators();
+
     G4ThreeVector GetTrackerOrigin();
 
     int _nStrawsPerPlane;
@@ -35,6 +80,13 @@ namespace mu2e {
     SupportModel _supportModel;
     int _verbosityLevel;
 
+    // Aggregate the steps of each (straw,particle) pair
+    bool _aggregateSteps;
+    Tracker const* _tracker = nullptr;
+    std::vector<StepAccumulator> _accumulators;
+    // index into _accumulators, keyed by (G4 track id, straw)
+    std::unordered_map<uint64_t,size_t> _accumulatorIndex;
+
   };
 
 } // namespace mu2e
@@ -54,7 +54,8 @@ namespace mu2e {
     _nStrawsPerPanel(0),
     _TrackerVersion(0),
     _supportModel(),
-    _verbosityLevel(0)
+    _verbosityLevel(0),
+    _aggregateSteps(config.getBool("tracker.aggregateSteps",false))
   {
 
     art::ServiceHandle<GeometryService> geom;
@@ -82,6 +83,7 @@ namespace mu2e {
 
       _verbosityLevel = max(verboseLevel,config.getInt("tracker.verbosityLevel",0)); // Geant4 SD verboseLevel
       _supportModel   = tracker->g4Tracker()->getSupportModel();
+      _tracker        = tracker.get();
 
       if ( _TrackerVersion < 3 ) {
         throw cet::exception("StrawSD")
@@ -241,20 +243,24 @@ namespace mu2e {
                         findAndCount(Mu2eG4UserHelpers::findStepStoppingProcessName(aStep)));
 
 
-    _collection->push_back( StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
-                                        sid.asUint16(),
-                                        edep,
-                                        aStep->GetNonIonizingEnergyDeposit(),
-                                        0., // visible energy deposit; used in scintillators
-                                        preStepPoint->GetGlobalTime(),
-                                        preStepPoint->GetProperTime(),
-                                        prePosTracker,
-                                        postPosTracker,
-                                        preMomWorld,
-                                        aStep->GetPostStepPoint()->GetMomentum(),
-                                        stepL,
-                                        endCode
-                                        ));
+    if ( _aggregateSteps ) {
+      accumulate(sid,aStep,prePosTracker,postPosTracker,endCode);
+    } else {
+      _collection->push_back( StepPointMC(_spHelper->particlePtr(aStep->GetTrack()),
+                                          sid.asUint16(),
+                                          edep,
+                                          aStep->GetNonIonizingEnergyDeposit(),
+                                          0., // visible energy deposit; used in scintillators
+                                          preStepPoint->GetGlobalTime(),
+                                          preStepPoint->GetProperTime(),
+                                          prePosTracker,
+                                          postPosTracker,
+                                          preMomWorld,
+                                          aStep->GetPostStepPoint()->GetMomentum(),
+                                          stepL,
+                                          endCode
+                                          ));
+    }
 
     if (_verbosityLevel>3) {
 
@@ -416,6 +422,97 @@ namespace mu2e {
   }
 
 
+  void StrawSD::Initialize(G4HCofThisEvent* HCE){
+    Mu2eG4SensitiveDetector::Initialize(HCE);
+    // keep the storage: it is reused in the next event
+    _accumulators.clear();
+    _accumulatorIndex.clear();
+  }
+
+  void StrawSD::accumulate( StrawId const& sid, G4Step const* aStep,
+                            G4ThreeVector const& prePosTracker, G4ThreeVector const& postPosTracker,
+                            ProcessCode endCode ){
+
+    // skip steps in the deadened region near the end of each wire, as MakeStrawGasSteps does
+    // for individual steps, since only the first step position survives the aggregation
+    Straw const& straw = _tracker->getStraw(sid);
+    if ( fabs((prePosTracker-straw.getMidPoint()).dot(straw.getDirection())) >= straw.halfLength() ) return;
+
+    G4StepPoint const* preStepPoint = aStep->GetPreStepPoint();
+    double time = preStepPoint->GetGlobalTime();
+
+    uint64_t key = (uint64_t(aStep->GetTrack()->GetTrackID()) << 16) | sid.asUint16();
+    auto ifnd = _accumulatorIndex.find(key);
+    if ( ifnd == _accumulatorIndex.end() ) {
+      _accumulatorIndex.emplace(key,_accumulators.size());
+      StepAccumulator acc;
+      acc.simp             = _spHelper->particlePtr(aStep->GetTrack());
+      acc.sid              = sid;
+      acc.edep             = aStep->GetTotalEnergyDeposit();
+      acc.nonIonizingEdep  = aStep->GetNonIonizingEnergyDeposit();
+      acc.pathLength       = aStep->GetStepLength();
+      acc.firstTime        = acc.lastTime = time;
+      acc.firstProperTime  = preStepPoint->GetProperTime();
+      acc.firstPosition    = prePosTracker;
+      acc.lastPostPosition = postPosTracker;
+      acc.firstMomentum    = preStepPoint->GetMomentum();
+      acc.lastPostMomentum = aStep->GetPostStepPoint()->GetMomentum();
+      acc.endCode          = endCode;
+      _accumulators.push_back(acc);
+      return;
+    }
+
+    StepAccumulator& acc = _accumulators[ifnd->second];
+    acc.edep            += aStep->GetTotalEnergyDeposit();
+    acc.nonIonizingEdep += aStep->GetNonIonizingEnergyDeposit();
+    acc.pathLength      += aStep->GetStepLength();
+    if ( time < acc.firstTime ) {
+      acc.firstTime       = time;
+      acc.firstProperTime = preStepPoint->GetProperTime();
+      acc.firstPosition   = prePosTracker;
+      acc.firstMomentum   = preStepPoint->GetMomentum();
+    }
+    if ( time > acc.lastTime ) {
+      acc.lastTime         = time;
+      acc.lastPostPosition = postPosTracker;
+      acc.lastPostMomentum = aStep->GetPostStepPoint()->GetMomentum();
+      acc.endCode          = endCode;
+    }
+  }
+
+  // The aggregated StepPointMC carries the entry point and momentum of the first step and
+  // the exit point and momentum of the last step.
+  void StrawSD::flushAccumulators(){
+    _collection->reserve(_collection->size() + _accumulators.size());
+    for ( auto const& acc : _accumulators ) {
+      _collection->push_back( StepPointMC(acc.simp,
+                                          acc.sid.asUint16(),
+                                          acc.edep,
+                                          acc.nonIonizingEdep,
+                                          0., // visible energy deposit; used in scintillators
+                                          acc.firstTime,
+                                          acc.firstProperTime,
+                                          acc.firstPosition,
+                                          acc.lastPostPosition,
+                                          acc.firstMomentum,
+                                          acc.lastPostMomentum,
+                                          acc.pathLength,
+                                          acc.endCode
+                                          ));
+    }
+    if ( _verbosityLevel>1 ) {
+      G4cout << __func__ << " aggregated " << _currentSize << " steps into "
+             << _accumulators.size() << " straw/particle steps" << G4endl;
+    }
+    _accumulators.clear();
+    _accumulatorIndex.clear();
+  }
+
+  void StrawSD::EndOfEvent(G4HCofThisEvent* HCE){
+    if ( _aggregateSteps ) flushAccumulators();
+    Mu2eG4SensitiveDetector::EndOfEvent(HCE);
+  }
+
   // The previous version of this code assumed that the tracker was centered in its mother.
   // That is no longer true.
   G4ThreeVector StrawSD::GetTrackerOrigin() {
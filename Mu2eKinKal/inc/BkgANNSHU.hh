@@ -13,6 +13,7 @@
 #include <iostream>
 #include <cstddef>
 #include <memory>
+#include "tbb/enumerable_thread_specific.h"
 
 namespace TMVA_SOFIE_TrainBkg {
   class Session;
@@ -27,11 +28,17 @@ namespace mu2e {
       static std::string const& configDescription(); // description of the variables
       BkgANNSHU(Config const& config);
       WireHitState wireHitState(WireHitState const& input, KinKal::ClosestApproachData const& tpdata, DriftInfo const& dinfo, ComboHit const& chit) const;
+      size_t signature() const { return signature_; }
     private:
-      std::shared_ptr<TMVA_SOFIE_TrainBkg::Session> mva_;
+      // inference writes to buffers owned by the session, so every thread fitting tracks gets its own.  The generated
+      // Session binds its tensor pointers to its own members and can only be built from the weights file: a copy would
+      // share the inference buffers of the original.  Each thread therefore parses the (few hundred value) weights file
+      // once, at its first inference with this updater.
+      std::shared_ptr<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainBkg::Session>> mva_;
       double mvacut_ =0; // cut value to decide if drift information is usable
       WHSMask freeze_; // states to freeze
       int diag_ =0; // diag print level
+      size_t signature_ =0; // configuration signature
   };
 }
 #endif
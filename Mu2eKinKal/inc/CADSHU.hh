@@ -22,6 +22,7 @@ namespace mu2e {
       static std::string const& configDescription(); // description of the variables
       // set the state based on the current PTCA value
       WireHitState wireHitState(WireHitState const& input, KinKal::ClosestApproachData const& tpdata,DriftInfo const& dinfo) const;
+      size_t signature() const { return signature_; }
     private:
       double maxdoca_ =0; // maximum DOCA to use hit
       double maxdvar_ =0; // maximum DOCA variance to use hit
@@ -31,6 +32,7 @@ namespace mu2e {
       WHSMask freeze_; // states to freeze
       KKSHFlag flag_; // flags
       int diag_ =0; // diag print level
+      size_t signature_ =0; // configuration signature
   };
 }
 #endif
@@ -16,6 +16,7 @@
 #include <iostream>
 #include <memory>
 #include <cstddef>
+#include "tbb/enumerable_thread_specific.h"
 
 namespace mu2e {
   class ComboHit;
@@ -26,15 +27,21 @@ namespace mu2e {
       DriftANNSHU(Config const& config);
       WireHitState wireHitState(WireHitState const& input, KinKal::ClosestApproachData const& tpdata, DriftInfo const& dinfo, ComboHit const& chit) const;
       static std::string const& configDescription(); // description of the variables
+      size_t signature() const { return signature_; }
     private:
-      std::shared_ptr<TMVA_SOFIE_TrainSign::Session> signmva_; // ANN for selecting correct sign LR ambiguity
-      std::shared_ptr<TMVA_SOFIE_TrainCluster::Session> clustermva_; // ANN for selecting good cluster behavior
+      // inference writes to buffers owned by the session, so every thread fitting tracks gets its own.  The generated
+      // Session binds its tensor pointers to its own members and can only be built from the weights file: a copy would
+      // share the inference buffers of the original.  Each thread therefore parses the (few hundred value) weights file
+      // once, at its first inference with this updater.
+      std::shared_ptr<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainSign::Session>> signmva_; // ANN for selecting correct sign LR ambiguity
+      std::shared_ptr<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainCluster::Session>> clustermva_; // ANN for selecting good cluster behavior
       double signmvacut_ =0; // cut value for sign MVA
       double clustermvacut_ =0; // cut value for cluster MVA
       double dtmvacut_ =0; // cut value for using dt constraint
       KKSHFlag flag_ = KKSHFlag(KKSHFlag::tot); // constrain time with TOT by default
       WHSMask freeze_; // states to freeze
       int diag_; // diag print level
+      size_t signature_ =0; // configuration signature
   };
 }
 #endif
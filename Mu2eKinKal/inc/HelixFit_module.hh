@@ -27,10 +27,12 @@
 #include "Offline/TrkReco/inc/TrkUtilities.hh"
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 #include "Offline/GeneralUtilities/inc/OwningPointerCollection.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 // data
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/DataProducts/inc/Helicity.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/KalSeed.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
@@ -53,6 +55,10 @@
 #include "Offline/Mu2eKinKal/inc/KKBField.hh"
 #include "Offline/Mu2eKinKal/inc/KKConstantBField.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+// tbb
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 // root
 #include "TH1F.h"
 #include "TTree.h"
@@ -102,6 +108,7 @@ namespace mu2e {
     fhicl::Atom<bool> saveFull { Name("SaveFullFit"), Comment("Save all helix segments associated with the fit"), false};
     fhicl::Sequence<float> zsave { Name("ZSavePositions"), Comment("Z positions to sample and save the fit result helices"), std::vector<float>()};
     fhicl::OptionalAtom<double> fixedBField { Name("ConstantBField"), Comment("Constant BField value") };
+    fhicl::Atom<unsigned> fitThreads { Name("FitThreads"), Comment("Maximum number of threads fitting the seeds of an event concurrently: 0 for all the job threads, 1 to fit them in sequence"), 0 };
  };
 
   struct GlobalConfig {
@@ -125,6 +132,16 @@ namespace mu2e {
       virtual KTRAJ makeSeedTraj(HelixSeed const& hseed) const = 0;
       virtual bool goodFit(KKTRK const& ktrk) const = 0;
       void fillSaveTimes(KKTRK const& ktrk,std::set<double>& savetimes) const;
+      // fit of a single helix seed.  The fits of an event are independent and can run concurrently
+      struct SeedFit {
+        HelixSeed const* hseed = nullptr;
+        HPtr hptr;
+        StrawHitIndexCollection strawHitIdxs;
+        std::unique_ptr<KKTRK> kktrk;
+        bool goodfit = false;
+      };
+      void fitSeed(SeedFit& seedfit, Tracker const& tracker, StrawResponse const& strawresponse, ComboHitCollection const& chcol,
+          Calorimeter const& calo, CCHandle const& cc_H) const;
       // data payload
       std::vector<art::ProductToken<HelixSeedCollection>> hseedCols_;
       art::ProductToken<ComboHitCollection> chcol_T_;
@@ -145,6 +162,8 @@ namespace mu2e {
       Config config_; // initial fit configuration object
       Config exconfig_; // extension configuration object
       bool fixedfield_; //
+      unsigned fitthreads_; // maximum number of concurrent fits
+      tbb::task_arena arena_; // limits the fits of this module to fitthreads_
   };
 
   HelixFit::HelixFit(const Parameters& settings,TrkFitFlag fitflag) : art::EDProducer{settings},
@@ -161,12 +180,15 @@ namespace mu2e {
     kkmat_(settings().matSettings()),
     config_(Mu2eKinKal::makeConfig(settings().kkFitSettings())),
     exconfig_(Mu2eKinKal::makeConfig(settings().kkExtSettings())),
-    fixedfield_(false)
+    fixedfield_(false),
+    fitthreads_(settings().modSettings().fitThreads()),
+    arena_(fitthreads_ > 0 ? static_cast<int>(fitthreads_) : tbb::task_arena::automatic)
     {
       if((!savefull_) && zsave_.size() == 0)
         throw cet::exception("RECO")<<"mu2e::HelixFit:Segment saving configuration error"<< endl;
       // collection handling
       for(const auto& hseedtag : settings().modSettings().helixSeedCollections()) { hseedCols_.emplace_back(consumes<HelixSeedCollection>(hseedtag)); }
+      consumesMany<ComboHitStrawIndex>(); // for the StrawHits of the seed hits
       produces<KKTRKCOL>();
       produces<KalSeedCollection>();
       produces<KalHelixAssns>();
@@ -200,6 +222,7 @@ namespace mu2e {
   }
 
   void HelixFit::produce(art::Event& event ) {
+    MU2E_PROFILE_SCOPE("HelixFit::produce");
     GeomHandle<Calorimeter> calo_h;
     // find current proditions
     auto const& strawresponse = strawResponse_h_.getPtr(event.id());
@@ -214,8 +237,10 @@ namespace mu2e {
     unique_ptr<KalHelixAssns> kkseedassns(new KalHelixAssns());
     auto KalSeedCollectionPID = event.getProductID<KalSeedCollection>();
     auto KalSeedCollectionGetter = event.productGetter(KalSeedCollectionPID);
-    // find the helix seed collections
+    // find the helix seed collections, and collect the seeds to fit.  Unwinding the combohits needs the event, so it is done here
     unsigned nhelix(0);
+    std::vector<SeedFit> seedfits;
+    ComboHitStrawIndexCache shindexcache(event);
     for (auto const& hseedtag : hseedCols_) {
       auto const& hseedcol_h = event.getValidHandle<HelixSeedCollection>(hseedtag);
       auto const& hseedcol = *hseedcol_h;
@@ -223,67 +248,98 @@ namespace mu2e {
       // loop over the seeds
       for(size_t iseed=0; iseed < hseedcol.size(); ++iseed) {
         auto const& hseed = hseedcol[iseed];
-        auto hptr = HPtr(hseedcol_h,iseed);
         // check helicity.  The test on the charge and helicity
         if(hseed.status().hasAllProperties(goodhelix_) ){
-          // construt the seed trajectory
-          KTRAJ seedtraj = makeSeedTraj(hseed);
-          // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
-          PKTRAJ pseedtraj(seedtraj);
+          seedfits.emplace_back();
+          auto& seedfit = seedfits.back();
+          seedfit.hseed = &hseed;
+          seedfit.hptr = HPtr(hseedcol_h,iseed);
           // first, we need to unwind the combohits.  We use this also to find the time range
-          StrawHitIndexCollection strawHitIdxs;
           auto const& hhits = hseed.hits();
-          for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ hhits.fillStrawHitIndices(event,ihit,strawHitIdxs); }
-          // next, build straw hits and materials from these
-          KKSTRAWHITCOL strawhits;
-          KKSTRAWXINGCOL strawxings;
-          strawhits.reserve(hhits.size());
-          strawxings.reserve(hhits.size());
-          kkfit_.makeStrawHits(*tracker, *strawresponse, *kkbf_, kkmat_.strawMaterial(), pseedtraj, chcol, strawHitIdxs, strawhits, strawxings);
-          // optionally (and if present) add the CaloCluster hi
-          // verify the cluster looks physically reasonable before adding it TODO!  Or, let the KKCaloHit updater do it TODO
-          KKCALOHITCOL calohits;
-          if (kkfit_.useCalo() && hseed.caloCluster().isNonnull())kkfit_.makeCaloHit(hseed.caloCluster(),*calo_h, pseedtraj, calohits);
-          // extend the seed range given the hits and xings
-          seedtraj.range() = kkfit_.range(strawhits,calohits,strawxings);
-          // create and fit the track
-          auto kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,kkfit_.fitParticle(),kkfit_.strawHitClusterer(),strawhits,strawxings,calohits);
-          // Check the fit
-          auto goodfit = goodFit(*kktrk);
-          // if we have an extension schedule, extend.
-          if(goodfit && exconfig_.schedule().size() > 0) {
-            kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
-            goodfit = goodFit(*kktrk);
-          }
-          if(print_>0)kktrk->printFit(std::cout,print_);
-          if(goodfit || saveall_){
-            TrkFitFlag fitflag(hptr->status());
-            fitflag.merge(fitflag_);
-            if(goodfit)
-              fitflag.merge(TrkFitFlag::FitOK);
-            else
-              fitflag.clear(TrkFitFlag::FitOK);
-            // Decide which segments to save
-            std::set<double> savetimes;
-            fillSaveTimes(*kktrk,savetimes);
-            kkseedcol->push_back(kkfit_.createSeed(*kktrk,fitflag,*calo_h,savetimes));
-            // fill assns with the helix seed
-            auto hptr = art::Ptr<HelixSeed>(hseedcol_h,iseed);
-            auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
-            kkseedassns->addSingle(kseedptr,hptr);
-            // save (unpersistable) KKTrk in the event
-            kktrkcol->push_back(kktrk.release());
-          }
+          for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ shindexcache.fillStrawHitIndices(hhits,ihit,seedfit.strawHitIdxs); }
+          // resolve the calo cluster reference before the fits
+          if (kkfit_.useCalo() && hseed.caloCluster().isNonnull()) hseed.caloCluster().get();
         }
       }
     }
+    // fit the seeds.  Each fit owns its result, which are saved below in seed order, so the output doesn't depend on the number of threads.
+    // Printout is only readable from a sequential fit
+    {
+      MU2E_PROFILE_SCOPE("HelixFit::fitSeeds");
+      auto fitSeeds = [&](tbb::blocked_range<size_t> const& range) {
+        for(size_t ifit = range.begin(); ifit != range.end(); ++ifit) fitSeed(seedfits[ifit], *tracker, *strawresponse, chcol, *calo_h, cc_H);
+      };
+      if(fitthreads_ == 1 || print_ > 0 || seedfits.size() < 2)
+        fitSeeds(tbb::blocked_range<size_t>(0,seedfits.size()));
+      else
+        arena_.execute([&](){ tbb::parallel_for(tbb::blocked_range<size_t>(0,seedfits.size(),1),fitSeeds); });
+    }
+    MU2E_PROFILE_COUNT("HelixFit::fits",seedfits.size());
+    for(auto& seedfit : seedfits) {
+      auto& kktrk = seedfit.kktrk;
+      auto goodfit = seedfit.goodfit;
+      if(print_>0)kktrk->printFit(std::cout,print_);
+      if(goodfit || saveall_){
+        TrkFitFlag fitflag(seedfit.hseed->status());
+        fitflag.merge(fitflag_);
+        if(goodfit)
+          fitflag.merge(TrkFitFlag::FitOK);
+        else
+          fitflag.clear(TrkFitFlag::FitOK);
+        // Decide which segments to save
+        std::set<double> savetimes;
+        fillSaveTimes(*kktrk,savetimes);
+        kkseedcol->push_back(kkfit_.createSeed(*kktrk,fitflag,*calo_h,savetimes));
+        // fill assns with the helix seed
+        auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
+        kkseedassns->addSingle(kseedptr,seedfit.hptr);
+        // save (unpersistable) KKTrk in the event
+        kktrkcol->push_back(kktrk.release());
+      }
+    }
     // put the output products into the event
+    MU2E_PROFILE_COUNT("HelixFit::tracks",kktrkcol->size());
     if(print_ > 0) std::cout << "Fitted " << kktrkcol->size() << " tracks from " << nhelix << " Helices" << std::endl;
     event.put(move(kktrkcol));
     event.put(move(kkseedcol));
     event.put(move(kkseedassns));
   }
 
+  void HelixFit::fitSeed(SeedFit& seedfit, Tracker const& tracker, StrawResponse const& strawresponse, ComboHitCollection const& chcol,
+      Calorimeter const& calo, CCHandle const& cc_H) const {
+    auto const& hseed = *seedfit.hseed;
+    // construt the seed trajectory
+    KTRAJ seedtraj = makeSeedTraj(hseed);
+    // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
+    PKTRAJ pseedtraj(seedtraj);
+    // next, build straw hits and materials from these
+    KKSTRAWHITCOL strawhits;
+    KKSTRAWXINGCOL strawxings;
+    strawhits.reserve(seedfit.strawHitIdxs.size());
+    strawxings.reserve(seedfit.strawHitIdxs.size());
+    kkfit_.makeStrawHits(tracker, strawresponse, *kkbf_, kkmat_.strawMaterial(), pseedtraj, chcol, seedfit.strawHitIdxs, strawhits, strawxings);
+    // optionally (and if present) add the CaloCluster hi
+    // verify the cluster looks physically reasonable before adding it TODO!  Or, let the KKCaloHit updater do it TODO
+    KKCALOHITCOL calohits;
+    if (kkfit_.useCalo() && hseed.caloCluster().isNonnull())kkfit_.makeCaloHit(hseed.caloCluster(),calo, pseedtraj, calohits);
+    // extend the seed range given the hits and xings
+    seedtraj.range() = kkfit_.range(strawhits,calohits,strawxings);
+    // create and fit the track
+    auto& kktrk = seedfit.kktrk;
+    {
+      MU2E_PROFILE_SCOPE("HelixFit::fit");
+      kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,kkfit_.fitParticle(),kkfit_.strawHitClusterer(),strawhits,strawxings,calohits);
+    }
+    // Check the fit
+    seedfit.goodfit = goodFit(*kktrk);
+    // if we have an extension schedule, extend.
+    if(seedfit.goodfit && exconfig_.schedule().size() > 0) {
+      MU2E_PROFILE_SCOPE("HelixFit::extendTrack");
+      kkfit_.extendTrack(exconfig_,*kkbf_, tracker,strawresponse, kkmat_.strawMaterial(), chcol, calo, cc_H, *kktrk );
+      seedfit.goodfit = goodFit(*kktrk);
+    }
+  }
+
   void HelixFit::fillSaveTimes(KKTRK const& ktrk,std::set<double>& savetimes) const {
     auto const& fittraj = ktrk.fitTraj();
     if(savefull_){ // loop over all pieces of the fit trajectory and record their times
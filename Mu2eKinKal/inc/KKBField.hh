@@ -8,6 +8,8 @@
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 // KinKal includes
 #include "KinKal/General/BFieldMap.hh"
+// tbb
+#include "tbb/enumerable_thread_specific.h"
 
 namespace mu2e
 {
@@ -17,7 +19,7 @@ namespace mu2e
       using Grad = ROOT::Math::SMatrix<double,3>; // field gradient: ie dBi/d(x,y,z)
       // construct from BField object and system translator.
       // This should be a single BField map valid in the detector system, to avoid making continuous translations FIXME!
-      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det) : bfmgr_(bfmgr), det_(det) {}
+      KKBField(BFieldManager const& bfmgr, DetectorSystem const& det) : bfmgr_(bfmgr), det_(det), cache_(bfmgr.cacheManager()) {}
       virtual ~KKBField() {}
       // KinKal BField interface
       // return value of the field at a poin
@@ -32,6 +34,8 @@ namespace mu2e
     private:
       BFieldManager const& bfmgr_;
       DetectorSystem const& det_;
+      // the map lookup cache remembers the last map used, so each thread needs its own to fit tracks concurrently
+      mutable tbb::enumerable_thread_specific<BFCacheManager> cache_;
   };
 }
 #endif
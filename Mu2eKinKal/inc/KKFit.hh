@@ -37,6 +37,7 @@
 // Other
 #include "cetlib_except/exception.h"
 #include <memory>
+#include <mutex>
 #include <cmath>
 #include <algorithm>
 namespace mu2e {
@@ -125,12 +126,13 @@ namespace mu2e {
       float maxStrawHitDoca_, maxStrawHitDt_, maxStrawDoca_, maxStrawDocaCon_;
       int sbuff_; // maximum distance from the track a strawhit can be to consider it for adding.
       int printLevel_;
-      // cached info computed from the tracker, used in hit adding; these must be lazy-evaluated as the tracker doesn't exist on construction
+      // cached info computed from the tracker, used in hit adding; these must be lazy-evaluated as the tracker doesn't exist on construction.
+      // Tracks can be extended concurrently, so this is done exactly once
       mutable double strawradius_;
       mutable double ymin_, ymax_, umax_; // panel-level info
       mutable double rmin_, rmax_; // plane-level info
       mutable double spitch_;
-      mutable bool needstrackerinfo_;
+      mutable std::once_flag trackerinfo_;
   };
 
   template <class KTRAJ> KKFit<KTRAJ>::KKFit(Mu2eConfig const& fitconfig) :
@@ -156,8 +158,7 @@ namespace mu2e {
     maxStrawDoca_(fitconfig.maxStrawDOCA()),
     maxStrawDocaCon_(fitconfig.maxStrawDOCAConsistency()),
     sbuff_(fitconfig.strawBuffer()),
-    printLevel_(fitconfig.printLevel()),
-    needstrackerinfo_(true)
+    printLevel_(fitconfig.printLevel())
   {}
 
   template <class KTRAJ> void KKFit<KTRAJ>::makeStrawHits(Tracker const& tracker,StrawResponse const& strawresponse,BFieldMap const& kkbf, KKStrawMaterial const& smat,
@@ -279,7 +280,7 @@ namespace mu2e {
     // build the set of existing straws
     auto const& ftraj = kktrk.fitTraj();
     // pre-compute some tracker info if needed
-    if(needstrackerinfo_)fillTrackerInfo(tracker);
+    std::call_once(trackerinfo_,[this,&tracker](){ fillTrackerInfo(tracker); });
     // list the IDs of existing straws: this speeds the search
     std::set<StrawId> oldstraws;
     for(auto const& strawxing : kktrk.strawXings())oldstraws.insert(strawxing->strawId());
@@ -418,7 +419,6 @@ namespace mu2e {
     rmin_ = innerstraw_origin.y() - sbuff_*strawradius_;
     rmax_ = outerstraw.wireEnd(StrawEnd::cal).mag() + sbuff_*strawradius_;
     spitch_ = (StrawId::_nstraws-1)/(ymax_-ymin_);
-    needstrackerinfo_= false;
   }
 
 
@@ -6,6 +6,7 @@
 #include "fhiclcpp/types/Atom.h"
 #include "fhiclcpp/types/Sequence.h"
 #include "fhiclcpp/types/OptionalSequence.h"
+#include "fhiclcpp/types/OptionalTuple.h"
 #include "fhiclcpp/types/Tuple.h"
 #include "KinKal/Fit/Config.hh"
 #include "KinKal/Fit/MetaIterConfig.hh"
@@ -17,6 +18,7 @@
 #include "Offline/Mu2eKinKal/inc/BkgANNSHU.hh"
 #include "Offline/Mu2eKinKal/inc/Chi2SHU.hh"
 #include "Offline/Mu2eKinKal/inc/StrawXingUpdater.hh"
+#include "Offline/Mu2eKinKal/inc/StrawHitUpdateTolerance.hh"
 namespace mu2e {
   namespace Mu2eKinKal{
 
@@ -49,6 +51,8 @@ namespace mu2e {
       Chi2SHUSettings combishuConfig{ Name("Chi2SHUSettings"), Comment(Chi2SHU::configDescription()) };
       using StrawXingUpdaterSettings = fhicl::Sequence<fhicl::Tuple<float,float,float,bool,int>>;
       StrawXingUpdaterSettings sxuConfig{ Name("StrawXingUpdaterSettings"), Comment(StrawXingUpdater::configDescription()) };
+      using StrawHitUpdateToleranceSettings = fhicl::OptionalTuple<float,float,float>;
+      StrawHitUpdateToleranceSettings shutolConfig{ Name("StrawHitUpdateTolerance"), Comment("Incremental StrawHit updates, re-evaluating the state only of hits that moved. " + StrawHitUpdateTolerance::configDescription()) };
     };
     // function to convert fhicl configuration to KinKal Config object
     KinKal::Config makeConfig(KinKalConfig const& fconfig);
@@ -10,6 +10,8 @@
 #include "KinKal/MatEnv/MatDBInfo.hh"
 #include "Offline/Mu2eKinKal/inc/KKStrawMaterial.hh"
 #include "Offline/Mu2eKinKal/inc/KKFileFinder.hh"
+#include <memory>
+#include <mutex>
 #include <string>
 namespace mu2e {
   class KKMaterial {
@@ -37,6 +39,7 @@ namespace mu2e {
       MatEnv::DetMaterial::energylossmode eloss_;
       mutable MatDBInfo* matdbinfo_; // material database
       mutable std::unique_ptr<KKStrawMaterial> smat_; // straw material
+      mutable std::once_flag smatflag_; // straw material is built on first use, possibly from concurrent fits
   };
 }
 #endif
@@ -23,7 +23,9 @@
 #include "Offline/Mu2eKinKal/inc/BkgANNSHU.hh"
 #include "Offline/Mu2eKinKal/inc/Chi2SHU.hh"
 #include "Offline/Mu2eKinKal/inc/StrawHitUpdaters.hh"
+#include "Offline/Mu2eKinKal/inc/StrawHitUpdateTolerance.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 // Other
 #include "cetlib_except/exception.h"
 #include <memory>
@@ -92,6 +94,13 @@ namespace mu2e {
       StrawHitIndex shindex_; // index to the StrawHit
       Straw const& straw_; // reference to straw of this hit
       StrawResponse const& sresponse_; // straw calibration information
+      // unbiased closest approach and updaters used the last time the state was evaluated, for incremental updates
+      struct WHSInputs {
+        double doca_ =0, docaerr_ =0, ptoca_ =0, stoca_ =0;
+        size_t updaters_ =0; // combined updater signature
+        bool valid_ = false;
+      };
+      WHSInputs whsinputs_;
       // utility functions
       void updateWHS(MetaIterConfig const& miconfig);
   };
@@ -143,13 +152,35 @@ namespace mu2e {
     auto cashu = miconfig.findUpdater<CADSHU>();
     auto annshu = miconfig.findUpdater<DriftANNSHU>();
     auto bkgshu = miconfig.findUpdater<BkgANNSHU>();
+    auto shutol = miconfig.findUpdater<StrawHitUpdateTolerance>();
     CA ca = unbiasedClosestApproach();
     if(ca.usable()){
+      WHSInputs inputs;
+      inputs.doca_ = ca.doca();
+      inputs.docaerr_ = sqrt(std::max(0.0,ca.docaVar()));
+      inputs.ptoca_ = ca.tpData().particleToca();
+      inputs.stoca_ = ca.tpData().sensorToca();
+      inputs.updaters_ = StrawHitUpdaters::signature(StrawHitUpdaters::none,
+          std::make_tuple(cashu ? cashu->signature() : 0, annshu ? annshu->signature() : 0, bkgshu ? bkgshu->signature() : 0));
+      inputs.valid_ = true;
+      // incremental update: keep the state if the same updaters already set it from (nearly) the same closest approach
+      bool keep = shutol && whsinputs_.valid_ && whsinputs_.updaters_ == inputs.updaters_ && whstate_.usable() &&
+        fabs(inputs.doca_ - whsinputs_.doca_) < shutol->maxddoca_ &&
+        fabs(inputs.docaerr_ - whsinputs_.docaerr_) < shutol->maxddocaerr_ &&
+        fabs(inputs.ptoca_ - whsinputs_.ptoca_) < shutol->maxdt_ &&
+        fabs(inputs.stoca_ - whsinputs_.stoca_) < shutol->maxdt_;
       auto dinfo = fillDriftInfo();
-      // there can be multiple updaters: apply them all
-      if(bkgshu)whstate_ = bkgshu->wireHitState(whstate_,ca.tpData(),dinfo,chit_);
-      if(cashu)whstate_ = cashu->wireHitState(whstate_,ca.tpData(),dinfo);
-      if(annshu)whstate_ = annshu->wireHitState(whstate_,ca.tpData(),dinfo,chit_);
+      if(keep){
+        MU2E_PROFILE_COUNT("KKStrawHit::statesKept",1);
+      } else {
+        MU2E_PROFILE_COUNT("KKStrawHit::statesEvaluated",1);
+        whsinputs_ = inputs;
+        // there can be multiple updaters: apply them all
+        if(bkgshu)whstate_ = bkgshu->wireHitState(whstate_,ca.tpData(),dinfo,chit_);
+        if(cashu)whstate_ = cashu->wireHitState(whstate_,ca.tpData(),dinfo);
+        if(annshu)whstate_ = annshu->wireHitState(whstate_,ca.tpData(),dinfo,chit_);
+      }
+      // the drift derivative and variance always follow the current closest approach, even when the state is kept
       if(whstate_.driftConstraint()){
         if(whstate_.constrainDriftDt())
           dDdT_ = dinfo.driftVelocity_;
@@ -166,6 +197,7 @@ namespace mu2e {
     } else {
       whstate_.algo_ = StrawHitUpdaters::unknown;
       whstate_.state_ = WireHitState::unusable;
+      whsinputs_.valid_ = false;
     }
   }
 
@@ -179,6 +211,7 @@ namespace mu2e {
 
   template <class KTRAJ> void KKStrawHit<KTRAJ>::setState(WireHitState const& whstate) {
     whstate_ = whstate;
+    whsinputs_.valid_ = false; // set from outside, the next update must evaluate it
   }
 
   template <class KTRAJ> DriftInfo KKStrawHit<KTRAJ>::fillDriftInfo() const {
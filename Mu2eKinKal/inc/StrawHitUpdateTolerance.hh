@@ -0,0 +1,21 @@
+#ifndef Mu2eKinKal_StrawHitUpdateTolerance_hh
+#define Mu2eKinKal_StrawHitUpdateTolerance_hh
+//
+// Tolerances for incremental StrawHit state updates.  When present in a meta-iteration configuration, a StrawHit
+// whose state was last set by updaters with the same configuration keeps that state if its unbiased closest approach
+// changed by less than these tolerances since then, instead of being re-evaluated
+//
+#include <tuple>
+#include <string>
+
+namespace mu2e {
+  struct StrawHitUpdateTolerance {
+    using Config = std::tuple<float,float,float>;
+    static std::string const& configDescription(); // description of the variables
+    StrawHitUpdateTolerance(Config const& config);
+    double maxddoca_ =0; // maximum DOCA change (mm)
+    double maxddocaerr_ =0; // maximum DOCA error change (mm)
+    double maxdt_ =0; // maximum change of the particle and sensor TOCA (ns)
+  };
+}
+#endif
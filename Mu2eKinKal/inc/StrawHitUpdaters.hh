@@ -3,7 +3,10 @@
 //
 #ifndef Mu2eKinKal_StrawHitUpdaters_hh
 #define Mu2eKinKal_StrawHitUpdaters_hh
+#include <cstddef>
+#include <functional>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace mu2e {
@@ -14,6 +17,15 @@ namespace mu2e {
     static std::string const& name(algorithm alg);
     static algorithm algo(std::string const& name);
     static std::vector<std::string> names_;
+    // signature of an updater configuration, to recognize the same updater in different meta-iterations
+    template <class CONFIG> static size_t signature(algorithm alg, CONFIG const& config);
   };
+
+  template <class CONFIG> size_t StrawHitUpdaters::signature(algorithm alg, CONFIG const& config) {
+    size_t sig = std::hash<int>()(alg);
+    std::apply([&sig](auto const&... par){
+        ((sig ^= std::hash<std::decay_t<decltype(par)>>()(par) + 0x9e3779b9 + (sig << 6) + (sig >> 2)), ...); }, config);
+    return sig;
+  }
 }
 #endif
@@ -12,10 +12,12 @@ namespace mu2e {
   BkgANNSHU::BkgANNSHU(Config const& config) {
     ConfigFileLookupPolicy configFile;
     auto mvaWgtsFile = configFile(std::get<0>(config));
-    mva_ = std::make_shared<TMVA_SOFIE_TrainBkg::Session>(mvaWgtsFile);
+    mva_ = std::make_shared<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainBkg::Session>>(mvaWgtsFile);
+    mva_->local(); // this thread reads the weights now, to catch configuration errors
     mvacut_ = std::get<1>(config);
     std::string freeze = std::get<2>(config);
     diag_ = std::get<3>(config);
+    signature_ = StrawHitUpdaters::signature(StrawHitUpdaters::BkgANN,config);
     freeze_ = WHSMask(freeze);
     if(diag_ > 0)std::cout << "BkgANNSHU weights " << std::get<0>(config) << " cut " << mvacut_ << " freeze " << freeze_ << std::endl;
   }
@@ -38,7 +40,7 @@ namespace mu2e {
       double upos = -endsign*tpdata.sensorDirection().Dot(tpdata.sensorPoca().Vect() - chit.centerPos());
       pars[5] = fabs(chit.wireDist() - upos);
       pars[6] = tpdata.particlePoca().Vect().Rho();
-      auto mvaout = mva_->infer(pars.data());
+      auto mvaout = mva_->local().infer(pars.data());
       whstate.quality_[WireHitState::bkg] = mvaout[0];
       if(diag_ > 2){
         whstate.algo_  = StrawHitUpdaters::BkgANN;
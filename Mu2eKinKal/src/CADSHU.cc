@@ -17,6 +17,7 @@ namespace mu2e {
     std::string freeze = std::get<6>(config);
     freeze_ = WHSMask(freeze);
     diag_ = std::get<7>(config);
+    signature_ = StrawHitUpdaters::signature(StrawHitUpdaters::CAD,config);
     if(diag_ > 0)std::cout << "CADSHU max doca, doca error " << maxdoca_ << " " << maxdocaerr
       << " rdrift range [" << minrdrift_ << "," << maxrdrift_ << "] Allowing "
         << allowed_ << " Freezing " << freeze_ << " Flags " << flag
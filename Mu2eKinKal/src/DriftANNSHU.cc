@@ -10,10 +10,12 @@ namespace mu2e {
   DriftANNSHU::DriftANNSHU(Config const& config) {
     ConfigFileLookupPolicy configFile;
     auto signmvaWgtsFile = configFile(std::get<0>(config));
-    signmva_ = std::make_shared<TMVA_SOFIE_TrainSign::Session>(signmvaWgtsFile);
+    signmva_ = std::make_shared<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainSign::Session>>(signmvaWgtsFile);
+    signmva_->local(); // this thread reads the weights now, to catch configuration errors
     signmvacut_ = std::get<1>(config);
     auto clustermvaWgtsFile = configFile(std::get<2>(config));
-    clustermva_ = std::make_shared<TMVA_SOFIE_TrainCluster::Session>(clustermvaWgtsFile);
+    clustermva_ = std::make_shared<tbb::enumerable_thread_specific<TMVA_SOFIE_TrainCluster::Session>>(clustermvaWgtsFile);
+    clustermva_->local();
     clustermvacut_ = std::get<3>(config);
     dtmvacut_ = std::get<4>(config);
     std::string freeze = std::get<5>(config);
@@ -21,6 +23,7 @@ namespace mu2e {
     std::string flag = std::get<6>(config);
     flag_ = KKSHFlag(flag);
     diag_ = std::get<7>(config);
+    signature_ = StrawHitUpdaters::signature(StrawHitUpdaters::DriftANN,config);
     if(diag_ > 0)
       std::cout << "DriftANNSHU LR sign weights " << std::get<0>(config) << " cut " << signmvacut_
         << " cluster weights " << std::get<0>(config) << " cut " << clustermvacut_ << " dt cut " << dtmvacut_
@@ -47,14 +50,14 @@ namespace mu2e {
       // For sign, noralize only to the crossing angle, as there it serves as an estimate of the drift radius
       double sint = sqrt(1.0-tpdata.dirDot()*tpdata.dirDot());
       spars[4] = chit.energyDep()*sint;
-      auto signmvaout = signmva_->infer(spars.data());
+      auto signmvaout = signmva_->local().infer(spars.data());
       cpars[0] = fabs(tpdata.doca());
       cpars[1] = dinfo.cDrift_;
       cpars[2] = chit.driftTime();
       // For drift quality, normalize to the estimated path length through the straw, as that measures the clustering effects
       double plen = sqrt(std::max(0.25, 6.25-dinfo.rDrift_*dinfo.rDrift_))/sint;
       cpars[3] = chit.energyDep()/plen;
-      auto clustermvaout = clustermva_->infer(cpars.data());
+      auto clustermvaout = clustermva_->local().infer(cpars.data());
       if(diag_ > 1)std::cout << std::setw(8) << std::setprecision(5)
         << "ANN inputs: doca, cdrift, sigdoca, TOTdrift, EDep "
           << spars[0] << " , "
@@ -10,7 +10,7 @@ namespace mu2e {
     CLHEP::Hep3Vector vpoint_mu2e = det_.toMu2e(vpoint);
     CLHEP::Hep3Vector field;
     //    = bfmgr_.getBField(vpoint_mu2e);
-    if(bfmgr_.getBFieldWithStatus(vpoint_mu2e,field))
+    if(bfmgr_.getBFieldWithStatus(vpoint_mu2e,cache_.local(),field))
       return VEC3(field);
     else
 // see if there's no maps; that says this is the no-field case
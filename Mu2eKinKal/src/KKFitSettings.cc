@@ -34,6 +34,9 @@ namespace mu2e {
       chi2shusettings = fitconfig.combishuConfig().value_or(chi2shusettings);
       // straw material updater must always be here
       auto const& sxusettings = fitconfig.sxuConfig();
+      // optional incremental StrawHit updates
+      StrawHitUpdateTolerance::Config shutolsettings;
+      bool incremental = fitconfig.shutolConfig(shutolsettings);
       // set the schedule for the meta-iterations
       unsigned ncadshu(0), nann(0), nbkg(0), ncomb(0), nnone(0), nsxu(0);
       for(auto const& misetting : fitconfig.miConfig()) {
@@ -60,6 +63,7 @@ namespace mu2e {
         // pad straw xing updaters if necessary
         miconfig.addUpdater(std::any(StrawXingUpdater(sxusettings.at(nsxu))));
         if(sxusettings.size()> nsxu+1)nsxu++;
+        if(incremental)miconfig.addUpdater(std::any(StrawHitUpdateTolerance(shutolsettings)));
         config.schedule_.push_back(miconfig);
       }
       // consistency checks
@@ -22,7 +22,7 @@ namespace mu2e {
     }
 
   KKStrawMaterial const& KKMaterial::strawMaterial() const {
-    if(smat_ == 0){
+    std::call_once(smatflag_,[this](){
       Tracker const & tracker = *(GeomHandle<Tracker>());
       auto const& sprop = tracker.strawProperties();
       smat_ = std::make_unique<KKStrawMaterial>(
@@ -30,7 +30,7 @@ namespace mu2e {
           matdbinfo_->findDetMaterial(wallmatname_),
           matdbinfo_->findDetMaterial(gasmatname_),
           matdbinfo_->findDetMaterial(wirematname_));
-    }
+    });
     return *smat_;
   }
 }
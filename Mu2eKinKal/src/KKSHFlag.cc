@@ -14,14 +14,16 @@ namespace mu2e {
   }
 
   std::map<std::string,KKSHFlagDetail::mask_type> const& KKSHFlagDetail::bitNames() {
-    static std::map<std::string,mask_type> bitnames;
-    if(bitnames.size()==0){
-      bitnames[std::string("TOT")]              = bit_to_mask(tot);
-      bitnames[std::string("AbsDrift")]         = bit_to_mask(absdrift);
-      bitnames[std::string("DriftDt")]          = bit_to_mask(driftdt);
-      bitnames[std::string("NullDriftVar")]     = bit_to_mask(nhdrift);
-      bitnames[std::string("ANNProb")]          = bit_to_mask(annprob);
-    }
+    // initialized once, also when first called from concurrent fits
+    static const std::map<std::string,mask_type> bitnames = [](){
+      std::map<std::string,mask_type> names;
+      names[std::string("TOT")]              = bit_to_mask(tot);
+      names[std::string("AbsDrift")]         = bit_to_mask(absdrift);
+      names[std::string("DriftDt")]          = bit_to_mask(driftdt);
+      names[std::string("NullDriftVar")]     = bit_to_mask(nhdrift);
+      names[std::string("ANNProb")]          = bit_to_mask(annprob);
+      return names;
+    }();
     return bitnames;
   }
 }
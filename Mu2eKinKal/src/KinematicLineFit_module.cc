@@ -31,6 +31,7 @@
 #include "Offline/DataProducts/inc/PDGCode.hh"
 #include "Offline/DataProducts/inc/Helicity.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/CosmicTrackSeed.hh"
 #include "Offline/RecoDataProducts/inc/KalSeed.hh"
@@ -49,6 +50,11 @@
 #include "Offline/Mu2eKinKal/inc/KKStrawHit.hh"
 #include "Offline/Mu2eKinKal/inc/KKBField.hh"
 #include "Offline/Mu2eKinKal/inc/KKFitUtilities.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
+// tbb
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
 // root
 #include "TH1F.h"
 #include "TTree.h"
@@ -114,6 +120,7 @@ namespace mu2e {
       fhicl::Atom<bool> saveFull { Name("SaveFullFit"), Comment("Save all track segments associated with the fit"), false};
       fhicl::Sequence<float> zsave { Name("ZSavePositions"), Comment("Z positions to sample and save the fit result helices"), std::vector<float>()};
       fhicl::Sequence<std::string> addHitFlags { Name("AddHitFlags"), Comment("Flags required to be present to add a hit"), std::vector<std::string>() };
+      fhicl::Atom<unsigned> fitThreads { Name("FitThreads"), Comment("Maximum number of threads fitting the seeds of an event concurrently: 0 for all the job threads, 1 to fit them in sequence"), 0 };
     };
 
     struct GlobalConfig {
@@ -136,6 +143,15 @@ namespace mu2e {
     // utility functions
     KTRAJ makeSeedTraj(CosmicTrackSeed const& hseed) const;
     bool goodFit(KKTRK const& ktrk) const;
+    // fit of a single cosmic seed.  The fits of an event are independent and can run concurrently
+    struct SeedFit {
+      CosmicTrackSeed const* hseed = nullptr;
+      HPtr hptr;
+      StrawHitIndexCollection strawHitIdxs;
+      std::unique_ptr<KKTRK> kktrk;
+    };
+    void fitSeed(SeedFit& seedfit, Tracker const& tracker, StrawResponse const& strawresponse, ComboHitCollection const& chcol,
+        Calorimeter const& calo, CCHandle const& cc_H) const;
     // data payload
     std::vector<art::ProductToken<CosmicTrackSeedCollection>> hseedCols_;
     art::ProductToken<ComboHitCollection> chcol_T_;
@@ -158,6 +174,8 @@ namespace mu2e {
     std::unique_ptr<KKBField> kkbf_;
     Config config_; // initial fit configuration object
     Config exconfig_; // extension configuration object
+    unsigned fitthreads_; // maximum number of concurrent fits
+    tbb::task_arena arena_; // limits the fits of this module to fitthreads_
   };
 
   KinematicLineFit::KinematicLineFit(const Parameters& settings) : art::EDProducer{settings},
@@ -173,13 +191,16 @@ namespace mu2e {
     kkfit_(settings().mu2eSettings()),
     kkmat_(settings().matSettings()),
     config_(Mu2eKinKal::makeConfig(settings().kkFitSettings())),
-    exconfig_(Mu2eKinKal::makeConfig(settings().kkExtSettings()))
+    exconfig_(Mu2eKinKal::makeConfig(settings().kkExtSettings())),
+    fitthreads_(settings().modSettings().fitThreads()),
+    arena_(fitthreads_ > 0 ? static_cast<int>(fitthreads_) : tbb::task_arena::automatic)
     {
       // should always save something
       if((!savefull_) && zsave_.size() == 0)
         throw cet::exception("RECO")<<"mu2e::KinematicLineFit:Segment saving configuration error"<< endl;
       // collection handling
       for(const auto& hseedtag : settings().modSettings().cosmicTrackSeedCollections()) { hseedCols_.emplace_back(consumes<CosmicTrackSeedCollection>(hseedtag)); }
+      consumesMany<ComboHitStrawIndex>(); // for the StrawHits of the seed hits
       produces<KKLineCollection>();
       produces<KalSeedCollection>();
       produces<KalLineAssns>();
@@ -219,6 +240,7 @@ namespace mu2e {
   }
 
   void KinematicLineFit::produce(art::Event& event ) {
+    MU2E_PROFILE_SCOPE("KinematicLineFit::produce");
     GeomHandle<mu2e::Calorimeter> calo_h;
     // find current proditions
     auto const& strawresponse = strawResponse_h_.getPtr(event.id());
@@ -233,86 +255,71 @@ namespace mu2e {
     unique_ptr<KalLineAssns> kkseedassns(new KalLineAssns());
     auto KalSeedCollectionPID = event.getProductID<KalSeedCollection>();
     auto KalSeedCollectionGetter = event.productGetter(KalSeedCollectionPID);
-    // find the track seed collections
+    // find the track seed collections, and collect the seeds to fit.  Unwinding the combohits needs the event, so it is done here
+    std::vector<SeedFit> seedfits;
+    ComboHitStrawIndexCache shindexcache(event);
     for (auto const& hseedtag : hseedCols_) {
       auto const& hseedcol_h = event.getValidHandle<CosmicTrackSeedCollection>(hseedtag);
       auto const& hseedcol = *hseedcol_h;
       // loop over the seeds
       for(size_t iseed=0; iseed < hseedcol.size(); ++iseed) {
         auto const& hseed = hseedcol[iseed];
-
-        auto hptr = HPtr(hseedcol_h,iseed);
         // check helicity.  The test on the charge and helicity
         if(hseed.status().hasAllProperties(goodline_) ){
-          // construt the seed trajectory
-          KTRAJ seedtraj = makeSeedTraj(hseed);
-          // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
-          PKTRAJ pseedtraj(seedtraj);
-
+          seedfits.emplace_back();
+          auto& seedfit = seedfits.back();
+          seedfit.hseed = &hseed;
+          seedfit.hptr = HPtr(hseedcol_h,iseed);
           // first, we need to unwind the combohits.  We use this also to find the time range
-          StrawHitIndexCollection strawHitIdxs;
           auto const& hhits = hseed.hits();
-          for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ hhits.fillStrawHitIndices(event,ihit,strawHitIdxs); }
-          // next, build straw hits and materials from these
-          KKSTRAWHITCOL strawhits;
-          KKSTRAWXINGCOL strawxings;
-          strawhits.reserve(hhits.size());
-          strawxings.reserve(hhits.size());
-          kkfit_.makeStrawHits(*tracker, *strawresponse, *kkbf_, kkmat_.strawMaterial(), pseedtraj, chcol, strawHitIdxs, strawhits, strawxings);
-
-          //here
-          KKCALOHITCOL calohits;
-          //if (kkfit_.useCalo()) kkfit_.makeCaloHit(hptr->caloCluster(),*calo_h, pseedtraj, calohits); --> CosmicTrackSeed has no CaloClusters....
-
-          if(print_ > 2){
-            for(auto const& strawhit : strawhits) strawhit->print(std::cout,2);
-            for(auto const& calohit : calohits) calohit->print(std::cout,2);
-            for(auto const& strawxing :strawxings) strawxing->print(std::cout,2);
-          }
-          // set the seed range given the hit TPOCA values
-          seedtraj.range() = kkfit_.range(strawhits,calohits, strawxings);
-          if(print_ > 0){
-            //std::cout << "Seed line parameters " << hseed.track() << std::endl;
-            seedtraj.print(std::cout,print_);
-          }
-          // create and fit the track
-          auto kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,kkfit_.fitParticle(),kkfit_.strawHitClusterer(),strawhits,strawxings,calohits,paramconstraints_);
-          auto goodfit = goodFit(*kktrk);
-          if(goodfit && exconfig_.schedule().size() > 0){
-            kkfit_.extendTrack(exconfig_,*kkbf_, *tracker,*strawresponse, kkmat_.strawMaterial(), chcol, *calo_h, cc_H, *kktrk );
-          }
-          bool save(true);//TODO - when would we like not to save?
-          if(save || saveall_){
-            // convert KKTrk into KalSeeds for persistence
-            auto const& fittraj = kktrk->fitTraj();
-            // convert fits into CosmicKalSeeds for persistence
-            TrkFitFlag fitflag(hptr->status());
-            fitflag.merge(TrkFitFlag::KKLine);
-            // Decide which segments to save
-            std::set<double> savetimes;
-            if(savefull_){
-              // loop over all pieces of the fit trajectory and record their times
-              for (auto const& traj : fittraj.pieces() ) savetimes.insert(traj->range().mid());
-            } else {
-              for(auto zpos : zsave_ ) {
-                // compute the time the trajectory crosses this plane
-                double tz = Mu2eKinKal::zTime(fittraj,zpos,fittraj.range().begin());
-                // find the explicit trajectory piece at this time, and store the midpoint time.  This enforces uniqueness (no duplicates)
-                auto const& zpiece = fittraj.nearestPiece(tz);
-                savetimes.insert(zpiece.range().mid());
-              }
-            }
-
-            kkseedcol->push_back(kkfit_.createSeed(*kktrk,fitflag,*calo_h,savetimes));
-            //kkseedcol->back()._status.merge(TrkFitFlag::KKLine);
-            kktrkcol->push_back(kktrk.release());
-            // fill assns with the cosmic seed
-            auto hptr = art::Ptr<CosmicTrackSeed>(hseedcol_h,iseed);
-            auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
-            kkseedassns->addSingle(kseedptr,hptr);
-            // save (unpersistable) KKTrk in the event
+          for(size_t ihit = 0; ihit < hhits.size(); ++ihit ){ shindexcache.fillStrawHitIndices(hhits,ihit,seedfit.strawHitIdxs); }
+        }
+      }
+    }
+    // fit the seeds.  Each fit owns its result, which are saved below in seed order, so the output doesn't depend on the number of threads.
+    // Printout is only readable from a sequential fit
+    {
+      MU2E_PROFILE_SCOPE("KinematicLineFit::fitSeeds");
+      auto fitSeeds = [&](tbb::blocked_range<size_t> const& range) {
+        for(size_t ifit = range.begin(); ifit != range.end(); ++ifit) fitSeed(seedfits[ifit], *tracker, *strawresponse, chcol, *calo_h, cc_H);
+      };
+      if(fitthreads_ == 1 || print_ > 0 || seedfits.size() < 2)
+        fitSeeds(tbb::blocked_range<size_t>(0,seedfits.size()));
+      else
+        arena_.execute([&](){ tbb::parallel_for(tbb::blocked_range<size_t>(0,seedfits.size(),1),fitSeeds); });
+    }
+    MU2E_PROFILE_COUNT("KinematicLineFit::fits",seedfits.size());
+    for(auto& seedfit : seedfits) {
+      auto& kktrk = seedfit.kktrk;
+      bool save(true);//TODO - when would we like not to save?
+      if(save || saveall_){
+        // convert KKTrk into KalSeeds for persistence
+        auto const& fittraj = kktrk->fitTraj();
+        // convert fits into CosmicKalSeeds for persistence
+        TrkFitFlag fitflag(seedfit.hseed->status());
+        fitflag.merge(TrkFitFlag::KKLine);
+        // Decide which segments to save
+        std::set<double> savetimes;
+        if(savefull_){
+          // loop over all pieces of the fit trajectory and record their times
+          for (auto const& traj : fittraj.pieces() ) savetimes.insert(traj->range().mid());
+        } else {
+          for(auto zpos : zsave_ ) {
+            // compute the time the trajectory crosses this plane
+            double tz = Mu2eKinKal::zTime(fittraj,zpos,fittraj.range().begin());
+            // find the explicit trajectory piece at this time, and store the midpoint time.  This enforces uniqueness (no duplicates)
+            auto const& zpiece = fittraj.nearestPiece(tz);
+            savetimes.insert(zpiece.range().mid());
           }
         }
+
+        kkseedcol->push_back(kkfit_.createSeed(*kktrk,fitflag,*calo_h,savetimes));
+        //kkseedcol->back()._status.merge(TrkFitFlag::KKLine);
+        kktrkcol->push_back(kktrk.release());
+        // fill assns with the cosmic seed
+        auto kseedptr = art::Ptr<KalSeed>(KalSeedCollectionPID,kkseedcol->size()-1,KalSeedCollectionGetter);
+        kkseedassns->addSingle(kseedptr,seedfit.hptr);
+        // save (unpersistable) KKTrk in the event
       }
     }
     // put the output products into the event
@@ -321,6 +328,44 @@ namespace mu2e {
     event.put(move(kkseedassns));
   }
 
+  void KinematicLineFit::fitSeed(SeedFit& seedfit, Tracker const& tracker, StrawResponse const& strawresponse, ComboHitCollection const& chcol,
+      Calorimeter const& calo, CCHandle const& cc_H) const {
+    // construt the seed trajectory
+    KTRAJ seedtraj = makeSeedTraj(*seedfit.hseed);
+    // wrap the seed traj in a Piecewise traj: needed to satisfy PTOCA interface
+    PKTRAJ pseedtraj(seedtraj);
+    // next, build straw hits and materials from these
+    KKSTRAWHITCOL strawhits;
+    KKSTRAWXINGCOL strawxings;
+    strawhits.reserve(seedfit.strawHitIdxs.size());
+    strawxings.reserve(seedfit.strawHitIdxs.size());
+    kkfit_.makeStrawHits(tracker, strawresponse, *kkbf_, kkmat_.strawMaterial(), pseedtraj, chcol, seedfit.strawHitIdxs, strawhits, strawxings);
+
+    //here
+    KKCALOHITCOL calohits;
+    //if (kkfit_.useCalo()) kkfit_.makeCaloHit(hptr->caloCluster(),calo, pseedtraj, calohits); --> CosmicTrackSeed has no CaloClusters....
+
+    if(print_ > 2){
+      for(auto const& strawhit : strawhits) strawhit->print(std::cout,2);
+      for(auto const& calohit : calohits) calohit->print(std::cout,2);
+      for(auto const& strawxing :strawxings) strawxing->print(std::cout,2);
+    }
+    // set the seed range given the hit TPOCA values
+    seedtraj.range() = kkfit_.range(strawhits,calohits, strawxings);
+    if(print_ > 0){
+      //std::cout << "Seed line parameters " << hseed.track() << std::endl;
+      seedtraj.print(std::cout,print_);
+    }
+    // create and fit the track
+    auto& kktrk = seedfit.kktrk;
+    kktrk = make_unique<KKTRK>(config_,*kkbf_,seedtraj,kkfit_.fitParticle(),kkfit_.strawHitClusterer(),strawhits,strawxings,calohits,paramconstraints_);
+    auto goodfit = goodFit(*kktrk);
+    if(goodfit && exconfig_.schedule().size() > 0){
+      MU2E_PROFILE_SCOPE("KinematicLineFit::extendTrack");
+      kkfit_.extendTrack(exconfig_,*kkbf_, tracker,strawresponse, kkmat_.strawMaterial(), chcol, calo, cc_H, *kktrk );
+    }
+  }
+
   KTRAJ KinematicLineFit::makeSeedTraj(CosmicTrackSeed const& hseed) const {
     //exctract CosmicTrack (contains parameters)
     VEC3 bnom(0.0,0.0,0.0);
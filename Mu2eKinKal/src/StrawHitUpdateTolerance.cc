@@ -0,0 +1,12 @@
+#include "Offline/Mu2eKinKal/inc/StrawHitUpdateTolerance.hh"
+namespace mu2e {
+  StrawHitUpdateTolerance::StrawHitUpdateTolerance(Config const& config) {
+    maxddoca_ = std::get<0>(config);
+    maxddocaerr_ = std::get<1>(config);
+    maxdt_ = std::get<2>(config);
+  }
+  std::string const& StrawHitUpdateTolerance::configDescription() {
+    static std::string descrip( "Maximum DOCA change (mm), Maximum DOCA error change (mm), Maximum particle and sensor TOCA change (ns) to keep a StrawHit state");
+    return descrip;
+  }
+}
@@ -11,12 +11,14 @@ namespace mu2e {
   }
 
   std::map<std::string,WHSMaskDetail::mask_type> const& WHSMaskDetail::bitNames() {
-    static std::map<std::string,mask_type> bitnames;
-    if(bitnames.size()==0){
-      bitnames[std::string("Inactive")]           = bit_to_mask(inactive);
-      bitnames[std::string("Null")]           = bit_to_mask(null);
-      bitnames[std::string("Drift")]             = bit_to_mask(drift);
-      }
+    // initialized once, also when first called from concurrent fits
+    static const std::map<std::string,mask_type> bitnames = [](){
+      std::map<std::string,mask_type> names;
+      names[std::string("Inactive")]           = bit_to_mask(inactive);
+      names[std::string("Null")]           = bit_to_mask(null);
+      names[std::string("Drift")]             = bit_to_mask(drift);
+      return names;
+    }();
     return bitnames;
   }
 
@@ -52,7 +52,7 @@ namespace mu2e {
     double         getXMaxUnbinned() const { return _xmax_unbinned;}
     double         getXMax() const { return _xmax;}
     double         getXMin() const { return _xmin;}
-    double         sample(double rand) {
+    double         sample(double rand) const {
       double temp = _xmin + (_xmax - _xmin) * rand;
       if (_finalBin && temp > _xmax-_binWidth){
         // for CE fix final bin
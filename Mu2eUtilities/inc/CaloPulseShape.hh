@@ -17,9 +17,16 @@
 //
 //  NOTE: uncomment the pline creation if the discontinuities in the second order derivative arising from the
 //        linear piecewise approxmiation are problematic for the minimization
+//
+// buildShapes() reads the pulse shape histogram named by the CalorimeterCalibrations conditions;
+// buildShapes(pshape) takes it from the caller, eg a job replaying recorded waveforms without services
 
+#include <memory>
 #include <vector>
 
+class TH1;
+class TH1F;
+
 namespace mu2e {
 
     class CaloPulseShape
@@ -29,6 +36,10 @@ namespace mu2e {
           ~CaloPulseShape() {};
 
           void buildShapes();
+          void buildShapes(const TH1& pshape);
+
+          // pulse shape histogram of the CalorimeterCalibrations conditions
+          static std::unique_ptr<TH1F> pulseHistogram();
 
           const std::vector<double>& digitizedPulse  (double hitTime)        const;
           double                     evaluate        (double timeDifference) const;
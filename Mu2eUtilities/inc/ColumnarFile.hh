@@ -0,0 +1,163 @@
+#ifndef Mu2eUtilities_ColumnarFile_hh
+#define Mu2eUtilities_ColumnarFile_hh
+
+//
+// A minimal columnar file format for flat analysis ntuples.
+//
+// A file holds any number of tables.  A table is a list of typed scalar
+// columns; each column is buffered in its own contiguous array, and when a
+// table has collected batchRows rows every column is compressed and written
+// as one block.  Filling a row is a memcpy per column, and the writes are a
+// few large blocks per batch instead of per-event, per-branch buffers.
+//
+// Layout (native byte order):
+//   "MU2ECOL1"
+//   records, each starting with a uint32 kind:
+//     Schema  table index, table name, number of columns, (name, type) per column
+//     Batch   table index, number of rows, per column (raw bytes, stored bytes, data)
+//     End     number of tables
+// A block is stored uncompressed when compression does not make it smaller.
+// Compression uses the ROOT algorithms, selected with the same settings
+// integer as TFile::SetCompressionSettings (100*algorithm + level, 0 = none).
+//
+// ColumnarReader reads back whole columns; the columnarToTree executable
+// converts a file to TTrees for interactive use.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+  enum class ColumnType : uint8_t { Float32=0, Float64, Int32, UInt32, Int64 };
+
+  template <class T> struct ColumnTypeOf;
+  template <> struct ColumnTypeOf<float>    { static constexpr ColumnType value = ColumnType::Float32; };
+  template <> struct ColumnTypeOf<double>   { static constexpr ColumnType value = ColumnType::Float64; };
+  template <> struct ColumnTypeOf<int32_t>  { static constexpr ColumnType value = ColumnType::Int32;   };
+  template <> struct ColumnTypeOf<uint32_t> { static constexpr ColumnType value = ColumnType::UInt32;  };
+  template <> struct ColumnTypeOf<int64_t>  { static constexpr ColumnType value = ColumnType::Int64;   };
+
+  std::size_t columnTypeSize(ColumnType type);
+  const char* columnTypeName(ColumnType type);
+
+  struct ColumnInfo {
+    std::string name;
+    ColumnType  type;
+  };
+
+  class ColumnarWriter {
+  public:
+
+    class Table {
+    public:
+      const std::string&             name()    const { return _name; }
+      const std::vector<ColumnInfo>& columns() const { return _columns; }
+      std::size_t                    rows()    const { return _totalRows; }
+
+      // Columns can only be added before the first row
+      std::size_t addColumn(const std::string& name, ColumnType type);
+
+      // Set the value of a column in the current row
+      template <class T> void fill(std::size_t column, T value) {
+        if(ColumnTypeOf<T>::value != _columns[column].type) {
+          throw cet::exception("COLUMNAR") << "ColumnarWriter: column " << _name << "." << _columns[column].name
+                                           << " is " << columnTypeName(_columns[column].type)
+                                           << ", filled with " << columnTypeName(ColumnTypeOf<T>::value) << "\n";
+        }
+        std::memcpy(_buffers[column].data() + _rows*sizeof(T), &value, sizeof(T));
+      }
+
+      // Close the current row; the batch is written when it is full
+      void endRow();
+
+    private:
+      friend class ColumnarWriter;
+      Table(ColumnarWriter& writer, std::size_t index, const std::string& name);
+      void startBatch();
+      void flush();
+
+      ColumnarWriter&                _writer;
+      std::size_t                    _index;
+      std::string                    _name;
+      std::vector<ColumnInfo>        _columns;
+      std::vector<std::vector<char>> _buffers;    // one per column, batchRows values
+      std::size_t                    _rows = 0;   // in the current batch
+      std::size_t                    _totalRows = 0;
+      bool                           _started = false;
+    };
+
+    // compressionSettings as TFile::SetCompressionSettings, eg 505 for ZSTD level 5
+    ColumnarWriter(const std::string& filename, int compressionSettings = 505, std::size_t batchRows = 4096);
+    ~ColumnarWriter();
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    Table& addTable(const std::string& name);
+
+    // Write the partial batches and the end record; called by the destructor
+    void close();
+
+    std::size_t rawBytes()    const { return _rawBytes; }
+    std::size_t storedBytes() const { return _storedBytes; }
+
+  private:
+    void writeBlock(std::vector<char>& data, std::size_t nbytes);
+    template <class T> void put(T value) { _out.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+    void putString(const std::string& s);
+
+    std::string                         _filename;
+    std::ofstream                       _out;
+    int                                 _algorithm;
+    int                                 _level;
+    std::size_t                         _batchRows;
+    std::vector<std::unique_ptr<Table>> _tables;
+    std::vector<char>                   _zipBuffer;
+    std::size_t                         _rawBytes = 0;
+    std::size_t                         _storedBytes = 0;
+    bool                                _closed = false;
+  };
+
+  class ColumnarReader {
+  public:
+    explicit ColumnarReader(const std::string& filename);
+
+    std::vector<std::string>       tables() const;
+    const std::vector<ColumnInfo>& columns(const std::string& table) const;
+    std::size_t                    rows(const std::string& table) const;
+
+    // All the values of a column, in row order
+    template <class T> std::vector<T> column(const std::string& table, const std::string& column) const {
+      std::vector<T> result;
+      auto const& data = rawColumn(table, column, ColumnTypeOf<T>::value);
+      result.resize(data.size()/sizeof(T));
+      if(!result.empty()) std::memcpy(result.data(), data.data(), data.size());
+      return result;
+    }
+
+  private:
+    struct TableData {
+      std::vector<ColumnInfo>        columns;
+      std::vector<std::vector<char>> data;
+      std::size_t                    rows = 0;
+    };
+    const TableData&         table(const std::string& name) const;
+    const std::vector<char>& rawColumn(const std::string& table, const std::string& column, ColumnType type) const;
+
+    std::string                      _filename;
+    std::vector<std::string>         _order;
+    std::map<std::string, TableData> _tables;
+  };
+
+} // namespace mu2e
+
+#endif /* Mu2eUtilities_ColumnarFile_hh */
@@ -7,6 +7,8 @@
 // - intermediate answers can be retrieved before the full
 // set of elements have been pushed
 // - after clear(), it is ready for a new set of elements
+// - the medians are found by selection (nth_element), not by a
+// full sort, so each evaluation is linear in the number of elements
 //
 
 #include <functional>
@@ -35,7 +37,8 @@ public:
 
   inline void push(float value, float weight = 1) {
     _vec.emplace_back(value, weight);
-    _needsSorting = true;
+    _goodWM = false;
+    _goodUWM = false;
     _totalWeight += weight;
   }
 
@@ -46,7 +49,6 @@ private:
   float median(bool useWeights);
 
   std::vector<MedianData> _vec;
-  bool _needsSorting;
   bool _goodWM;
   bool _goodUWM;
   float _weightedMedian;
@@ -25,6 +25,18 @@
 // the feature (the default). If the number of inputs is less than
 // averageNumRecordsToUse, all input records are used.
 //
+// Instead of the ROOT ntuples the records can be read from binary
+// libraries (GeneralUtilities/inc/RSNTLibrary.hh), made from the ntuples by
+// makeRSNTLibrary.  The libraries, given by libraryFiles in place of
+// inputFiles/treeName/branchName/pieBranchName, are memory mapped and
+// sampled in place: nothing is loaded at construction, and the pages are
+// shared by all the jobs on a node.  The correlations of a
+// multi-record ntuple are kept in the library.  averageNumRecordsToUse
+// does not apply to libraries, all their events are used.  A library
+// holds the events, in order, that its ntuples give with
+// averageNumRecordsToUse=0; the sampled sequences still differ, since
+// loading the ntuples draws random numbers from the engine.
+//
 // See StoppedParticleReactionGun_module.cc and InFlightParticleSampler_module.cc
 // for examples of use.
 //
@@ -33,6 +45,7 @@
 #ifndef RootTreeSampler_hh
 #define RootTreeSampler_hh
 
+#include <algorithm>
 #include <vector>
 
 #include "fhiclcpp/types/Atom.h"
@@ -53,6 +66,7 @@
 #include "TFile.h"
 
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "Offline/GeneralUtilities/inc/RSNTLibrary.hh"
 
 namespace mu2e {
 
@@ -64,19 +78,29 @@ namespace mu2e {
       using Name=fhicl::Name;
       using Comment=fhicl::Comment;
 
+      fhicl::Sequence<std::string> libraryFiles {
+        Name("libraryFiles"),
+          Comment("List of binary record libraries made by makeRSNTLibrary.\n"
+                  "If not empty, they are used instead of the ROOT ntuples."),
+          std::vector<std::string>{}
+      };
+
       fhicl::Sequence<std::string> inputFiles {
         Name("inputFiles"),
-          Comment("List of input ntuple files")
+          Comment("List of input ntuple files"),
+          [this](){ return libraryFiles().empty(); }
       };
 
       fhicl::Atom<std::string> treeName {
         Name("treeName"),
-          Comment("Name of the ROOT tree object containing particle records")
+          Comment("Name of the ROOT tree object containing particle records"),
+          [this](){ return libraryFiles().empty(); }
           };
 
       fhicl::Atom<std::string> branchName {
         Name("branchName"),
-          Comment("Name of the ROOT tree branch containing particle records")
+          Comment("Name of the ROOT tree branch containing particle records"),
+          [this](){ return libraryFiles().empty(); }
           };
 
       fhicl::Atom<long> averageNumRecordsToUse {
@@ -97,7 +121,7 @@ namespace mu2e {
           Comment("Only for generators resampling correlated particles from\n"
                   "multiple ntuple records:\n"
                   "Name of the ROOT tree branch that maps input records to events."),
-          [this](){ return !std::is_same<EventRecord,NtupleRecord>::value; }
+          [this](){ return !std::is_same<EventRecord,NtupleRecord>::value && libraryFiles().empty(); }
       };
     };
 
@@ -108,10 +132,15 @@ namespace mu2e {
     RootTreeSampler(art::RandomNumberGenerator::base_engine_t& engine,
                     const fhicl::ParameterSet& pset);
 
-    const EventRecord& fire() { return records_.at(randFlat_.fireInt(records_.size())); }
+    const EventRecord& fire() {
+      if(libraries_.empty()) {
+        return records_.at(randFlat_.fireInt(records_.size()));
+      }
+      return libraryRecord(randFlat_.fireInt(numRecords()));
+    }
 
     typename std::vector<EventRecord>::size_type
-    numRecords() const { return records_.size(); }
+    numRecords() const { return libraries_.empty() ? records_.size() : libraryFirstEvent_.back(); }
 
   private:
     CLHEP::RandFlat randFlat_;
@@ -119,6 +148,15 @@ namespace mu2e {
 
     typedef std::vector<std::string> Strings;
 
+    // library inputs: events [libraryFirstEvent_[i], libraryFirstEvent_[i+1]) are in libraries_[i];
+    // a single-record sampler uses every record as an event, also of a correlated library
+    std::vector<RSNTLibrary<NtupleRecord> > libraries_;
+    std::vector<std::size_t> libraryFirstEvent_;
+    EventRecord libraryEvent_;  // the last multi-record event returned by fire()
+
+    void openLibraries(const Strings& files, int verbosityLevel);
+    const EventRecord& libraryRecord(std::size_t ievent);
+
     long countInputRecords(const art::ServiceHandle<art::TFileService>& tfs,
                            const Strings& files,
                            const std::string& treeName);
@@ -341,6 +379,11 @@ namespace mu2e {
                   const Config& conf)
     : randFlat_(engine)
   {
+    if(!conf.libraryFiles().empty()) {
+      openLibraries(conf.libraryFiles(), conf.verbosityLevel());
+      return;
+    }
+
     const auto inputFiles(conf.inputFiles());
     const auto treeName(conf.treeName());
     const long averageNumRecordsToUse(conf.averageNumRecordsToUse());
@@ -449,6 +492,12 @@ namespace mu2e {
                   const fhicl::ParameterSet& pset)
     : randFlat_(engine)
   {
+    const auto libraryFiles(pset.get<std::vector<std::string> >("libraryFiles", {}));
+    if(!libraryFiles.empty()) {
+      openLibraries(libraryFiles, pset.get<int>("verbosityLevel", 0));
+      return;
+    }
+
     const auto inputFiles(pset.get<std::vector<std::string> >("inputFiles"));
     const auto treeName(pset.get<std::string>("treeName"));
     const long averageNumRecordsToUse(pset.get<long>("averageNumRecordsToUse", 0));
@@ -573,6 +622,55 @@ namespace mu2e {
     return res;
   }
 
+  //================================================================
+  template<class EventRecord, class NtupleRecord>
+  void RootTreeSampler<EventRecord, NtupleRecord>::openLibraries(const Strings& files, int verbosityLevel)
+  {
+    constexpr bool singleRecord = std::is_same<EventRecord,NtupleRecord>::value;
+
+    libraries_.reserve(files.size());
+    libraryFirstEvent_.assign(1, 0);
+    for(const auto& fn : files) {
+      libraries_.emplace_back(ConfigFileLookupPolicy()(fn));
+      const auto& lib = libraries_.back();
+      if(!singleRecord && !lib.correlated()) {
+        throw cet::exception("BADINPUT")<<"RootTreeSampler: library \""<<lib.fileName()
+                                        <<"\" has no event index, it can not be used for correlated records\n";
+      }
+      libraryFirstEvent_.push_back(libraryFirstEvent_.back() + (singleRecord ? lib.numRecords() : lib.numEvents()));
+
+      if(verbosityLevel > 0) {
+        std::cout<<"RootTreeSampler: mapped "<<lib.numEvents()<<" events, "
+                 <<lib.numRecords()<<" records, library "<<lib.fileName()
+                 <<std::endl;
+      }
+    }
+
+    if(numRecords() == 0) {
+      throw cet::exception("BADINPUT")<<"RootTreeSampler: no records in the libraryFiles\n";
+    }
+    if(verbosityLevel > 0) {
+      std::cout<<"RootTreeSampler: using "<<numRecords()<<" event entries from "
+               <<libraries_.size()<<" libraries"<<std::endl;
+    }
+  }
+
+  template<class EventRecord, class NtupleRecord>
+  const EventRecord& RootTreeSampler<EventRecord, NtupleRecord>::libraryRecord(std::size_t ievent)
+  {
+    const std::size_t ilib = std::upper_bound(libraryFirstEvent_.begin(), libraryFirstEvent_.end(), ievent)
+      - libraryFirstEvent_.begin() - 1;
+    const auto& lib = libraries_[ilib];
+    const std::size_t i = ievent - libraryFirstEvent_[ilib];
+    if constexpr (std::is_same<EventRecord,NtupleRecord>::value) {
+      return lib.record(i);
+    }
+    else {
+      libraryEvent_.assign(lib.eventBegin(i), lib.eventEnd(i));
+      return libraryEvent_;
+    }
+  }
+
   //================================================================
 }
 
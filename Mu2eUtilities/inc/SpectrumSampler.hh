@@ -0,0 +1,98 @@
+#ifndef Mu2eUtilities_SpectrumSampler_hh
+#define Mu2eUtilities_SpectrumSampler_hh
+
+//
+// Sampling of a BinnedSpectrum, in place of CLHEP::RandGeneral.
+//
+// SpectrumTable holds the precomputed tables of a spectrum: the cumulative
+// distribution, as built by CLHEP::RandGeneral, and a Walker alias table.
+// Both give a fraction in [0,1) of the spectrum range, the bin drawn with
+// its weight and the position in the bin uniform (a CDF linear in each bin):
+//
+//   inverseCDF  one uniform number and a binary search over the bins.  This
+//               is the algorithm of RandGeneral (IntType 0): with the same
+//               engine state it returns exactly the same numbers.
+//   alias       two uniform numbers and no search, O(1) whatever the number
+//               of bins.  Same distribution, different sequence.
+//
+// SpectrumTable::cached() builds the BinnedSpectrum and its tables once per
+// process for each spectrum parameter set, so generators configured with
+// the same spectrum share them, and the analytic shapes are not evaluated
+// again by each module or tool.
+//
+// The method is chosen by the samplingMethod key of the spectrum parameter
+// set, "inverseCDF" (default) or "alias".
+//
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fhiclcpp/ParameterSet.h"
+
+#include "Offline/Mu2eUtilities/inc/BinnedSpectrum.hh"
+
+namespace CLHEP { class HepRandomEngine; }
+
+namespace mu2e {
+
+  class SpectrumTable {
+  public:
+
+    explicit SpectrumTable(BinnedSpectrum spectrum);
+
+    // The tables of BinnedSpectrum(psphys), shared by all the users of the same parameters
+    static std::shared_ptr<const SpectrumTable> cached(const fhicl::ParameterSet& psphys);
+
+    const BinnedSpectrum& spectrum() const { return _spectrum; }
+    std::size_t           nbins()    const { return _prob.size(); }
+
+    // fraction of the spectrum range from u in [0,1), as CLHEP::RandGeneral::mapRandom
+    double inverseCDF(double u) const;
+
+    // fraction of the spectrum range from two uniform numbers: u1 picks the bin, u2 the position in it
+    double alias(double u1, double u2) const;
+
+  private:
+    BinnedSpectrum        _spectrum;
+    std::vector<double>   _cdf;      // nbins+1 entries, 0 to 1
+    std::vector<double>   _prob;     // probability to keep bin i rather than its alias
+    std::vector<unsigned> _alias;
+    double                _oneOverNbins;
+  };
+
+  class SpectrumSampler {
+  public:
+
+    enum Method { inverseCDF, alias };
+    static Method parseMethod(const std::string& name);
+
+    SpectrumSampler(CLHEP::HepRandomEngine& engine, std::shared_ptr<const SpectrumTable> table, Method method = inverseCDF);
+
+    // cached tables of BinnedSpectrum(psphys), the method from psphys.samplingMethod
+    SpectrumSampler(CLHEP::HepRandomEngine& engine, const fhicl::ParameterSet& psphys);
+
+    const BinnedSpectrum& spectrum() const { return _table->spectrum(); }
+    Method                method()   const { return _method; }
+
+    // fraction of the spectrum range in [0,1), as CLHEP::RandGeneral::fire()
+    double fire();
+
+    // a value of the spectrum variable, spectrum().sample(fire())
+    double sample() { return spectrum().sample(fire()); }
+
+    // n fractions or values, for generators drawing many at a time
+    void fireArray  (std::size_t n, double* out);
+    void sampleArray(std::size_t n, double* out);
+
+  private:
+    CLHEP::HepRandomEngine*              _engine;
+    std::shared_ptr<const SpectrumTable> _table;
+    Method                               _method;
+    std::vector<double>                  _flat;   // uniform numbers of fireArray
+  };
+
+} // end of namespace mu2e
+
+#endif /* Mu2eUtilities_SpectrumSampler_hh */
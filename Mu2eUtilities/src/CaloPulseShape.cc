@@ -15,12 +15,8 @@ namespace mu2e {
    {}
 
    //----------------------------------------------------------------------------------------------------------------------
-   void CaloPulseShape::buildShapes()
+   std::unique_ptr<TH1F> CaloPulseShape::pulseHistogram()
    {
-
-       pulseVec_.clear();
-
-       // Get the pulse shape histogram
        ConditionsHandle<CalorimeterCalibrations> calorimeterCalibrations("ignored");
        std::string fileName = calorimeterCalibrations->pulseFileName();
        std::string histName = calorimeterCalibrations->pulseHistName();
@@ -32,12 +28,24 @@ namespace mu2e {
                                                      <<" from file "<<fileName.c_str()<<" does not exist";
          pshape->SetDirectory(0);
        pulseFile.Close();
+       return std::unique_ptr<TH1F>(pshape);
+   }
 
+   //----------------------------------------------------------------------------------------------------------------------
+   void CaloPulseShape::buildShapes()
+   {
+       buildShapes(*pulseHistogram());
+   }
+
+   //----------------------------------------------------------------------------------------------------------------------
+   void CaloPulseShape::buildShapes(const TH1& pshape)
+   {
+       pulseVec_.clear();
 
        // Adjust binning to match digitizer sampling period, shift to zero and normalize
-       int nbins = int((pshape->GetXaxis()->GetXmax()-pshape->GetXaxis()->GetXmin())/digiStep_);
-       TH1F pulseShape("ps","ps", nbins, 0.0, pshape->GetXaxis()->GetXmax()-pshape->GetXaxis()->GetXmin());
-       for (int i=1;i<=nbins;++i) pulseShape.SetBinContent(i,pshape->Interpolate(pulseShape.GetBinCenter(i)));
+       int nbins = int((pshape.GetXaxis()->GetXmax()-pshape.GetXaxis()->GetXmin())/digiStep_);
+       TH1F pulseShape("ps","ps", nbins, 0.0, pshape.GetXaxis()->GetXmax()-pshape.GetXaxis()->GetXmin());
+       for (int i=1;i<=nbins;++i) pulseShape.SetBinContent(i,pshape.Interpolate(pulseShape.GetBinCenter(i)));
        pulseShape.Scale(1.0/pulseShape.GetMaximum(),"nosw2");
 
        // Cache histogram content into vector and shift waveform (see note),
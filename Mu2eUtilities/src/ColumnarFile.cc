@@ -0,0 +1,304 @@
+#include "Offline/Mu2eUtilities/inc/ColumnarFile.hh"
+
+#include <algorithm>
+
+#include "Compression.h"
+#include "RZip.h"
+
+namespace mu2e {
+
+  namespace {
+    const char magic[8] = {'M','U','2','E','C','O','L','1'};
+    enum RecordKind : uint32_t { Schema=1, Batch=2, End=3 };
+
+    // ROOT compresses at most 0xffffff bytes in one call, and adds a 9 byte header
+    const std::size_t maxBlockBytes = 0xffffff;
+    const std::size_t zipHeaderBytes = 9;
+
+    template <class T> T get(std::ifstream& in, const std::string& filename) {
+      T value;
+      if(!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw cet::exception("COLUMNAR") << "ColumnarReader: file " << filename << " is truncated\n";
+      }
+      return value;
+    }
+
+    std::string getString(std::ifstream& in, const std::string& filename) {
+      auto n = get<uint32_t>(in, filename);
+      std::string s(n, ' ');
+      if(n > 0 && !in.read(&s[0], n)) {
+        throw cet::exception("COLUMNAR") << "ColumnarReader: file " << filename << " is truncated\n";
+      }
+      return s;
+    }
+  }
+
+  std::size_t columnTypeSize(ColumnType type) {
+    switch(type) {
+    case ColumnType::Float32: return sizeof(float);
+    case ColumnType::Float64: return sizeof(double);
+    case ColumnType::Int32:   return sizeof(int32_t);
+    case ColumnType::UInt32:  return sizeof(uint32_t);
+    case ColumnType::Int64:   return sizeof(int64_t);
+    }
+    throw cet::exception("COLUMNAR") << "Unknown column type " << int(type) << "\n";
+  }
+
+  const char* columnTypeName(ColumnType type) {
+    switch(type) {
+    case ColumnType::Float32: return "float";
+    case ColumnType::Float64: return "double";
+    case ColumnType::Int32:   return "int";
+    case ColumnType::UInt32:  return "unsigned";
+    case ColumnType::Int64:   return "long";
+    }
+    return "unknown";
+  }
+
+  //================================================================
+  ColumnarWriter::Table::Table(ColumnarWriter& writer, std::size_t index, const std::string& name) :
+    _writer(writer), _index(index), _name(name)
+  {}
+
+  std::size_t ColumnarWriter::Table::addColumn(const std::string& name, ColumnType type) {
+    if(_started) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: column " << name
+                                       << " added to table " << _name << " after its first row\n";
+    }
+    for(auto const& c : _columns) {
+      if(c.name == name) {
+        throw cet::exception("COLUMNAR") << "ColumnarWriter: duplicate column " << _name << "." << name << "\n";
+      }
+    }
+    _columns.push_back(ColumnInfo{name, type});
+    _buffers.emplace_back(_writer._batchRows*columnTypeSize(type), 0);
+    return _columns.size()-1;
+  }
+
+  // The schema is written when the first row is complete, so that the
+  // columns can be declared lazily, eg from the first event
+  void ColumnarWriter::Table::startBatch() {
+    auto& w = _writer;
+    w.put<uint32_t>(Schema);
+    w.put<uint32_t>(_index);
+    w.putString(_name);
+    w.put<uint32_t>(_columns.size());
+    for(auto const& c : _columns) {
+      w.putString(c.name);
+      w.put<uint8_t>(static_cast<uint8_t>(c.type));
+    }
+    _started = true;
+  }
+
+  void ColumnarWriter::Table::endRow() {
+    if(!_started) startBatch();
+    ++_totalRows;
+    if(++_rows == _writer._batchRows) flush();
+  }
+
+  void ColumnarWriter::Table::flush() {
+    if(_rows == 0) return;
+    auto& w = _writer;
+    w.put<uint32_t>(Batch);
+    w.put<uint32_t>(_index);
+    w.put<uint32_t>(_rows);
+    for(std::size_t i=0; i<_columns.size(); ++i) {
+      w.writeBlock(_buffers[i], _rows*columnTypeSize(_columns[i].type));
+      // values of columns not filled in a row read back as 0
+      std::fill(_buffers[i].begin(), _buffers[i].end(), 0);
+    }
+    _rows = 0;
+  }
+
+  //================================================================
+  ColumnarWriter::ColumnarWriter(const std::string& filename, int compressionSettings, std::size_t batchRows) :
+    _filename(filename),
+    _out(filename, std::ios::binary | std::ios::trunc),
+    _algorithm(compressionSettings/100),
+    _level(compressionSettings%100),
+    _batchRows(batchRows)
+  {
+    if(!_out) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: can not open " << filename << " for writing\n";
+    }
+    if(batchRows == 0 || batchRows*sizeof(int64_t) > maxBlockBytes) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: batchRows must be in [1," << maxBlockBytes/sizeof(int64_t)
+                                       << "], not " << batchRows << "\n";
+    }
+    if(compressionSettings < 0 || _level > 9) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: bad compression settings " << compressionSettings << "\n";
+    }
+    _zipBuffer.resize(batchRows*sizeof(int64_t) + zipHeaderBytes);
+    _out.write(magic, sizeof(magic));
+  }
+
+  ColumnarWriter::~ColumnarWriter() {
+    try {
+      close();
+    } catch(...) {
+      // a destructor must not throw; call close() to see the errors
+    }
+  }
+
+  ColumnarWriter::Table& ColumnarWriter::addTable(const std::string& name) {
+    if(_closed) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: table " << name << " added to the closed file " << _filename << "\n";
+    }
+    for(auto const& t : _tables) {
+      if(t->name() == name) {
+        throw cet::exception("COLUMNAR") << "ColumnarWriter: duplicate table " << name << "\n";
+      }
+    }
+    _tables.emplace_back(new Table(*this, _tables.size(), name));
+    return *_tables.back();
+  }
+
+  void ColumnarWriter::close() {
+    if(_closed) return;
+    _closed = true;
+    for(auto& t : _tables) {
+      if(!t->_started) t->startBatch();  // empty tables keep their schema
+      t->flush();
+    }
+    put<uint32_t>(End);
+    put<uint32_t>(_tables.size());
+    _out.close();
+    if(_out.fail()) {
+      throw cet::exception("COLUMNAR") << "ColumnarWriter: error writing " << _filename << "\n";
+    }
+  }
+
+  void ColumnarWriter::putString(const std::string& s) {
+    put<uint32_t>(s.size());
+    _out.write(s.data(), s.size());
+  }
+
+  void ColumnarWriter::writeBlock(std::vector<char>& data, std::size_t nbytes) {
+    int stored = 0;
+    if(_level > 0 && nbytes > zipHeaderBytes) {
+      int srcsize = nbytes;
+      int tgtsize = nbytes;  // no room to grow: incompressible blocks are stored as they are
+      R__zipMultipleAlgorithm(_level, &srcsize, data.data(), &tgtsize, _zipBuffer.data(), &stored,
+                              static_cast<ROOT::RCompressionSetting::EAlgorithm::EValues>(_algorithm));
+    }
+    put<uint32_t>(nbytes);
+    if(stored > 0 && std::size_t(stored) < nbytes) {
+      put<uint32_t>(stored);
+      _out.write(_zipBuffer.data(), stored);
+    } else {
+      stored = nbytes;
+      put<uint32_t>(stored);
+      _out.write(data.data(), nbytes);
+    }
+    _rawBytes    += nbytes;
+    _storedBytes += stored;
+  }
+
+  //================================================================
+  ColumnarReader::ColumnarReader(const std::string& filename) :
+    _filename(filename)
+  {
+    std::ifstream in(filename, std::ios::binary);
+    if(!in) {
+      throw cet::exception("COLUMNAR") << "ColumnarReader: can not open " << filename << "\n";
+    }
+    char header[sizeof(magic)];
+    if(!in.read(header, sizeof(header)) || !std::equal(header, header+sizeof(header), magic)) {
+      throw cet::exception("COLUMNAR") << "ColumnarReader: " << filename << " is not a columnar file\n";
+    }
+
+    std::vector<TableData*> byIndex;
+    std::vector<unsigned char> stored;
+    while(true) {
+      auto kind = get<uint32_t>(in, filename);
+      if(kind == End) break;
+      auto index = get<uint32_t>(in, filename);
+      if(kind == Schema) {
+        auto name = getString(in, filename);
+        auto& t = _tables[name];
+        _order.push_back(name);
+        auto ncol = get<uint32_t>(in, filename);
+        for(uint32_t i=0; i<ncol; ++i) {
+          auto cname = getString(in, filename);
+          auto type = static_cast<ColumnType>(get<uint8_t>(in, filename));
+          columnTypeSize(type); // validates the type
+          t.columns.push_back(ColumnInfo{cname, type});
+        }
+        t.data.resize(ncol);
+        if(byIndex.size() <= index) byIndex.resize(index+1, nullptr);
+        byIndex[index] = &t;
+      } else if(kind == Batch) {
+        if(index >= byIndex.size() || byIndex[index] == nullptr) {
+          throw cet::exception("COLUMNAR") << "ColumnarReader: batch of undeclared table " << index << " in " << filename << "\n";
+        }
+        auto& t = *byIndex[index];
+        auto nrows = get<uint32_t>(in, filename);
+        for(std::size_t i=0; i<t.columns.size(); ++i) {
+          auto nraw    = get<uint32_t>(in, filename);
+          auto nstored = get<uint32_t>(in, filename);
+          if(nraw != nrows*columnTypeSize(t.columns[i].type)) {
+            throw cet::exception("COLUMNAR") << "ColumnarReader: inconsistent block size in " << filename << "\n";
+          }
+          auto& column = t.data[i];
+          auto offset = column.size();
+          column.resize(offset + nraw);
+          if(nstored == nraw) {
+            if(nraw > 0 && !in.read(column.data()+offset, nraw)) {
+              throw cet::exception("COLUMNAR") << "ColumnarReader: file " << filename << " is truncated\n";
+            }
+          } else {
+            stored.resize(nstored);
+            if(!in.read(reinterpret_cast<char*>(stored.data()), nstored)) {
+              throw cet::exception("COLUMNAR") << "ColumnarReader: file " << filename << " is truncated\n";
+            }
+            int srcsize = nstored;
+            int tgtsize = nraw;
+            int irep = 0;
+            R__unzip(&srcsize, stored.data(), &tgtsize, reinterpret_cast<unsigned char*>(column.data()+offset), &irep);
+            if(std::size_t(irep) != nraw) {
+              throw cet::exception("COLUMNAR") << "ColumnarReader: corrupt compressed block in " << filename << "\n";
+            }
+          }
+        }
+        t.rows += nrows;
+      } else {
+        throw cet::exception("COLUMNAR") << "ColumnarReader: unknown record " << kind << " in " << filename << "\n";
+      }
+    }
+  }
+
+  std::vector<std::string> ColumnarReader::tables() const {
+    return _order;
+  }
+
+  const ColumnarReader::TableData& ColumnarReader::table(const std::string& name) const {
+    auto it = _tables.find(name);
+    if(it == _tables.end()) {
+      throw cet::exception("COLUMNAR") << "ColumnarReader: no table " << name << " in " << _filename << "\n";
+    }
+    return it->second;
+  }
+
+  const std::vector<ColumnInfo>& ColumnarReader::columns(const std::string& name) const {
+    return table(name).columns;
+  }
+
+  std::size_t ColumnarReader::rows(const std::string& name) const {
+    return table(name).rows;
+  }
+
+  const std::vector<char>& ColumnarReader::rawColumn(const std::string& name, const std::string& column, ColumnType type) const {
+    auto const& t = table(name);
+    for(std::size_t i=0; i<t.columns.size(); ++i) {
+      if(t.columns[i].name == column) {
+        if(t.columns[i].type != type) {
+          throw cet::exception("COLUMNAR") << "ColumnarReader: column " << name << "." << column << " is "
+                                           << columnTypeName(t.columns[i].type) << ", read as " << columnTypeName(type) << "\n";
+        }
+        return t.data[i];
+      }
+    }
+    throw cet::exception("COLUMNAR") << "ColumnarReader: no column " << name << "." << column << " in " << _filename << "\n";
+  }
+
+} // namespace mu2e
@@ -12,7 +12,6 @@ namespace mu2e {
 
 void MedianCalculator::clear() {
   _vec.clear();
-  _needsSorting = true;
   _goodWM = false;
   _goodUWM = false;
   _weightedMedian = 0;
@@ -34,30 +33,39 @@ float MedianCalculator::median(bool useWeights) {
     return _vec[0].val;
   }
 
-  if (_needsSorting) {
-    std::sort(_vec.begin(), _vec.end(), lessByValue());
-    _needsSorting = false;
-    _goodWM = false;
-    _goodUWM = false;
-  }
-
   if (useWeights) {
 
     if (!_goodWM) {
 
-      // integratng low to high, id will the first entry past the 50% point
-      // the entry at id then satisfies the definition of weighted median:
-      // the sum of weights above and below id (not including id)
-      // is less than 50%.  id can be the first or last entry.
-
-      size_t id = 0;
-      float sum = _vec[0].wg;
-      while (sum < 0.5 * _totalWeight) {
-        ++id;
-        sum += _vec[id].wg;
+      // the weighted median is the value of the first entry, in increasing
+      // order of value, at which the integrated weight reaches 50%: the sums
+      // of weights above and below it (not including it) are less than 50%.
+      // Find it by repeatedly partitioning the range that contains it
+      // around its middle element, carrying the weight integrated below.
+
+      const float half = 0.5 * _totalWeight;
+      auto lo = _vec.begin();
+      auto hi = _vec.end();
+      float below = 0;
+      while (hi - lo > 1) {
+        auto mid = lo + (hi - lo) / 2;
+        std::nth_element(lo, mid, hi, lessByValue());
+        float wlow = 0;
+        for (auto it = lo; it != mid; ++it) wlow += it->wg;
+        if (below + wlow >= half) {
+          hi = mid;
+        } else if (below + wlow + mid->wg < half) {
+          below += wlow + mid->wg;
+          lo = mid + 1;
+        } else {
+          lo = mid;
+          hi = mid + 1;
+        }
       }
+      // rounding in the weight sums can leave lo at the end
+      if (lo == _vec.end()) lo = std::max_element(_vec.begin(), _vec.end(), lessByValue());
 
-      _weightedMedian = _vec[id].val;
+      _weightedMedian = lo->val;
       _goodWM = true;
     }
 
@@ -69,10 +77,14 @@ float MedianCalculator::median(bool useWeights) {
 
       // v_size is >=2, so id >=1
       size_t id = v_size / 2;
+      auto mid = _vec.begin() + id;
+      std::nth_element(_vec.begin(), mid, _vec.end(), lessByValue());
       if (v_size % 2 == 0) {
-        _unweightedMedian = (_vec[id - 1].val + _vec[id].val) / 2.0;
+        // the largest of the lower half is the other middle value
+        auto low = std::max_element(_vec.begin(), mid, lessByValue());
+        _unweightedMedian = (low->val + mid->val) / 2.0;
       } else {
-        _unweightedMedian = _vec[id].val;
+        _unweightedMedian = mid->val;
       }
       _goodUWM = true;
     }
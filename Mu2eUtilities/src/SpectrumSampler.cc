@@ -0,0 +1,134 @@
+#include "Offline/Mu2eUtilities/inc/SpectrumSampler.hh"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+#include "CLHEP/Random/RandomEngine.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/ParameterSetID.h"
+
+namespace mu2e {
+
+  SpectrumTable::SpectrumTable(BinnedSpectrum spectrum) :
+    _spectrum(std::move(spectrum))
+  {
+    const std::size_t n = _spectrum.getNbins();
+    if(n == 0) {
+      throw cet::exception("BADCONFIG")<<"SpectrumTable: empty spectrum\n";
+    }
+
+    // Cumulative distribution, computed as CLHEP::RandGeneral::prepareTable so that
+    // inverseCDF() reproduces RandGeneral bit for bit; negative weights count as 0.
+    _cdf.resize(n+1);
+    _cdf[0] = 0.;
+    for(std::size_t i=0; i<n; ++i) {
+      _cdf[i+1] = _cdf[i] + std::max(_spectrum.getPDF(i), 0.);
+    }
+    const double total = _cdf[n];
+    if(!(total > 0.)) {
+      throw cet::exception("BADCONFIG")<<"SpectrumTable: the spectrum has no positive weight\n";
+    }
+    for(auto& c : _cdf) c /= total;
+    _oneOverNbins = 1.0/n;
+
+    // Walker alias table, with Vose's construction: bins below the mean weight
+    // are topped up by bins above it, each bin ends up holding one alias
+    _prob.resize(n);
+    _alias.resize(n);
+    std::vector<double> scaled(n);
+    std::vector<unsigned> small, large;
+    for(std::size_t i=0; i<n; ++i) {
+      scaled[i] = std::max(_spectrum.getPDF(i), 0.)*n/total;
+      _alias[i] = i;
+      if(scaled[i] < 1.) small.push_back(i);
+      else               large.push_back(i);
+    }
+    while(!small.empty() && !large.empty()) {
+      const unsigned s = small.back(); small.pop_back();
+      const unsigned l = large.back();
+      _prob[s]  = scaled[s];
+      _alias[s] = l;
+      scaled[l] -= 1. - scaled[s];
+      if(scaled[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // what is left is 1 up to rounding
+    for(auto i : large) _prob[i] = 1.;
+    for(auto i : small) _prob[i] = 1.;
+  }
+
+  double SpectrumTable::inverseCDF(double u) const {
+    // the bin k with _cdf[k] <= u < _cdf[k+1]
+    const std::size_t n = nbins();
+    std::size_t k = std::upper_bound(_cdf.begin(), _cdf.end(), u) - _cdf.begin();
+    k = std::min(std::max(k, std::size_t(1)), n) - 1;
+    const double binMeasure = _cdf[k+1] - _cdf[k];
+    if(binMeasure == 0) return (k + .5)*_oneOverNbins;
+    const double binFraction = (u - _cdf[k])/binMeasure;
+    return (k + binFraction)*_oneOverNbins;
+  }
+
+  double SpectrumTable::alias(double u1, double u2) const {
+    const double x = u1*nbins();
+    std::size_t k = std::min(std::size_t(x), nbins()-1);
+    if(x - k >= _prob[k]) k = _alias[k];
+    return (k + u2)*_oneOverNbins;
+  }
+
+  std::shared_ptr<const SpectrumTable> SpectrumTable::cached(const fhicl::ParameterSet& psphys) {
+    static std::mutex mutex;
+    static std::map<fhicl::ParameterSetID, std::shared_ptr<const SpectrumTable> > tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& table = tables[psphys.id()];
+    if(!table) table = std::make_shared<const SpectrumTable>(BinnedSpectrum(psphys));
+    return table;
+  }
+
+  //================================================================
+  SpectrumSampler::Method SpectrumSampler::parseMethod(const std::string& name) {
+    if(name == "inverseCDF") return inverseCDF;
+    if(name == "alias")      return alias;
+    throw cet::exception("BADCONFIG")<<"SpectrumSampler: unknown samplingMethod "<<name<<"\n";
+  }
+
+  SpectrumSampler::SpectrumSampler(CLHEP::HepRandomEngine& engine, std::shared_ptr<const SpectrumTable> table, Method method) :
+    _engine(&engine),
+    _table(std::move(table)),
+    _method(method)
+  {}
+
+  SpectrumSampler::SpectrumSampler(CLHEP::HepRandomEngine& engine, const fhicl::ParameterSet& psphys) :
+    SpectrumSampler(engine, SpectrumTable::cached(psphys), parseMethod(psphys.get<std::string>("samplingMethod", "inverseCDF")))
+  {}
+
+  double SpectrumSampler::fire() {
+    if(_method == alias) {
+      const double u1 = _engine->flat();
+      return _table->alias(u1, _engine->flat());
+    }
+    return _table->inverseCDF(_engine->flat());
+  }
+
+  void SpectrumSampler::fireArray(std::size_t n, double* out) {
+    if(_method == alias) {
+      _flat.resize(2*n);
+      _engine->flatArray(2*n, _flat.data());
+      for(std::size_t i=0; i<n; ++i) out[i] = _table->alias(_flat[2*i], _flat[2*i+1]);
+    }
+    else {
+      _engine->flatArray(n, out);
+      for(std::size_t i=0; i<n; ++i) out[i] = _table->inverseCDF(out[i]);
+    }
+  }
+
+  void SpectrumSampler::sampleArray(std::size_t n, double* out) {
+    fireArray(n, out);
+    const auto& spectrum = _table->spectrum();
+    for(std::size_t i=0; i<n; ++i) out[i] = spectrum.sample(out[i]);
+  }
+
+} // end of namespace mu2e
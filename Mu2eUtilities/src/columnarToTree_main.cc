@@ -0,0 +1,113 @@
+// Convert a columnar file (Mu2eUtilities/inc/ColumnarFile.hh), such as the
+// output of the ColumnarNtupleMaker module, to a ROOT file with one flat
+// TTree per table and one branch per column, for interactive use.
+//
+// Usage:
+//   columnarToTree --output <file.root> <input.col>
+//
+
+#include "Offline/Mu2eUtilities/inc/ColumnarFile.hh"
+
+#include "cetlib_except/exception.h"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+  void usage() {
+    std::cerr<<"Usage: columnarToTree --output <file.root> <input.col>\n";
+  }
+
+  const char* leafType(mu2e::ColumnType type) {
+    switch(type) {
+    case mu2e::ColumnType::Float32: return "F";
+    case mu2e::ColumnType::Float64: return "D";
+    case mu2e::ColumnType::Int32:   return "I";
+    case mu2e::ColumnType::UInt32:  return "i";
+    case mu2e::ColumnType::Int64:   return "L";
+    }
+    return "";
+  }
+
+  template<class T>
+  std::vector<char> columnBytes(const mu2e::ColumnarReader& reader, const std::string& table, const std::string& column) {
+    auto values = reader.column<T>(table, column);
+    std::vector<char> bytes(values.size()*sizeof(T));
+    if(!values.empty()) std::memcpy(bytes.data(), values.data(), bytes.size());
+    return bytes;
+  }
+
+  void convert(const std::string& input, const std::string& output) {
+    mu2e::ColumnarReader reader(input);
+    std::unique_ptr<TFile> outfile(TFile::Open(output.c_str(), "RECREATE"));
+    if(!outfile || outfile->IsZombie()) {
+      throw cet::exception("BADINPUT")<<"columnarToTree: can not create \""<<output<<"\"\n";
+    }
+
+    for(const auto& table : reader.tables()) {
+      const auto& columns = reader.columns(table);
+      const std::size_t nrows = reader.rows(table);
+
+      std::vector<std::vector<char>> data;
+      for(const auto& c : columns) {
+        switch(c.type) {
+        case mu2e::ColumnType::Float32: data.push_back(columnBytes<float>   (reader, table, c.name)); break;
+        case mu2e::ColumnType::Float64: data.push_back(columnBytes<double>  (reader, table, c.name)); break;
+        case mu2e::ColumnType::Int32:   data.push_back(columnBytes<int32_t> (reader, table, c.name)); break;
+        case mu2e::ColumnType::UInt32:  data.push_back(columnBytes<uint32_t>(reader, table, c.name)); break;
+        case mu2e::ColumnType::Int64:   data.push_back(columnBytes<int64_t> (reader, table, c.name)); break;
+        }
+      }
+
+      TTree *tree = new TTree(table.c_str(), table.c_str());
+      std::vector<char> row(columns.size()*sizeof(int64_t));
+      for(std::size_t i=0; i<columns.size(); ++i) {
+        const std::string leaflist = columns[i].name + "/" + leafType(columns[i].type);
+        tree->Branch(columns[i].name.c_str(), row.data() + i*sizeof(int64_t), leaflist.c_str());
+      }
+      for(std::size_t r=0; r<nrows; ++r) {
+        for(std::size_t i=0; i<columns.size(); ++i) {
+          const std::size_t size = mu2e::columnTypeSize(columns[i].type);
+          std::memcpy(row.data() + i*sizeof(int64_t), data[i].data() + r*size, size);
+        }
+        tree->Fill();
+      }
+      tree->Write();
+      std::cout<<"columnarToTree: wrote "<<nrows<<" rows of table "<<table<<std::endl;
+    }
+    outfile->Close();
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::string output;
+  std::vector<std::string> inputs;
+  for(int i=1; i<argc; ++i) {
+    const std::string arg(argv[i]);
+    if     (arg == "--output" && i+1 < argc) output = argv[++i];
+    else if(arg == "-h" || arg == "--help") { usage(); return 0; }
+    else if(arg.rfind("--", 0) == 0) { usage(); return 1; }
+    else inputs.push_back(arg);
+  }
+  if(output.empty() || inputs.size() != 1) {
+    usage();
+    return 1;
+  }
+
+  try {
+    convert(inputs[0], output);
+  }
+  catch(const cet::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 2;
+  }
+  return 0;
+}
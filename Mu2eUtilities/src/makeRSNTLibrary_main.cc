@@ -0,0 +1,145 @@
+// Convert the ROOT ntuples read by RootTreeSampler into a binary record
+// library (GeneralUtilities/inc/RSNTLibrary.hh), to be given to the
+// samplers as libraryFiles.  The records of all the inputs are written in
+// order; with --pie the events of the "particle in event" branch are kept.
+//
+// Usage:
+//   makeRSNTLibrary --type <record type> --tree <tree> --branch <branch> [--pie <branch>]
+//                   --output <library> <input.root> [<input.root> ...]
+//
+// record types: StoppedParticleF, StoppedParticleTauNormF, InFlightParticleD
+//
+// Example, stopped muons:
+//   makeRSNTLibrary --type StoppedParticleF --tree stoppedMuonDumper/stops --branch stops \
+//                   --output muonStops.rsl mustops.root
+//
+
+#include "Offline/GeneralUtilities/inc/RSNTIO.hh"
+#include "Offline/GeneralUtilities/inc/RSNTLibrary.hh"
+
+#include "cetlib_except/exception.h"
+
+#include "TBranch.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+  struct Options {
+    std::string type;
+    std::string tree;
+    std::string branch;
+    std::string pie;
+    std::string output;
+    std::vector<std::string> inputs;
+  };
+
+  void usage() {
+    std::cerr<<"Usage: makeRSNTLibrary --type <record type> --tree <tree> --branch <branch> [--pie <branch>]\n"
+             <<"                       --output <library> <input.root> [<input.root> ...]\n"
+             <<"record types: StoppedParticleF, StoppedParticleTauNormF, InFlightParticleD\n";
+  }
+
+  template<class NtupleRecord>
+  void convert(const Options& opt) {
+    const bool correlated = !opt.pie.empty();
+    mu2e::RSNTLibraryWriter<NtupleRecord> writer(opt.output, correlated);
+
+    for(const auto& fn : opt.inputs) {
+      std::unique_ptr<TFile> infile(TFile::Open(fn.c_str(), "READ"));
+      if(!infile || infile->IsZombie()) {
+        throw cet::exception("BADINPUT")<<"makeRSNTLibrary: can not open \""<<fn<<"\"\n";
+      }
+      TTree *nt = dynamic_cast<TTree*>(infile->Get(opt.tree.c_str()));
+      if(!nt) {
+        throw cet::exception("BADINPUT")<<"makeRSNTLibrary: Could not get tree \""<<opt.tree
+                                        <<"\" from file \""<<fn<<"\"\n";
+      }
+      TBranch *bb = nt->GetBranch(opt.branch.c_str());
+      if(!bb) {
+        throw cet::exception("BADINPUT")<<"makeRSNTLibrary: Could not get branch \""<<opt.branch
+                                        <<"\" in tree \""<<opt.tree<<"\" from file \""<<fn<<"\"\n";
+      }
+      if(unsigned(bb->GetNleaves()) != NtupleRecord::numBranchLeaves()) {
+        throw cet::exception("BADINPUT")<<"makeRSNTLibrary: wrong number of leaves: expect "
+                                        <<NtupleRecord::numBranchLeaves()<<", but branch \""<<opt.branch
+                                        <<"\" in file \""<<fn<<"\" has "<<bb->GetNleaves()<<"\n";
+      }
+      NtupleRecord ntr;
+      bb->SetAddress(&ntr);
+
+      TBranch *pieb = nullptr;
+      unsigned particleInEvent(-1);
+      if(correlated) {
+        pieb = nt->GetBranch(opt.pie.c_str());
+        if(!pieb) {
+          throw cet::exception("BADINPUT")<<"makeRSNTLibrary: Could not get branch \""<<opt.pie
+                                          <<"\" in tree \""<<opt.tree<<"\" from file \""<<fn<<"\"\n";
+        }
+        pieb->SetAddress(&particleInEvent);
+      }
+
+      const Long64_t nTreeEntries = nt->GetEntries();
+      std::cout<<"makeRSNTLibrary: reading "<<nTreeEntries<<" entries from "<<fn<<std::endl;
+      for(Long64_t i=0; i<nTreeEntries; ++i) {
+        if(correlated) {
+          pieb->GetEntry(i);
+          if(i == 0 && particleInEvent != 0) {
+            throw cet::exception("BADINPUT")<<"makeRSNTLibrary: Error: unexpected particleInEvent!=0 "
+                                            <<"at the start of \""<<fn<<"\"\n";
+          }
+          if(particleInEvent == 0) writer.beginEvent();
+        }
+        bb->GetEntry(i);
+        writer.add(ntr);
+      }
+      bb->ResetAddress();
+      if(pieb) pieb->ResetAddress();
+    }
+
+    writer.close();
+    std::cout<<"makeRSNTLibrary: wrote "<<writer.numRecords()<<" records to "<<opt.output<<std::endl;
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  for(int i=1; i<argc; ++i) {
+    const std::string arg(argv[i]);
+    const bool hasValue = i+1 < argc;
+    if     (arg == "--type"   && hasValue) opt.type   = argv[++i];
+    else if(arg == "--tree"   && hasValue) opt.tree   = argv[++i];
+    else if(arg == "--branch" && hasValue) opt.branch = argv[++i];
+    else if(arg == "--pie"    && hasValue) opt.pie    = argv[++i];
+    else if(arg == "--output" && hasValue) opt.output = argv[++i];
+    else if(arg == "-h" || arg == "--help") { usage(); return 0; }
+    else if(arg.rfind("--", 0) == 0) { usage(); return 1; }
+    else opt.inputs.push_back(arg);
+  }
+  if(opt.type.empty() || opt.tree.empty() || opt.branch.empty() || opt.output.empty() || opt.inputs.empty()) {
+    usage();
+    return 1;
+  }
+
+  try {
+    if     (opt.type == "StoppedParticleF")        convert<mu2e::IO::StoppedParticleF>(opt);
+    else if(opt.type == "StoppedParticleTauNormF") convert<mu2e::IO::StoppedParticleTauNormF>(opt);
+    else if(opt.type == "InFlightParticleD")       convert<mu2e::IO::InFlightParticleD>(opt);
+    else {
+      std::cerr<<"makeRSNTLibrary: unknown record type "<<opt.type<<"\n";
+      usage();
+      return 1;
+    }
+  }
+  catch(const cet::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 2;
+  }
+  return 0;
+}
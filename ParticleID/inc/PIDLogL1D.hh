@@ -1,5 +1,7 @@
 // This class represents a 1D distribution used in particle ID
-// determination.
+// determination.  The log-density is tabulated at construction, so
+// value() is a lookup (optionally interpolated between bin centers)
+// and the object can be shared between threads.
 //
 // Andrei Gaponenko, 2016
 
@@ -10,6 +12,7 @@
 #include <vector>
 
 #include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
 
 #include "fhiclcpp/ParameterSet.h"
 
@@ -20,11 +23,18 @@ namespace mu2e {
   class PIDLogL1D {
     static double binValueCutoff_;
     Binning axis_;
-    std::vector<double> vals_;
+    // log(max(binValueCutoff_, normalized bin content))
+    std::vector<double> logvals_;
+    bool interpolate_;
+
+    void readTextFile(const std::string& resolvedFileName);
 
   public:
     double value(double x) const;
 
+    // Batch evaluation: res[i] = value(x[i])
+    void values(std::vector<double>& res, const std::vector<double>& x) const;
+
     // the smallest value() that is returned instead of log(0) if
     // the distribution vanishes at the given x.
     static double cutoff();
@@ -33,6 +43,15 @@ namespace mu2e {
       fhicl::Atom<std::string> inputFile {fhicl::Name("inputFile"),
           fhicl::Comment("File with a text representation of the distribution")
           };
+
+      fhicl::Atom<bool> interpolate {fhicl::Name("interpolate"),
+          fhicl::Comment("Interpolate the log-density linearly between bin centers"),
+          false
+          };
+
+      fhicl::OptionalAtom<std::string> cacheFile {fhicl::Name("cacheFile"),
+          fhicl::Comment("Binary cache of the tabulated distribution. Read if up to date with inputFile, (re)written otherwise.")
+          };
     };
 
     explicit PIDLogL1D(const Config& conf);
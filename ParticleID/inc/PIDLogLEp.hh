@@ -2,6 +2,10 @@
 // of projected track path in the calorimeter.  Based on Stntuple's
 // TEmuLogLH by Pasha Murat.
 //
+// The log-density is tabulated at construction, so value() is a lookup
+// (optionally interpolated in E/p between bin centers within a path
+// slice) and the object can be shared between threads.
+//
 // Andrei Gaponenko, 2016
 
 #ifndef ParticleID_inc_PIDLogLEp_hh
@@ -11,6 +15,7 @@
 #include <vector>
 
 #include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
 #include "fhiclcpp/types/Sequence.h"
 
 #include "fhiclcpp/ParameterSet.h"
@@ -24,12 +29,21 @@ namespace mu2e {
     static double binValueCutoff_;
     Binning epaxis_;
     NUBinning pathaxis_;
-    // Outer container is vs path, inner is E/p slice
-    std::vector<std::vector<double> > vals_;
+    // log(max(binValueCutoff_, normalized bin content)), one E/p
+    // slice after another: index = pathbin*epaxis_.nbins() + epbin
+    std::vector<double> logvals_;
+    bool interpolate_;
+
+    void readTextFile(const std::string& resolvedFileName);
 
   public:
     double value(double x, double y) const;
 
+    // Batch evaluation: res[i] = value(ep[i], path[i])
+    void values(std::vector<double>& res,
+                const std::vector<double>& ep,
+                const std::vector<double>& path) const;
+
     // the smallest value() that is returned instead of log(0) if
     // the distribution vanishes at the given x.
     static double cutoff();
@@ -42,6 +56,15 @@ namespace mu2e {
       fhicl::Sequence<double> pathBinBoundaries{fhicl::Name("pathBinBoundaries"),
           fhicl::Comment("Use E/p distributions for the given slices of projected track path length.")
           };
+
+      fhicl::Atom<bool> interpolate {fhicl::Name("interpolate"),
+          fhicl::Comment("Interpolate the log-density in E/p linearly between bin centers"),
+          false
+          };
+
+      fhicl::OptionalAtom<std::string> cacheFile {fhicl::Name("cacheFile"),
+          fhicl::Comment("Binary cache of the tabulated distributions. Read if up to date with inputFile and pathBinBoundaries, (re)written otherwise.")
+          };
     };
 
     explicit PIDLogLEp(const Config& conf);
@@ -5,6 +5,8 @@
 #ifndef ParticleID_inc_PIDLogLRatio_hh
 #define ParticleID_inc_PIDLogLRatio_hh
 
+#include <vector>
+
 #include "fhiclcpp/types/Table.h"
 
 #include "fhiclcpp/ParameterSet.h"
@@ -27,6 +29,19 @@ namespace mu2e {
         ps - backgroundHypothesis_.value(x...);
     }
 
+    // Batch evaluation over all candidates of an event: res[i] is
+    // value() for the i-th element of each input vector.  Reentrant;
+    // the scratch buffer is local to the call.
+    template<typename ... Args>
+    void values(std::vector<double>& res, const Args&... x) const {
+      std::vector<double> pb;
+      signalHypothesis_.values(res, x...);
+      backgroundHypothesis_.values(pb, x...);
+      for(std::size_t i=0; i<res.size(); ++i) {
+        res[i] = (res[i] <= LogL::cutoff()) ? LogL::cutoff() : res[i] - pb[i];
+      }
+    }
+
     static double cutoff() { return LogL::cutoff(); }
 
     const LogL& signalLogLikelihood() const { return signalHypothesis_; }
@@ -0,0 +1,47 @@
+// Compact binary cache for the PID likelihood tables.  Parsing the
+// text histograms is the slow part of constructing PIDLogL1D and
+// PIDLogLEp, so the already normalized log-density tables are written
+// to a cache file and reused by later jobs.
+//
+// A cache is valid only for the source file it was made from (size and
+// modification time), the format version, and a set of configuration
+// values that affect the table content (e.g. the E/p path slices).
+// Anything else makes read() return false, and the caller rebuilds the
+// table from the text file and rewrites the cache.
+
+#ifndef ParticleID_inc_PIDTableCache_hh
+#define ParticleID_inc_PIDTableCache_hh
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class PIDTableCache {
+  public:
+    // increment whenever the file layout changes
+    static constexpr uint32_t formatVersion = 1;
+    static constexpr uint32_t magic = 0x4d325054; // "M2PT"
+
+    PIDTableCache(const std::string& cacheFile,
+                  const std::string& sourceFile,
+                  const std::vector<double>& key);
+
+    // axis holds the binning parameters, table the bin contents
+    bool read(std::vector<double>& axis, std::vector<double>& table) const;
+
+    // Failure to write is reported but not fatal.
+    bool write(const std::vector<double>& axis, const std::vector<double>& table) const;
+
+  private:
+    std::string cacheFile_;
+    std::string sourceFile_;
+    std::vector<double> key_;
+    uint64_t sourceSize_ = 0;
+    int64_t sourceMtime_ = 0;
+  };
+
+}
+
+#endif/*ParticleID_inc_PIDTableCache_hh*/
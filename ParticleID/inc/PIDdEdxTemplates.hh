@@ -0,0 +1,75 @@
+// dE/dx probability of the straw hits of a track for one particle
+// hypothesis, as used by AvikPID and AvikPIDNew: there is one energy
+// deposition template per gas path bound, and the template of a hit is
+// morphed (PIDUtilities::th1dmorph) between the two bounds which
+// bracket its path.
+//
+// By default every hit is morphed, as the modules always did.  With a
+// positive pathStep the morphed templates are instead tabulated at
+// construction on a grid of paths, pathStep apart within each pair of
+// bounds, and a track is evaluated by table lookups, interpolated
+// linearly in path between the grid nodes.  The table is exact at the
+// nodes, and its difference to the morphing is measured at construction
+// in the middle of every grid step: a pair of bounds where it exceeds
+// the tolerance, relative to the maximum of the morphed template, keeps
+// the morphing per hit.  This is the case of templates which are far
+// apart, where the morphing moves the peak by more than a bin within a
+// step.  The templates are not owned and must outlive the object.
+
+#ifndef ParticleID_inc_PIDdEdxTemplates_hh
+#define ParticleID_inc_PIDdEdxTemplates_hh
+
+#include <algorithm>
+#include <vector>
+
+class TH1D;
+
+namespace mu2e {
+
+  class PIDdEdxTemplates {
+  public:
+    // templates[i] is the energy deposition distribution for a gas path of
+    // pathBounds[i]; all the templates have the binning of templates[0],
+    // starting at 0
+    PIDdEdxTemplates(TH1D* const* templates, const float* pathBounds, int nBounds,
+                     double pathStep = 0, double tolerance = 0.01);
+
+    // product of the template probabilities of the hits with a path between
+    // the first and the last bound; hits with a vanishing probability are left out
+    double probability(const std::vector<double>& gasPaths, const std::vector<double>& eDeps) const;
+
+    bool   tabulated() const { return !_table.empty(); }
+    // number of tabulated morphed templates
+    int    nNodes()    const { return _table.size()/(_nbins+2); }
+    // number of pairs of bounds left to the morphing per hit in a table
+    int    nMorphedPairs() const { return std::count(_nSteps.begin(), _nSteps.end(), 0); }
+    // largest |table - morphing| over the bins of the tabulated pairs,
+    // relative to the largest bin of the morphed template
+    double maxTableDeviation() const { return _maxDeviation; }
+
+  private:
+    // largest |interpolation - morphing| in the steps of the nodes, relative to the morphed maximum
+    double deviation(TH1D* const* templates, int k, const std::vector<double>& nodes, int nsteps) const;
+    // pair of bounds low < path <= high
+    int    boundPair(double path) const;
+    // template bin of the energy deposition, as TH1::GetBinContent would find it
+    int    edepBin(double eDep) const;
+    double morphedProbability(int k, double path, double eDep) const;
+    double tabulatedProbability(int k, double path, double eDep) const;
+
+    std::vector<TH1D*>  _templates;
+    std::vector<float>  _bounds;
+    int                 _nbins;
+    float               _lastBin;
+    float               _binSize;
+    std::vector<int>    _firstNode;  // first grid node of each pair of bounds
+    std::vector<int>    _nSteps;     // number of grid steps between each pair of bounds, 0 if morphed
+    // bin contents of the morphed templates, nbins+2 per grid node with the
+    // ROOT numbering: 0 and nbins+1 are the (empty) underflow and overflow
+    std::vector<double> _table;
+    double              _maxDeviation = 0;
+  };
+
+}
+
+#endif/*ParticleID_inc_PIDdEdxTemplates_hh*/
@@ -0,0 +1,20 @@
+// Linear interpolation of values tabulated at the centers of the bins
+// of a uniform axis: the result at x, which is in bin i, interpolates
+// between bin i and its neighbor on the side of x.  It is constant in
+// the outer halves of the first and last bins.
+//
+// Used by the tabulated PID likelihoods, PIDLogL1D and PIDLogLEp.
+
+#ifndef ParticleID_inc_interpolateBins_hh
+#define ParticleID_inc_interpolateBins_hh
+
+#include "Offline/GeneralUtilities/inc/Binning.hh"
+
+namespace mu2e {
+
+  // v points to the axis.nbins() tabulated values
+  double interpolateBins(const double* v, const Binning& axis, Binning::IndexType i, double x);
+
+}
+
+#endif/*ParticleID_inc_interpolateBins_hh*/
@@ -9,6 +9,7 @@
 
 // C++ includes.
 #include <iostream>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -46,7 +47,7 @@
 
 #include "Offline/RecoDataProducts/inc/TrkFitDirection.hh"
 
-#include "Offline/ParticleID/inc/PIDUtilities.hh"
+#include "Offline/ParticleID/inc/PIDdEdxTemplates.hh"
 #include "Offline/RecoDataProducts/inc/AvikPIDNewProduct.hh"
 
 #include "Offline/ProditionsService/inc/ProditionsHandle.hh"
@@ -93,9 +94,9 @@ namespace mu2e {
     TH1D* _heletemp[kNbounds];
     TH1D* _hmuotemp[kNbounds];
 
-    int   _templatesnbins ;
-    float _templateslastbin ;
-    float _templatesbinsize ;
+    double _dedxPathStep;
+    std::unique_ptr<PIDdEdxTemplates> _eleDedx;
+    std::unique_ptr<PIDdEdxTemplates> _muoDedx;
 
     const KalRepPtrCollection* _listOfTracks;
 
@@ -153,14 +154,9 @@ namespace mu2e {
     virtual void endJob     ();
 
     static  void myfcn(Int_t &, Double_t *, Double_t &f, Double_t *par, Int_t);
-    static  int  findlowhist(float d);
 
     bool   calculateVadimSlope(const KalRep* KRep, double *Slope, double *Eslope);
 
-    double calculateDedxProb  (std::vector<double>* GasPaths ,
-                               std::vector<double>* EDeps    ,
-                               TH1D**               Templates);
-
     void   doubletMaker(const KalRep* Trk);
 
     //    double calculateAvikSums();
@@ -215,29 +211,6 @@ namespace mu2e {
     }
   }
 
-//-----------------------------------------------------------------------------
-  int AvikPIDNew::findlowhist(float d) {
-
-    if (d<=AvikPIDNew::_pathbounds[0]) return 0;
-
-    else if (d>_pathbounds[0] && d<=_pathbounds[1]) return 0;
-    else if (d>_pathbounds[1] && d<=_pathbounds[2]) return 1;
-    else if (d>_pathbounds[2] && d<=_pathbounds[3]) return 2;
-    else if (d>_pathbounds[3] && d<=_pathbounds[4]) return 3;
-    else if (d>_pathbounds[4] && d<=_pathbounds[5]) return 4;
-    else if (d>_pathbounds[5] && d<=_pathbounds[6]) return 5;
-    else if (d>_pathbounds[6] && d<=_pathbounds[7]) return 6;
-    else if (d>_pathbounds[7] && d<=_pathbounds[8]) return 7;
-    else if (d>_pathbounds[8] && d<=_pathbounds[9]) return 8;
-    else if (d>_pathbounds[9] && d<=_pathbounds[10]) return 9;
-    else if (d>_pathbounds[10]) return 10;
-    else {
-      printf ("AvikPIDNew::findlowhist ERROR: d=%12.5e is out of  bounds. BAIL OUT\n",d);
-    }
-
-    return -9999;
-  }
-
 //-----------------------------------------------------------------------------
   AvikPIDNew::AvikPIDNew(fhicl::ParameterSet const& pset):
     art::EDProducer{pset},
@@ -246,6 +219,7 @@ namespace mu2e {
     _trkRecModuleLabel      (pset.get<string>             ("trkRecModuleLabel"   )),
     _eleDedxTemplateFile    (pset.get<std::string>        ("eleDedxTemplateFile" )),
     _muoDedxTemplateFile    (pset.get<std::string>        ("muoDedxTemplateFile" )),
+    _dedxPathStep           (pset.get<double>             ("dedxPathStep",0.     )),
     _darPset                (pset.get<fhicl::ParameterSet>("DoubletAmbigResolver")),
     _pidtree                (0)
   {
@@ -272,11 +246,17 @@ namespace mu2e {
       muoDedxTemplateFile->GetObject(name,_hmuotemp[i]);
     }
 //-----------------------------------------------------------------------------
-// all dE/dX template histograms are supposed to have the same limits and Nbins
+// all dE/dX template histograms are supposed to have the same limits and Nbins;
+// with a positive dedxPathStep the morphed templates are tabulated once
+// instead of morphed for every hit
 //-----------------------------------------------------------------------------
-    _templatesnbins   = _heletemp[0]->GetNbinsX();
-    _templateslastbin = _heletemp[0]->GetBinLowEdge(_templatesnbins)+_heletemp[0]->GetBinWidth(1);
-    _templatesbinsize = _heletemp[0]->GetBinWidth(1);
+    _eleDedx = std::make_unique<PIDdEdxTemplates>(_heletemp,_pathbounds,kNbounds,_dedxPathStep);
+    _muoDedx = std::make_unique<PIDdEdxTemplates>(_hmuotemp,_pathbounds,kNbounds,_dedxPathStep);
+    if (_dedxPathStep > 0) {
+      cout << "AvikPIDNew: dE/dx templates tabulated in " << _eleDedx->nNodes() << " path nodes, " << _eleDedx->nMorphedPairs() << " (ele) " << _muoDedx->nMorphedPairs()
+           << " (muo) path intervals left to the morphing, largest deviation from the morphing "
+           << _eleDedx->maxTableDeviation() << " (ele) " << _muoDedx->maxTableDeviation() << " (muo) of the template maximum" << endl;
+    }
 //-----------------------------------------------------------------------------
 // Avik function parameters for dRdz slope residuals
 //-----------------------------------------------------------------------------
@@ -522,48 +502,6 @@ namespace mu2e {
     }
   }
 
-//-----------------------------------------------------------------------------
-  double AvikPIDNew::calculateDedxProb(std::vector<double>* GasPaths ,
-                                       std::vector<double>* EDeps    ,
-                                       TH1D**               Templates) {
-
-    static const double _minpath = 0.5;
-    static const double _maxpath = 10.;
-
-    double thisprob = 1;
-
-    for (unsigned int ipath = 0; ipath < GasPaths->size(); ipath++){
-      double thispath = GasPaths->at(ipath);
-      double thisedep = EDeps->at(ipath);
-
-      double tmpprob = 0;
-      if (thispath > _minpath && thispath<=_maxpath){
-          int lowhist = findlowhist(thispath);
-
-          PIDUtilities util;
-          TH1D* hinterp = util.th1dmorph(Templates[lowhist],
-                                         Templates[lowhist+1],
-                                         _pathbounds[lowhist],
-                                         _pathbounds[lowhist+1],
-                                         thispath,1,0);
-//-----------------------------------------------------------------------------
-// probability for this edep
-//-----------------------------------------------------------------------------
-          int thisedepbin = -999;
-          if (thisedep > _templateslastbin) thisedepbin = _templatesnbins;
-          else                              thisedepbin = int(thisedep/_templatesbinsize)+1;
-
-          tmpprob=hinterp->GetBinContent(thisedepbin);
-
-          hinterp->Delete();
-        }
-
-      if (tmpprob> 0) thisprob = thisprob * tmpprob;
-    }
-
-    return thisprob;
-  }
-
 //-----------------------------------------------------------------------------
 // the straight line fit should be done explicitly
 //-----------------------------------------------------------------------------
@@ -972,9 +910,9 @@ namespace mu2e {
         }
       }
 
-      dedx_prob_ele   = calculateDedxProb(&gaspaths, &edeps, _heletemp);
+      dedx_prob_ele   = _eleDedx->probability(gaspaths, edeps);
       _logDedxProbEle = log(dedx_prob_ele);
-      dedx_prob_muo   = calculateDedxProb(&gaspaths, &edeps, _hmuotemp);
+      dedx_prob_muo   = _muoDedx->probability(gaspaths, edeps);
       _logDedxProbMuo = log(dedx_prob_muo);
 //-----------------------------------------------------------------------------
 // calculate ddR/ds slope for the electron tracks
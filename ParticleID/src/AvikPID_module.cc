@@ -10,6 +10,7 @@
 
 // C++ includes.
 #include <iostream>
+#include <memory>
 #include <string>
 #include <sstream>
 
@@ -47,7 +48,7 @@
 
 #include "Offline/RecoDataProducts/inc/TrkFitDirection.hh"
 
-#include "Offline/ParticleID/inc/PIDUtilities.hh"
+#include "Offline/ParticleID/inc/PIDdEdxTemplates.hh"
 #include "Offline/RecoDataProducts/inc/AvikPIDProduct.hh"
 
 #include "Offline/ProditionsService/inc/ProditionsHandle.hh"
@@ -100,9 +101,9 @@ namespace mu2e {
     TH1D* _heletemp[nbounds];
     TH1D* _hmuotemp[nbounds];
 
-    int   _templatesnbins ;
-    float _templateslastbin ;
-    float _templatesbinsize ;
+    double _dedxPathStep;
+    std::unique_ptr<PIDdEdxTemplates> _eleDedx;
+    std::unique_ptr<PIDdEdxTemplates> _muoDedx;
 
     const KalRepPtrCollection* _listOfEleTracks;
     const KalRepPtrCollection* _listOfMuoTracks;
@@ -184,14 +185,9 @@ namespace mu2e {
     void endJob();
 
     static  void myfcn(Int_t &, Double_t *, Double_t &f, Double_t *par, Int_t);
-    static  int  findlowhist(float d);
 
     bool calculateVadimSlope(const KalRep* KRep, double *Slope, double *Eslope);
 
-    double calculateDedxProb(std::vector<double>* GasPaths ,
-                             std::vector<double>* EDeps    ,
-                             TH1D**               Templates);
-
     void   doubletMaker(const KalRep* ele_Trk, const KalRep* muo_Trk);
 
     //    double calculateAvikSums();
@@ -246,30 +242,6 @@ namespace mu2e {
     }
   }
 
-//-----------------------------------------------------------------------------
-  int AvikPID::findlowhist(float d){
-
-    if (d<=AvikPID::_pathbounds[0]) return 0;
-
-    else if (d>_pathbounds[0] && d<=_pathbounds[1]) return 0;
-    else if (d>_pathbounds[1] && d<=_pathbounds[2]) return 1;
-    else if (d>_pathbounds[2] && d<=_pathbounds[3]) return 2;
-    else if (d>_pathbounds[3] && d<=_pathbounds[4]) return 3;
-    else if (d>_pathbounds[4] && d<=_pathbounds[5]) return 4;
-    else if (d>_pathbounds[5] && d<=_pathbounds[6]) return 5;
-    else if (d>_pathbounds[6] && d<=_pathbounds[7]) return 6;
-    else if (d>_pathbounds[7] && d<=_pathbounds[8]) return 7;
-    else if (d>_pathbounds[8] && d<=_pathbounds[9]) return 8;
-    else if (d>_pathbounds[9] && d<=_pathbounds[10]) return 9;
-    else if (d>_pathbounds[10]) return 10;
-
-    else {
-      cout<<"Out of  bounds. Should never end up here\n";
-    }
-
-    return -9999.;
-  }
-
 //-----------------------------------------------------------------------------
   AvikPID::AvikPID(fhicl::ParameterSet const& pset):
     art::EDProducer{pset},
@@ -281,6 +253,7 @@ namespace mu2e {
 
     _eleDedxTemplateFile(pset.get<std::string>("EleDedxTemplateFile")),
     _muoDedxTemplateFile(pset.get<std::string>("MuoDedxTemplateFile")),
+    _dedxPathStep       (pset.get<double>("DedxPathStep",0.)),
 
     _darPset            (pset.get<fhicl::ParameterSet>("DoubletAmbigResolver")),
 
@@ -312,11 +285,16 @@ namespace mu2e {
     }
 //-----------------------------------------------------------------------------
 // all electron and muon De/Dx template histograms are supposed to have the
-// same limits and number of bins
-//-----------------------------------------------------------------------------
-    _templatesnbins   = _heletemp[0]->GetNbinsX();
-    _templateslastbin = _heletemp[0]->GetBinLowEdge(_templatesnbins)+_heletemp[0]->GetBinWidth(1);
-    _templatesbinsize = _heletemp[0]->GetBinWidth(1);
+// same limits and number of bins; with a positive DedxPathStep the morphed
+// templates are tabulated once instead of morphed for every hit
+//-----------------------------------------------------------------------------
+    _eleDedx = std::make_unique<PIDdEdxTemplates>(_heletemp,_pathbounds,nbounds,_dedxPathStep);
+    _muoDedx = std::make_unique<PIDdEdxTemplates>(_hmuotemp,_pathbounds,nbounds,_dedxPathStep);
+    if (_dedxPathStep > 0) {
+      cout << "AvikPID: dE/dx templates tabulated in " << _eleDedx->nNodes() << " path nodes, " << _eleDedx->nMorphedPairs() << " (ele) " << _muoDedx->nMorphedPairs()
+           << " (muo) path intervals left to the morphing, largest deviation from the morphing "
+           << _eleDedx->maxTableDeviation() << " (ele) " << _muoDedx->maxTableDeviation() << " (muo) of the template maximum" << endl;
+    }
 //-----------------------------------------------------------------------------
 // Avik function parameters for dRdz slope residuals
 //-----------------------------------------------------------------------------
@@ -743,48 +721,6 @@ namespace mu2e {
     }
   }
 
-//-----------------------------------------------------------------------------
-  double AvikPID::calculateDedxProb(std::vector<double>* GasPaths ,
-                                    std::vector<double>* EDeps    ,
-                                    TH1D**               Templates) {
-
-    static const double _minpath = 0.5;
-    static const double _maxpath = 10.;
-
-    double thisprob = 1;
-
-    for (unsigned int ipath = 0; ipath < GasPaths->size(); ipath++){
-      double thispath = GasPaths->at(ipath);
-      double thisedep = EDeps->at(ipath);
-
-      double tmpprob = 0;
-      if (thispath > _minpath && thispath<=_maxpath){
-          int lowhist = findlowhist(thispath);
-
-          PIDUtilities util;
-          TH1D* hinterp = util.th1dmorph(Templates[lowhist],
-                                         Templates[lowhist+1],
-                                         _pathbounds[lowhist],
-                                         _pathbounds[lowhist+1],
-                                         thispath,1,0);
-//-----------------------------------------------------------------------------
-// probability for this edep
-//-----------------------------------------------------------------------------
-          int thisedepbin = -999;
-          if (thisedep > _templateslastbin) thisedepbin = _templatesnbins;
-          else                              thisedepbin = int(thisedep/_templatesbinsize)+1;
-
-          tmpprob=hinterp->GetBinContent(thisedepbin);
-
-          hinterp->Delete();
-        }
-
-      if (tmpprob> 0) thisprob = thisprob * tmpprob;
-    }
-
-    return thisprob;
-  }
-
 //-----------------------------------------------------------------------------
 // the straight line fit should be done explicitly
 //-----------------------------------------------------------------------------
@@ -1271,8 +1207,8 @@ namespace mu2e {
             }
           }
 
-          eprob  = calculateDedxProb(&gaspaths, &edeps, _heletemp);
-          muprob = calculateDedxProb(&gaspaths, &edeps, _hmuotemp);
+          eprob  = _eleDedx->probability(gaspaths, edeps);
+          muprob = _muoDedx->probability(gaspaths, edeps);
 
           _logDedxProbEle = log(eprob );
           _logDedxProbMuo = log(muprob);
@@ -1337,8 +1273,8 @@ namespace mu2e {
         _nMatched        = -1;
         _nMatchedAll     = -1;
 
-        eprob  = calculateDedxProb(&gaspaths, &edeps, _heletemp);
-        muprob = calculateDedxProb(&gaspaths, &edeps, _hmuotemp);
+        eprob  = _eleDedx->probability(gaspaths, edeps);
+        muprob = _muoDedx->probability(gaspaths, edeps);
 
         _logDedxProbEle = log(eprob );
         _logDedxProbMuo = log(muprob);
@@ -1409,8 +1345,8 @@ namespace mu2e {
           }
         }
 
-        eprob  = calculateDedxProb(&gaspaths, &edeps, _heletemp);
-        muprob = calculateDedxProb(&gaspaths, &edeps, _hmuotemp);
+        eprob  = _eleDedx->probability(gaspaths, edeps);
+        muprob = _muoDedx->probability(gaspaths, edeps);
 
         _logDedxProbEle = log(eprob );
         _logDedxProbMuo = log(muprob);
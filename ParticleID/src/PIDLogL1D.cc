@@ -12,6 +12,8 @@
 #include <stdexcept>
 
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "Offline/ParticleID/inc/PIDTableCache.hh"
+#include "Offline/ParticleID/inc/interpolateBins.hh"
 
 namespace mu2e {
 
@@ -22,20 +24,47 @@ namespace mu2e {
   {}
 
   double PIDLogL1D::value(double dt) const {
-    double res = binValueCutoff_;
     auto i = axis_.findBin(dt);
-    if(i != Binning::nobin) {
-      res = std::max(binValueCutoff_, vals_[i]);
+    if(i == Binning::nobin) {
+      return cutoff();
+    }
+    return interpolate_ ? interpolateBins(logvals_.data(), axis_, i, dt) : logvals_[i];
+  }
+
+  void PIDLogL1D::values(std::vector<double>& res, const std::vector<double>& x) const {
+    res.resize(x.size());
+    for(std::size_t k=0; k<x.size(); ++k) {
+      res[k] = value(x[k]);
     }
-    return log(res);
   }
 
   double PIDLogL1D::cutoff() {
     return log(binValueCutoff_);
   }
 
-  PIDLogL1D::PIDLogL1D(const Config& conf) {
+  PIDLogL1D::PIDLogL1D(const Config& conf)
+    : interpolate_(conf.interpolate())
+  {
     const std::string resolvedFileName = ConfigFileLookupPolicy()(conf.inputFile());
+
+    std::string cacheFile;
+    if(conf.cacheFile(cacheFile)) {
+      PIDTableCache cache(cacheFile, resolvedFileName, {});
+      std::vector<double> axis;
+      if(cache.read(axis, logvals_) && (axis.size() == 3) && (axis[0] == logvals_.size())) {
+        axis_ = Binning(logvals_.size(), axis[1], axis[2]);
+        return;
+      }
+      readTextFile(resolvedFileName);
+      cache.write({double(axis_.nbins()), axis_.low(), axis_.high()}, logvals_);
+    }
+    else {
+      readTextFile(resolvedFileName);
+    }
+  }
+
+  void PIDLogL1D::readTextFile(const std::string& resolvedFileName) {
+    std::vector<double> vals;
     std::ifstream infile(resolvedFileName);
     if(!infile.is_open()) {
       throw cet::exception("BADCONFIG")
@@ -78,19 +107,21 @@ namespace mu2e {
       else {
         std::istringstream is(line);
         double val;
-        while(is>>val) vals_.emplace_back(val);
+        while(is>>val) vals.emplace_back(val);
       }
     }
 
-    if(axis_.nbins() != vals_.size()) {
+    if(axis_.nbins() != vals.size()) {
       throw cet::exception("BADINPUT")
         <<"PIDLogL1D() error: nbins != the number of values provided: nbins = "
-        <<axis_.nbins()<<", num values = "<<vals_.size()<<"\n";
+        <<axis_.nbins()<<", num values = "<<vals.size()<<"\n";
     }
 
-    // Normalize the histogram to unity integral
-    double sum = std::accumulate(vals_.begin(), vals_.end(), 0.);
-    std::for_each(vals_.begin(), vals_.end(), [sum](double &v){ v/=sum; });
+    // Normalize the histogram to unity integral and tabulate the log
+    double sum = std::accumulate(vals.begin(), vals.end(), 0.);
+    logvals_.resize(vals.size());
+    std::transform(vals.begin(), vals.end(), logvals_.begin(),
+                   [sum](double v){ return log(std::max(binValueCutoff_, v/sum)); });
   }
 
 }
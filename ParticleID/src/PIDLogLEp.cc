@@ -12,6 +12,8 @@
 #include <stdexcept>
 
 #include "Offline/ConfigTools/inc/ConfigFileLookupPolicy.hh"
+#include "Offline/ParticleID/inc/PIDTableCache.hh"
+#include "Offline/ParticleID/inc/interpolateBins.hh"
 
 namespace mu2e {
 
@@ -22,27 +24,61 @@ namespace mu2e {
   {}
 
   double PIDLogLEp::value(double ep, double path) const {
-    double res = binValueCutoff_;
-
     auto ix = epaxis_.findBin(ep);
     auto iy = pathaxis_.findBin(path);
 
-    if((ix != Binning::nobin)&&(iy != Binning::nobin)) {
-      res = std::max(binValueCutoff_, vals_[iy][ix]);
+    if((ix == Binning::nobin)||(iy == NUBinning::nobin)) {
+      return cutoff();
     }
 
-    return log(res);
+    const double* slice = logvals_.data() + iy*epaxis_.nbins();
+    return interpolate_ ? interpolateBins(slice, epaxis_, ix, ep) : slice[ix];
+  }
+
+  void PIDLogLEp::values(std::vector<double>& res,
+                         const std::vector<double>& ep,
+                         const std::vector<double>& path) const {
+    if(ep.size() != path.size()) {
+      throw cet::exception("BADINPUT")
+        <<"PIDLogLEp::values(): inconsistent input sizes: "<<ep.size()<<" vs "<<path.size()<<"\n";
+    }
+    res.resize(ep.size());
+    for(std::size_t k=0; k<ep.size(); ++k) {
+      res[k] = value(ep[k], path[k]);
+    }
   }
 
   double PIDLogLEp::cutoff() {
     return log(binValueCutoff_);
   }
 
-  PIDLogLEp::PIDLogLEp(const Config& conf) {
+  PIDLogLEp::PIDLogLEp(const Config& conf)
+    : interpolate_(conf.interpolate())
+  {
     auto pathbb = conf.pathBinBoundaries();
     pathaxis_ = NUBinning(pathbb.begin(), pathbb.end());
 
     const std::string resolvedFileName = ConfigFileLookupPolicy()(conf.inputFile());
+
+    std::string cacheFile;
+    if(conf.cacheFile(cacheFile)) {
+      // the path slicing changes the table content, so it is part of the key
+      PIDTableCache cache(cacheFile, resolvedFileName, pathbb);
+      std::vector<double> axis;
+      if(cache.read(axis, logvals_) && (axis.size() == 3)
+         && (axis[0]*pathaxis_.nbins() == logvals_.size())) {
+        epaxis_ = Binning(Binning::IndexType(axis[0]), axis[1], axis[2]);
+        return;
+      }
+      readTextFile(resolvedFileName);
+      cache.write({double(epaxis_.nbins()), epaxis_.low(), epaxis_.high()}, logvals_);
+    }
+    else {
+      readTextFile(resolvedFileName);
+    }
+  }
+
+  void PIDLogLEp::readTextFile(const std::string& resolvedFileName) {
     std::ifstream infile(resolvedFileName);
     if(!infile.is_open()) {
       throw cet::exception("BADCONFIG")
@@ -102,22 +138,28 @@ namespace mu2e {
         <<epaxis_.nbins()*tmppathaxis.nbins()<<", got "<<buf.size()<<"\n";
     }
 
-    // Rebin data from buf into path length bins
+    // Rebin data from buf into path length bins.
+    // Outer container is vs path, inner is E/p slice
+    std::vector<std::vector<double> > vals;
     for(NUBinning::IndexType i=0; i<pathaxis_.nbins(); ++i) {
-      vals_.emplace_back(std::vector<double>(epaxis_.nbins(), 0.));
+      vals.emplace_back(std::vector<double>(epaxis_.nbins(), 0.));
     }
     for(Binning::IndexType tmpbin=0; tmpbin < tmppathaxis.nbins(); ++tmpbin) {
       NUBinning::IndexType pathbin = pathaxis_.findBin(tmppathaxis.binCenter(tmpbin));
       for(Binning::IndexType iebin=0; iebin < epaxis_.nbins(); ++iebin) {
         auto ibuf = tmpbin + iebin * tmppathaxis.nbins();
-        vals_.at(pathbin).at(iebin) += buf.at(ibuf);
+        vals.at(pathbin).at(iebin) += buf.at(ibuf);
       }
     }
 
-    // Normalize slice histograms
-    for(auto& ephist: vals_) {
+    // Normalize slice histograms and tabulate the log
+    logvals_.clear();
+    logvals_.reserve(pathaxis_.nbins()*epaxis_.nbins());
+    for(const auto& ephist: vals) {
       double sum = std::accumulate(ephist.begin(), ephist.end(), 0.);
-      std::for_each(ephist.begin(), ephist.end(), [sum](double &v){ v/=sum; });
+      for(double v: ephist) {
+        logvals_.emplace_back(log(std::max(binValueCutoff_, v/sum)));
+      }
     }
 
   }
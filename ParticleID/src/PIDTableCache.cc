@@ -0,0 +1,85 @@
+#include "Offline/ParticleID/inc/PIDTableCache.hh"
+#include "Offline/GeneralUtilities/inc/fnv1aHash.hh"
+#include "Offline/GeneralUtilities/inc/writeFileAtomically.hh"
+
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace mu2e {
+
+  namespace {
+    template <typename T> void put(std::ostream& os, const T& val) {
+      os.write(reinterpret_cast<const char*>(&val), sizeof(T));
+    }
+    template <typename T> void get(std::istream& is, T& val) {
+      is.read(reinterpret_cast<char*>(&val), sizeof(T));
+    }
+    void putVector(std::ostream& os, const std::vector<double>& v) {
+      put(os, static_cast<uint64_t>(v.size()));
+      os.write(reinterpret_cast<const char*>(v.data()), v.size()*sizeof(double));
+    }
+    bool getVector(std::istream& is, std::vector<double>& v) {
+      uint64_t n(0);
+      get(is, n);
+      if(!is || n > (1ULL<<28)) return false;
+      v.resize(n);
+      is.read(reinterpret_cast<char*>(v.data()), n*sizeof(double));
+      return bool(is);
+    }
+
+    uint64_t checksum(const std::vector<double>& v) {
+      return fnv1aHash(v.data(), v.size()*sizeof(double));
+    }
+  }
+
+  PIDTableCache::PIDTableCache(const std::string& cacheFile,
+                               const std::string& sourceFile,
+                               const std::vector<double>& key)
+    : cacheFile_(cacheFile)
+    , sourceFile_(sourceFile)
+    , key_(key)
+  {
+    struct stat st;
+    if(::stat(sourceFile_.c_str(), &st) == 0) {
+      sourceSize_ = st.st_size;
+      sourceMtime_ = st.st_mtime;
+    }
+  }
+
+  bool PIDTableCache::read(std::vector<double>& axis, std::vector<double>& table) const {
+    std::ifstream in(cacheFile_, std::ios::binary);
+    if(!in) return false;
+
+    uint32_t m(0), version(0);
+    uint64_t size(0), sum(0);
+    int64_t mtime(0);
+    std::vector<double> key;
+    get(in, m);
+    get(in, version);
+    get(in, size);
+    get(in, mtime);
+    if(!in || m != magic || version != formatVersion
+       || size != sourceSize_ || mtime != sourceMtime_) {
+      return false;
+    }
+    if(!getVector(in, key) || key != key_) return false;
+    if(!getVector(in, axis) || !getVector(in, table)) return false;
+    get(in, sum);
+    return bool(in) && sum == checksum(table);
+  }
+
+  bool PIDTableCache::write(const std::vector<double>& axis, const std::vector<double>& table) const {
+    std::ostringstream out;
+    put(out, magic);
+    put(out, formatVersion);
+    put(out, sourceSize_);
+    put(out, sourceMtime_);
+    putVector(out, key_);
+    putVector(out, axis);
+    putVector(out, table);
+    put(out, checksum(table));
+    return writeFileAtomically(cacheFile_, out.str());
+  }
+
+}
@@ -0,0 +1,114 @@
+#include "Offline/ParticleID/inc/PIDdEdxTemplates.hh"
+#include "Offline/ParticleID/inc/PIDUtilities.hh"
+
+#include "cetlib_except/exception.h"
+
+#include "TH1D.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mu2e {
+
+  PIDdEdxTemplates::PIDdEdxTemplates(TH1D* const* templates, const float* pathBounds, int nBounds,
+                                     double pathStep, double tolerance)
+    : _templates(templates, templates+nBounds)
+    , _bounds(pathBounds, pathBounds+nBounds)
+    , _nbins(templates[0]->GetNbinsX())
+    , _lastBin(templates[0]->GetBinLowEdge(_nbins)+templates[0]->GetBinWidth(1))
+    , _binSize(templates[0]->GetBinWidth(1))
+  {
+    if(nBounds < 2) {
+      throw cet::exception("BADCONFIG")
+        <<"PIDdEdxTemplates(): needs at least 2 templates\n";
+    }
+    if(pathStep <= 0.) return;
+
+    PIDUtilities util;
+    std::vector<double> nodes;
+    for(int k=0; k+1<nBounds; ++k) {
+      const double low = _bounds[k], high = _bounds[k+1];
+      const int nsteps = std::max(1, int(std::ceil((high-low)/pathStep - 1.e-6)));
+      nodes.clear();
+      for(int j=0; j<=nsteps; ++j) {
+        const double path = (j == nsteps) ? high : low + j*(high-low)/nsteps;
+        TH1D* hinterp = util.th1dmorph(templates[k], templates[k+1], low, high, path, 1, 0);
+        nodes.push_back(0.);
+        for(int ib=1; ib<=_nbins; ++ib) nodes.push_back(hinterp->GetBinContent(ib));
+        nodes.push_back(0.);
+        hinterp->Delete();
+      }
+      const double dev = deviation(templates, k, nodes, nsteps);
+      if(dev > tolerance) {
+        _firstNode.push_back(-1);
+        _nSteps.push_back(0);
+        continue;
+      }
+      _maxDeviation = std::max(_maxDeviation, dev);
+      _firstNode.push_back(_table.size()/(_nbins+2));
+      _nSteps.push_back(nsteps);
+      _table.insert(_table.end(), nodes.begin(), nodes.end());
+    }
+  }
+
+  // the linear interpolation is the furthest from the morphing in the middle of the steps
+  double PIDdEdxTemplates::deviation(TH1D* const* templates, int k, const std::vector<double>& nodes, int nsteps) const {
+    PIDUtilities util;
+    const double low = _bounds[k], high = _bounds[k+1];
+    double dev(0);
+    for(int j=0; j<nsteps; ++j) {
+      const double path = low + (j+0.5)*(high-low)/nsteps;
+      TH1D* hinterp = util.th1dmorph(templates[k], templates[k+1], low, high, path, 1, 0);
+      const double* node = nodes.data() + j*(_nbins+2);
+      double maxdiff(0), maxbin(0);
+      for(int ib=1; ib<=_nbins; ++ib) {
+        const double morphed = hinterp->GetBinContent(ib);
+        maxdiff = std::max(maxdiff, std::abs(0.5*(node[ib]+node[_nbins+2+ib]) - morphed));
+        maxbin  = std::max(maxbin, morphed);
+      }
+      if(maxbin > 0) dev = std::max(dev, maxdiff/maxbin);
+      hinterp->Delete();
+    }
+    return dev;
+  }
+
+  int PIDdEdxTemplates::boundPair(double path) const {
+    return std::lower_bound(_bounds.begin(), _bounds.end(), path) - _bounds.begin() - 1;
+  }
+
+  int PIDdEdxTemplates::edepBin(double eDep) const {
+    return (eDep > _lastBin) ? _nbins : int(eDep/_binSize)+1;
+  }
+
+  double PIDdEdxTemplates::morphedProbability(int k, double path, double eDep) const {
+    PIDUtilities util;
+    TH1D* hinterp = util.th1dmorph(_templates[k], _templates[k+1], _bounds[k], _bounds[k+1], path, 1, 0);
+    const double p = hinterp->GetBinContent(edepBin(eDep));
+    hinterp->Delete();
+    return p;
+  }
+
+  double PIDdEdxTemplates::tabulatedProbability(int k, double path, double eDep) const {
+    const double low = _bounds[k], high = _bounds[k+1];
+    const double u = (path-low)/(high-low)*_nSteps[k];
+    const int j = std::min(int(u), _nSteps[k]-1);
+    const double f = u - j;
+    const int bin = std::clamp(edepBin(eDep), 0, _nbins+1);
+    const double* node = _table.data() + (_firstNode[k]+j)*(_nbins+2);
+    return (1.-f)*node[bin] + f*node[_nbins+2+bin];
+  }
+
+  double PIDdEdxTemplates::probability(const std::vector<double>& gasPaths, const std::vector<double>& eDeps) const {
+    double prob = 1;
+    for(std::size_t ih=0; ih<gasPaths.size(); ++ih) {
+      const double path = gasPaths[ih];
+      if(path <= _bounds.front() || path > _bounds.back()) continue;
+      const int k = boundPair(path);
+      const double p = (tabulated() && _nSteps[k] > 0) ? tabulatedProbability(k, path, eDeps[ih])
+                                                       : morphedProbability(k, path, eDeps[ih]);
+      if(p > 0) prob *= p;
+    }
+    return prob;
+  }
+
+}
@@ -0,0 +1,17 @@
+#include "Offline/ParticleID/inc/interpolateBins.hh"
+
+#include <cmath>
+
+namespace mu2e {
+
+  double interpolateBins(const double* v, const Binning& axis, Binning::IndexType i, double x) {
+    const double u = (x - axis.binCenter(i))/axis.binWidth();
+    Binning::IndexType j = (u < 0.) ? i - 1 : i + 1;
+    if((u < 0. && i == 0) || (u >= 0. && j >= axis.nbins())) {
+      return v[i];
+    }
+    const double f = std::abs(u);
+    return (1. - f)*v[i] + f*v[j];
+  }
+
+}
@@ -0,0 +1,92 @@
+//
+// Flattened index from the hits of a ComboHitCollection to the StrawHits (and StrawDigis) they
+// are made of.  The chain of parent collections is resolved once, level by level, and the
+// result is stored as a compressed row table: the straw hits of ComboHit ich are the entries
+// [offset(ich),offset(ich+1)), so the lookups that ComboHitCollection::fillStrawHitIndices
+// does recursively through the event become array slices.
+//
+#ifndef RecoDataProducts_ComboHitStrawIndex_hh
+#define RecoDataProducts_ComboHitStrawIndex_hh
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+#include "canvas/Persistency/Provenance/ProductID.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace mu2e {
+
+  class ComboHitStrawIndex {
+  public:
+    // contiguous indices of one ComboHit
+    class Slice {
+    public:
+      Slice(const StrawHitIndex* begin, const StrawHitIndex* end) : _begin(begin), _end(end) {}
+      const StrawHitIndex* begin() const { return _begin; }
+      const StrawHitIndex* end()   const { return _end; }
+      size_t size() const { return _end - _begin; }
+      bool empty() const { return _end == _begin; }
+      StrawHitIndex operator[](size_t i) const { return _begin[i]; }
+    private:
+      const StrawHitIndex *_begin, *_end;
+    };
+
+    ComboHitStrawIndex() : _offset(1,0) {}
+#ifndef __ROOTCLING__
+    // index chcol, looking its parents up in the event.  id is the product ID of chcol, needed
+    // only to index collections embedded in other objects (HelixSeed, TimeCluster hits)
+    ComboHitStrawIndex(art::Event const& event, ComboHitCollection const& chcol, art::ProductID const& id = art::ProductID());
+#endif
+
+    art::ProductID const& collection() const { return _id; }
+    size_t   nHits() const { return _offset.size()-1; }
+    size_t   nStrawHits() const { return _shids.size(); }
+    unsigned nStrawHits(size_t ich) const { return _offset[ich+1] - _offset[ich]; }
+
+    Slice strawHits (size_t ich) const { return slice(_shids,ich); }
+    Slice strawDigis(size_t ich) const { return slice(_sdids,ich); }
+    // append the indices of hit ich, as ComboHitCollection::fillStrawHitIndices/fillStrawDigiIndices
+    void fillStrawHitIndices (size_t ich, std::vector<StrawHitIndex>& shids) const;
+    void fillStrawDigiIndices(size_t ich, std::vector<StrawDigiIndex>& sdids) const;
+    // the same for hit ich of a collection whose parent is the indexed collection
+    void fillStrawHitIndices (ComboHitCollection const& chcol, size_t ich, std::vector<StrawHitIndex>& shids) const;
+    void fillStrawDigiIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawDigiIndex>& sdids) const;
+
+  private:
+    Slice slice(std::vector<StrawHitIndex> const& ids, size_t ich) const {
+      return Slice(ids.data() + _offset[ich], ids.data() + _offset[ich+1]);
+    }
+    void checkParent(ComboHitCollection const& chcol) const;
+
+    art::ProductID             _id;      // indexed collection
+    std::vector<unsigned>      _offset;  // nHits()+1 entries
+    std::vector<StrawHitIndex> _shids;   // StrawHit indices
+    std::vector<StrawDigiIndex> _sdids;  // StrawDigi indices, parallel to _shids
+  };
+
+#ifndef __ROOTCLING__
+  // Indices of the event ComboHitCollections referenced by embedded collections (the hits of
+  // HelixSeeds, TimeClusters, ...).  The ComboHitStrawIndex products of the event
+  // (MakeComboHitStrawIndex) are used when they index the collection; the others are built on
+  // first use and kept for the rest of the event.  Modules using it should declare
+  // consumesMany<ComboHitStrawIndex>().
+  class ComboHitStrawIndexCache {
+  public:
+    explicit ComboHitStrawIndexCache(art::Event const& event) : _event(event) {}
+    // index of the parent of chcol
+    ComboHitStrawIndex const& parentIndex(ComboHitCollection const& chcol);
+    // append the indices of hit ich of chcol.  A collection without parent is at the StrawHit level
+    void fillStrawHitIndices (ComboHitCollection const& chcol, size_t ich, std::vector<StrawHitIndex>& shids);
+    void fillStrawDigiIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawDigiIndex>& sdids);
+  private:
+    art::Event const& _event;
+    bool _eventIndices = false; // the event products are in _indices
+    std::map<art::ProductID,ComboHitStrawIndex const*> _indices; // by indexed collection
+    std::map<art::ProductID,ComboHitStrawIndex> _built; // the indices not found in the event
+  };
+#endif
+
+}
+#endif
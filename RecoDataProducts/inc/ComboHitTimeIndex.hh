@@ -0,0 +1,62 @@
+//
+// Time index of a ComboHitCollection, shared by the time cluster finders.  For every hit
+// selection (HitSelectionBits / HitBackgroundBits pair) it keeps the selected hits sorted by
+// corrected time, with the cumulative number of straw hits, so that the hits and the number
+// of straw hits in a time window are found with a binary search.
+// The selections are stored back to back: selection i owns the entries [first(i),last(i)).
+//
+#ifndef RecoDataProducts_ComboHitTimeIndex_hh
+#define RecoDataProducts_ComboHitTimeIndex_hh
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace mu2e {
+
+  class ComboHitTimeIndex {
+  public:
+    // [first,last) entries of the index
+    typedef std::pair<unsigned,unsigned> Range;
+
+    ComboHitTimeIndex() {}
+    // shfcol may be null if only the empty selection (all hits) is requested
+    ComboHitTimeIndex(const ComboHitCollection& chcol, const StrawHitFlagCollection* shfcol,
+                      const std::vector<StrawHitFlag>& sel, const std::vector<StrawHitFlag>& bkg);
+
+    // number of hits in the indexed collection
+    size_t   nHits()       const { return _nhits; }
+    unsigned nSelections() const { return _sel.size(); }
+    // selection with these bits, -1 if it is not indexed
+    int      findSelection(const StrawHitFlag& sel, const StrawHitFlag& bkg) const;
+
+    Range    range (unsigned isel) const { return Range(_offset[isel],_offset[isel+1]); }
+    // entries of selection isel with tmin <= time <= tmax
+    Range    window(unsigned isel, float tmin, float tmax) const;
+
+    StrawHitIndex hit (unsigned ientry) const { return _hits[ientry]; }
+    float         time(unsigned ientry) const { return _times[ientry]; }
+    unsigned      nStrawHits(const Range& range) const { return _nshsum[range.second] - _nshsum[range.first]; }
+    // z range of the hits of selection isel, for bounding z-dependent time corrections
+    float         zmin(unsigned isel) const { return _zmin[isel]; }
+    float         zmax(unsigned isel) const { return _zmax[isel]; }
+
+    // number of straw hits of selection isel in nbins bins of width tbin starting at tmin
+    void histogram(unsigned isel, float tmin, float tbin, unsigned nbins, std::vector<unsigned>& counts) const;
+
+  private:
+    unsigned                   _nhits = 0;
+    std::vector<StrawHitFlag>  _sel, _bkg;
+    std::vector<unsigned>      _offset;  // nSelections()+1 entries
+    std::vector<StrawHitIndex> _hits;
+    std::vector<float>         _times;
+    std::vector<unsigned>      _nshsum;  // straw hits in the entries before, _hits.size()+1 entries
+    std::vector<float>         _zmin, _zmax;
+  };
+
+}
+#endif
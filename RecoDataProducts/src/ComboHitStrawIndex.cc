@@ -0,0 +1,122 @@
+//
+// Flattened ComboHit to StrawHit index, see the header
+//
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
+#include "cetlib_except/exception.h"
+
+namespace mu2e {
+
+  ComboHitStrawIndex::ComboHitStrawIndex(art::Event const& event, ComboHitCollection const& chcol, art::ProductID const& id) :
+    _id(id)
+  {
+    // find the chain of collections down to the StrawHit level, looking each parent up only once
+    std::vector<ComboHitCollection const*> chain(1,&chcol);
+    while(chain.back()->parent().isValid()){
+      art::Handle<ComboHitCollection> ph;
+      chain.back()->setParentHandle(event,ph);
+      if(!ph.isValid())
+        throw cet::exception("RECO")<<"mu2e::ComboHitStrawIndex: Can't find parent collection" << std::endl;
+      chain.push_back(ph.product());
+    }
+    // the bottom collection references the StrawDigis, and its hit index is the StrawHit index
+    auto const& shcol = *chain.back();
+    _offset.reserve(shcol.size()+1);
+    _shids.reserve(shcol.size());
+    _sdids.reserve(shcol.size());
+    _offset.push_back(0);
+    for(size_t ish = 0; ish < shcol.size(); ++ish){
+      ComboHit const& ch = shcol[ish];
+      if(ch.nCombo() != 1 || ch.nStrawHits() != 1)
+        throw cet::exception("RECO")<<"mu2e::ComboHitStrawIndex: invalid ComboHit" << std::endl;
+      _shids.push_back(ish);
+      _sdids.push_back(ch.index(0));
+      _offset.push_back(_shids.size());
+    }
+    // roll the table up one level at a time
+    std::vector<unsigned> offset;
+    std::vector<StrawHitIndex> shids;
+    std::vector<StrawDigiIndex> sdids;
+    for(size_t ilevel = chain.size()-1; ilevel-- > 0; ){
+      auto const& level = *chain[ilevel];
+      offset.clear(); shids.clear(); sdids.clear();
+      offset.reserve(level.size()+1);
+      shids.reserve(_shids.size());
+      sdids.reserve(_sdids.size());
+      offset.push_back(0);
+      for(auto const& ch : level){
+        for(uint16_t iind = 0; iind < ch.nCombo(); ++iind){
+          size_t ip = ch.index(iind);
+          if(ip+1 >= _offset.size())
+            throw cet::exception("RECO")<<"mu2e::ComboHitStrawIndex: invalid parent index " << ip << std::endl;
+          shids.insert(shids.end(),_shids.begin()+_offset[ip],_shids.begin()+_offset[ip+1]);
+          sdids.insert(sdids.end(),_sdids.begin()+_offset[ip],_sdids.begin()+_offset[ip+1]);
+        }
+        offset.push_back(shids.size());
+      }
+      _offset.swap(offset);
+      _shids.swap(shids);
+      _sdids.swap(sdids);
+    }
+  }
+
+  void ComboHitStrawIndex::fillStrawHitIndices(size_t ich, std::vector<StrawHitIndex>& shids) const {
+    auto ids = strawHits(ich);
+    shids.insert(shids.end(),ids.begin(),ids.end());
+  }
+
+  void ComboHitStrawIndex::fillStrawDigiIndices(size_t ich, std::vector<StrawDigiIndex>& sdids) const {
+    auto ids = strawDigis(ich);
+    sdids.insert(sdids.end(),ids.begin(),ids.end());
+  }
+
+  void ComboHitStrawIndex::checkParent(ComboHitCollection const& chcol) const {
+    if(chcol.parent() != _id || !_id.isValid())
+      throw cet::exception("RECO")<<"mu2e::ComboHitStrawIndex: collection parent " << chcol.parent()
+        << " is not the indexed collection " << _id << std::endl;
+  }
+
+  void ComboHitStrawIndex::fillStrawHitIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawHitIndex>& shids) const {
+    checkParent(chcol);
+    ComboHit const& ch = chcol.at(ich);
+    for(uint16_t iind = 0; iind < ch.nCombo(); ++iind) fillStrawHitIndices(ch.index(iind),shids);
+  }
+
+  void ComboHitStrawIndex::fillStrawDigiIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawDigiIndex>& sdids) const {
+    checkParent(chcol);
+    ComboHit const& ch = chcol.at(ich);
+    for(uint16_t iind = 0; iind < ch.nCombo(); ++iind) fillStrawDigiIndices(ch.index(iind),sdids);
+  }
+
+  ComboHitStrawIndex const& ComboHitStrawIndexCache::parentIndex(ComboHitCollection const& chcol) {
+    if(!_eventIndices){
+      for(auto const& ih : _event.getMany<ComboHitStrawIndex>())
+        if(ih.isValid() && ih->collection().isValid()) _indices.emplace(ih->collection(),ih.product());
+      _eventIndices = true;
+    }
+    auto ifnd = _indices.find(chcol.parent());
+    if(ifnd == _indices.end()){
+      art::Handle<ComboHitCollection> ph;
+      chcol.setParentHandle(_event,ph);
+      if(!ph.isValid())
+        throw cet::exception("RECO")<<"mu2e::ComboHitStrawIndexCache: Can't find parent collection" << std::endl;
+      auto const& index = _built.emplace(ph.id(),ComboHitStrawIndex(_event,*ph,ph.id())).first->second;
+      ifnd = _indices.emplace(ph.id(),&index).first;
+    }
+    return *ifnd->second;
+  }
+
+  void ComboHitStrawIndexCache::fillStrawHitIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawHitIndex>& shids) {
+    if(chcol.parent().isValid())
+      parentIndex(chcol).fillStrawHitIndices(chcol,ich,shids);
+    else
+      shids.push_back(ich);
+  }
+
+  void ComboHitStrawIndexCache::fillStrawDigiIndices(ComboHitCollection const& chcol, size_t ich, std::vector<StrawDigiIndex>& sdids) {
+    if(chcol.parent().isValid())
+      parentIndex(chcol).fillStrawDigiIndices(chcol,ich,sdids);
+    else
+      sdids.push_back(chcol.at(ich).index(0));
+  }
+
+}
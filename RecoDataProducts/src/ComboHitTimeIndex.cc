@@ -0,0 +1,70 @@
+//
+// Time index of a ComboHitCollection, see the header
+//
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace mu2e {
+
+  ComboHitTimeIndex::ComboHitTimeIndex(const ComboHitCollection& chcol, const StrawHitFlagCollection* shfcol,
+                                       const std::vector<StrawHitFlag>& sel, const std::vector<StrawHitFlag>& bkg) :
+    _nhits(chcol.size()), _sel(sel), _bkg(bkg)
+  {
+    // sort once, the selections are then filled in time order
+    std::vector<StrawHitIndex> sorted(chcol.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&chcol](StrawHitIndex a, StrawHitIndex b){return chcol[a].correctedTime() < chcol[b].correctedTime();});
+
+    _offset.reserve(_sel.size()+1);
+    _offset.push_back(0);
+    _nshsum.push_back(0);
+    for (size_t isel=0; isel<_sel.size(); ++isel) {
+      const bool all = _sel[isel] == StrawHitFlag() && _bkg[isel] == StrawHitFlag();
+      float zmin(std::numeric_limits<float>::max()), zmax(std::numeric_limits<float>::lowest());
+      for (StrawHitIndex ich : sorted) {
+        if (!all) {
+          const StrawHitFlag& flag = (*shfcol)[ich];
+          if (!flag.hasAllProperties(_sel[isel]) || flag.hasAnyProperty(_bkg[isel])) continue;
+        }
+        const ComboHit& ch = chcol[ich];
+        _hits.push_back(ich);
+        _times.push_back(ch.correctedTime());
+        _nshsum.push_back(_nshsum.back() + ch.nStrawHits());
+        zmin = std::min(zmin, float(ch.pos().z()));
+        zmax = std::max(zmax, float(ch.pos().z()));
+      }
+      _offset.push_back(_hits.size());
+      _zmin.push_back(zmin);
+      _zmax.push_back(zmax);
+    }
+  }
+
+  int ComboHitTimeIndex::findSelection(const StrawHitFlag& sel, const StrawHitFlag& bkg) const {
+    for (size_t isel=0; isel<_sel.size(); ++isel) {
+      if (_sel[isel] == sel && _bkg[isel] == bkg) return isel;
+    }
+    return -1;
+  }
+
+  ComboHitTimeIndex::Range ComboHitTimeIndex::window(unsigned isel, float tmin, float tmax) const {
+    auto begin = _times.begin() + _offset[isel];
+    auto end   = _times.begin() + _offset[isel+1];
+    auto first = std::lower_bound(begin, end, tmin);
+    auto last  = std::upper_bound(first, end, tmax);
+    return Range(first - _times.begin(), last - _times.begin());
+  }
+
+  void ComboHitTimeIndex::histogram(unsigned isel, float tmin, float tbin, unsigned nbins, std::vector<unsigned>& counts) const {
+    counts.assign(nbins, 0);
+    const Range entries = window(isel, tmin, tmin + nbins*tbin);
+    for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) {
+      unsigned ibin = unsigned((_times[ientry] - tmin)/tbin);
+      if (ibin < nbins) counts[ibin] += _nshsum[ientry+1] - _nshsum[ientry];
+    }
+  }
+
+}
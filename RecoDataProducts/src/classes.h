@@ -28,6 +28,8 @@
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigiFlag.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 
 // tracking intermediate products
 #include "Offline/RecoDataProducts/inc/HelixHit.hh"
@@ -0,0 +1,158 @@
+#ifndef SeedService_PhiloxEngine_hh
+#define SeedService_PhiloxEngine_hh
+//
+// A counter-based random engine: the Philox4x32-10 block function of
+// Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC11),
+// wrapped as a CLHEP::HepRandomEngine so that all the CLHEP distribution
+// classes can draw from it.
+//
+// The i-th 128 bit block of random bits is a function of (key, stream, i)
+// only.  An engine for a given (key, stream) therefore returns the same
+// sequence no matter which other engines exist or in which order, or on
+// which thread, they are used.  Engines are cheap to create: create one
+// per unit of work (see RandomStreams.hh) instead of sharing one.
+//
+// Each stream holds 2^32 blocks, i.e. 2^33 values of flat().
+//
+
+#include "CLHEP/Random/RandomEngine.h"
+
+#include "cetlib_except/exception.h"
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace mu2e {
+
+  class PhiloxEngine : public CLHEP::HepRandomEngine {
+  public:
+
+    typedef std::array<uint32_t,2> Key;
+    typedef std::array<uint32_t,4> Block;
+    typedef std::array<uint32_t,3> Stream;  // the upper three counter words
+
+    PhiloxEngine( Key const& key, Stream const& stream ):
+      key_(key), stream_(stream), index_(0), used_(4){
+      theSeed = key_[0];
+    }
+
+    // One application of the block function; public for tests against the reference values.
+    static Block philox( Block counter, Key key );
+
+    // Move to the start of another stream; the key is kept.
+    void setStream( Stream const& stream ) { stream_ = stream; index_ = 0; used_ = 4; }
+
+    Key    const& key()    const { return key_; }
+    Stream const& stream() const { return stream_; }
+
+    // Uniform in the open interval (0,1) with 53 random bits.
+    double flat() override {
+      uint64_t hi = nextWord() >> 5;
+      uint64_t lo = nextWord() >> 6;
+      return ( double(hi*67108864u + lo) + 0.5 ) * twoToMinus53;
+    }
+
+    void flatArray( const int size, double* vect ) override {
+      for ( int i=0; i<size; ++i ) vect[i] = flat();
+    }
+
+    // The seed sets the key and restarts the stream.
+    void setSeed( long seed, int ) override {
+      theSeed = seed;
+      key_    = Key{{ uint32_t(seed), uint32_t(uint64_t(seed)>>32) }};
+      index_  = 0;
+      used_   = 4;
+    }
+
+    void setSeeds( const long* seeds, int ) override {
+      if ( seeds != nullptr && seeds[0] != 0 ) {
+        theSeeds = seeds;
+        setSeed( seeds[0], 0 );
+        if ( seeds[1] != 0 ) key_[1] = uint32_t(seeds[1]);
+      }
+    }
+
+    void saveStatus( const char filename[] = "PhiloxEngine.conf" ) const override {
+      std::ofstream out(filename);
+      if ( !out ) throw cet::exception("RANDOM") << "PhiloxEngine: cannot write " << filename << "\n";
+      put(out);
+    }
+
+    void restoreStatus( const char filename[] = "PhiloxEngine.conf" ) override {
+      std::ifstream in(filename);
+      if ( !in ) throw cet::exception("RANDOM") << "PhiloxEngine: cannot read " << filename << "\n";
+      get(in);
+    }
+
+    void showStatus() const override {
+      std::cout << "PhiloxEngine: key " << key_[0] << " " << key_[1]
+                << " stream " << stream_[0] << " " << stream_[1] << " " << stream_[2]
+                << " block " << index_ << " word " << used_ << std::endl;
+    }
+
+    std::string name() const override { return "PhiloxEngine"; }
+
+    std::ostream& put( std::ostream& os ) const override {
+      os << name() << " " << key_[0] << " " << key_[1] << " "
+         << stream_[0] << " " << stream_[1] << " " << stream_[2] << " "
+         << index_ << " " << used_ << "\n";
+      return os;
+    }
+
+    std::istream& get( std::istream& is ) override {
+      std::string tag;
+      is >> tag >> key_[0] >> key_[1] >> stream_[0] >> stream_[1] >> stream_[2] >> index_ >> used_;
+      if ( !is || tag != name() || used_ > 4 ) {
+        throw cet::exception("RANDOM") << "PhiloxEngine: bad engine state\n";
+      }
+      // The buffer holds the block before index_.
+      if ( used_ < 4 ) buffer_ = philox( Block{{ index_-1, stream_[0], stream_[1], stream_[2] }}, key_ );
+      return is;
+    }
+
+    // 32 random bits.
+    operator unsigned int() override { return nextWord(); }
+
+  private:
+
+    static constexpr double twoToMinus53 = 1.0/9007199254740992.0;
+
+    uint32_t nextWord() {
+      if ( used_ == 4 ) {
+        if ( index_ == UINT32_MAX ) {
+          throw cet::exception("RANDOM") << "PhiloxEngine: stream exhausted\n";
+        }
+        buffer_ = philox( Block{{ index_++, stream_[0], stream_[1], stream_[2] }}, key_ );
+        used_ = 0;
+      }
+      return buffer_[used_++];
+    }
+
+    Key      key_;
+    Stream   stream_;
+    uint32_t index_;   // next block of the stream
+    unsigned used_;    // words of buffer_ already returned
+    Block    buffer_;
+  };
+
+  //================================================================
+  inline PhiloxEngine::Block PhiloxEngine::philox( Block c, Key k ) {
+    constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+    for ( int round=0; round<10; ++round ) {
+      const uint64_t p0 = uint64_t(M0)*c[0];
+      const uint64_t p1 = uint64_t(M1)*c[2];
+      c = Block{{ uint32_t(p1>>32)^c[1]^k[0], uint32_t(p1),
+                  uint32_t(p0>>32)^c[3]^k[1], uint32_t(p0) }};
+      k[0] += W0;
+      k[1] += W1;
+    }
+    return c;
+  }
+
+} // namespace mu2e
+
+#endif /* SeedService_PhiloxEngine_hh */
@@ -0,0 +1,76 @@
+#ifndef SeedService_RandomStreams_hh
+#define SeedService_RandomStreams_hh
+//
+// Reproducible random number streams for work that is split inside a module,
+// e.g. over detector elements on several threads.
+//
+// Each (module, event, element) gets its own counter-based engine
+// (PhiloxEngine.hh):
+//   - the module is identified by its seed from the SeedService,
+//   - the event by (run, subRun, event),
+//   - the element by a number chosen by the module, e.g. a straw or SiPM id.
+// The draws for an element depend only on these, not on the number of threads,
+// the order in which the elements are processed, or on which elements exist.
+//
+// Usage in a module:
+//
+//   // c'tor
+//   streams_(art::ServiceHandle<SeedService>()->getSeed())
+//
+//   // produce(), may be called from several tasks at once
+//   auto engine = streams_.engine(event.id(), element);
+//   CLHEP::RandGaussQ gauss(engine);
+//
+// The engine is a CLHEP::HepRandomEngine, but it is not managed by the
+// art RandomNumberGenerator service, so it is not part of the saved
+// random number state; it does not need to be, since it is recreated
+// from the event id.  The module may use the same seed for its ordinary
+// engine: the streams are separated from all engines of other kinds.
+//
+
+#include "Offline/SeedService/inc/PhiloxEngine.hh"
+#include "Offline/SeedService/inc/SeedService.hh"
+
+#include "canvas/Persistency/Provenance/EventID.h"
+
+#include <cstdint>
+
+namespace mu2e {
+
+  class RandomStreams {
+  public:
+
+    explicit RandomStreams( SeedService::seed_t seed ):
+      seed_(seed){}
+
+    SeedService::seed_t seed() const { return seed_; }
+
+    // The engine of one element in one event.
+    PhiloxEngine engine( art::EventID const& id, uint32_t element ) const {
+      return PhiloxEngine( key(id), PhiloxEngine::Stream{{ element, id.subRun(), id.event() }} );
+    }
+
+    // For the work of a module outside of the event loop, e.g. at beginRun.
+    PhiloxEngine engine( art::RunNumber_t run, uint32_t element ) const {
+      return PhiloxEngine( key(run), PhiloxEngine::Stream{{ element, UINT32_MAX, UINT32_MAX }} );
+    }
+
+  private:
+
+    // The key holds the module (seed) and the run; the upper bits of the
+    // seed are folded in to keep seeds that differ there apart.
+    PhiloxEngine::Key key( art::EventID const& id ) const { return key(id.run()); }
+    PhiloxEngine::Key key( art::RunNumber_t run ) const {
+      const uint64_t seed = seed_;
+      return PhiloxEngine::Key{{ uint32_t(seed) ^ keyTag, uint32_t(run) ^ uint32_t(seed>>32) }};
+    }
+
+    // Separates the keys from seeds used directly as keys of other PhiloxEngines.
+    static constexpr uint32_t keyTag = 0x5EEDC0DE;
+
+    SeedService::seed_t seed_;
+  };
+
+} // namespace mu2e
+
+#endif /* SeedService_RandomStreams_hh */
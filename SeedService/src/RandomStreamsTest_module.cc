@@ -0,0 +1,102 @@
+//
+//  Test the RandomStreams: the draws of each element must not depend on
+//  the order in which the elements are processed, nor on the number of threads.
+//
+
+#include "Offline/SeedService/inc/RandomStreams.hh"
+#include "Offline/SeedService/inc/SeedService.hh"
+
+// Framework includes.
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "cetlib_except/exception.h"
+
+#include "CLHEP/Random/RandGaussQ.h"
+#include "CLHEP/Random/RandPoissonQ.h"
+
+#include "tbb/parallel_for.h"
+
+// C++ includes.
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+namespace mu2e {
+
+  class RandomStreamsTest : public art::EDAnalyzer {
+
+  public:
+
+    explicit RandomStreamsTest(fhicl::ParameterSet const& pset);
+
+    void beginJob() override;
+    void analyze(const art::Event& event) override;
+
+  private:
+    // the draws of one element: a mix of distributions with fixed and variable numbers of draws
+    void draw( art::EventID const& id, unsigned element, std::vector<double>& values ) const;
+
+    unsigned nElements_;
+    unsigned nDraws_;
+    RandomStreams streams_;
+  };
+
+  RandomStreamsTest::RandomStreamsTest(fhicl::ParameterSet const& pSet):
+    art::EDAnalyzer(pSet),
+    nElements_(pSet.get<unsigned>("nElements",1000)),
+    nDraws_(pSet.get<unsigned>("nDraws",100)),
+    streams_(art::ServiceHandle<SeedService>()->getSeed()){
+  }
+
+  void RandomStreamsTest::beginJob(){
+    // Reference values of the Random123 distribution (kat_vectors, philox4x32 10 rounds).
+    auto block = PhiloxEngine::philox( PhiloxEngine::Block{{0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}},
+                                       PhiloxEngine::Key{{0xa4093822,0x299f31d0}} );
+    if ( block != PhiloxEngine::Block{{0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1}} ){
+      throw cet::exception("RANDOM") << "RandomStreamsTest: Philox4x32-10 does not reproduce the reference values.\n";
+    }
+  }
+
+  void RandomStreamsTest::draw( art::EventID const& id, unsigned element, std::vector<double>& values ) const{
+    auto engine = streams_.engine(id, element);
+    CLHEP::RandGaussQ   gauss(engine);
+    CLHEP::RandPoissonQ poisson(engine);
+    values.clear();
+    for ( unsigned i=0; i<nDraws_; ++i ){
+      values.push_back( gauss.fire() );
+      values.push_back( poisson.fire(3.0) );
+    }
+  }
+
+  void RandomStreamsTest::analyze(const art::Event& event){
+
+    std::vector<std::vector<double> > forward(nElements_), backward(nElements_), parallel(nElements_);
+
+    for ( unsigned i=0; i<nElements_; ++i ){
+      draw( event.id(), i, forward[i] );
+    }
+    for ( unsigned i=nElements_; i-- > 0; ){
+      draw( event.id(), i, backward[i] );
+    }
+    tbb::parallel_for( 0u, nElements_, [&]( unsigned i ){ draw( event.id(), i, parallel[i] ); } );
+
+    if ( forward != backward || forward != parallel ){
+      throw cet::exception("RANDOM") << "RandomStreamsTest: the draws depend on the processing order in event "
+                                     << event.id() << "\n";
+    }
+    for ( unsigned i=1; i<nElements_; ++i ){
+      if ( forward[i] == forward[i-1] ){
+        throw cet::exception("RANDOM") << "RandomStreamsTest: elements " << i-1 << " and " << i
+                                       << " have the same draws in event " << event.id() << "\n";
+      }
+    }
+
+    cout << "RandomStreamsTest " << event.id() << ": " << nElements_ << " elements reproduced, first draw "
+         << ( nElements_ > 0 ? forward[0].front() : 0. ) << endl;
+  }
+
+} // end namespace mu2e
+
+DEFINE_ART_MODULE(mu2e::RandomStreamsTest);
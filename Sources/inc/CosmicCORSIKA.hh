@@ -3,6 +3,11 @@
 #ifndef Sources_inc_CosmicCORSIKA_hh
 #define Sources_inc_CosmicCORSIKA_hh
 
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "Offline/GlobalConstantsService/inc/GlobalConstantsHandle.hh"
@@ -25,6 +30,7 @@
 #include "Offline/CalorimeterGeom/inc/Calorimeter.hh"
 #include "Offline/ExtinctionMonitorFNAL/Geometry/inc/ExtMonFNAL.hh"
 #include "Offline/GeneralUtilities/inc/safeSqrt.hh"
+#include "Offline/GeneralUtilities/inc/MappedFile.hh"
 
 #include "CLHEP/Units/SystemOfUnits.h"
 #include "CLHEP/Vector/ThreeVector.h"
@@ -58,6 +64,8 @@ struct Config
   fhicl::Atom<float> targetBoxYmax{Name("targetBoxYmax"), Comment("Target box y max")};
   fhicl::Atom<float> targetBoxZmin{Name("targetBoxZmin"), Comment("Target box z min")};
   fhicl::Atom<float> targetBoxZmax{Name("targetBoxZmax"), Comment("Target box z max")};
+  fhicl::Atom<bool> bufferedReader{Name("bufferedReader"), Comment("Map the input files and decode showers in parallel batches; false for the record-by-record stream reader"), true};
+  fhicl::Atom<unsigned> batchSize{Name("batchSize"), Comment("Number of particle records decoded per parallel batch by the buffered reader"), 256};
 };
 
 typedef fhicl::WrappedTable<Config> Parameters;
@@ -216,17 +224,41 @@ namespace mu2e {
       };
 
       virtual bool generate(GenParticleCollection &, unsigned int &);
-      void openFile(ifstream *f, unsigned &run, float &lowE, float &highE);
+      void openFile(const std::string &filename, unsigned &run, float &lowE, float &highE);
+      void closeFile();
 
     private:
-      bool genEvent(std::map<std::pair<int,int>, GenParticleCollection> &particles_map);
-      float wrapvarBoxNo(const float var, const float low, const float high, int &boxno);
+      typedef std::map<std::pair<int,int>, GenParticleCollection> ParticlesMap;
 
-      std::vector<CLHEP::Hep3Vector> _targetBoxIntersections;
-      std::vector<CLHEP::Hep3Vector> _worldIntersections;
-      std::map<std::pair<int,int>, GenParticleCollection> _particles_map;
+      // Particle sub-blocks of the records read by one call of genEvent, as found by the indexing pass
+      // of the buffered reader: the byte offset and the number of words of each sub-block.
+      struct ParticleGroup {
+        std::vector<std::pair<std::size_t, unsigned>> blocks;
+        unsigned primaries; // number of showers started up to the end of the group
+      };
+
+      void parseRunHeader(unsigned &run, float &lowE, float &highE);
+      bool genEvent(ParticlesMap &particles_map);
+      void addParticle(const float *words, float xOffset, float zOffset, ParticlesMap &particles_map) const;
+      void projectToTarget(const GenParticleCollection &particles, GenParticleCollection &genParts) const;
+      float wrapvarBoxNo(const float var, const float low, const float high, int &boxno) const;
+
+      void indexFile();
+      bool fillEventQueue();
+      bool generateBuffered(GenParticleCollection &, unsigned int &);
+
+      ParticlesMap _particles_map;
 
       GlobalConstantsHandle<ParticleDataList> pdt;
+      // corsikaToPdgId and the masses, indexed by CORSIKA id.  The masses are looked up once:
+      // ParticleDataList adds unknown nuclei to its list on first use, which must not happen
+      // in the parallel decoding.
+      struct CorsikaParticle {
+        int pdgId = 0;
+        float mass = 0;
+        bool known = false;
+      };
+      std::vector<CorsikaParticle> _corsikaParticles;
 
       static constexpr float _GeV2MeV = CLHEP::GeV / CLHEP::MeV;
       static constexpr float _cm2mm = CLHEP::cm / CLHEP::mm;
@@ -247,7 +279,18 @@ namespace mu2e {
       float _targetBoxZmin = 0;
       float _targetBoxZmax = 0;
 
-      std::ifstream *input;
+      bool _bufferedReader = true;
+      unsigned _batchSize = 256;
+
+      // stream reader
+      std::unique_ptr<std::ifstream> input;
+
+      // buffered reader
+      std::unique_ptr<MappedFile> _mappedFile;
+      std::vector<ParticleGroup> _groups;
+      std::size_t _nextGroup = 0;
+      std::deque<std::pair<GenParticleCollection, unsigned>> _eventQueue; // events and the showers started before them
+      unsigned _primariesEmitted = 0;
 
       unsigned _current_event_number = -1;
       unsigned _event_count = 0;
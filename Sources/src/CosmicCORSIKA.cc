@@ -7,11 +7,29 @@
 
 #include "Offline/Sources/inc/CosmicCORSIKA.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "cetlib_except/exception.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 using CLHEP::Hep3Vector;
 using CLHEP::HepLorentzVector;
 
 namespace mu2e {
 
+  namespace {
+    // One 4 byte word of the mapped file; the records are not aligned for the compiler
+    template <class T> T word(const char *p) {
+      T value;
+      std::memcpy(&value, p, sizeof(T));
+      return value;
+    }
+  }
+
   CosmicCORSIKA::CosmicCORSIKA(const Config &conf, SeedService::seed_t seed)
       : _fluxConstant(conf.fluxConstant()),
         _tOffset(conf.tOffset()),
@@ -23,87 +41,208 @@ namespace mu2e {
         _targetBoxYmax(conf.targetBoxYmax()),  // mm
         _targetBoxZmin(conf.targetBoxZmin()), // mm
         _targetBoxZmax(conf.targetBoxZmax()),  // mm
+        _bufferedReader(conf.bufferedReader()),
+        _batchSize(std::max(conf.batchSize(), 1u)),
         _engine(seed),
         _randFlatX(_engine, -(_targetBoxXmax-_targetBoxXmin+_showerAreaExtension)/2, +(_targetBoxXmax-_targetBoxXmin+_showerAreaExtension)/2),
         _randFlatZ(_engine, -(_targetBoxZmax-_targetBoxZmin+_showerAreaExtension)/2, +(_targetBoxZmax-_targetBoxZmin+_showerAreaExtension)/2)
   {
+    _corsikaParticles.resize(corsikaToPdgId.rbegin()->first + 1);
+    for (auto const &p : corsikaToPdgId) {
+      try {
+        _corsikaParticles[p.first] = CorsikaParticle{p.second, float(pdt->particle(p.second).mass()), true};
+      }
+      catch (cet::exception &) {
+        // not in the particle list: reported if the particle is found in the input
+      }
+    }
   }
 
-  void CosmicCORSIKA::openFile(ifstream *f, unsigned &runNumber, float &lowE, float &highE)
+  void CosmicCORSIKA::openFile(const std::string &filename, unsigned &runNumber, float &lowE, float &highE)
   {
-    input = f;
+    closeFile();
     _current_event_number = -1;
     _event_count = 0;
     _run_number = -1;
+    _primaries = 0;
     _infmt = Format::UNDEFINED;
 
-    while( input->read(_buf.ch, 4)) {
-      unsigned reclen = _buf.in[0];
-      // CORSIKA records are in units of 4 bytes
-      if(reclen % 4) {
-        throw std::runtime_error("Error: record size not a multiple of 4");
+    unsigned reclen = 0;
+    if(_bufferedReader) {
+      _mappedFile = std::make_unique<MappedFile>(filename);
+      if(_mappedFile->size() >= 4) {
+        reclen = word<unsigned>(_mappedFile->data());
       }
-
-      // We will be looking at at least 8 bytes to determine the
-      // input file format, and all real CORSIKA records are longer
-      // than that.
-      if(reclen < 2*4) {
-        throw std::runtime_error("Error: reclen too small");
+    } else {
+      input = std::make_unique<std::ifstream>(filename, std::ios::binary);
+      if(!*input) {
+        throw cet::exception("FILE") << "CosmicCORSIKA: can not open " << filename << "\n";
       }
-
-      // Read the full record
-      if(!input->read(_buf.ch, reclen)) {
-        break;
+      if(input->read(_buf.ch, 4)) {
+        reclen = _buf.in[0];
       }
+    }
 
-      // Determine the format and and store the decision for future blocks.
-      // We are starting file read, so should see the RUNH marker
-      // In COMPACT format each block is preceded by 4 bytes
-      // giving the size of the block in words.
+    // CORSIKA records are in units of 4 bytes
+    if(reclen % 4) {
+      throw std::runtime_error("Error: record size not a multiple of 4");
+    }
 
-      if(!strncmp(_buf.ch+0, "RUNH", 4)) {
-        std::cout<<"Reading NORMAL format"<<std::endl;
-        _infmt = Format::NORMAL;
-      }
-      else if(!strncmp(_buf.ch+4, "RUNH", 4)) {
-        std::cout<<"Reading COMPACT format"<<std::endl;
-        _infmt = Format::COMPACT;
-      }
-      else {
-        throw std::runtime_error("Error: did not find the RUNH record to determine COMPACT flag");
-      }
+    // We will be looking at at least 8 bytes to determine the
+    // input file format, and all real CORSIKA records are longer
+    // than that.
+    if(reclen < 2*4) {
+      throw std::runtime_error("Error: reclen too small");
+    }
 
-      unsigned iword = 0;
-      if(_infmt == Format::COMPACT) {
-        // Move to the beginning of the actual block
-        ++iword;
-      }
+    if(reclen > 4*_fbsize_words) {
+      throw std::runtime_error("Error: reclen too big");
+    }
 
-      if(!strncmp(_buf.ch+4*iword, "RUNH", 4)) {
-        runNumber = lrint(_buf.fl[1+iword]);
-        lowE = float(_buf.fl[16+iword]);
-        highE = float(_buf.fl[17+iword]);
-      }
+    // Read the full record
+    bool complete = false;
+    if(_bufferedReader) {
+      complete = _mappedFile->size() >= 4 + reclen;
+      if(complete) std::memcpy(_buf.ch, _mappedFile->data() + 4, reclen);
+    } else {
+      complete = bool(input->read(_buf.ch, reclen));
+      input->clear();
+      input->seekg(0, std::ios::beg);
+    }
 
-      break;
+    if(complete) {
+      parseRunHeader(runNumber, lowE, highE);
+    }
 
+    if(_bufferedReader) {
+      indexFile();
     }
-    input->clear();
-    input->seekg(0, ios::beg);
+  }
+
+  void CosmicCORSIKA::parseRunHeader(unsigned &runNumber, float &lowE, float &highE)
+  {
+    // Determine the format and and store the decision for future blocks.
+    // We are starting file read, so should see the RUNH marker
+    // In COMPACT format each block is preceded by 4 bytes
+    // giving the size of the block in words.
+
+    if(!strncmp(_buf.ch+0, "RUNH", 4)) {
+      std::cout<<"Reading NORMAL format"<<std::endl;
+      _infmt = Format::NORMAL;
+    }
+    else if(!strncmp(_buf.ch+4, "RUNH", 4)) {
+      std::cout<<"Reading COMPACT format"<<std::endl;
+      _infmt = Format::COMPACT;
+    }
+    else {
+      throw std::runtime_error("Error: did not find the RUNH record to determine COMPACT flag");
+    }
+
+    unsigned iword = 0;
+    if(_infmt == Format::COMPACT) {
+      // Move to the beginning of the actual block
+      ++iword;
+    }
+
+    if(!strncmp(_buf.ch+4*iword, "RUNH", 4)) {
+      runNumber = lrint(_buf.fl[1+iword]);
+      lowE = float(_buf.fl[16+iword]);
+      highE = float(_buf.fl[17+iword]);
+    }
+  }
+
+  void CosmicCORSIKA::closeFile()
+  {
+    input.reset();
+    _mappedFile.reset();
+    _groups.clear();
+    _nextGroup = 0;
+    _eventQueue.clear();
+    _primariesEmitted = 0;
+    _particles_map.clear();
   }
 
   CosmicCORSIKA::~CosmicCORSIKA(){
   }
 
 
-  float CosmicCORSIKA::wrapvarBoxNo(const float var, const float low, const float high, int &boxno)
+  float CosmicCORSIKA::wrapvarBoxNo(const float var, const float low, const float high, int &boxno) const
   {
     //wrap variable so that it's always between low and high
     boxno = int(floor(var / (high - low)));
     return (var - (high - low) * floor(var / (high - low))) + low;
   }
 
-  bool CosmicCORSIKA::genEvent(std::map<std::pair<int,int>, GenParticleCollection> &particles_map) {
+  // Convert one particle, the 7 words of a particle sub-block, and add it to the tile of the shower area it falls in
+  void CosmicCORSIKA::addParticle(const float *words, float xOffset, float zOffset, ParticlesMap &particles_map) const
+  {
+    unsigned id = words[0] / 1000;
+    int pdgId = 0;
+    float m = 0; // MeV
+    if (id < _corsikaParticles.size() && _corsikaParticles[id].known) {
+      pdgId = _corsikaParticles[id].pdgId;
+      m = _corsikaParticles[id].mass;
+    }
+    else {
+      // throws for the ids without a PDG id or without a mass
+      pdgId = corsikaToPdgId.at(id);
+      m = pdt->particle(pdgId).mass();
+    }
+    const float P_x = words[2] * _GeV2MeV;
+    const float P_y = -words[3] * _GeV2MeV;
+    const float P_z = words[1] * _GeV2MeV;
+
+    int boxnox = 0, boxnoz = 0;
+
+    const float x = wrapvarBoxNo(words[5] * _cm2mm + xOffset, _targetBoxXmin - _showerAreaExtension, _targetBoxXmax + _showerAreaExtension, boxnox);
+    const float z = wrapvarBoxNo(-words[4] * _cm2mm + zOffset, _targetBoxZmin - _showerAreaExtension, _targetBoxZmax + _showerAreaExtension, boxnoz);
+    std::pair xz(boxnox, boxnoz);
+
+    const float energy = safeSqrt(P_x * P_x + P_y * P_y + P_z * P_z + m * m);
+
+    const Hep3Vector position(x, _targetBoxYmax, z);
+    const HepLorentzVector mom4(P_x, P_y, P_z, energy);
+
+    const float particleTime = words[6] * _ns2s;
+    particles_map[xz].emplace_back(static_cast<PDGCode::type>(pdgId),
+                                   GenId::cosmicCORSIKA, position, mom4,
+                                   particleTime);
+  }
+
+  // Keep the particles of one tile that cross the target box, or all of them if not projecting,
+  // with the times relative to the earliest particle of the tile
+  void CosmicCORSIKA::projectToTarget(const GenParticleCollection &particles, GenParticleCollection &genParts) const
+  {
+    GenParticleCollection crossingParticles;
+    std::vector<CLHEP::Hep3Vector> targetBoxIntersections;
+
+    float timeOffset = std::numeric_limits<float>::max();
+
+    for (unsigned int i = 0; i < particles.size(); i++) {
+      const GenParticle &particle = particles[i];
+
+      targetBoxIntersections.clear();
+      VectorVolume particleTarget(particle.position(), particle.momentum().vect(),
+                                  _targetBoxXmin, _targetBoxXmax,
+                                  _targetBoxYmin, _targetBoxYmax,
+                                  _targetBoxZmin, _targetBoxZmax);
+
+      particleTarget.calIntersections(targetBoxIntersections);
+
+      if (targetBoxIntersections.size() > 0 || !_projectToTargetBox)
+        crossingParticles.push_back(particle);
+
+      if (particle.time() < timeOffset)
+        timeOffset = particle.time();
+    }
+
+    for (unsigned int i = 0; i < crossingParticles.size(); i++) {
+      const GenParticle &part = crossingParticles[i];
+      genParts.push_back(GenParticle(part.pdgId(), part.generatorId(), part.position(), part.momentum(), part.time()+_tOffset-timeOffset));
+    }
+  }
+
+  bool CosmicCORSIKA::genEvent(ParticlesMap &particles_map) {
 
       const float xOffset = _randFlatX.fire();
       const float zOffset = _randFlatZ.fire();
@@ -189,35 +328,7 @@ namespace mu2e {
               if (id == 0)
                 continue;
               n_part++;
-              const int pdgId = corsikaToPdgId.at(id);
-              const float P_x = _buf.fl[iword + i_part + 2] * _GeV2MeV;
-              const float P_y = -_buf.fl[iword + i_part + 3] * _GeV2MeV;
-              const float P_z = _buf.fl[iword + i_part + 1] * _GeV2MeV;
-
-              int boxnox = 0, boxnoz = 0;
-
-              const float x = wrapvarBoxNo(_buf.fl[iword + i_part + 5] * _cm2mm + xOffset, _targetBoxXmin - _showerAreaExtension, _targetBoxXmax + _showerAreaExtension, boxnox);
-              const float z = wrapvarBoxNo(-_buf.fl[iword + i_part + 4] * _cm2mm + zOffset, _targetBoxZmin - _showerAreaExtension, _targetBoxZmax + _showerAreaExtension, boxnoz);
-              std::pair xz(boxnox, boxnoz);
-              const float m = pdt->particle(pdgId).mass(); // to MeV
-
-              const float energy = safeSqrt(P_x * P_x + P_y * P_y + P_z * P_z + m * m);
-
-              const Hep3Vector position(x, _targetBoxYmax, z);
-              const HepLorentzVector mom4(P_x, P_y, P_z, energy);
-
-              const float particleTime = _buf.fl[iword + i_part + 6] * _ns2s;
-              GenParticle part(static_cast<PDGCode::type>(pdgId),
-                    GenId::cosmicCORSIKA, position, mom4,
-                    particleTime);
-
-              if (particles_map.count(xz) == 0) {
-                GenParticleCollection parts;
-                parts.push_back(part);
-                particles_map.insert({xz, parts});
-              } else {
-                particles_map[xz].push_back(part);
-              }
+              addParticle(&_buf.fl[iword + i_part], xOffset, zOffset, particles_map);
             }
 
           }
@@ -246,55 +357,214 @@ namespace mu2e {
 
   bool CosmicCORSIKA::generate( GenParticleCollection& genParts, unsigned int &primaries)
   {
+    if (_bufferedReader) {
+      return generateBuffered(genParts, primaries);
+    }
+
     // loop over particles in the truth object
     bool passed = false;
     while (!passed) {
       if (_particles_map.size() == 0)
       {
-        if (!genEvent(_particles_map)) {
+        // a file truncated without the end of run record ends here as well
+        if (!genEvent(_particles_map) || _particles_map.size() == 0) {
           return false;
         }
       }
 
-      GenParticleCollection particles = _particles_map.begin()->second;
-      GenParticleCollection crossingParticles;
-
-      float timeOffset = std::numeric_limits<float>::max();
       primaries = _primaries;
+      projectToTarget(_particles_map.begin()->second, genParts);
+      _particles_map.erase(_particles_map.begin()->first);
 
-      for (unsigned int i = 0; i < particles.size(); i++) {
-        GenParticle particle = particles[i];
+      if (genParts.size() != 0) {
+        passed = true;
+        _primaries = 0;
+      }
 
-        _targetBoxIntersections.clear();
-        VectorVolume particleTarget(particle.position(), particle.momentum().vect(),
-                                    _targetBoxXmin, _targetBoxXmax,
-                                    _targetBoxYmin, _targetBoxYmax,
-                                    _targetBoxZmin, _targetBoxZmax);
+    }
 
-        particleTarget.calIntersections(_targetBoxIntersections);
+    return true;
+
+  }
 
-        if (_targetBoxIntersections.size() > 0 || !_projectToTargetBox)
-          crossingParticles.push_back(particle);
+  //================================================================
+  // Buffered reader.  The whole file is mapped, and a first, serial pass over
+  // the records checks the run and event headers and trailers and finds the
+  // particle sub-blocks that genEvent would read in each of its calls.  The
+  // groups of sub-blocks are then decoded and projected in parallel batches;
+  // the shower offsets are drawn in file order before each batch, so the
+  // events are the same as those of the stream reader.
 
-        if (particle.time() < timeOffset)
-          timeOffset = particle.time();
+  void CosmicCORSIKA::indexFile()
+  {
+    const char *data = _mappedFile->data();
+    const std::size_t size = _mappedFile->size();
+
+    ParticleGroup group;
+    std::size_t pos = 0;
+    while (pos + 4 <= size) {
+
+      const unsigned reclen = word<unsigned>(data + pos);
+      if(reclen % 4) {
+        throw std::runtime_error("Error: record size not a multiple of 4");
+      }
+      if(reclen < 2*4) {
+        throw std::runtime_error("Error: reclen too small");
+      }
+      if(reclen > 4*_fbsize_words) {
+        throw std::runtime_error("Error: reclen too big");
       }
+      // an incomplete record ends the file, as for the stream reader
+      if(pos + 4 + reclen > size) {
+        break;
+      }
+      const std::size_t record = pos + 4;
+      const char *rec = data + record;
+
+      unsigned n_part = 0;
+      for(unsigned iword = 0; iword < reclen/4; ) {
+
+        unsigned block_words = (_infmt == Format::COMPACT) ?
+          word<unsigned>(rec + 4*iword) : 273;
+
+        if(!block_words) {
+          throw std::runtime_error("Got block_words = 0\n");
+        }
+
+        if(_infmt == Format::COMPACT) {
+          ++iword;
+        }
 
-      for (unsigned int i = 0; i < crossingParticles.size(); i++) {
-          GenParticle part = crossingParticles[i];
-          genParts.push_back(GenParticle(part.pdgId(), part.generatorId(), part.position(), part.momentum(), part.time()+_tOffset-timeOffset));
+        const char *block = rec + 4*iword;
+        std::string event_marker =
+          (_infmt == Format::NORMAL || !_event_count) ? "EVTH" : "EVHW";
+
+        if(!strncmp(block, "RUNH", 4)) {
+          _run_number = lrint(word<float>(block + 4));
+        }
+        else if(!strncmp(block, "RUNE", 4)) {
+          unsigned end_run_number = lrint(word<float>(block + 4));
+          unsigned end_event_count = lrint(word<float>(block + 8));
+          if(end_run_number != _run_number) {
+            throw std::runtime_error("Error: run number mismatch in end of run record\n");
+          }
+          if(_event_count != end_event_count) {
+            std::cerr<<"RUNE: _event_count = "<<_event_count<<" end record = "<<end_event_count<<std::endl;
+            throw std::runtime_error("Error: event count mismatch in end of run record\n");
+          }
+          // the particles of the current group are not used, as in the stream reader
+          return;
+        }
+        else if(!strncmp(block, event_marker.data(), 4)) {
+          ++_event_count;
+          _current_event_number = lrint(word<float>(block + 4));
+          ++_primaries;
+        }
+        else if(!strncmp(block, "EVTE", 4)) {
+          unsigned end_event_number = lrint(word<float>(block + 4));
+          if(end_event_number != _current_event_number) {
+            throw std::runtime_error("Error: event number mismatch in end of event record\n");
+          }
+        }
+        else {
+          // the decoding reads 7 words for every particle of the sub-block
+          if(4*(iword + 7*((block_words + 6)/7)) > reclen) {
+            throw std::runtime_error("Error: particle sub-block extends beyond its record\n");
+          }
+          unsigned n_block = 0;
+          for (unsigned i_part = 0; i_part < block_words; i_part+=7) {
+            if (unsigned(word<float>(block + 4*i_part) / 1000) != 0) ++n_block;
+          }
+          if (n_block > 0) {
+            group.blocks.emplace_back(record + 4*iword, block_words);
+            n_part += n_block;
+          }
+        }
+
+        iword += block_words;
       }
-      _particles_map.erase(_particles_map.begin()->first);
 
-      if (genParts.size() != 0) {
-        passed = true;
-        _primaries = 0;
+      // Here we expect the FORTRAN end of record padding
+      if(pos + 4 + reclen + 4 > size) {
+        break;
+      }
+      if(word<unsigned>(rec + reclen) != reclen) {
+        throw std::runtime_error("Error: unexpected FORTRAN record end padding");
+      }
+      pos += reclen + 8;
+
+      if (n_part > 0) {
+        group.primaries = _primaries;
+        _groups.push_back(std::move(group));
+        group = ParticleGroup();
       }
+    }
+  }
+
+  bool CosmicCORSIKA::fillEventQueue()
+  {
+    if (_nextGroup == _groups.size()) {
+      // the stream reader draws the offsets of every call before it finds the
+      // end of the run or of the file: draw them as well to stay in step
+      _randFlatX.fire();
+      _randFlatZ.fire();
+      return false;
+    }
+    const std::size_t n = std::min<std::size_t>(_batchSize, _groups.size() - _nextGroup);
 
+    std::vector<std::pair<float,float>> offsets(n);
+    for (auto &offset : offsets) {
+      offset.first  = _randFlatX.fire();
+      offset.second = _randFlatZ.fire();
     }
 
+    std::vector<std::vector<GenParticleCollection>> events(n);
+    const char *data = _mappedFile->data();
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n),
+      [&](const tbb::blocked_range<std::size_t> &range) {
+        float words[7];
+        for (std::size_t i = range.begin(); i != range.end(); ++i) {
+          ParticlesMap particles_map;
+          for (auto const &block : _groups[_nextGroup + i].blocks) {
+            for (unsigned i_part = 0; i_part < block.second; i_part+=7) {
+              std::memcpy(words, data + block.first + 4*i_part, sizeof(words));
+              if (unsigned(words[0] / 1000) == 0)
+                continue;
+              addParticle(words, offsets[i].first, offsets[i].second, particles_map);
+            }
+          }
+          for (auto const &tile : particles_map) {
+            GenParticleCollection genParts;
+            projectToTarget(tile.second, genParts);
+            events[i].push_back(std::move(genParts));
+          }
+        }
+      });
+
+    for (std::size_t i = 0; i < n; ++i) {
+      for (auto &genParts : events[i]) {
+        if (genParts.size() != 0) {
+          _eventQueue.emplace_back(std::move(genParts), _groups[_nextGroup + i].primaries);
+        }
+      }
+    }
+    _nextGroup += n;
     return true;
+  }
 
+  bool CosmicCORSIKA::generateBuffered( GenParticleCollection& genParts, unsigned int &primaries)
+  {
+    while (_eventQueue.empty()) {
+      if (!fillEventQueue()) {
+        return false;
+      }
+    }
+    auto &event = _eventQueue.front();
+    genParts.insert(genParts.end(), std::make_move_iterator(event.first.begin()), std::make_move_iterator(event.first.end()));
+    primaries = event.second - _primariesEmitted;
+    _primariesEmitted = event.second;
+    _eventQueue.pop_front();
+    return true;
   }
 
 }// end namespace
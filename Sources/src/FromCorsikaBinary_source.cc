@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <chrono>
 #include <boost/utility.hpp>
 #include <cassert>
 #include <set>
@@ -52,9 +53,13 @@ namespace mu2e {
       std::set<art::SubRunID> seenSRIDs_;
 
       std::string currentFileName_;
-      std::ifstream *currentFile_ = nullptr;
       float garbage;
 
+      // reading speed, reported at the end of each file
+      std::chrono::steady_clock::duration readTime_{};
+      unsigned long showers_ = 0;
+      unsigned long events_ = 0;
+
       unsigned currentSubRunNumber_; // from file
       // A helper function used to manage the principals.
       // This is boilerplate that does not change if you change the data products.
@@ -124,11 +129,15 @@ namespace mu2e {
       currentFileName_ = filename;
       currentEventNumber_ = 0;
 
-      currentFile_ = new ifstream(currentFileName_);
+      const auto start = std::chrono::steady_clock::now();
+      readTime_ = std::chrono::steady_clock::duration::zero();
+      showers_ = 0;
+      events_ = 0;
 
       unsigned subrun = 0;
       float lowE, highE;
-      _corsikaGen.openFile(currentFile_, subrun, lowE, highE);
+      _corsikaGen.openFile(currentFileName_, subrun, lowE, highE);
+      readTime_ += std::chrono::steady_clock::now() - start;
       currentSubRunNumber_ = subrun;
       _lowE = lowE;
       _highE = highE;
@@ -137,8 +146,12 @@ namespace mu2e {
 
     //----------------------------------------------------------------
     void CorsikaBinaryDetail::closeCurrentFile() {
+      const double seconds = std::chrono::duration<double>(readTime_).count();
+      mf::LogInfo("FromCorsikaBinary") << "Read " << showers_ << " showers in " << events_ << " events from "
+                                       << currentFileName_ << " in " << seconds << " s: "
+                                       << (seconds > 0 ? showers_/seconds : 0.) << " showers/s";
       currentFileName_ = "";
-      currentFile_->close();
+      _corsikaGen.closeFile();
     }
 
     //----------------------------------------------------------------
@@ -150,11 +163,15 @@ namespace mu2e {
     {
       std::unique_ptr<GenParticleCollection> particles(new GenParticleCollection());
       unsigned int primaries;
+      const auto start = std::chrono::steady_clock::now();
       bool still_data = _corsikaGen.generate(*particles, primaries);
+      readTime_ += std::chrono::steady_clock::now() - start;
 
       if (!still_data) {
         return false;
       }
+      showers_ += primaries;
+      ++events_;
 
       managePrincipals(runNumber_, currentSubRunNumber_, ++currentEventNumber_, outR, outSR, outE);
       art::put_product_in_principal(std::move(particles), *outE, myModuleLabel_);
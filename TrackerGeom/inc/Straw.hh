@@ -47,6 +47,12 @@ namespace mu2e {
           const xyzVec wireends[2],
           const xyzVec strawends[2]);
 
+      // restore a straw from its persisted content (see GeometrySnapshot); no normalization is applied
+      Straw (const StrawId& id,
+          const xyzVec& wmid, const xyzVec& smid,
+          const xyzVec& wdir, const xyzVec& sdir,
+          float halflen);
+
       // Accept the compiler copy constructor and assignment operators
 
 
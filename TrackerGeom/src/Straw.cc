@@ -38,6 +38,13 @@ namespace mu2e {
     _sdir((calstrawend - hvstrawend).unit()),
     _hlen(0.5*(hvwireend - calwireend).mag()) {}
 
+  // persisted state constructor
+  Straw::Straw (const StrawId& id,
+      const xyzVec& wmid, const xyzVec& smid,
+      const xyzVec& wdir, const xyzVec& sdir,
+      float halflen) :
+    _id(id), _wmid(wmid), _smid(smid), _wdir(wdir), _sdir(sdir), _hlen(halflen) {}
+
   std::string Straw::name( std::string const& base ) const{
     std::ostringstream os;
     os << base << _id;
@@ -30,6 +30,10 @@
 #include "Offline/MCDataProducts/inc/StrawGasStep.hh"
 #include "Offline/MCDataProducts/inc/StepPointMC.hh"
 #include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include "tbb/parallel_for.h"
+#include "tbb/blocked_range.h"
 // root
 #include "TH1F.h"
 #include "TTree.h"
@@ -69,8 +73,12 @@ namespace mu2e {
           Comment("Dont combine Deltas from this module's collection")};
         fhicl::Atom<unsigned> startSize { Name("StartSize"),
           Comment("Starting size for straw-particle vector"),4};
+        fhicl::Atom<bool> parallelFill{ Name("ParallelFill"),
+          Comment("Fill the StrawGasSteps of different straw-particle pairs in parallel (only without diag or debug)"),true};
         fhicl::Atom<bool> allStepsAssns{ Name("AllStepsAssns"),
           Comment("Build the association to all the contributing StepPointMCs"),false};
+        fhicl::Atom<bool> aggregatedSteps{ Name("AggregatedSteps"),
+          Comment("Input StepPointMCs were aggregated per straw and particle in G4 (tracker.aggregateSteps)"),false};
       };
       using Parameters = art::EDProducer::Table<Config>;
       explicit MakeStrawGasSteps(const Parameters& conf);
@@ -79,21 +87,42 @@ namespace mu2e {
       void beginJob() override;
       void beginRun(art::Run& run) override;
       void produce(art::Event& e) override;
-      typedef pair<StrawId,cet::map_vector_key> SSPair; // key for pair of straw, SimParticle
       typedef art::Ptr<StepPointMC> SPMCP;
-      typedef vector<SPMCP> SPMCPV;
-      typedef map< SSPair , SPMCPV > SPSMap; // steps by straw, SimParticle
       typedef art::Handle<StepPointMCCollection> SPMCCH;
       typedef vector< SPMCCH > SPMCCHV;
-      void fillMap(Tracker const& tracker,TrackerStatus const& trackerStatus,
-          SPMCCH const& spmcch, SPSMap& spsmap);
-      void compressDeltas(SPSMap& spsmap);
-      void setStepType(SPMCP const& spmcptr, ParticleData const& pdata, StrawGasStep::StepType& stype);
-      void fillStep(SPMCPV const& spmcptrs, Straw const& straw,
+      // reference to one StepPointMC, used to sort the steps by straw and SimParticle
+      struct StepRef {
+        uint16_t sid; // StrawId
+        cet::map_vector_key pid; // SimParticle key
+        uint32_t index; // index into the StepPointMC collection
+        bool operator < (StepRef const& other) const {
+          if(sid != other.sid) return sid < other.sid;
+          if(pid != other.pid) return pid < other.pid;
+          return index < other.index;
+        }
+      };
+      // steps of one straw, SimParticle pair: a contiguous range of the sorted references,
+      // followed by the steps of the (delta-ray) groups merged into it, in merge order
+      struct StepGroup {
+        StrawId sid;
+        cet::map_vector_key pid;
+        uint32_t begin, end;
+        vector<uint32_t> merged;
+        bool active;
+        StepGroup(StrawId id, cet::map_vector_key key, uint32_t ibeg) : sid(id), pid(key), begin(ibeg), end(ibeg), active(true) {}
+      };
+      typedef vector<uint32_t> SPMCIV; // indices of StepPointMCs in their collection
+      void fillGroups(Tracker const& tracker,TrackerStatus const& trackerStatus,
+          StepPointMCCollection const& steps, vector<StepRef>& refs, vector<StepGroup>& groups);
+      void groupSteps(vector<StepRef> const& refs, vector<StepGroup> const& groups, uint32_t igroup, SPMCIV& sindices) const;
+      int findGroup(vector<StepGroup> const& groups, StrawId sid, cet::map_vector_key pid) const;
+      void compressDeltas(StepPointMCCollection const& steps, vector<StepRef> const& refs, vector<StepGroup>& groups);
+      void setStepType(StepPointMC const& spmc, ParticleData const& pdata, StrawGasStep::StepType& stype) const;
+      void fillStep(StepPointMCCollection const& steps, SPMCIV const& sindices, Straw const& straw,
           ParticleData const& pdata, cet::map_vector_key pid, StrawGasStep& sgs);
-      void fillStepDiag(Straw const& straw, StrawGasStep const& sgs, SPMCPV const& spmcptrs);
+      void fillStepDiag(Straw const& straw, StrawGasStep const& sgs, StepPointMCCollection const& steps, SPMCIV const& sindices);
       int _debug, _diag;
-      bool _combineDeltas, _allAssns;
+      bool _combineDeltas, _allAssns, _aggregated, _parallel;
       float _maxDeltaLen;
       float _minionBG, _minionKE;
       float _curlfac, _linefac;
@@ -124,6 +153,8 @@ namespace mu2e {
     _diag(config().diag()),
     _combineDeltas(config().combineDeltas()),
     _allAssns(config().allStepsAssns()),
+    _aggregated(config().aggregatedSteps()),
+    _parallel(config().parallelFill()),
     _maxDeltaLen(config().maxDeltaLength()),
     _minionBG(config().minionBG()),
     _minionKE(config().minionKE()),
@@ -224,8 +255,16 @@ namespace mu2e {
       nspmcs += steps.size();
     }
     sgsc->reserve(nspmcs);
+    // the diagnostics and debug printout accumulate state, so they require serial filling
+    bool parallel = _parallel && _diag == 0 && _debug <= 1;
+    // work space, reused for all collections
+    vector<StepRef> refs;
+    vector<StepGroup> groups;
+    vector<uint32_t> active;
+    vector<ParticleData const*> pdatas;
     // Loop over StepPointMC collections
     for( auto const& handle : stepsHandles) {
+      StepPointMCCollection const& steps(*handle);
       // see if we should compress deltas from this collection
       bool dcomp = _combineDeltas && (handle.provenance()->moduleLabel() != _keepDeltas);
       if(_debug > 1){
@@ -234,37 +273,63 @@ namespace mu2e {
         else
           cout << "No compression for collection " << handle.provenance()->moduleLabel() << endl;
       }
-      // Loop over the StepPointMCs in this collection and sort them by straw and SimParticle
-      SPSMap spsmap; // map of step points by straw,sim particle
-      fillMap(tracker,trackerStatus,handle, spsmap);
+      // Sort the StepPointMCs in this collection by straw and SimParticle
+      fillGroups(tracker,trackerStatus,steps,refs,groups);
       // optionally combine delta-rays that never leave the straw with their parent particle
-      if(dcomp)compressDeltas(spsmap);
-      nspss += spsmap.size();
+      if(dcomp)compressDeltas(steps,refs,groups);
+      active.clear();
+      pdatas.clear();
+      for(uint32_t igroup=0; igroup < groups.size(); ++igroup){
+        if(groups[igroup].active){
+          active.push_back(igroup);
+          // resolve the SimParticles serially
+          auto const& simptr = steps[refs[groups[igroup].begin].index].simParticle();
+          pdatas.push_back(&pdt->particle(simptr->pdgId()));
+        }
+      }
+      nspss += active.size();
       // convert the SimParticle/straw pair steps into StrawGas objects and fill the collection.
-      for(auto ispsmap = spsmap.begin(); ispsmap != spsmap.end(); ispsmap++){
-        auto pid = ispsmap->first.second; // primary SimParticle
-        auto const& spmcptrs = ispsmap->second;
-        auto const& straw = tracker.getStraw(ispsmap->first.first);
-        auto const& simptr = spmcptrs.front()->simParticle();
-        auto pdata = pdt->particle(simptr->pdgId());
-        StrawGasStep sgs;
-        fillStep(spmcptrs,straw,pdata,pid,sgs);
-        sgsc->push_back(sgs);
-        auto sgsptr = art::Ptr<StrawGasStep>(StrawGasStepCollectionPID,sgsc->size()-1,StrawGasStepCollectionGetter);
+      size_t ioff = sgsc->size();
+      sgsc->resize(ioff + active.size());
+      auto fillRange = [&](tbb::blocked_range<size_t> const& range) {
+        SPMCIV sindices;
+        sindices.reserve(_ssize);
+        for(size_t iactive = range.begin(); iactive != range.end(); ++iactive){
+          auto const& group = groups[active[iactive]];
+          sindices.clear();
+          groupSteps(refs,groups,active[iactive],sindices);
+          fillStep(steps,sindices,tracker.getStraw(group.sid),*pdatas[iactive],group.pid,(*sgsc)[ioff+iactive]);
+        }
+      };
+      if(parallel)
+        tbb::parallel_for(tbb::blocked_range<size_t>(0,active.size()),fillRange);
+      else
+        fillRange(tbb::blocked_range<size_t>(0,active.size()));
+      if(!(_allAssns || _diag > 0 || _debug > 1))continue;
+      SPMCIV sindices;
+      for(size_t iactive=0; iactive < active.size(); ++iactive){
+        auto const& sgs = (*sgsc)[ioff+iactive];
+        auto const& straw = tracker.getStraw(sgs.strawId());
+        sindices.clear();
+        groupSteps(refs,groups,active[iactive],sindices);
         // optionall add Assns for all StepPoints, including delta-rays
         if(_allAssns){
-          for(auto const& spmcptr : spmcptrs)
-            sgsa->addSingle(sgsptr,spmcptr);
+          auto sgsptr = art::Ptr<StrawGasStep>(StrawGasStepCollectionPID,ioff+iactive,StrawGasStepCollectionGetter);
+          for(auto isp : sindices)
+            sgsa->addSingle(sgsptr,SPMCP(handle,isp));
+        }
+        if(_diag > 0){
+          // recompute the primary/secondary counts for this step
+          fillStep(steps,sindices,straw,*pdatas[iactive],groups[active[iactive]].pid,(*sgsc)[ioff+iactive]);
+          fillStepDiag(straw,sgs,steps,sindices);
         }
-        if(_diag > 0)fillStepDiag(straw,sgs,spmcptrs);
         if(_debug > 1){
           // checks and printout
-          cout << " SGS with " << spmcptrs.size() << " steps, StrawId = " << sgs.strawId()  << " SimParticle Key = " << sgs.simParticle()->id()
+          cout << " SGS with " << sindices.size() << " steps, StrawId = " << sgs.strawId()  << " SimParticle Key = " << sgs.simParticle()->id()
             << " edep = " << sgs.ionizingEdep() << " pathlen = " << sgs.stepLength() << " glen = " << sqrt((sgs.endPosition()-sgs.startPosition()).mag2()) << " width = " << sgs.width()
             << " time = " << sgs.time() << endl;
 
           // check if end is inside physical straw
-          const Straw& straw = tracker.getStraw(sgs.strawId());
           static double r2 = tracker.strawProperties()._strawInnerRadius * tracker.strawProperties()._strawInnerRadius;
           Hep3Vector hend = GenVector::Hep3Vec(sgs.endPosition());
           double rd2 = (hend-straw.getMidPoint()).perpPart(straw.getDirection()).mag2();
@@ -279,7 +344,7 @@ namespace mu2e {
     if(_allAssns) event.put(move(sgsa));
   } // end of produce
 
-  void MakeStrawGasSteps::fillStep(SPMCPV const& spmcptrs, Straw const& straw,
+  void MakeStrawGasSteps::fillStep(StepPointMCCollection const& steps, SPMCIV const& sindices, Straw const& straw,
       ParticleData const& pdata, cet::map_vector_key pid, StrawGasStep& sgs){
     // variables we accumulate for all the StepPoints in this pair
     double eion(0.0), pathlen(0.0);
@@ -288,41 +353,45 @@ namespace mu2e {
       _epri=_esec=0.0;
     }
     // keep track of the first and last PRIMARY step
-    SPMCP  first;
-    SPMCP  last;
+    StepPointMC const* first(0);
+    StepPointMC const* last(0);
     // loop over all  the StepPoints for this SimParticle
-    for(auto const& spmcptr : spmcptrs){
-      bool primary=spmcptr->simParticle()->id() == pid;
+    for(auto isp : sindices){
+      auto const& spmc = steps[isp];
+      bool primary= spmc.simParticle().key() == pid.asUint();
       // update eion for all contributions
-      eion += spmcptr->ionizingEdep();
+      eion += spmc.ionizingEdep();
       // treat primary and secondary (delta-ray) energy differently
       if(primary) {
         // primary: update path length, and entry/exit
-        pathlen += spmcptr->stepLength();
-        if(first.isNull() || spmcptr->time() < first->time()) first = spmcptr;
-        if(last.isNull() || spmcptr->time() > last->time()) last = spmcptr;
+        pathlen += spmc.stepLength();
+        if(first == 0 || spmc.time() < first->time()) first = &spmc;
+        if(last == 0 || spmc.time() > last->time()) last = &spmc;
       }
       // diagnostics
       if(_diag >1){
         if(primary){
           _npri++;
-          _epri += spmcptr->ionizingEdep();
+          _epri += spmc.ionizingEdep();
         } else {
           _nsec++;
-          _esec += spmcptr->ionizingEdep();
+          _esec += spmc.ionizingEdep();
         }
       }
     }
-    if(first.isNull() || last.isNull())
+    if(first == 0 || last == 0)
       throw cet::exception("SIM")<<"mu2e::MakeStrawGasSteps: No first or last step" << endl;
     // Define the position at entrance and exit; note the StepPointMC position is at the start of the step, so we have to extend the last
     XYZVectorF start = XYZVectorF(first->position());
     // determine the type of step
     StrawGasStep::StepType stype;
-    setStepType(first,pdata,stype);
+    setStepType(*first,pdata,stype);
     // compute the end position and step type
     XYZVectorF end = XYZVectorF(last->postPosition());
-    XYZVectorF momvec = XYZVectorF(0.5*(first->momentum() + last->momentum()));        // average first and last momentum
+    // an aggregated step spans the whole straw: use its exit momentum.  Unaggregated steps use
+    // the momentum at the start of the last step, the difference is the loss in that step
+    auto const& lastmom = _aggregated ? last->postMomentum() : last->momentum();
+    XYZVectorF momvec = XYZVectorF(0.5*(first->momentum() + lastmom));        // average first and last momentum
     float  mom = sqrt(momvec.mag2());
     // determine the width from the sigitta or curl radius
     auto pdir = first->momentum().unit();
@@ -339,9 +408,14 @@ namespace mu2e {
         start, end, momvec, first->simParticle());
   }
 
-  void MakeStrawGasSteps::fillMap(Tracker const& tracker,TrackerStatus const& trackerStatus,
-      SPMCCH const& spmcch, SPSMap& spsmap) {
-    StepPointMCCollection const& steps(*spmcch);
+  // Sort references to the usable steps by straw and SimParticle, and group them.  The
+  // group order and the step order within each group are the same as those of a
+  // std::map keyed by (straw, SimParticle) filled in collection order.
+  void MakeStrawGasSteps::fillGroups(Tracker const& tracker,TrackerStatus const& trackerStatus,
+      StepPointMCCollection const& steps, vector<StepRef>& refs, vector<StepGroup>& groups) {
+    refs.clear();
+    groups.clear();
+    refs.reserve(steps.size());
     for (size_t ispmc =0; ispmc<steps.size();++ispmc) {
       const auto& step = steps[ispmc];
       StrawId const & sid = step.strawId();
@@ -351,57 +425,76 @@ namespace mu2e {
         double wpos = fabs((step.position()-straw.getMidPoint()).dot(straw.getDirection()));
         //skip steps that occur in the deadened region near the end of each wire
         if( wpos <  straw.halfLength()){
-          cet::map_vector_key tid = step.simParticle().get()->id();
-          // create key
-          SSPair stpair(sid,tid);
-          // create ptr to this step
-          SPMCP  spmcptr(spmcch,ispmc);
-          vector<SPMCP > spmcptrv;
-          spmcptrv.reserve(_ssize);
-          spmcptrv.push_back(spmcptr);
-          // check if this key exists and add it if not
-          auto ssp = spsmap.emplace(stpair,spmcptrv);
-          // if the key already exists, just add this Ptr to the vector
-          if(!ssp.second)ssp.first->second.push_back(spmcptr);
+          // the Ptr key is the SimParticle key: no need to resolve the Ptr
+          refs.push_back(StepRef{sid.asUint16(),cet::map_vector_key(step.simParticle().key()),static_cast<uint32_t>(ispmc)});
         }
       } else if ( _debug>1 ) {
         std::cout << "No Signal, StrawId " << sid << endl;
       }
     }
+    std::sort(refs.begin(),refs.end());
+    for(uint32_t iref=0; iref < refs.size(); ++iref){
+      auto const& ref = refs[iref];
+      if(groups.empty() || groups.back().sid.asUint16() != ref.sid || groups.back().pid != ref.pid)
+        groups.emplace_back(StrawId(ref.sid),ref.pid,iref);
+      groups.back().end = iref+1;
+    }
+  }
+
+  void MakeStrawGasSteps::groupSteps(vector<StepRef> const& refs, vector<StepGroup> const& groups,
+      uint32_t igroup, SPMCIV& sindices) const {
+    auto const& group = groups[igroup];
+    for(uint32_t iref = group.begin; iref != group.end; ++iref)
+      sindices.push_back(refs[iref].index);
+    for(auto jgroup : group.merged)
+      groupSteps(refs,groups,jgroup,sindices);
+  }
+
+  int MakeStrawGasSteps::findGroup(vector<StepGroup> const& groups, StrawId sid, cet::map_vector_key pid) const {
+    auto key = make_pair(sid.asUint16(),pid);
+    auto ifnd = std::lower_bound(groups.begin(),groups.end(),key,
+        [](StepGroup const& group, pair<uint16_t,cet::map_vector_key> const& key) {
+        return make_pair(group.sid.asUint16(),group.pid) < key; });
+    if(ifnd == groups.end() || ifnd->sid != sid || ifnd->pid != pid || !ifnd->active) return -1;
+    return std::distance(groups.begin(),ifnd);
   }
 
-  void MakeStrawGasSteps::compressDeltas(SPSMap& spsmap) {
+  void MakeStrawGasSteps::compressDeltas(StepPointMCCollection const& steps, vector<StepRef> const& refs, vector<StepGroup>& groups) {
     // first, make some helper maps
-    typedef map< cet::map_vector_key, StrawId > SMap; // map from key to Straw, to test for uniqueness
-    typedef map< cet::map_vector_key, cet::map_vector_key> DMap; // map from delta ray to parent
+    typedef unordered_map< uint64_t, StrawId > SMap; // map from key to Straw, to test for uniqueness
+    typedef unordered_map< uint64_t, cet::map_vector_key> DMap; // map from delta ray to parent
     SMap smap;
     DMap dmap;
-    for(auto isps = spsmap.begin(); isps != spsmap.end(); isps++ ) {
-      auto sid = isps->first.first;
-      auto tid = isps->first.second;
+    smap.reserve(groups.size());
+    for(auto const& group : groups) {
+      auto sid = group.sid;
+      auto tid = group.pid.asUint();
       // map key to straw
       auto sp = smap.emplace(tid,sid);
       if(!sp.second && sp.first->second != sid && sp.first->second.valid())sp.first->second = StrawId(); // Particle already seen in another straw: make invalid to avoid compressing it
     }
 
     // loop over particle-straw pairs looking for delta rays
-    auto isps =spsmap.begin();
-    while(isps != spsmap.end()){
+    SPMCIV dsteps;
+    for(uint32_t igroup=0; igroup < groups.size(); ++igroup){
       bool isdelta(false);
-      auto& dsteps = isps->second;
-      auto dkey =isps->first.second;
+      auto& group = groups[igroup];
+      auto dkey = group.pid;
       // see if this particle is a delta-ray and if it's step is short
-      auto pcode = dsteps.front()->simParticle()->creationCode();
+      auto const& simp = steps[refs[group.begin].index].simParticle();
+      auto pcode = simp->creationCode();
       if(pcode == ProcessCode::eIoni || pcode == ProcessCode::hIoni){
         // make sure this particle doesnt have a step in any other straw
-        auto ifnd = smap.find(dkey);
+        auto ifnd = smap.find(dkey.asUint());
         if(ifnd == smap.end())
           throw cet::exception("SIM")<<"mu2e::MakeStrawGasSteps: No SimParticle found for delta key " << dkey << endl;
         else if(ifnd->second.valid()){ // only compress delta rays without hits in any other straw
           // add the lengths of all the steps in this straw
+          dsteps.clear();
+          groupSteps(refs,groups,igroup,dsteps);
           float len(0.0);
-          for(auto const& istep : dsteps)
-            len += istep->stepLength();
+          for(auto istep : dsteps)
+            len += steps[istep].stepLength();
           if(len < _maxDeltaLen){
             // short delta ray. flag for combination
             isdelta = true;
@@ -410,39 +503,34 @@ namespace mu2e {
       }
       // if this is a delta, map it back to the primary
       if(isdelta){
-        auto strawid = isps->first.first;
+        auto strawid = group.sid;
         // find its parent
-        auto pkey = dsteps.front()->simParticle()->parentId();
+        auto pkey = simp->parentId();
         // map it so that potential daughters can map back through this particle even after compression
-        dmap[dkey] = pkey;
+        dmap[dkey.asUint()] = pkey;
         // find the parent. This must be recursive, as delta rays can come from delta rays (from delta rays...)
-        auto jfnd = dmap.find(pkey);
+        auto jfnd = dmap.find(pkey.asUint());
         while(jfnd != dmap.end()){
           pkey = jfnd->second;
-          jfnd = dmap.find(pkey);
+          jfnd = dmap.find(pkey.asUint());
         }
-        // now, find the parent back in the original map
-        auto ifnd = spsmap.find(make_pair(strawid,pkey));
-        if(ifnd != spsmap.end()){
+        // now, find the parent back in the original groups
+        int pgroup = findGroup(groups,strawid,pkey);
+        if(pgroup >= 0){
           if(_debug > 1)cout << "mu2e::MakeStrawGasSteps: SimParticle found for delta parent key " << pkey << " straw " << strawid << endl;
           // move the contents to the primary
-          auto& psteps = ifnd->second;
-          psteps.insert(psteps.end(),dsteps.begin(),dsteps.end());
-          // erase the delta ray and advance the iterator
-          isps = spsmap.erase(isps);
+          groups[pgroup].merged.push_back(igroup);
+          group.active = false;
         } else {
           // there are a very few delta rays whose parents die in the straw walls that cause StepPoints, so this is not an error.  These stay
           // as uncompressed particles.
           if(_debug > 1)cout << "mu2e::MakeStrawGasSteps: No SimParticle found for delta parent key " << pkey << " straw " << strawid << endl;
-          isps++;
         }
-      } else
-        // move to the next straw/particle pair
-        isps++;
+      }
     }
   }
 
-  void MakeStrawGasSteps::fillStepDiag(Straw const& straw, StrawGasStep const& sgs, SPMCPV const& spmcptrs) {
+  void MakeStrawGasSteps::fillStepDiag(Straw const& straw, StrawGasStep const& sgs, StepPointMCCollection const& steps, SPMCIV const& sindices) {
     _erad = sqrt((GenVector::Hep3Vec(sgs.endPosition())-straw.getMidPoint()).perpPart(straw.getDirection()).mag2());
     _hendrad->Fill(_erad);
     _hphi->Fill(_brot);
@@ -451,7 +539,7 @@ namespace mu2e {
       _sion = sgs.stepType().ionization();
       _prilen = sgs.stepLength();
       _pridist = sqrt((sgs.endPosition()-sgs.startPosition()).mag2());
-      auto const& spmc = *spmcptrs.front();
+      auto const& spmc = steps[sindices.front()];
       _partP = spmc.momentum().mag();
       _partPDG = spmc.simParticle()->pdgId();
       _elen = spmc.stepLength();
@@ -465,25 +553,26 @@ namespace mu2e {
       _sp.clear();
       _slen.clear();
       auto sdir = GenVector::Hep3Vec(sgs.endPosition()-sgs.startPosition()).unit();
-      for(auto const& spmcptr : spmcptrs){
-        auto dist = ((spmcptr->position()-GenVector::Hep3Vec(sgs.startPosition())).cross(sdir)).mag();
+      for(auto isp : sindices){
+        auto const& step = steps[isp];
+        auto dist = ((step.position()-GenVector::Hep3Vec(sgs.startPosition())).cross(sdir)).mag();
         _sdist.push_back(dist);
-        _sdot.push_back(sdir.dot(spmcptr->momentum().unit()));
-        _sp.push_back(spmcptr->momentum().mag());
-        _slen.push_back(spmcptr->stepLength());
+        _sdot.push_back(sdir.dot(step.momentum().unit()));
+        _sp.push_back(step.momentum().mag());
+        _slen.push_back(step.stepLength());
       }
       _sgsdiag->Fill();
     }
   }
 
-  void MakeStrawGasSteps::setStepType(SPMCP const& spmcptr, ParticleData const& pdata, StrawGasStep::StepType& stype) {
+  void MakeStrawGasSteps::setStepType(StepPointMC const& spmc, ParticleData const& pdata, StrawGasStep::StepType& stype) const {
     // now determine ioniztion and shape
     int itype, shape;
     if(pdata.charge() == 0.0){
       itype = StrawGasStep::StepType::neutral;
       shape = StrawGasStep::StepType::point;
     } else {
-      double mom = spmcptr->momentum().mag();
+      double mom = spmc.momentum().mag();
       if(mom < _curlmom)
         shape = StrawGasStep::StepType::curl;
       else if(mom < _linemom)
@@ -0,0 +1,69 @@
+#ifndef Trigger_IntensityLevels_hh
+#define Trigger_IntensityLevels_hh
+//
+// Microbunch intensity levels for the intensity-aware trigger filters: the intensity of the
+// event is read from one of ProtonBunchIntensity (protons), IntensityInfoTrackerHits (straw
+// hits) or IntensityInfoCalo (calorimeter hits), and classified by increasing thresholds:
+// level 0 is below the first threshold, level i at or above threshold i-1.  A filter keeps
+// one set of cuts per level, level 0 holding its nominal cuts.  Without thresholds there is
+// a single level and the event is not read.  The intensity product must be made upstream of
+// the filter in its path, and the filter declares it with declareConsumes.
+//
+//   intensityLevels : { source : IntensityInfoTrackerHits tag : makeSH thresholds : [ 3000, 6000 ] }
+//
+
+#include "art/Framework/Core/ConsumesCollector.h"
+#include "art/Framework/Principal/Event.h"
+#include "canvas/Utilities/InputTag.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class IntensityLevels {
+  public:
+    enum Source {protonBunchIntensity=0, trackerHits, caloHits};
+
+    struct Config {
+      using Name    = fhicl::Name;
+      using Comment = fhicl::Comment;
+      fhicl::Atom<std::string>    source     { Name("source"),     Comment("ProtonBunchIntensity, IntensityInfoTrackerHits or IntensityInfoCalo") };
+      fhicl::Atom<art::InputTag>  tag        { Name("tag"),        Comment("producer of the intensity estimate") };
+      fhicl::Sequence<double>     thresholds { Name("thresholds"), Comment("increasing intensities at which levels 1, 2, ... start") };
+    };
+
+    IntensityLevels() {}
+    explicit IntensityLevels(const Config& config);
+
+    bool     used()    const { return !_thresholds.empty(); }
+    unsigned nLevels() const { return _thresholds.size()+1; }
+
+    // declare the intensity product, from the constructor of the owning module
+    void     declareConsumes(art::ConsumesCollector& cc) const;
+
+    // intensity of the event, in units of the source
+    double   intensity(const art::Event& event) const;
+    // same, false if the event has no intensity product
+    bool     findIntensity(const art::Event& event, double& intensity) const;
+    unsigned level(double intensity) const;
+    unsigned level(const art::Event& event) const { return used() ? level(intensity(event)) : 0; }
+
+    // check that a filter gives cuts for each level above 0
+    void     checkCuts(size_t ncuts, const std::string& module) const;
+    // pass counts by level, as printed by the filters at endRun
+    void     printCounts(std::ostream& os, const std::string& module,
+                         const std::vector<unsigned>& nevt, const std::vector<unsigned>& npass) const;
+
+  private:
+    Source              _source = protonBunchIntensity;
+    art::InputTag       _tag;
+    std::vector<double> _thresholds;
+  };
+
+}
+
+#endif /* Trigger_IntensityLevels_hh */
@@ -0,0 +1,60 @@
+#ifndef Trigger_TriggerCostMonitor_hh
+#define Trigger_TriggerCostMonitor_hh
+//
+// Service measuring the wall-clock time of every module in every event, for the trigger path
+// cost model (see TriggerCostReport_module).  The times of an event are kept until the next
+// event starts on the same schedule, so they can be read by an analyzer in an end path.
+//
+// Usage: services.TriggerCostMonitor : {}
+//
+
+#include "art/Framework/Services/Registry/ServiceDeclarationMacros.h"
+#include "canvas/Persistency/Provenance/EventID.h"
+#include "fhiclcpp/ParameterSet.h"
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace art {
+  class ActivityRegistry;
+  class Event;
+  class ModuleContext;
+  class ScheduleContext;
+}
+
+namespace mu2e {
+
+  class TriggerCostMonitor {
+  public:
+    TriggerCostMonitor(const fhicl::ParameterSet&, art::ActivityRegistry&);
+    TriggerCostMonitor(TriggerCostMonitor const&) = delete;
+    TriggerCostMonitor& operator=(TriggerCostMonitor const&) = delete;
+
+    // Times [ms] of the modules run so far in this event, by module label; empty if the event
+    // is not being processed
+    std::map<std::string,double> moduleTimes(const art::EventID& id) const;
+
+  private:
+    typedef std::chrono::steady_clock clock;
+
+    struct ScheduleData {
+      art::EventID                         event;
+      std::map<std::string,clock::time_point> start;
+      std::map<std::string,double>         times;
+    };
+
+    void preEvent  (art::Event const& event, art::ScheduleContext sc);
+    void preModule (art::ModuleContext const& mc);
+    void postModule(art::ModuleContext const& mc);
+
+    // modules of the same event can run concurrently on different paths
+    mutable std::mutex                 mutex_;
+    std::map<unsigned,ScheduleData>    schedules_;
+  };
+
+}
+
+DECLARE_ART_SERVICE(mu2e::TriggerCostMonitor, SHARED)
+#endif /* Trigger_TriggerCostMonitor_hh */
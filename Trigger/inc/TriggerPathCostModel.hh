@@ -0,0 +1,102 @@
+#ifndef Trigger_TriggerPathCostModel_hh
+#define Trigger_TriggerPathCostModel_hh
+//
+// Cost model of the trigger paths, filled event by event from the module times and the
+// trigger decisions measured on a sample (see TriggerCostMonitor_service and
+// TriggerCostReport_module).
+//
+// For every path it keeps the latency of the path run standalone (the sum of the times of
+// the modules it ran, shared modules included), and splits the path into stages: a stage is
+// a run of modules ending with a filter that rejected at least once in the sample.  From the
+// mean cost and the conditional acceptance of each stage it computes the expected latency,
+// and the stage order that minimizes it if the stages were independent (ascending
+// cost/rejection).  The menu author still has to check the data dependencies between stages.
+//
+// It also derives, for every path, cuts on cheap observables (digi counts, calorimeter energy
+// sum, proton bunch intensity) keeping a given fraction of the accepted events, and the
+// rejection these cuts would have as a pre-filter (see TriggerPreFilter_module).
+//
+
+#include <array>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mu2e {
+
+  class TriggerPathCostModel {
+  public:
+    enum Observable {nStrawDigis=0, nCaloDigis, caloEnergy, protonBunchIntensity, nObservables};
+    // values of the observables in an event, NaN if not measured
+    typedef std::array<double,nObservables> Observables;
+
+    struct Stage {
+      std::vector<std::string> modules;
+      double   cost       = 0;  // mean time [ms] of the stage, when run
+      double   acceptance = 1;  // fraction of the events reaching the stage that pass it
+      unsigned nIn        = 0;
+    };
+
+    struct Cut {
+      Observable obs;
+      double     min;
+      double     max;
+    };
+
+    struct PreFilter {
+      std::vector<Cut> cuts;
+      double           efficiency = 1; // fraction of the accepted events passing the cuts
+      double           rejection  = 0; // fraction of all events failing the cuts
+    };
+
+    static const char* observableName(Observable obs);
+    static const char* minParameter  (Observable obs);
+    static const char* maxParameter  (Observable obs);
+
+    // times are the module times [ms] of the event by label, lastModule the index of the last
+    // module run on the path
+    void fill(const std::string& path, const std::vector<std::string>& modules,
+              const std::map<std::string,double>& times, unsigned lastModule, bool accept);
+    // once per event, after the paths
+    void fillEvent(const std::map<std::string,double>& times, const Observables& obs);
+
+    std::vector<std::string> paths() const;
+    unsigned nEvents() const {return eventLatency_.size();}
+
+    std::vector<Stage>    stages(const std::string& path) const;
+    // stage indices in order of increasing cost/rejection
+    static std::vector<unsigned> recommendedOrder(const std::vector<Stage>& stages);
+    static double expectedLatency(const std::vector<Stage>& stages, const std::vector<unsigned>& order);
+
+    // q in [0,1]; latency [ms] of the path run standalone, or of the full event if path is empty
+    double    latencyQuantile(const std::string& path, double q) const;
+    PreFilter preFilter(const std::string& path, double efficiency) const;
+
+    void print(std::ostream& os, const std::vector<double>& percentiles, double efficiency) const;
+    // fcl tables of TriggerPreFilter instances for the paths whose pre-filter rejects at least minRejection;
+    // pbiTag is the ProtonBunchIntensity the intensity cuts were derived from
+    void writePreFilters(std::ostream& os, double efficiency, double minRejection, const std::string& pbiTag) const;
+
+  private:
+    struct ModuleStats {
+      std::string label;
+      unsigned    nRun   = 0;
+      unsigned    nStop  = 0;  // path rejected at this module
+      double      sumTime= 0;
+    };
+    struct PathStats {
+      std::vector<ModuleStats> modules;
+      std::vector<float>       latency;
+      std::vector<unsigned>    accepted;  // indices of the accepted events
+      unsigned                 nAccept = 0;
+    };
+
+    std::map<std::string,PathStats> paths_;
+    std::vector<float>              eventLatency_;
+    std::vector<Observables>        observables_;
+  };
+
+}
+
+#endif /* Trigger_TriggerPathCostModel_hh */
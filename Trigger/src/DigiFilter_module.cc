@@ -2,20 +2,28 @@
 //  Filter for selecting good time cluster: this is part of the track trigger
 //  Original author: Dave Brown (LBNL) 3/1/2017
 //
+//  The digi count ranges can depend on the microbunch intensity: with an intensityLevels
+//  table (see IntensityLevels), intensityCuts gives the ranges of each level above the
+//  nominal one, missing values being taken from the level below.
+//
 // framework
 #include "art/Framework/Core/EDFilter.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "fhiclcpp/ParameterSet.h"
+#include "fhiclcpp/types/Table.h"
 // mu2e
 // data
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/RecoDataProducts/inc/CaloDigi.hh"
+#include "Offline/Trigger/inc/IntensityLevels.hh"
 // #include "RecoDataProducts/inc/TriggerInfo.hh"
 // c++
 #include <iostream>
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -35,15 +43,20 @@ namespace mu2e
     bool            _useCD;   //flag for using the CaloDigi
 
     //list of the parameters used to perform the filtering
-    int             _minnsd;  //minimum number of StrawDigi required
-    int             _maxnsd;  //maximum number of StrawDigi required
-    int             _minncd;  //minimum number of CaloDigi required
-    int             _maxncd;  //maximum number of CaloDigi required
+    struct Cuts {
+      int           minnsd;   //minimum number of StrawDigi required
+      int           maxnsd;   //maximum number of StrawDigi required
+      int           minncd;   //minimum number of CaloDigi required
+      int           maxncd;   //maximum number of CaloDigi required
+    };
+    std::vector<Cuts> _cuts;  //by intensity level
     float           _maxcaloE;//maximum energy, from the sum of all caloDigi
+    IntensityLevels _levels;
 
     int             _debug;
     // counters
     unsigned _nevt, _npass;
+    std::vector<unsigned> _nevtLevel, _npassLevel;
   };
 
   DigiFilter::DigiFilter(fhicl::ParameterSet const& pset) :
@@ -52,17 +65,33 @@ namespace mu2e
     _cdTag    (pset.get<art::InputTag>("caloDigiCollection")),
     _useSD    (pset.get<bool>("useStrawDigi")),
     _useCD    (pset.get<bool>("useCaloDigi")),
-    _minnsd   (pset.get<int>("minNStrawDigi")),
-    _maxnsd   (pset.get<int>("maxNStrawDigi")),
-    _minncd   (pset.get<int>("minNCaloDigi")),
-    _maxncd   (pset.get<int>("maxNCaloDigi")),
+    _cuts     {{pset.get<int>("minNStrawDigi"),pset.get<int>("maxNStrawDigi"),
+                pset.get<int>("minNCaloDigi"), pset.get<int>("maxNCaloDigi")}},
     _maxcaloE (pset.get<float>("maxCaloEnergy")),
     _debug    (pset.get<int>("debugLevel",0)),
     _nevt(0), _npass(0)
-  {}
+  {
+    fhicl::ParameterSet levels;
+    if (pset.get_if_present("intensityLevels",levels)){
+      _levels = IntensityLevels(fhicl::Table<IntensityLevels::Config>(levels,std::set<std::string>{})());
+      auto levelCuts = pset.get<std::vector<fhicl::ParameterSet>>("intensityCuts");
+      _levels.checkCuts(levelCuts.size(),"DigiFilter");
+      for (const auto& lc : levelCuts){
+        const Cuts& below = _cuts.back();
+        _cuts.push_back({lc.get<int>("minNStrawDigi",below.minnsd),lc.get<int>("maxNStrawDigi",below.maxnsd),
+                         lc.get<int>("minNCaloDigi", below.minncd),lc.get<int>("maxNCaloDigi", below.maxncd)});
+      }
+    }
+    _levels.declareConsumes(consumesCollector());
+    _nevtLevel.assign(_levels.nLevels(),0);
+    _npassLevel.assign(_levels.nLevels(),0);
+  }
 
   bool DigiFilter::filter(art::Event& event){
     ++_nevt;
+    const unsigned level = _levels.level(event);
+    const Cuts& cuts = _cuts[level];
+    ++_nevtLevel[level];
     bool retval(false), retvalSD(false), retvalCD(false); // preset to fail
     // find the collection
 
@@ -84,15 +113,15 @@ namespace mu2e
     }
 
     if (_useSD) {
-      if ( (nsd >= _minnsd) &&
-           (nsd <= _maxnsd) ){
+      if ( (nsd >= cuts.minnsd) &&
+           (nsd <= cuts.maxnsd) ){
         retvalSD = true;
       }
     }
 
     if (_useCD) {
-      if ( (ncd >= _minncd) &&
-           (ncd <= _maxncd) ){
+      if ( (ncd >= cuts.minncd) &&
+           (ncd <= cuts.maxncd) ){
         retvalCD = true;
       }
     }
@@ -107,6 +136,7 @@ namespace mu2e
 
     if (retval){
       ++_npass;
+      ++_npassLevel[level];
 
       if(_debug > 1){
         cout << moduleDescription().moduleLabel() << " passed event " << event.id() << endl;
@@ -118,6 +148,7 @@ namespace mu2e
   bool DigiFilter::endRun( art::Run& run ) {
     if(_debug > 0 && _nevt > 0){
       cout << moduleDescription().moduleLabel() << " passed " << _npass << " events out of " << _nevt << " for a ratio of " << float(_npass)/float(_nevt) << endl;
+      if (_levels.used()) _levels.printCounts(cout,moduleDescription().moduleLabel(),_nevtLevel,_npassLevel);
     }
     return true;
   }
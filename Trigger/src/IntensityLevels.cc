@@ -0,0 +1,89 @@
+#include "Offline/Trigger/inc/IntensityLevels.hh"
+
+#include "Offline/MCDataProducts/inc/ProtonBunchIntensity.hh"
+#include "Offline/RecoDataProducts/inc/IntensityInfoCalo.hh"
+#include "Offline/RecoDataProducts/inc/IntensityInfoTrackerHits.hh"
+
+#include "cetlib_except/exception.h"
+
+#include <algorithm>
+#include <ostream>
+
+namespace mu2e {
+
+  IntensityLevels::IntensityLevels(const Config& config) :
+    _tag       (config.tag()),
+    _thresholds(config.thresholds())
+  {
+    const std::string source = config.source();
+    if      (source == "ProtonBunchIntensity")     _source = protonBunchIntensity;
+    else if (source == "IntensityInfoTrackerHits") _source = trackerHits;
+    else if (source == "IntensityInfoCalo")        _source = caloHits;
+    else throw cet::exception("CONFIG") << "IntensityLevels: unknown intensity source " << source << "\n";
+    if (_thresholds.empty() || !std::is_sorted(_thresholds.begin(), _thresholds.end()) ||
+        std::adjacent_find(_thresholds.begin(), _thresholds.end()) != _thresholds.end())
+      throw cet::exception("CONFIG") << "IntensityLevels: thresholds must be given in increasing order\n";
+  }
+
+  void IntensityLevels::declareConsumes(art::ConsumesCollector& cc) const {
+    if (!used()) return;
+    switch (_source) {
+    case protonBunchIntensity : cc.consumes<ProtonBunchIntensity>(_tag);     break;
+    case trackerHits          : cc.consumes<IntensityInfoTrackerHits>(_tag); break;
+    case caloHits             : cc.consumes<IntensityInfoCalo>(_tag);        break;
+    }
+  }
+
+  double IntensityLevels::intensity(const art::Event& event) const {
+    switch (_source) {
+    case protonBunchIntensity : return event.getValidHandle<ProtonBunchIntensity>(_tag)->intensity();
+    case trackerHits          : return event.getValidHandle<IntensityInfoTrackerHits>(_tag)->nTrackerHits();
+    case caloHits             : return event.getValidHandle<IntensityInfoCalo>(_tag)->nCaloHits();
+    }
+    return 0;
+  }
+
+  bool IntensityLevels::findIntensity(const art::Event& event, double& intensity) const {
+    switch (_source) {
+    case protonBunchIntensity : {
+      auto handle = event.getHandle<ProtonBunchIntensity>(_tag);
+      if (handle) intensity = handle->intensity();
+      return bool(handle);
+    }
+    case trackerHits          : {
+      auto handle = event.getHandle<IntensityInfoTrackerHits>(_tag);
+      if (handle) intensity = handle->nTrackerHits();
+      return bool(handle);
+    }
+    case caloHits             : {
+      auto handle = event.getHandle<IntensityInfoCalo>(_tag);
+      if (handle) intensity = handle->nCaloHits();
+      return bool(handle);
+    }
+    }
+    return false;
+  }
+
+  unsigned IntensityLevels::level(double intensity) const {
+    return std::upper_bound(_thresholds.begin(), _thresholds.end(), intensity) - _thresholds.begin();
+  }
+
+  void IntensityLevels::checkCuts(size_t ncuts, const std::string& module) const {
+    if (ncuts+1 != nLevels())
+      throw cet::exception("CONFIG") << module << ": " << ncuts << " sets of intensity cuts for "
+                                     << nLevels()-1 << " intensity levels above the nominal one\n";
+  }
+
+  void IntensityLevels::printCounts(std::ostream& os, const std::string& module,
+                                    const std::vector<unsigned>& nevt, const std::vector<unsigned>& npass) const {
+    for (unsigned ilev=0; ilev<nevt.size() && ilev<npass.size(); ++ilev) {
+      if (nevt[ilev] == 0) continue;
+      os << module << " intensity level " << ilev;
+      if (ilev > 0)                  os << " (>= " << _thresholds[ilev-1] << ")";
+      else if (!_thresholds.empty()) os << " (< " << _thresholds[0] << ")";
+      os << " passed " << npass[ilev] << " events out of " << nevt[ilev] << " for a ratio of "
+         << float(npass[ilev])/float(nevt[ilev]) << std::endl;
+    }
+  }
+
+}
@@ -0,0 +1,180 @@
+//
+//  Latency budget report: run in an end path of a trigger job together with the
+//  TriggerCostMonitor service.  The latency of an event is the sum of the times of the
+//  modules run on it before this one; events over the budget are counted by microbunch
+//  intensity level (see IntensityLevels), and at the end of the job the report prints, for
+//  every level, the latency percentiles and the budget violations, then the slowest events
+//  and the modules which took the most time in the events over the budget.  The events
+//  without the intensity product, as from a source which does not make it, are reported
+//  in an "unknown" row.
+//
+//  services.TriggerCostMonitor : {}
+//  physics.analyzers.latencyBudget : { @table::Trigger.analyzers.LatencyBudgetReport }
+//  physics.e1 : [ latencyBudget ]
+//
+// framework
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalTable.h"
+#include "fhiclcpp/types/Sequence.h"
+// mu2e
+#include "Offline/Trigger/inc/IntensityLevels.hh"
+#include "Offline/Trigger/inc/TriggerCostMonitor.hh"
+// c++
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace mu2e
+{
+  class LatencyBudgetReport : public art::EDAnalyzer
+  {
+  public:
+    struct Config {
+      using Name    = fhicl::Name;
+      using Comment = fhicl::Comment;
+      fhicl::Atom<double>                           budget          { Name("budget"),          Comment("latency budget of an event [ms]") };
+      fhicl::OptionalTable<IntensityLevels::Config> intensityLevels { Name("intensityLevels"), Comment("microbunch intensity levels of the report") };
+      fhicl::Sequence<double>                       percentiles     { Name("percentiles"),     Comment("latency percentiles to print"), std::vector<double>{50.,90.,99.} };
+      fhicl::Atom<unsigned>                         nSlowest        { Name("nSlowest"),        Comment("number of slowest events to print"), 10 };
+      fhicl::Atom<unsigned>                         nModules        { Name("nModules"),        Comment("number of modules to print for the events over the budget"), 5 };
+    };
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit LatencyBudgetReport(const Parameters& config);
+    void analyze(const art::Event& event) override;
+    void endJob() override;
+
+  private:
+    struct SlowEvent {
+      art::EventID event;
+      double       latency;
+      unsigned     level;      // unknownLevel() if the event has no intensity
+      std::string  module;     // slowest module of the event
+      double       moduleTime;
+    };
+
+    double                  _budget;
+    IntensityLevels         _levels;
+    std::vector<double>     _percentiles;
+    unsigned                _nSlowest;
+    unsigned                _nModules;
+
+    std::vector<std::vector<float>> _latency;    // by level, then unknown
+    std::vector<unsigned>           _nOver;      // by level, then unknown
+    std::vector<SlowEvent>          _slowest;    // sorted by decreasing latency
+    std::map<std::string,double>    _overTime;   // module times summed over the events over the budget
+
+    unsigned    unknownLevel() const { return _levels.nLevels(); }
+    std::string levelName(unsigned level) const { return level == unknownLevel() ? "unknown" : std::to_string(level); }
+  };
+
+  LatencyBudgetReport::LatencyBudgetReport(const Parameters& config) :
+    art::EDAnalyzer{config},
+    _budget     (config().budget()),
+    _percentiles(config().percentiles()),
+    _nSlowest   (config().nSlowest()),
+    _nModules   (config().nModules())
+  {
+    IntensityLevels::Config levels;
+    if (config().intensityLevels(levels)) _levels = IntensityLevels(levels);
+    _levels.declareConsumes(consumesCollector());
+    _latency.resize(_levels.nLevels()+1);
+    _nOver.assign(_levels.nLevels()+1,0);
+  }
+
+  void LatencyBudgetReport::analyze(const art::Event& event) {
+    art::ServiceHandle<TriggerCostMonitor> monitor;
+    const auto times = monitor->moduleTimes(event.id());
+    double latency(0);
+    for (const auto& [label,time] : times) latency += time;
+
+    unsigned level(0);
+    double intensity(0);
+    if (_levels.used()) level = _levels.findIntensity(event,intensity) ? _levels.level(intensity) : unknownLevel();
+    _latency[level].push_back(latency);
+    if (latency > _budget) {
+      ++_nOver[level];
+      for (const auto& [label,time] : times) _overTime[label] += time;
+    }
+
+    if (_nSlowest == 0) return;
+    if (_slowest.size() == _nSlowest && latency <= _slowest.back().latency) return;
+    SlowEvent slow{event.id(), latency, level, "", 0};
+    for (const auto& [label,time] : times) {
+      if (time > slow.moduleTime) { slow.module = label; slow.moduleTime = time; }
+    }
+    auto it = std::upper_bound(_slowest.begin(), _slowest.end(), slow,
+                               [](const SlowEvent& a, const SlowEvent& b){ return a.latency > b.latency; });
+    _slowest.insert(it, slow);
+    if (_slowest.size() > _nSlowest) _slowest.pop_back();
+  }
+
+  void LatencyBudgetReport::endJob() {
+    // nearest rank percentile
+    auto percentile = [](const std::vector<float>& sorted, double p) {
+      if (sorted.empty()) return 0.0;
+      size_t rank = std::ceil(p/100.0*sorted.size());
+      return double(sorted[std::min(sorted.size(), std::max<size_t>(rank,1)) - 1]);
+    };
+
+    std::ostream& os = std::cout;
+    const std::string label = moduleDescription().moduleLabel();
+    os << label << ": latency per event [ms], budget " << _budget << " ms" << std::endl;
+    os << std::setw(8) << "level" << std::setw(10) << "events" << std::setw(10) << "mean";
+    for (double p : _percentiles) {
+      std::ostringstream name;
+      name << "p" << p;
+      os << std::setw(10) << name.str();
+    }
+    os << std::setw(10) << "max" << std::setw(12) << "over budget" << std::setw(10) << "fraction" << std::endl;
+
+    std::vector<float> all;
+    unsigned nOver(0);
+    auto printLine = [&](const std::string& name, std::vector<float>& lat, unsigned nover) {
+      std::sort(lat.begin(), lat.end());
+      os << std::setw(8) << name << std::setw(10) << lat.size();
+      if (lat.empty()) {
+        os << std::endl;
+        return;
+      }
+      os << std::fixed << std::setprecision(2) << std::setw(10) << std::accumulate(lat.begin(), lat.end(), 0.0)/lat.size();
+      for (double p : _percentiles) os << std::setw(10) << percentile(lat, p);
+      os << std::setw(10) << lat.back() << std::setw(12) << nover << std::setw(10) << std::setprecision(4)
+         << double(nover)/lat.size() << std::defaultfloat << std::endl;
+    };
+    for (unsigned ilev=0; ilev<_latency.size(); ++ilev) {
+      if (ilev == unknownLevel() && _latency[ilev].empty()) continue;
+      all.insert(all.end(), _latency[ilev].begin(), _latency[ilev].end());
+      nOver += _nOver[ilev];
+      printLine(levelName(ilev), _latency[ilev], _nOver[ilev]);
+    }
+    if (_levels.used()) printLine("all", all, nOver);
+
+    if (!_slowest.empty()) {
+      os << label << ": slowest events" << std::endl;
+      for (const auto& slow : _slowest) {
+        os << "  " << slow.event << " level " << levelName(slow.level) << " " << slow.latency << " ms, slowest module "
+           << slow.module << " " << slow.moduleTime << " ms" << std::endl;
+      }
+    }
+
+    if (nOver > 0 && _nModules > 0) {
+      std::vector<std::pair<std::string,double>> modules(_overTime.begin(), _overTime.end());
+      std::sort(modules.begin(), modules.end(), [](const auto& a, const auto& b){ return a.second > b.second; });
+      if (modules.size() > _nModules) modules.resize(_nModules);
+      os << label << ": mean module time [ms] in the " << nOver << " events over the budget" << std::endl;
+      for (const auto& [module,time] : modules) os << "  " << std::setw(30) << std::left << module << std::right << time/nOver << std::endl;
+    }
+  }
+}
+using mu2e::LatencyBudgetReport;
+DEFINE_ART_MODULE(LatencyBudgetReport);
@@ -0,0 +1,55 @@
+//
+// Measure the time of every module in every event for the trigger path cost model
+//
+
+#include "Offline/Trigger/inc/TriggerCostMonitor.hh"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ActivityRegistry.h"
+#include "art/Framework/Services/Registry/ServiceDefinitionMacros.h"
+#include "art/Persistency/Provenance/ModuleContext.h"
+#include "art/Persistency/Provenance/ScheduleContext.h"
+
+namespace mu2e {
+
+  TriggerCostMonitor::TriggerCostMonitor(const fhicl::ParameterSet&, art::ActivityRegistry& iRegistry) {
+    iRegistry.sPreProcessEvent.watch(this, &TriggerCostMonitor::preEvent  );
+    iRegistry.sPreModule.watch      (this, &TriggerCostMonitor::preModule );
+    iRegistry.sPostModule.watch     (this, &TriggerCostMonitor::postModule);
+  }
+
+  std::map<std::string,double> TriggerCostMonitor::moduleTimes(const art::EventID& id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [sid,data] : schedules_) {
+      if (data.event == id) return data.times;
+    }
+    return std::map<std::string,double>();
+  }
+
+  void TriggerCostMonitor::preEvent(art::Event const& event, art::ScheduleContext sc) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScheduleData& data = schedules_[sc.id().id()];
+    data.event = event.id();
+    data.start.clear();
+    data.times.clear();
+  }
+
+  void TriggerCostMonitor::preModule(art::ModuleContext const& mc) {
+    const auto now = clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    schedules_[mc.scheduleID().id()].start[mc.moduleLabel()] = now;
+  }
+
+  void TriggerCostMonitor::postModule(art::ModuleContext const& mc) {
+    const auto now = clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    ScheduleData& data = schedules_[mc.scheduleID().id()];
+    auto it = data.start.find(mc.moduleLabel());
+    if (it == data.start.end()) return;
+    data.times[mc.moduleLabel()] += std::chrono::duration<double,std::milli>(now - it->second).count();
+    data.start.erase(it);
+  }
+
+}
+
+DEFINE_ART_SERVICE(mu2e::TriggerCostMonitor);
@@ -0,0 +1,146 @@
+//
+//  Trigger path cost report: run in an end path of a trigger job together with the
+//  TriggerCostMonitor service.  For every event it reads the module times and the trigger
+//  results of the paths and fills a TriggerPathCostModel; at the end of the job it prints the
+//  per-path latency percentiles, the stages with their cost and acceptance, a cheaper stage
+//  order when there is one, and the cuts of a TriggerPreFilter for each path.  The pre-filter
+//  cuts can also be written to a fcl file to be included in the trigger menu.
+//
+//  services.TriggerCostMonitor : {}
+//  physics.analyzers.triggerCost : { @table::Trigger.analyzers.TriggerCostReport }
+//  physics.e1 : [ triggerCost ]
+//
+// framework
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "canvas/Persistency/Common/TriggerResults.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
+#include "fhiclcpp/types/Sequence.h"
+// mu2e
+#include "Offline/Mu2eUtilities/inc/TriggerResultsNavigator.hh"
+#include "Offline/Trigger/inc/TriggerCostMonitor.hh"
+#include "Offline/Trigger/inc/TriggerPathCostModel.hh"
+// data
+#include "Offline/MCDataProducts/inc/ProtonBunchIntensity.hh"
+#include "Offline/RecoDataProducts/inc/CaloDigi.hh"
+#include "Offline/RecoDataProducts/inc/CaloHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+// c++
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace mu2e
+{
+  class TriggerCostReport : public art::EDAnalyzer
+  {
+  public:
+    struct Config {
+      using Name    = fhicl::Name;
+      using Comment = fhicl::Comment;
+      fhicl::Atom<std::string>           processName     { Name("processName"),           Comment("process of the trigger paths, empty for the current one"), "" };
+      fhicl::OptionalAtom<art::InputTag> sdTag           { Name("strawDigiCollection"),   Comment("StrawDigi collection") };
+      fhicl::OptionalAtom<art::InputTag> cdTag           { Name("caloDigiCollection"),    Comment("CaloDigi collection") };
+      fhicl::OptionalAtom<art::InputTag> chTag           { Name("caloHitCollection"),     Comment("CaloHit collection, for the energy sum") };
+      fhicl::OptionalAtom<art::InputTag> pbiTag          { Name("protonBunchIntensity"),  Comment("ProtonBunchIntensity") };
+      fhicl::Sequence<double>            percentiles     { Name("percentiles"),           Comment("latency percentiles to print"), std::vector<double>{50.,90.,99.} };
+      fhicl::Atom<double>                efficiency      { Name("preFilterEfficiency"),   Comment("fraction of the accepted events kept by the pre-filter cuts"), 0.999 };
+      fhicl::Atom<double>                minRejection    { Name("minPreFilterRejection"), Comment("minimum rejection to suggest a pre-filter"), 0.05 };
+      fhicl::Atom<std::string>           preFilterFile   { Name("preFilterFile"),         Comment("fcl file for the suggested pre-filters, none if empty"), "" };
+    };
+    using Parameters = art::EDAnalyzer::Table<Config>;
+
+    explicit TriggerCostReport(const Parameters& config);
+    void beginJob() override;
+    void analyze(const art::Event& event) override;
+    void endJob() override;
+
+  private:
+    TriggerPathCostModel::Observables observables(const art::Event& event) const;
+
+    std::string                _processName;
+    art::InputTag              _sdTag, _cdTag, _chTag, _pbiTag;
+    bool                       _useSD, _useCD, _useCH, _usePBI;
+    std::vector<double>        _percentiles;
+    double                     _efficiency;
+    double                     _minRejection;
+    std::string                _preFilterFile;
+
+    // modules of the paths, looked up once as the registry search is slow
+    std::map<std::string,std::vector<std::string>> _pathModules;
+    TriggerPathCostModel       _model;
+  };
+
+  TriggerCostReport::TriggerCostReport(const Parameters& config) :
+    art::EDAnalyzer{config},
+    _processName  (config().processName()),
+    _useSD        (config().sdTag (_sdTag)),
+    _useCD        (config().cdTag (_cdTag)),
+    _useCH        (config().chTag (_chTag)),
+    _usePBI       (config().pbiTag(_pbiTag)),
+    _percentiles  (config().percentiles()),
+    _efficiency   (config().efficiency()),
+    _minRejection (config().minRejection()),
+    _preFilterFile(config().preFilterFile())
+  {
+    if (_useSD)  consumes<StrawDigiCollection>(_sdTag);
+    if (_useCD)  consumes<CaloDigiCollection>(_cdTag);
+    if (_useCH)  consumes<CaloHitCollection>(_chTag);
+    if (_usePBI) consumes<ProtonBunchIntensity>(_pbiTag);
+  }
+
+  void TriggerCostReport::beginJob() {
+    // the module description is only available once the job has started
+    if (_processName.empty()) _processName = moduleDescription().processName();
+  }
+
+  TriggerPathCostModel::Observables TriggerCostReport::observables(const art::Event& event) const {
+    TriggerPathCostModel::Observables obs;
+    obs.fill(std::numeric_limits<double>::quiet_NaN());
+    if (_useSD)  obs[TriggerPathCostModel::nStrawDigis] = event.getValidHandle<StrawDigiCollection>(_sdTag)->size();
+    if (_useCD)  obs[TriggerPathCostModel::nCaloDigis]  = event.getValidHandle<CaloDigiCollection>(_cdTag)->size();
+    if (_useCH) {
+      float energy(0);
+      for (const auto& hit : *event.getValidHandle<CaloHitCollection>(_chTag)) energy += hit.energyDep();
+      obs[TriggerPathCostModel::caloEnergy] = energy;
+    }
+    if (_usePBI) obs[TriggerPathCostModel::protonBunchIntensity] = event.getValidHandle<ProtonBunchIntensity>(_pbiTag)->intensity();
+    return obs;
+  }
+
+  void TriggerCostReport::analyze(const art::Event& event) {
+    art::InputTag const tag{"TriggerResults::" + _processName};
+    auto const trigResultsH = event.getValidHandle<art::TriggerResults>(tag);
+    TriggerResultsNavigator trigNavig(trigResultsH.product());
+
+    art::ServiceHandle<TriggerCostMonitor> monitor;
+    const auto times = monitor->moduleTimes(event.id());
+
+    for (unsigned i=0; i<trigNavig.getTrigPaths().size(); ++i) {
+      const std::string path = trigNavig.getTrigPathName(i);
+      if (!trigNavig.wasrun(path)) continue;
+      auto it = _pathModules.find(path);
+      if (it == _pathModules.end()) it = _pathModules.emplace(path, trigNavig.triggerModules(path)).first;
+      _model.fill(path, it->second, times, trigNavig.indexLastModule(path), trigNavig.accepted(path));
+    }
+    _model.fillEvent(times, observables(event));
+  }
+
+  void TriggerCostReport::endJob() {
+    _model.print(std::cout, _percentiles, _efficiency);
+    if (!_preFilterFile.empty()) {
+      std::ofstream out(_preFilterFile);
+      if (!out) throw cet::exception("TriggerCostReport") << "cannot open " << _preFilterFile << "\n";
+      _model.writePreFilters(out, _efficiency, _minRejection, _pbiTag.encode());
+    }
+  }
+}
+using mu2e::TriggerCostReport;
+DEFINE_ART_MODULE(TriggerCostReport);
@@ -0,0 +1,266 @@
+//
+// Cost model of the trigger paths, see the header
+//
+#include "Offline/Trigger/inc/TriggerPathCostModel.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+namespace mu2e {
+
+  namespace {
+    // nearest-rank quantile of a sorted sample
+    template <class T>
+    double quantile(const std::vector<T>& sorted, double q) {
+      if (sorted.empty()) return 0;
+      q = std::min(std::max(q,0.),1.);
+      return sorted[std::lround(q*(sorted.size()-1))];
+    }
+
+    bool isCount(TriggerPathCostModel::Observable obs) {
+      return obs == TriggerPathCostModel::nStrawDigis || obs == TriggerPathCostModel::nCaloDigis;
+    }
+  }
+
+  const char* TriggerPathCostModel::observableName(Observable obs) {
+    static const char* names[nObservables] = {"nStrawDigis","nCaloDigis","caloEnergy","protonBunchIntensity"};
+    return names[obs];
+  }
+  const char* TriggerPathCostModel::minParameter(Observable obs) {
+    static const char* names[nObservables] = {"minNStrawDigi","minNCaloDigi","minCaloEnergy","minIntensity"};
+    return names[obs];
+  }
+  const char* TriggerPathCostModel::maxParameter(Observable obs) {
+    static const char* names[nObservables] = {"maxNStrawDigi","maxNCaloDigi","maxCaloEnergy","maxIntensity"};
+    return names[obs];
+  }
+
+  //================================================================
+  void TriggerPathCostModel::fill(const std::string& path, const std::vector<std::string>& modules,
+                                  const std::map<std::string,double>& times, unsigned lastModule, bool accept) {
+    PathStats& ps = paths_[path];
+    if (ps.modules.empty()) {
+      for (const auto& label : modules) {
+        ps.modules.emplace_back();
+        ps.modules.back().label = label;
+      }
+    }
+
+    double latency(0);
+    const unsigned nrun = std::min<unsigned>(lastModule+1, ps.modules.size());
+    for (unsigned i=0; i<nrun; ++i) {
+      ModuleStats& ms = ps.modules[i];
+      auto it = times.find(ms.label);
+      const double t = it != times.end() ? it->second : 0.;
+      ++ms.nRun;
+      ms.sumTime += t;
+      latency    += t;
+    }
+    ps.latency.push_back(latency);
+
+    if (accept) {
+      ++ps.nAccept;
+      ps.accepted.push_back(observables_.size());
+    } else if (lastModule < ps.modules.size()) {
+      ++ps.modules[lastModule].nStop;
+    }
+  }
+
+  void TriggerPathCostModel::fillEvent(const std::map<std::string,double>& times, const Observables& obs) {
+    double latency(0);
+    for (const auto& [label,t] : times) latency += t;
+    eventLatency_.push_back(latency);
+    observables_.push_back(obs);
+  }
+
+  std::vector<std::string> TriggerPathCostModel::paths() const {
+    std::vector<std::string> res;
+    for (const auto& [name,ps] : paths_) res.push_back(name);
+    return res;
+  }
+
+  //================================================================
+  std::vector<TriggerPathCostModel::Stage> TriggerPathCostModel::stages(const std::string& path) const {
+    std::vector<Stage> res;
+    auto ip = paths_.find(path);
+    if (ip == paths_.end()) return res;
+    const PathStats& ps = ip->second;
+
+    Stage stage;
+    for (unsigned i=0; i<ps.modules.size(); ++i) {
+      const ModuleStats& ms = ps.modules[i];
+      if (stage.modules.empty()) stage.nIn = ms.nRun;
+      stage.modules.push_back(ms.label);
+      if (ms.nRun > 0) stage.cost += ms.sumTime/ms.nRun;
+
+      const bool last = i+1 == ps.modules.size();
+      if (ms.nStop > 0 || last) {
+        const unsigned nOut = last ? ps.nAccept : ps.modules[i+1].nRun;
+        stage.acceptance = stage.nIn > 0 ? double(nOut)/stage.nIn : 1.;
+        res.push_back(stage);
+        stage = Stage();
+      }
+    }
+    return res;
+  }
+
+  std::vector<unsigned> TriggerPathCostModel::recommendedOrder(const std::vector<Stage>& stages) {
+    auto rank = [](const Stage& s) {
+      return s.acceptance < 1. ? s.cost/(1.-s.acceptance) : std::numeric_limits<double>::infinity();
+    };
+    std::vector<unsigned> order(stages.size());
+    for (unsigned i=0; i<order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](unsigned a, unsigned b) {return rank(stages[a]) < rank(stages[b]);});
+    return order;
+  }
+
+  double TriggerPathCostModel::expectedLatency(const std::vector<Stage>& stages, const std::vector<unsigned>& order) {
+    double latency(0), reach(1);
+    for (unsigned i : order) {
+      latency += reach*stages[i].cost;
+      reach   *= stages[i].acceptance;
+    }
+    return latency;
+  }
+
+  double TriggerPathCostModel::latencyQuantile(const std::string& path, double q) const {
+    std::vector<float> sorted;
+    if (path.empty()) {
+      sorted = eventLatency_;
+    } else {
+      auto ip = paths_.find(path);
+      if (ip == paths_.end()) return 0;
+      sorted = ip->second.latency;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    return quantile(sorted, q);
+  }
+
+  //================================================================
+  TriggerPathCostModel::PreFilter TriggerPathCostModel::preFilter(const std::string& path, double efficiency) const {
+    PreFilter res;
+    auto ip = paths_.find(path);
+    if (ip == paths_.end() || ip->second.accepted.empty()) return res;
+    const PathStats& ps = ip->second;
+
+    std::vector<Observable> measured;
+    for (int iobs=0; iobs<nObservables; ++iobs) {
+      bool all = !observables_.empty();
+      for (const auto& obs : observables_) all = all && !std::isnan(obs[iobs]);
+      if (all) measured.push_back(Observable(iobs));
+    }
+    if (measured.empty()) return res;
+
+    // the inefficiency is shared among the lower and upper cuts of all observables
+    const double tail = (1.-efficiency)/(2.*measured.size());
+    for (Observable iobs : measured) {
+      std::vector<double> values;
+      for (unsigned ievt : ps.accepted) values.push_back(observables_[ievt][iobs]);
+      std::sort(values.begin(), values.end());
+      Cut cut{iobs, quantile(values, tail), quantile(values, 1.-tail)};
+      if (isCount(iobs)) {
+        cut.min = std::floor(cut.min);
+        cut.max = std::ceil(cut.max);
+      }
+      res.cuts.push_back(cut);
+    }
+
+    auto pass = [&](const Observables& obs) {
+      for (const auto& cut : res.cuts) {
+        if (obs[cut.obs] < cut.min || obs[cut.obs] > cut.max) return false;
+      }
+      return true;
+    };
+    unsigned nAccPass(0), nFail(0);
+    for (unsigned ievt : ps.accepted) if (pass(observables_[ievt])) ++nAccPass;
+    for (const auto& obs : observables_) if (!pass(obs)) ++nFail;
+    res.efficiency = double(nAccPass)/ps.accepted.size();
+    res.rejection  = double(nFail)/observables_.size();
+    return res;
+  }
+
+  //================================================================
+  void TriggerPathCostModel::print(std::ostream& os, const std::vector<double>& percentiles, double efficiency) const {
+    auto printPercentiles = [&](const std::string& path) {
+      for (double p : percentiles) {
+        os << "  p" << std::defaultfloat << p << std::fixed << " " << std::setprecision(3) << latencyQuantile(path, p/100.) << " ms";
+      }
+      os << "\n";
+    };
+
+    os << "TriggerPathCostModel: " << nEvents() << " events\n"
+       << std::fixed << "event latency:";
+    printPercentiles("");
+
+    for (const auto& [name,ps] : paths_) {
+      os << "\npath " << name << ": accepted " << ps.nAccept << " / " << ps.latency.size()
+         << "\n  latency:";
+      printPercentiles(name);
+
+      const auto st = stages(name);
+      os << "  " << std::setw(6) << "stage" << std::setw(12) << "cost [ms]" << std::setw(12) << "acceptance"
+         << std::setw(10) << "events" << "  modules\n";
+      for (unsigned i=0; i<st.size(); ++i) {
+        os << "  " << std::setw(6) << i << std::setw(12) << std::setprecision(3) << st[i].cost
+           << std::setw(12) << std::setprecision(4) << st[i].acceptance << std::setw(10) << st[i].nIn << " ";
+        for (const auto& label : st[i].modules) os << " " << label;
+        os << "\n";
+      }
+
+      std::vector<unsigned> current(st.size());
+      for (unsigned i=0; i<current.size(); ++i) current[i] = i;
+      const auto order = recommendedOrder(st);
+      os << "  expected latency " << std::setprecision(3) << expectedLatency(st, current) << " ms";
+      if (order != current) {
+        os << ", " << expectedLatency(st, order) << " ms with the stage order (if independent):";
+        for (unsigned i : order) os << " " << i;
+      }
+      os << "\n";
+
+      const auto pf = preFilter(name, efficiency);
+      if (!pf.cuts.empty()) {
+        os << "  pre-filter:";
+        for (const auto& cut : pf.cuts) {
+          os << " " << std::setprecision(isCount(cut.obs) ? 0 : 3) << cut.min << " <= "
+             << observableName(cut.obs) << " <= " << cut.max << ",";
+        }
+        os << std::setprecision(4) << " efficiency " << pf.efficiency << ", rejection " << pf.rejection << "\n";
+      }
+    }
+    os << std::defaultfloat;
+  }
+
+  void TriggerPathCostModel::writePreFilters(std::ostream& os, double efficiency, double minRejection, const std::string& pbiTag) const {
+    // write the cuts exactly as TriggerPreFilter will read them: caloEnergy is a float, the intensity a double
+    auto cutValue = [&os](Observable obs, double value) {
+      if (isCount(obs))                    os << (long long)value;
+      else if (obs == caloEnergy)          os << std::setprecision(std::numeric_limits<float>::max_digits10) << float(value);
+      else                                 os << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    };
+    const auto precision = os.precision();
+    os << "# Pre-filters suggested by TriggerPathCostModel from " << nEvents() << " events\n";
+    for (const auto& name : paths()) {
+      const auto pf = preFilter(name, efficiency);
+      if (pf.cuts.empty() || pf.rejection < minRejection) continue;
+      os << "# " << name << ": efficiency " << pf.efficiency << ", rejection " << pf.rejection << "\n"
+         << name << "PreFilter : {\n"
+         << "    @table::Trigger.filters.triggerPreFilter\n";
+      for (const auto& cut : pf.cuts) {
+        // the prolog table has no ProtonBunchIntensity tag
+        if (cut.obs == protonBunchIntensity) os << "    protonBunchIntensity : \"" << pbiTag << "\"\n";
+        os << "    " << minParameter(cut.obs) << " : ";
+        cutValue(cut.obs, cut.min);
+        os << "\n    " << maxParameter(cut.obs) << " : ";
+        cutValue(cut.obs, cut.max);
+        os << "\n";
+        os.precision(precision);
+      }
+      os << "}\n";
+    }
+  }
+
+}
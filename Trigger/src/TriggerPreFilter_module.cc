@@ -0,0 +1,143 @@
+//
+//  Cheap pre-filter placed at the head of a trigger path: it rejects the events whose digi
+//  counts, calorimeter energy sum or proton bunch intensity are outside the ranges seen in
+//  the events accepted by the path, before any reconstruction is run.  The cuts are derived
+//  from a sample by TriggerCostReport (see TriggerPathCostModel); unset cuts are not applied.
+//
+// framework
+#include "art/Framework/Core/EDFilter.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Principal/Run.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
+// data
+#include "Offline/MCDataProducts/inc/ProtonBunchIntensity.hh"
+#include "Offline/RecoDataProducts/inc/CaloDigi.hh"
+#include "Offline/RecoDataProducts/inc/CaloHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+// c++
+#include <iostream>
+#include <string>
+
+namespace mu2e
+{
+  class TriggerPreFilter : public art::EDFilter
+  {
+  public:
+    struct Config {
+      using Name    = fhicl::Name;
+      using Comment = fhicl::Comment;
+      fhicl::OptionalAtom<art::InputTag> sdTag      { Name("strawDigiCollection"),  Comment("StrawDigi collection") };
+      fhicl::OptionalAtom<art::InputTag> cdTag      { Name("caloDigiCollection"),   Comment("CaloDigi collection") };
+      fhicl::OptionalAtom<art::InputTag> chTag      { Name("caloHitCollection"),    Comment("CaloHit collection, for the energy sum") };
+      fhicl::OptionalAtom<art::InputTag> pbiTag     { Name("protonBunchIntensity"), Comment("ProtonBunchIntensity") };
+      fhicl::OptionalAtom<int>           minnsd     { Name("minNStrawDigi"),        Comment("minimum number of StrawDigi") };
+      fhicl::OptionalAtom<int>           maxnsd     { Name("maxNStrawDigi"),        Comment("maximum number of StrawDigi") };
+      fhicl::OptionalAtom<int>           minncd     { Name("minNCaloDigi"),         Comment("minimum number of CaloDigi") };
+      fhicl::OptionalAtom<int>           maxncd     { Name("maxNCaloDigi"),         Comment("maximum number of CaloDigi") };
+      fhicl::OptionalAtom<float>         mincaloE   { Name("minCaloEnergy"),        Comment("minimum sum of the CaloHit energies [MeV]") };
+      fhicl::OptionalAtom<float>         maxcaloE   { Name("maxCaloEnergy"),        Comment("maximum sum of the CaloHit energies [MeV]") };
+      fhicl::OptionalAtom<double>        minpbi     { Name("minIntensity"),         Comment("minimum proton bunch intensity") };
+      fhicl::OptionalAtom<double>        maxpbi     { Name("maxIntensity"),         Comment("maximum proton bunch intensity") };
+      fhicl::Atom<int>                   debug      { Name("debugLevel"),           Comment("debug level"), 0 };
+    };
+    using Parameters = art::EDFilter::Table<Config>;
+
+    explicit TriggerPreFilter(const Parameters& config);
+    virtual bool filter(art::Event& event) override;
+    virtual bool endRun( art::Run& run ) override;
+
+  private:
+    // a cut on one observable; useMin/useMax are false for the unset bounds
+    template <class T>
+    struct Range {
+      bool useMin = false, useMax = false;
+      T    min = 0, max = 0;
+      bool used() const { return useMin || useMax; }
+      bool pass(T val) const { return (!useMin || val >= min) && (!useMax || val <= max); }
+    };
+    template <class T>
+    static Range<T> range(const fhicl::OptionalAtom<T>& min, const fhicl::OptionalAtom<T>& max);
+    void checkTag(bool used, bool hasTag, const char* tag) const;
+
+    art::InputTag   _sdTag, _cdTag, _chTag, _pbiTag;
+    Range<int>      _nsd, _ncd;
+    Range<float>    _caloE;
+    Range<double>   _pbi;
+    int             _debug;
+    // counters
+    unsigned _nevt, _npass;
+  };
+
+  template <class T>
+  TriggerPreFilter::Range<T> TriggerPreFilter::range(const fhicl::OptionalAtom<T>& min, const fhicl::OptionalAtom<T>& max) {
+    Range<T> res;
+    res.useMin = min(res.min);
+    res.useMax = max(res.max);
+    return res;
+  }
+
+  void TriggerPreFilter::checkTag(bool used, bool hasTag, const char* tag) const {
+    if (used && !hasTag) {
+      throw cet::exception("CONFIG") << "TriggerPreFilter: a cut requires " << tag << " to be set\n";
+    }
+  }
+
+  TriggerPreFilter::TriggerPreFilter(const Parameters& config) :
+    art::EDFilter{config},
+    _nsd   (range(config().minnsd,   config().maxnsd)),
+    _ncd   (range(config().minncd,   config().maxncd)),
+    _caloE (range(config().mincaloE, config().maxcaloE)),
+    _pbi   (range(config().minpbi,   config().maxpbi)),
+    _debug (config().debug()),
+    _nevt(0), _npass(0)
+  {
+    checkTag(_nsd.used(),   config().sdTag (_sdTag),  "strawDigiCollection");
+    checkTag(_ncd.used(),   config().cdTag (_cdTag),  "caloDigiCollection");
+    checkTag(_caloE.used(), config().chTag (_chTag),  "caloHitCollection");
+    checkTag(_pbi.used(),   config().pbiTag(_pbiTag), "protonBunchIntensity");
+    if (_nsd.used())   consumes<StrawDigiCollection>(_sdTag);
+    if (_ncd.used())   consumes<CaloDigiCollection>(_cdTag);
+    if (_caloE.used()) consumes<CaloHitCollection>(_chTag);
+    if (_pbi.used())   consumes<ProtonBunchIntensity>(_pbiTag);
+  }
+
+  bool TriggerPreFilter::filter(art::Event& event){
+    ++_nevt;
+    // cheapest first: each collection is only read if the previous cuts passed
+    bool retval(true);
+    if (retval && _pbi.used()){
+      retval = _pbi.pass(event.getValidHandle<ProtonBunchIntensity>(_pbiTag)->intensity());
+    }
+    if (retval && _nsd.used()){
+      retval = _nsd.pass(event.getValidHandle<StrawDigiCollection>(_sdTag)->size());
+    }
+    if (retval && _ncd.used()){
+      retval = _ncd.pass(event.getValidHandle<CaloDigiCollection>(_cdTag)->size());
+    }
+    if (retval && _caloE.used()){
+      float energy(0);
+      for (const auto& hit : *event.getValidHandle<CaloHitCollection>(_chTag)) energy += hit.energyDep();
+      retval = _caloE.pass(energy);
+    }
+
+    if (retval){
+      ++_npass;
+      if(_debug > 1){
+        std::cout << moduleDescription().moduleLabel() << " passed event " << event.id() << std::endl;
+      }
+    }
+    return retval;
+  }
+
+  bool TriggerPreFilter::endRun( art::Run& run ) {
+    if(_debug > 0 && _nevt > 0){
+      std::cout << moduleDescription().moduleLabel() << " passed " << _npass << " events out of " << _nevt << " for a ratio of " << float(_npass)/float(_nevt) << std::endl;
+    }
+    return true;
+  }
+}
+using mu2e::TriggerPreFilter;
+DEFINE_ART_MODULE(TriggerPreFilter);
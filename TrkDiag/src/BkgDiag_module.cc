@@ -20,6 +20,7 @@
 // data
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/BkgCluster.hh"
 #include "Offline/RecoDataProducts/inc/BkgClusterHit.hh"
@@ -33,6 +34,7 @@
 #include "canvas/Utilities/InputTag.h"
 #include "fhiclcpp/types/Atom.h"
 #include "fhiclcpp/types/Sequence.h"
+#include <memory>
 using std::string;
 using namespace ROOT::Math::VectorUtil;
 namespace mu2e
@@ -83,6 +85,7 @@ namespace mu2e
       // time offset
       // cache of event objects
       const ComboHitCollection* _chcol;
+      std::unique_ptr<ComboHitStrawIndexCache> _shindex; // StrawDigis of the ComboHits of the current event
       const StrawHitFlagCollection* _shfcol;
       const StrawDigiMCCollection *_mcdigis;
       const BkgClusterCollection *_bkgccol;
@@ -132,7 +135,9 @@ namespace mu2e
     _bkgqToken{ consumes<BkgQualCollection>(config().BkgQualCollection() ) },
     _bkghToken{ consumes<BkgClusterHitCollection>(config().BkgClusterHitCollection() ) },
     _mcdigisToken{ consumes<StrawDigiMCCollection>(config().StrawDigiMCCollection() ) }
-  {}
+  {
+    consumesMany<ComboHitStrawIndex>(); // used by _shindex when the event has them
+  }
 
   BkgDiag::~BkgDiag(){}
 
@@ -203,6 +208,7 @@ namespace mu2e
   }
 
   void BkgDiag::analyze(const art::Event& event ) {
+    _shindex = std::make_unique<ComboHitStrawIndexCache>(event);
     if(!findData(event))
       throw cet::exception("RECO")<<"mu2e::BkgDiag: data missing or incomplete"<< std::endl;
     // check consistency
@@ -219,7 +225,7 @@ namespace mu2e
       _hitNcombo[_nhits] = _chcol->at(ich).nCombo();
       if(_mcdiag){
         std::vector<StrawDigiIndex> dids;
-        _chcol->fillStrawDigiIndices(event,ich,dids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,dids);
         StrawDigiMC const& mcdigi = _mcdigis->at(dids[0]);// taking 1st digi: is there a better idea??
         art::Ptr<SimParticle> const& spp = mcdigi.earlyStrawGasStep()->simParticle();
         _hitPdg[_nhits] = spp->pdgId();
@@ -277,7 +283,7 @@ namespace mu2e
         std::vector<StrawDigiIndex> cdids;
         for(auto const& ich : cluster.hits()){
           // get the list of StrawHit indices associated with this ComboHit
-          _chcol->fillStrawDigiIndices(event,ich,cdids);
+          _shindex->fillStrawDigiIndices(*_chcol,ich,cdids);
         }
         double pmom(0.0);
         std::vector<int> icontrib;
@@ -319,7 +325,7 @@ namespace mu2e
         fillStrawHitInfo(ich,bkghinfo);
         if(_mcdiag){
           std::vector<StrawDigiIndex> dids;
-          _chcol->fillStrawDigiIndices(event,ich,dids);
+          _shindex->fillStrawDigiIndices(*_chcol,ich,dids);
           StrawDigiMC const& mcdigi = _mcdigis->at(dids[0]);// taking 1st digi: is there a better idea??
           fillStrawHitInfoMC(mcdigi,pptr,bkghinfo);
         }
@@ -27,6 +27,7 @@
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
 #include "Offline/MCDataProducts/inc/MCRelationship.hh"
@@ -35,6 +36,7 @@
 // diagnostics
 #include "Offline/TrkDiag/inc/ComboHitInfo.hh"
 #include <map>
+#include <memory>
 
 namespace mu2e
 {
@@ -72,6 +74,7 @@ namespace mu2e
       art::ProductToken<StrawDigiADCWaveformCollection> _digiadcsToken;
       // event data cache
       const ComboHitCollection* _chcol;
+      std::unique_ptr<ComboHitStrawIndexCache> _shindex; // StrawDigis of the ComboHits of the current event
       const StrawHitFlagCollection* _shfcol;
       const StrawDigiMCCollection *_mcdigis;
       const StrawDigiCollection *_digis;
@@ -130,7 +133,9 @@ namespace mu2e
     _mcdigisToken{ consumes<StrawDigiMCCollection>(config().StrawDigiMCCollection() ) },
     _digisToken{ consumes<StrawDigiCollection>(config().StrawDigiCollection() ) },
     _digiadcsToken{ consumes<StrawDigiADCWaveformCollection>(config().StrawDigiCollection() ) }
-  {}
+  {
+    consumesMany<ComboHitStrawIndex>(); // used by _shindex when the event has them
+  }
 
   ComboHitDiag::~ComboHitDiag(){}
 
@@ -203,6 +208,7 @@ namespace mu2e
   }
 
   void ComboHitDiag::analyze(const art::Event& evt ) {
+    _shindex = std::make_unique<ComboHitStrawIndexCache>(evt);
     // find data in event
     findData(evt);
     _evt = evt.id().event();  // add event id
@@ -292,7 +298,7 @@ namespace mu2e
         _chinfomc.clear();
         // get the StrawDigi indices associated with this ComboHit
         std::vector<StrawDigiIndex> shids;
-        _chcol->fillStrawDigiIndices(evt,ich,shids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
         if(shids.size() != ch.nStrawHits())
           throw cet::exception("DIAG")<<"mu2e::ComboHitDiag: invalid ComboHit" << std::endl;
 // find the SimParticle responsable for most of the hits
@@ -348,7 +354,7 @@ namespace mu2e
       }
       if (_digis != 0){
         std::vector<StrawDigiIndex> shids;
-        _chcol->fillStrawDigiIndices(evt,ich,shids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
         // use the 1st hit to define the MC match; this is arbitrary should be an average FIXME!
         auto digi = _digis->at(shids[0]);
         for(size_t iend=0;iend<2;++iend){
@@ -364,7 +370,7 @@ namespace mu2e
       }
       if (_digiadcs != 0){
         std::vector<StrawDigiIndex> shids;
-        _chcol->fillStrawDigiIndices(evt,ich,shids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
         // use the 1st hit to define the MC match; this is arbitrary should be an average FIXME!
         auto digiadc = _digiadcs->at(shids[0]);
         _digiadc = digiadc.samples();
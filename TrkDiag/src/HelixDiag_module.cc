@@ -27,6 +27,7 @@
 #include "Offline/MCDataProducts/inc/MCRelationship.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
@@ -48,6 +49,7 @@
 #include <functional>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 using namespace std;
 using CLHEP::Hep3Vector;
 using namespace ROOT::Math::VectorUtil;
@@ -86,6 +88,7 @@ namespace mu2e {
       art::InputTag _primaryTag;
       // cache of event objects
       const ComboHitCollection* _chcol;
+      std::unique_ptr<ComboHitStrawIndexCache> _shindex; // StrawDigis of the ComboHits of the current event
       const HelixSeedCollection* _hscol;
       const StrawHitFlagCollection*   _shfcol;
       const StrawDigiMCCollection* _mcdigis;
@@ -158,6 +161,7 @@ namespace mu2e {
     _primaryTag(pset.get<art::InputTag>("PrimaryParticleTag","FindMCPrimary")),
     _toff(pset.get<fhicl::ParameterSet>("TimeOffsets"))
     {
+      consumesMany<ComboHitStrawIndex>(); // used by _shindex when the event has them
       if(_diag > 0){
         art::ServiceHandle<art::TFileService> tfs;
         _hdiag=tfs->make<TTree>("hdiag","Helix Finding diagnostics");
@@ -213,6 +217,7 @@ namespace mu2e {
   }
 
   void HelixDiag::analyze(art::Event const& evt) {
+    _shindex = std::make_unique<ComboHitStrawIndexCache>(evt);
     _iev=evt.id().event();
     // find the data
     if(findData(evt)) {
@@ -246,7 +251,7 @@ namespace mu2e {
         std::vector<StrawDigiIndex> sdis;
         for(size_t ihh = 0;ihh < hhits.size(); ++ihh) {
           ComboHit const& hhit = hhits[ihh];
-          hhits.fillStrawDigiIndices(evt,ihh,sdis);
+          _shindex->fillStrawDigiIndices(hhits,ihh,sdis);
           if(!hhit.flag().hasAnyProperty(StrawHitFlag::outlier))_nused += hhit.nStrawHits();
         }
         art::Ptr<SimParticle> pspp;
@@ -270,7 +275,7 @@ namespace mu2e {
             for(size_t ihh = 0;ihh < hhits.size(); ++ihh) {
               ComboHit const& hhit = hhits[ihh];
               vector<StrawDigiIndex> sdis;
-              hhits.fillStrawDigiIndices(evt,ihh,sdis);
+              _shindex->fillStrawDigiIndices(hhits,ihh,sdis);
               for(auto idigi : sdis) {
                 StrawDigiMC const& mcdigi = _mcdigis->at(idigi);
                 if ( mcdigi.earlyStrawGasStep()->simParticle() == pspp ){
@@ -465,7 +470,7 @@ namespace mu2e {
       // mc truth
       if(_mcdiag){
         std::vector<StrawDigiIndex> sdis;
-        hhits.fillStrawDigiIndices(evt,ihit,sdis);
+        _shindex->fillStrawDigiIndices(hhits,ihit,sdis);
 
         if(primary(pspp,sdis[0])){
 
@@ -530,7 +535,7 @@ namespace mu2e {
       if(_mcdiag){
         // get digi pointers from combo hits
         std::vector<StrawDigiIndex> sdis;
-        _chcol->fillStrawDigiIndices(evt,ich,sdis);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,sdis);
         for(auto isd : sdis) {
           StrawDigiMC const& mcdigi = _mcdigis->at(isd);
           auto const& spmcp = mcdigi.earlyStrawGasStep();
@@ -657,7 +662,7 @@ namespace mu2e {
       // mc truth
       if(_mcdiag){
         std::vector<StrawDigiIndex> sdis;
-        hhits.fillStrawDigiIndices(evt,ihit,sdis);
+        _shindex->fillStrawDigiIndices(hhits,ihit,sdis);
 
         if(primary(pspp,sdis[0])){
           if (use(hhit) ) {
@@ -711,7 +716,7 @@ namespace mu2e {
       if(_mcdiag){
         // get digi pointers from combo hits
         std::vector<StrawDigiIndex> sdis;
-        _chcol->fillStrawDigiIndices(evt,ich,sdis);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,sdis);
         for(auto isd : sdis) {
           StrawDigiMC const& mcdigi = _mcdigis->at(isd);
           auto const& spmcp = mcdigi.earlyStrawGasStep();
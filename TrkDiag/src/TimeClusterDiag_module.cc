@@ -25,6 +25,7 @@
 #include "Offline/TrkDiag/inc/TrkMCTools.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
@@ -38,6 +39,7 @@
 #include <functional>
 #include <iostream>
 #include <algorithm>
+#include <memory>
 using namespace std;
 
 namespace mu2e {
@@ -95,6 +97,7 @@ namespace mu2e {
     unsigned      _nbins;
     // cache of event objects
     const ComboHitCollection*     _chcol;
+    std::unique_ptr<ComboHitStrawIndexCache> _shindex; // StrawDigis of the ComboHits of the current event
     const TimeClusterCollection*    _tccol;
     const CaloClusterCollection*    _cccol;
     const StrawDigiMCCollection*          _mcdigis;
@@ -161,6 +164,7 @@ namespace mu2e {
     _pitch             (pset.get<float>(  "AveragePitch",0.6)), // =sin(lambda)
     _ttcalc            (pset.get<fhicl::ParameterSet>("T0Calculator",fhicl::ParameterSet()))
     {
+      consumesMany<ComboHitStrawIndex>(); // used by _shindex when the event has them
       // set # bins for time spectrum plot
       _nbins = (unsigned)rint((_tmax-_tmin)/_tbin);
       _tcsel = StrawHitFlag(StrawHitFlag::tclust);
@@ -175,6 +179,7 @@ namespace mu2e {
   }
 
   void TimeClusterDiag::analyze(art::Event const& event ) {
+    _shindex = std::make_unique<ComboHitStrawIndexCache>(event);
     _iev=event.id().event();
     // find the data
     if(!findData(event) )
@@ -285,7 +290,7 @@ namespace mu2e {
       if(_useflagcol)_shfcol.back().merge(_evtshfcol->at(ich));
       if(_mcdiag){
         std::vector<StrawDigiIndex> shids;
-        _chcol->fillStrawDigiIndices(event,ich,shids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
         unsigned nce(0);
         for(auto idigi : shids) {
           StrawDigiMC const& mcdigi = _mcdigis->at(idigi);
@@ -386,7 +391,7 @@ namespace mu2e {
       // MC truth
       if(_mcdiag){
         std::vector<StrawDigiIndex> shids;
-        _chcol->fillStrawDigiIndices(event,ich,shids);
+        _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
         StrawDigiMC const& mcdigi = _mcdigis->at(shids[0]);// FIXME!
         StrawEnd itdc;
         tchi._mctime = _toff.timeWithOffsetsApplied( *mcdigi.strawGasStep(itdc));
@@ -519,7 +524,7 @@ namespace mu2e {
     vector<spcount> sct;
     for (auto ich : tc._strawHitIdxs) {
       std::vector<StrawDigiIndex> shids;
-      _chcol->fillStrawDigiIndices(event,ich,shids);
+      _shindex->fillStrawDigiIndices(*_chcol,ich,shids);
       for(auto shid : shids ) {
         StrawDigiMC const& mcdigi = _mcdigis->at(shid);
         StrawEnd itdc;
@@ -29,6 +29,7 @@
 #include "Offline/RecoDataProducts/inc/StrawHitPosition.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/HelixSeed.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/TrkQual.hh"
 #include "Offline/RecoDataProducts/inc/KalSeed.hh"
 #include "Offline/MCDataProducts/inc/StrawDigiMC.hh"
@@ -47,6 +48,7 @@
 #include <functional>
 #include <algorithm>
 #include <iostream>
+#include <memory>
 using namespace std;
 using CLHEP::Hep3Vector;
 
@@ -89,6 +91,7 @@ namespace mu2e {
       const KalSeedCollection* _kfcol;
       const TimeClusterCollection* _tccol;
       const ComboHitCollection* _chcol;
+      std::unique_ptr<ComboHitStrawIndexCache> _shindex; // StrawDigis of the ComboHits of the current event
       const StrawDigiMCCollection* _mcdigis;
       const PrimaryParticle* _primary;
       const StepPointMCCollection* _vdmcsteps;
@@ -163,6 +166,7 @@ namespace mu2e {
     _beamWtModule( pset.get<art::InputTag>("beamWeightModule","PBIWeight" )),
     _toff(pset.get<fhicl::ParameterSet>("TimeOffsets"))
     {
+      consumesMany<ComboHitStrawIndex>(); // used by _shindex when the event has them
       if(_diag > 0){
         art::ServiceHandle<art::TFileService> tfs;
         _trdiag=tfs->make<TTree>("trdiag","Track Reconstruction Diagnostics");
@@ -251,6 +255,7 @@ namespace mu2e {
   }
 
   void TrkRecoDiag::analyze(art::Event const& evt) {
+    _shindex = std::make_unique<ComboHitStrawIndexCache>(evt);
     _iev=evt.id().event();
     resetTTree();
     // find the data
@@ -384,7 +389,7 @@ namespace mu2e {
     for(auto ihs = hsc.begin(); ihs != hsc.end(); ++ihs) {
       std::vector<StrawDigiIndex> sdis;
       for(size_t ihit=0;ihit < ihs->hits().size();ihit++)
-        ihs->hits().fillStrawDigiIndices(evt,ihit,sdis);
+        _shindex->fillStrawDigiIndices(ihs->hits(),ihit,sdis);
       unsigned nmc = TrkMCTools::primaryParticle(spp,sdis,_mcdigis);
       if(spp == bestspp && nmc > nprimary){
         retval = ihs;
@@ -402,7 +407,7 @@ namespace mu2e {
       // translate from ComboHit to StrawDigi indices
       std::vector<StrawDigiIndex> sdis;
       for(auto ihit : itc->hits())
-        _chcol->fillStrawDigiIndices(evt,ihit,sdis);
+        _shindex->fillStrawDigiIndices(*_chcol,ihit,sdis);
       unsigned nmc = TrkMCTools::primaryParticle(spp,sdis,_mcdigis);
       if(spp == bestspp && nmc > nprimary){
         retval = itc;
@@ -2,10 +2,16 @@
 //  Filter for selecting good helices (pat. rec. output): this is part of the track trigger
 //  Original author: Dave Brown (LBNL) 3/1/2017
 //
+//  The hit and fit quality cuts can depend on the microbunch intensity: with intensityLevels
+//  (see IntensityLevels), intensityCuts gives the cuts of each level above the nominal one.
+//
 // framework
 #include "fhiclcpp/types/Atom.h"
 #include "fhiclcpp/types/OptionalAtom.h"
+#include "fhiclcpp/types/OptionalSequence.h"
+#include "fhiclcpp/types/OptionalTable.h"
 #include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
 #include "art/Framework/Core/EDFilter.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -24,6 +30,7 @@
 // helper function
 #include "Offline/GeneralUtilities/inc/PhiPrescalingParams.hh"
 #include "Offline/GeneralUtilities/inc/ParameterSetHelpers.hh"
+#include "Offline/Trigger/inc/IntensityLevels.hh"
 //#include "TrkFilters/inc/TrkFiltersHelpers.hh"
 
 using namespace CLHEP;
@@ -38,6 +45,17 @@ namespace mu2e
   class HelixFilter : public art::EDFilter
   {
     public:
+      // cuts of an intensity level, default from the level below
+      struct LevelCuts{
+        using Name    = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::OptionalAtom<int>        minNStrawHits        {     Name("minNStrawHits"),           Comment("minNStrawHits  ") };
+        fhicl::OptionalAtom<double>     minHitRatio          {     Name("minHitRatio"),             Comment("minHitRatio    ") };
+        fhicl::OptionalAtom<double>     minMomentum          {     Name("minMomentum"),             Comment("minMomentum    ") };
+        fhicl::OptionalAtom<double>     minPt                {     Name("minPt"),                   Comment("minPt          ") };
+        fhicl::OptionalAtom<double>     maxChi2XY            {     Name("maxChi2XY"),               Comment("maxChi2XY      ") };
+        fhicl::OptionalAtom<double>     maxChi2PhiZ          {     Name("maxChi2PhiZ"),             Comment("maxChi2PhiZ    ") };
+      };
       struct Config{
         using Name    = fhicl::Name;
         using Comment = fhicl::Comment;
@@ -62,6 +80,8 @@ namespace mu2e
         fhicl::Atom<int>                debugLevel           {     Name("debugLevel"),              Comment("debugLevel")     , 0 };
         fhicl::OptionalAtom<bool>       prescaleUsingD0Phi   {     Name("prescaleUsingD0Phi"),      Comment("prescaleUsingD0Phi") };
         fhicl::Table<PhiPrescalingParams::Config>             prescalerPar{     Name("prescalerPar"),      Comment("prescalerPar") };
+        fhicl::OptionalTable<IntensityLevels::Config>         intensityLevels{  Name("intensityLevels"),   Comment("Microbunch intensity levels") };
+        fhicl::OptionalSequence<fhicl::Table<LevelCuts>>      intensityCuts{    Name("intensityCuts"),     Comment("Cuts of the intensity levels above the nominal one") };
       };
 
       using Parameters = art::EDFilter::Table<Config>;
@@ -76,13 +96,19 @@ namespace mu2e
       bool          _hascc; // Calo Cluster
       bool          _doHelicityCheck;
       int           _hel;
-      int           _minnstrawhits;
-      double        _minHitRatio;
-      double        _minmom, _maxmom;
+      // cuts depending on the intensity level
+      struct Cuts {
+        int         minnstrawhits;
+        double      minHitRatio;
+        double      minmom;
+        double      minpT;
+        double      maxchi2XY;
+        double      maxchi2PhiZ;
+      };
+      std::vector<Cuts> _cuts;
+      IntensityLevels _levels;
+      double        _maxmom;
       double        _maxpT;
-      double        _minpT;
-      double        _maxchi2XY;
-      double        _maxchi2PhiZ;
       double        _maxd0;
       double        _mind0;
       double        _maxlambda;
@@ -98,6 +124,7 @@ namespace mu2e
       int           _debug;
       // counters
       unsigned      _nevt, _npass;
+      std::vector<unsigned> _nevtLevel, _npassLevel;
 
       int evalIPAPresc(const float &phi0);
   };
@@ -108,13 +135,9 @@ namespace mu2e
     _hascc             (config().requireCaloCluster()),
     _doHelicityCheck   (config().doHelicityCheck()),
     _hel               (config().helicity()),
-    _minnstrawhits     (config().minNStrawHits()),
-    _minHitRatio       (config().minHitRatio()),
-    _minmom            (config().minMomentum()),
+    _cuts              {{config().minNStrawHits(), config().minHitRatio(), config().minMomentum(),
+                         config().minPt(), config().maxChi2XY(), config().maxChi2PhiZ()}},
     _maxmom            (config().maxMomentum()),
-    _minpT             (config().minPt()),
-    _maxchi2XY         (config().maxChi2XY()),
-    _maxchi2PhiZ       (config().maxChi2PhiZ()),
     _maxd0             (config().maxD0()),
     _mind0             (config().minD0()),
     _maxlambda         (config().maxAbsLambda()),
@@ -134,6 +157,26 @@ namespace mu2e
       }else {
         _prescaleUsingD0Phi = false;
       }
+      IntensityLevels::Config levels;
+      if (config().intensityLevels(levels)){
+        _levels = IntensityLevels(levels);
+        std::vector<LevelCuts> levelCuts;
+        config().intensityCuts(levelCuts);
+        _levels.checkCuts(levelCuts.size(),"HelixFilter");
+        for (const auto& lc : levelCuts){
+          Cuts cuts(_cuts.back());
+          lc.minNStrawHits(cuts.minnstrawhits);
+          lc.minHitRatio  (cuts.minHitRatio);
+          lc.minMomentum  (cuts.minmom);
+          lc.minPt        (cuts.minpT);
+          lc.maxChi2XY    (cuts.maxchi2XY);
+          lc.maxChi2PhiZ  (cuts.maxchi2PhiZ);
+          _cuts.push_back(cuts);
+        }
+      }
+      _levels.declareConsumes(consumesCollector());
+      _nevtLevel.assign(_levels.nLevels(),0);
+      _npassLevel.assign(_levels.nLevels(),0);
       produces<TriggerInfo>();
     }
 
@@ -160,6 +203,9 @@ namespace mu2e
     // create output
     std::unique_ptr<TriggerInfo> triginfo(new TriggerInfo);
     ++_nevt;
+    const unsigned level = _levels.level(evt);
+    const Cuts& cuts = _cuts[level];
+    ++_nevtLevel[level];
     bool retval(false); // preset to fail
     // find the collection
     auto hsH = evt.getValidHandle<HelixSeedCollection>(_hsTag);
@@ -189,19 +235,19 @@ namespace mu2e
       }
       if( hs.status().hasAllProperties(_goodh) &&
           (!_hascc || hs.caloCluster().isNonnull()) &&
-          nstrawhits >= _minnstrawhits &&
-          hpT        >= _minpT &&
-          chi2XY     <= _maxchi2XY &&
-          chi2PhiZ   <= _maxchi2PhiZ &&
+          nstrawhits >= cuts.minnstrawhits &&
+          hpT        >= cuts.minpT &&
+          chi2XY     <= cuts.maxchi2XY &&
+          chi2PhiZ   <= cuts.maxchi2PhiZ &&
           d0         <= _maxd0 &&
           d0         >= _mind0 &&
           lambda     <= _maxlambda &&
           lambda     >= _minlambda &&
           nLoops     <= _maxnloops &&
           nLoops     >= _minnloops &&
-          hmom       >= _minmom    &&
+          hmom       >= cuts.minmom    &&
           hmom       <= _maxmom    &&
-          hRatio     >= _minHitRatio ) {
+          hRatio     >= cuts.minHitRatio ) {
 
         //now check if we want to prescake or not
         if (_prescaleUsingD0Phi) {
@@ -209,6 +255,7 @@ namespace mu2e
           int   prescaler = evalIPAPresc(phiAtD0);
           if (_nevt % prescaler != 0)               continue;
         }
+        if (!retval) ++_npassLevel[level];
         retval = true;
         ++_npass;
         // Fill the trigger info object
@@ -228,6 +275,7 @@ namespace mu2e
   bool HelixFilter::endRun( art::Run& run ) {
     if(_debug > 0 && _nevt > 0){
       std::cout << moduleDescription().moduleLabel() << " paassed " <<  _npass << " events out of " << _nevt << " for a ratio of " << float(_npass)/float(_nevt) << std::endl;
+      if (_levels.used()) _levels.printCounts(std::cout,moduleDescription().moduleLabel(),_nevtLevel,_npassLevel);
     }
     return true;
   }
@@ -2,20 +2,29 @@
 //  Filter for selecting good time cluster: this is part of the track trigger
 //  Original author: Dave Brown (LBNL) 3/1/2017
 //
+//  The minimum number of hits can depend on the microbunch intensity: with intensityLevels
+//  (see IntensityLevels), intensityCuts gives the cut of each level above the nominal one.
+//
 // framework
 #include "art/Framework/Core/EDFilter.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
+#include "fhiclcpp/types/OptionalSequence.h"
+#include "fhiclcpp/types/OptionalTable.h"
 #include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
 // mu2e
 // data
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/RecoDataProducts/inc/TriggerInfo.hh"
+#include "Offline/Trigger/inc/IntensityLevels.hh"
 // c++
 #include <iostream>
 #include <memory>
+#include <vector>
 
 
 namespace mu2e
@@ -23,6 +32,11 @@ namespace mu2e
   class TimeClusterFilter : public art::EDFilter
   {
     public:
+      struct LevelCuts{
+        using Name    = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::OptionalAtom<unsigned>   minNStrawHits        {    Name("minNStrawHits"),              Comment("minNStrawHits, default from the level below")};
+      };
       struct Config{
         using Name    = fhicl::Name;
         using Comment = fhicl::Comment;
@@ -30,6 +44,8 @@ namespace mu2e
         fhicl::Atom<bool>               requireCaloCluster   {    Name("requireCaloCluster"),         Comment("Require caloCluster") };
         fhicl::Atom<unsigned>           minNStrawHits        {    Name("minNStrawHits"),                   Comment("minNStrawHits")};
         fhicl::Atom<int>                debugLevel           {    Name("debugLevel"),                 Comment("Debug"),0 };
+        fhicl::OptionalTable<IntensityLevels::Config>   intensityLevels{ Name("intensityLevels"), Comment("Microbunch intensity levels") };
+        fhicl::OptionalSequence<fhicl::Table<LevelCuts>> intensityCuts { Name("intensityCuts"),   Comment("Cuts of the intensity levels above the nominal one") };
       };
 
       using Parameters = art::EDFilter::Table<Config>;
@@ -42,21 +58,38 @@ namespace mu2e
 
       art::InputTag _tcTag;
       bool          _hascc; // Calo Cluster
-      unsigned      _minnhits;
+      std::vector<unsigned> _minnhits; // by intensity level
+      IntensityLevels _levels;
       int           _debug;
       // counters
       unsigned      _nevt, _npass;
+      std::vector<unsigned> _nevtLevel, _npassLevel;
   };
 
   TimeClusterFilter::TimeClusterFilter(const Parameters& conf)
     : art::EDFilter{conf},
     _tcTag   (conf().timeClusterCollection()),
     _hascc   (conf().requireCaloCluster()),
-    _minnhits(conf().minNStrawHits()),
+    _minnhits{conf().minNStrawHits()},
     _debug   (conf().debugLevel()),
     _nevt    (0),
     _npass   (0)
     {
+      IntensityLevels::Config levels;
+      if (conf().intensityLevels(levels)){
+        _levels = IntensityLevels(levels);
+        std::vector<LevelCuts> levelCuts;
+        conf().intensityCuts(levelCuts);
+        _levels.checkCuts(levelCuts.size(),"TimeClusterFilter");
+        for (const auto& lc : levelCuts){
+          unsigned minnhits(_minnhits.back());
+          lc.minNStrawHits(minnhits);
+          _minnhits.push_back(minnhits);
+        }
+      }
+      _levels.declareConsumes(consumesCollector());
+      _nevtLevel.assign(_levels.nLevels(),0);
+      _npassLevel.assign(_levels.nLevels(),0);
       produces<TriggerInfo>();
     }
 
@@ -64,6 +97,8 @@ namespace mu2e
     // create output
     std::unique_ptr<TriggerInfo> triginfo(new TriggerInfo);
     ++_nevt;
+    const unsigned level = _levels.level(evt);
+    ++_nevtLevel[level];
     bool retval(false); // preset to fail
     // find the collection
     auto tcH = evt.getValidHandle<TimeClusterCollection>(_tcTag);
@@ -75,7 +110,8 @@ namespace mu2e
         std::cout << moduleDescription().moduleLabel() << " nStrawHits = " << tc.nStrawHits() << " t0 = " << tc.t0().t0() << std::endl;
       }
       if( (!_hascc || tc.caloCluster().isNonnull()) &&
-          tc.nStrawHits() >= _minnhits) {
+          tc.nStrawHits() >= _minnhits[level]) {
+        if (!retval) ++_npassLevel[level];
         retval = true;
         ++_npass;
         // Fill the trigger info object
@@ -95,6 +131,7 @@ namespace mu2e
   bool TimeClusterFilter::endRun( art::Run& run ) {
     if(_debug > 0 && _nevt > 0){
       std::cout << moduleDescription().moduleLabel() << " passed " << _npass << " events out of " << _nevt << " for a ratio of " << float(_npass)/float(_nevt) << std::endl;
+      if (_levels.used()) _levels.printCounts(std::cout,moduleDescription().moduleLabel(),_nevtLevel,_npassLevel);
     }
     return true;
   }
@@ -0,0 +1,38 @@
+#ifndef TrkHitReco_BkgClusterQuality_hh
+#define TrkHitReco_BkgClusterQuality_hh
+//
+// Quality variables and background MVA of the hit clusters flagged by FlagBkgHits, also
+// replayed by kernelBenchmark.  A cluster with fewer active hits or planes than the minima
+// is left with an unset MVA status, and the MVA is not evaluated for it.
+//
+#include "Offline/Mu2eUtilities/inc/MVATools.hh"
+#include "Offline/RecoDataProducts/inc/BkgCluster.hh"
+#include "Offline/RecoDataProducts/inc/BkgQual.hh"
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+
+namespace mu2e
+{
+
+  class BkgClusterQuality
+  {
+    public:
+      BkgClusterQuality(unsigned minActiveHits, unsigned minNPlanes, const StrawHitFlag& stereo, const MVATools::Config& mva);
+
+      void init() { mva_.initMVA(); }
+
+      void fillBkgQual(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
+      void fillMVA(BkgQual& cqual) const;
+
+    private:
+      void countHits(  const BkgCluster& cluster, unsigned& nactive, unsigned& nstereo, const ComboHitCollection& chcol) const;
+      void countPlanes(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
+
+      unsigned     minnhits_;
+      unsigned     minnp_;
+      StrawHitFlag stereo_;
+      MVATools     mva_;
+  };
+
+}
+#endif
@@ -0,0 +1,112 @@
+//
+// Recorded inputs of the reconstruction kernels benchmarked by kernelBenchmark: per event, the
+// ComboHits, the straw digi waveforms and the calorimeter digis, written by the KernelInputRecorder
+// module in the columnar format of Mu2eUtilities/inc/ColumnarFile.hh.  The ComboHits carry their
+// positions, so the clustering kernels need no geometry.  Only the fields the kernels use are kept:
+// the indices to the parent hits are not.
+//
+// The conditions the kernels need are recorded once, at the first run: the calorimeter
+// digitization period and pulse shape (CaloTemplateWFProcessor), the electronics constants of
+// StrawResponse (PeakFit), and the tracker straws (DeltaFinderAlg), with the content of a
+// GeometrySnapshot.
+//
+#ifndef TrkHitReco_KernelInputs_hh
+#define TrkHitReco_KernelInputs_hh
+
+#include "Offline/GeometryService/inc/GeometrySnapshot.hh"
+#include "Offline/Mu2eUtilities/inc/ColumnarFile.hh"
+#include "Offline/RecoDataProducts/inc/CaloDigi.hh"
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+#include "Offline/TrackerConditions/inc/StrawResponse.hh"
+#include "Offline/TrackerGeom/inc/Tracker.hh"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TH1;
+
+namespace mu2e {
+
+  struct RecordedEvent
+  {
+    uint32_t                       run    = 0;
+    uint32_t                       subRun = 0;
+    uint32_t                       event  = 0;
+    ComboHitCollection             comboHits;
+    StrawDigiADCWaveformCollection strawWaveforms;
+    CaloDigiCollection             caloDigis;
+  };
+
+  // the StrawResponse constants used by the waveform fits
+  struct RecordedStrawResponse
+  {
+    double                                      adcPeriod         = 0;   // ns
+    double                                      adcLSB            = 0;   // mV
+    uint32_t                                    maxADC            = 0;
+    uint32_t                                    nADCPreSamples    = 0;
+    std::array<double,StrawElectronics::npaths> analogNoise       = {};  // mV
+    std::array<double,StrawElectronics::npaths> currentToVoltage  = {};
+    double                                      saturationVoltage = 0;   // mV
+    double                                      adcPedestal       = 0;
+    double                                      pmpEnergyScale    = 0;
+  };
+
+  struct KernelInputs
+  {
+    double                                             caloDigiSampling = 0;   // ns
+    std::vector<double>                                caloPulseShape;         // bin contents, empty if not recorded
+    double                                             caloPulseMin     = 0;   // axis of the pulse shape histogram (ns)
+    double                                             caloPulseMax     = 0;
+    std::unique_ptr<RecordedStrawResponse>             strawResponse;          // null if not recorded
+    std::unique_ptr<GeometrySnapshot::StrawCollection> straws;                 // null if not recorded
+    std::vector<RecordedEvent>                         events;
+  };
+
+  class KernelInputWriter
+  {
+    public:
+      KernelInputWriter(const std::string& filename, double caloDigiSampling, int compressionSettings = 505);
+
+      // Any collection may be missing
+      void write(uint32_t run, uint32_t subRun, uint32_t event, const ComboHitCollection* comboHits,
+                 const StrawDigiADCWaveformCollection* strawWaveforms, const CaloDigiCollection* caloDigis);
+      // Conditions, written once
+      void writeCaloPulseShape(const TH1& pulseShape);
+      void writeStrawResponse(const StrawResponse& srep);
+      void writeStraws(const GeometrySnapshot::StrawCollection& straws);
+      void close();
+
+      std::size_t events()      const { return events_->rows(); }
+      std::size_t rawBytes()    const { return file_.rawBytes(); }
+      std::size_t storedBytes() const { return file_.storedBytes(); }
+
+    private:
+      ColumnarWriter          file_;
+      ColumnarWriter::Table*  events_;
+      ColumnarWriter::Table*  comboHits_;
+      ColumnarWriter::Table*  strawWaveforms_;
+      ColumnarWriter::Table*  strawSamples_;
+      ColumnarWriter::Table*  caloDigis_;
+      ColumnarWriter::Table*  caloSamples_;
+      ColumnarWriter::Table*  caloPulseAxis_;
+      ColumnarWriter::Table*  caloPulseShape_;
+      ColumnarWriter::Table*  strawResponse_;
+      ColumnarWriter::Table*  straws_;
+  };
+
+  // Throws if the file was written by another version of the recorder
+  KernelInputs readKernelInputs(const std::string& filename);
+
+  // A StrawResponse with only the recorded constants set, enough for the waveform fits
+  StrawResponse::cptr_t makeStrawResponse(const RecordedStrawResponse& recorded);
+
+  // A Tracker of the recorded straws, with all the planes present, enough for the pattern recognition
+  std::unique_ptr<Tracker> makeTracker(const GeometrySnapshot::StrawCollection& straws);
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef TrkHitReco_PeakFitTemplate_hh
+#define TrkHitReco_PeakFitTemplate_hh
+//
+// Waveform fit without ROOT minimization, using the model of PeakFitFunction: pedestal, main
+// peak and optional early and late peaks, with the same parameter limits as PeakFitRoot.
+// The pulse shape is sampled once on a (width, time) grid.  For given time, width and late
+// shift the model is linear in the pedestal and the charges, which are solved by bounded linear
+// least squares; the chisquared profiled this way is minimized over time, width and late shift
+// by coarse scans, then by a bounded Newton search.  process does no heap
+// allocation.  When ADC truncation is modelled the saturated samples are left out of the fit.
+//
+// A fixed width means no convolution, as PeakFitRoot does.
+//
+#include "Offline/TrkHitReco/inc/PeakFit.hh"
+#include <array>
+#include <vector>
+
+namespace mu2e {
+
+  namespace TrkHitReco {
+
+    class PeakFitTemplate : public PeakFit
+    {
+      public:
+
+        PeakFitTemplate(const StrawResponse& srep, const fhicl::ParameterSet& pset);
+        virtual ~PeakFitTemplate(){}
+
+        virtual void process(TrkTypes::ADCWaveform const& adcData, PeakFitParams & fit) const;
+
+        // sampled response to a unit charge of the given width, at time t after the peak time
+        double pulse(double t, double width) const;
+
+        static constexpr size_t maxSamples = 64;
+
+      private:
+
+        enum amplitude {pedestalAmp=0,mainAmp,earlyAmp,lateAmp,nAmplitudes};
+        enum nonlinear {peakTime=0,peakWidth,lateDelay,nNonlinear};
+        typedef std::array<double,maxSamples> Samples;
+
+        // waveform prepared for the fit
+        struct Data
+        {
+          Samples  y;     // ADC counts
+          Samples  use;   // 1 for the fitted samples, 0 for saturated ones
+          size_t   n;
+        };
+
+        // minimal chisquared over the amplitudes for given nonlinear parameters
+        double profile(Data const& data, const double par[nNonlinear], double amp[nAmplitudes]) const;
+
+        bool            _truncateADC;     // model ADC truncation
+        bool            _floatPedestal;   // float pedestal in fit
+        bool            _floatWidth;      // float width in fit
+        bool            _earlyPeak;       // fit the tail of an earlier hit
+        bool            _latePeak;        // fit a second, later peak
+        unsigned        _maxIter;         // maximum number of Newton iterations
+        double          _tolerance;       // Newton convergence on the nonlinear parameters (ns)
+        double          _scanStep;        // step of the coarse time and late delay scans (ns)
+        double          _widthScanStep;   // step of the coarse width scan (ns)
+        int             _debug;
+
+        double          _period;          // ADC sampling period
+        double          _invsigma2;       // inverse ADC noise squared
+        double          _saturation;      // smallest saturated ADC value
+        double          _ampmin[nAmplitudes], _ampmax[nAmplitudes];
+        double          _parmin[nNonlinear],  _parmax[nNonlinear], _dpar[nNonlinear];
+        Samples         _earlyShape;      // early peak tail of unit charge at each sample
+
+        // pulse template, _nw rows of _nt times
+        double             _tmin, _dt, _dw;
+        size_t             _nt, _nw;
+        std::vector<float> _template;
+    };
+  }
+}
+#endif
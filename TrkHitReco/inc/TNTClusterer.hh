@@ -8,6 +8,7 @@
 #define TNTClusterer_HH
 
 #include "fhiclcpp/types/Atom.h"
+#include "Offline/GeneralUtilities/inc/SpatialGrid.hh"
 #include "Offline/RecoDataProducts/inc/StrawDigi.hh"
 #include "Offline/TrkHitReco/inc/BkgClusterer.hh"
 #include "fhiclcpp/types/Sequence.h"
@@ -66,12 +67,13 @@ namespace mu2e {
 
     private:
       static const int numBuckets = 256; //number of buckets to store the clusters vs time - optimized for speed
-      using arrayVecBkg = std::array<std::vector<int>,numBuckets>;
+      static const int numXYBuckets = 16; //number of buckets to store the clusters vs x and vs y
+      using ClusterGrid = SpatialGrid<3,float>; // clusters indexed in (x,y,t)
 
       void     initClu      (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
       void     clusterAlgo  (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo, float tbin);
       unsigned formClusters (const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, float tbin,
-          std::vector<BkgHit>& hinfo, arrayVecBkg& hitIndex);
+          std::vector<BkgHit>& hinfo);
       void     mergeClusters(std::vector<BkgCluster>& clusters, const ComboHitCollection& chcol,
           std::vector<BkgHit>& hinfo, float dt, float dd2);
       void     mergeTwoClu  (BkgCluster& clu1, BkgCluster& clu2 );
@@ -79,12 +81,15 @@ namespace mu2e {
       void     dump         (const std::vector<BkgCluster>& clusters, std::vector<BkgHit>& hinfo);
 
       std::vector<int> hitDtIdx_;
+      ClusterGrid      clusterIndex_;
+      std::vector<unsigned> candidates_;
       float            dhit_;
       float            dseed_;
       float            dd_;
       float            dd2_;
       float            dt_;
       float            maxwt_;
+      float            md_;
       float            md2_;
       float            trms2inv_;
       float            maxHitdt_;
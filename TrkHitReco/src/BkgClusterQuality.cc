@@ -0,0 +1,123 @@
+#include "Offline/TrkHitReco/inc/BkgClusterQuality.hh"
+#include "Offline/DataProducts/inc/StrawId.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace mu2e
+{
+
+  BkgClusterQuality::BkgClusterQuality(unsigned minActiveHits, unsigned minNPlanes, const StrawHitFlag& stereo,
+                                       const MVATools::Config& mva) :
+    minnhits_(minActiveHits),
+    minnp_(minNPlanes),
+    stereo_(stereo),
+    mva_(mva)
+  {}
+
+
+  //--------------------------------------------------------------------------------------------------------------
+  void BkgClusterQuality::fillBkgQual(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const
+  {
+    unsigned nactive, nstereo;
+    countHits(cluster, nactive, nstereo,chcol);
+    cqual.setMVAStatus(MVAStatus::unset);
+
+    if (nactive < minnhits_) return;
+    countPlanes(cluster,cqual,chcol);
+
+    cqual[BkgQual::hrho]  = 0;
+    cqual[BkgQual::shrho] = 0;
+    cqual[BkgQual::nhits] = nactive;
+    cqual[BkgQual::sfrac] = static_cast<float>(nstereo)/nactive;
+    cqual[BkgQual::crho] = sqrtf(cluster.pos().perp2());
+
+    if (cqual[BkgQual::np] >= minnp_)
+    {
+      std::vector<float> hz;
+      for (const auto& chit : cluster.hits()) hz.push_back(chcol[chit].pos().z());
+
+      // find the min, max and largest gap from the sorted Z positions
+      std::sort(hz.begin(),hz.end());
+      float zgap = 0.0;
+      for (unsigned iz=1;iz<hz.size();++iz) zgap=std::max(zgap,hz[iz]-hz[iz-1]);
+      cqual[BkgQual::zmin] = hz.front();
+      cqual[BkgQual::zmax] = hz.back();
+      cqual[BkgQual::zgap] = zgap;
+
+      cqual.setMVAStatus(MVAStatus::filled);
+    }
+    else
+    {
+      cqual[BkgQual::zmin]  = -1.0;
+      cqual[BkgQual::zmax]  = -1.0;
+      cqual[BkgQual::zgap]  = -1.0;
+    }
+  }
+
+
+  //----------------------------------------------
+  void BkgClusterQuality::fillMVA(BkgQual& cqual) const
+  {
+    if (cqual.status() == MVAStatus::unset) return;
+
+    std::vector<float> mvavars(7,0.0);
+    mvavars[0] = cqual.varValue(BkgQual::crho);
+    mvavars[1] = cqual.varValue(BkgQual::zmin);
+    mvavars[2] = cqual.varValue(BkgQual::zmax);
+    mvavars[3] = cqual.varValue(BkgQual::zgap);
+    mvavars[4] = cqual.varValue(BkgQual::np);
+    mvavars[5] = cqual.varValue(BkgQual::npfrac);
+    mvavars[6] = cqual.varValue(BkgQual::nhits);
+    float mvaout = mva_.evalMVA(mvavars);
+
+    cqual.setMVAValue(mvaout);
+    cqual.setMVAStatus(MVAStatus::calculated);
+  }
+
+
+
+  //-------------------------------------------------------------------------------------------------------------
+  void BkgClusterQuality::countPlanes(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const
+  {
+    std::array<int,StrawId::_nplanes> hitplanes{0};
+    for (const auto& chit : cluster.hits())
+    {
+      const ComboHit& ch = chcol[chit];
+      hitplanes[ch.strawId().plane()] += ch.nStrawHits();
+    }
+
+    unsigned ipmin(0),ipmax(StrawId::_nplanes-1);
+    while (hitplanes[ipmin]==0) ++ipmin;
+    while (hitplanes[ipmax]==0) --ipmax;
+
+    unsigned npexp(0),np(0),nphits(0);
+    for(unsigned ip = ipmin; ip <= ipmax; ++ip)
+    {
+      npexp++; // should use TTracker to see if plane is physically present FIXME!
+      if (hitplanes[ip]> 0)++np;
+      nphits += hitplanes[ip];
+    }
+
+    cqual[BkgQual::np]     = np;
+    cqual[BkgQual::npexp]  = npexp;
+    cqual[BkgQual::npfrac] = static_cast<float>(np)/static_cast<float>(npexp);
+    cqual[BkgQual::nphits] = static_cast<float>(nphits)/static_cast<float>(np);
+  }
+
+
+  //----------------------------------------------------------------------------------------------------------------------------------
+  void BkgClusterQuality::countHits(const BkgCluster& cluster, unsigned& nactive, unsigned& nstereo, const ComboHitCollection& chcol) const
+  {
+    nactive = nstereo = 0;
+    for (const auto& chit : cluster.hits())
+    {
+      const ComboHit& ch = chcol[chit];
+      nactive += ch.nStrawHits();
+      if (ch.flag().hasAnyProperty(stereo_)) nstereo += ch.nStrawHits();
+    }
+  }
+
+}
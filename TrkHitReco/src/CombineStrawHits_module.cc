@@ -5,6 +5,10 @@
 //
 // Modified by B. Echenard (Caltech), assumes that the hits are ordered by panels
 // Dave Brown confirmed this is the case
+//
+// Within each panel the hits are sorted by straw and time, so the partner
+// candidates of a hit come from a short window scan of the neighboring
+// straws instead of a scan of the whole panel.
 
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
 #include "fhiclcpp/types/Atom.h"
@@ -17,6 +21,7 @@
 #include "fhiclcpp/ParameterSet.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace mu2e {
@@ -50,7 +55,20 @@ namespace mu2e {
       void produce( art::Event& e);
 
     private:
-      void combine(const ComboHitCollection* chcolOrig, ComboHitCollection& chcol);
+      // sort key used for the neighbor search inside a panel
+      struct HitKey {
+        uint16_t straw;
+        float    time;
+        uint32_t pos;    // position in the processing order
+        bool operator < (HitKey const& other) const {
+          if (straw != other.straw) return straw < other.straw;
+          if (time  != other.time)  return time  < other.time;
+          return pos < other.pos;
+        }
+      };
+
+      void combine(const ComboHitCollection* chcolOrig, std::vector<uint16_t> const& order, ComboHitCollection& chcol);
+      float hitTime(ComboHit const& ch) const { return _useTOT ? ch.correctedTime() : ch.time(); }
       void combineHits(const ComboHitCollection* chcolOrig, ComboHit& combohit);
 
       int           _debug;
@@ -108,73 +126,95 @@ namespace mu2e {
     chcolNew->reserve(chcolOrig->size());
     chcolNew->setParent(chH);
 
+    // order in which the hits are processed; ComboHit indices always refer to the input collection
+    std::vector<uint16_t> order(chcolOrig->size());
+    for (size_t ich=0;ich<order.size();++ich) order[ich] = ich;
     if (_isVSTdata){
       // currently VST data is not sorted by panel number so we must sort manually
-      // sort hits by panel
-      ComboHitCollection* chcolsort = new ComboHitCollection();
-      chcolsort->reserve(chcolOrig->size());
-      chcolsort->setParent(chH);
-      std::array<std::vector<uint16_t>,StrawId::_nupanels> panels;
-      size_t nsh = chcolOrig->size();
-      for(uint16_t ish=0;ish<nsh;++ish){
-        ComboHit const& ch = (*chcolOrig)[ish];
-        // select hits based on flag
-        panels[ch.strawId().uniquePanel()].push_back(ish);
-      }
-      for (uint16_t ipanel=0;ipanel<StrawId::_nupanels;ipanel++){
-        for (uint16_t ish=0;ish<panels[ipanel].size();ish++){
-          chcolsort->push_back(chcolOrig->at(panels[ipanel][ish]));
-        }
-      }
-      combine(chcolsort, *chcolNew);
-    }else{
-      combine(chcolOrig, *chcolNew);
+      std::stable_sort(order.begin(),order.end(),[chcolOrig](uint16_t i, uint16_t j){
+          return (*chcolOrig)[i].strawId().uniquePanel() < (*chcolOrig)[j].strawId().uniquePanel(); });
     }
+    combine(chcolOrig, order, *chcolNew);
     event.put(std::move(chcolNew));
   }
 
 
-  void CombineStrawHits::combine(const ComboHitCollection* chcolOrig, ComboHitCollection& chcol)
+  void CombineStrawHits::combine(const ComboHitCollection* chcolOrig, std::vector<uint16_t> const& order, ComboHitCollection& chcol)
   {
-    std::vector<bool> isUsed(chcolOrig->size(),false);
-    for (size_t ich=0;ich<chcolOrig->size();++ich)
-    {
-      if (isUsed[ich]) continue;
-      isUsed[ich] = true;
+    // the time window is widened slightly for the search so that rounding never
+    // drops a pair, the exact time cut is applied to each candidate
+    static constexpr float ttol = 1e-3;
 
-      const ComboHit& hit1 = (*chcolOrig)[ich];
-      if ( _testflag && (!hit1.flag().hasAllProperties(_shsel) || hit1.flag().hasAnyProperty(_shmask)) ) continue;
-      ComboHit combohit;
-      combohit.init(hit1,ich);
-      int panel1 = hit1.strawId().uniquePanel();
+    std::vector<bool> isUsed(order.size(),false);
+    std::vector<HitKey> keys;
+    std::vector<uint32_t> partners;
 
-      for (size_t jch=ich+1;jch<chcolOrig->size();++jch)
-      {
-        if (isUsed[jch]) continue;
-        const ComboHit& hit2 = (*chcolOrig)[jch];
-
-        if (hit2.strawId().uniquePanel() != panel1) break;
-        if (abs(hit2.strawId().straw()-hit1.strawId().straw())> _maxds ) continue; // hits are not sorted by straw number
-        if ( _testflag && (!hit2.flag().hasAllProperties(_shsel) || hit2.flag().hasAnyProperty(_shmask)) ) continue;
+    // panels are contiguous in the processing order
+    size_t pbegin(0);
+    while (pbegin < order.size())
+    {
+      int panel = (*chcolOrig)[order[pbegin]].strawId().uniquePanel();
+      size_t pend = pbegin+1;
+      while (pend < order.size() && (*chcolOrig)[order[pend]].strawId().uniquePanel() == panel) ++pend;
+
+      keys.clear();
+      for (size_t ip=pbegin;ip<pend;++ip) {
+        ComboHit const& ch = (*chcolOrig)[order[ip]];
+        keys.push_back(HitKey{ch.strawId().straw(),hitTime(ch),uint32_t(ip)});
+      }
+      std::sort(keys.begin(),keys.end());
 
-        float dt = _useTOT ? fabs(hit1.correctedTime() - hit2.correctedTime()) : fabs(hit1.time() - hit2.time());
-        if (dt > _maxdt) continue;
+      for (size_t ip=pbegin;ip<pend;++ip)
+      {
+        if (isUsed[ip]) continue;
+        isUsed[ip] = true;
+
+        size_t ich = order[ip];
+        const ComboHit& hit1 = (*chcolOrig)[ich];
+        if ( _testflag && (!hit1.flag().hasAllProperties(_shsel) || hit1.flag().hasAnyProperty(_shmask)) ) continue;
+        ComboHit combohit;
+        combohit.init(hit1,ich);
+
+        int   straw1 = hit1.strawId().straw();
+        float time1  = hitTime(hit1);
+        partners.clear();
+        for (int straw2=std::max(0,straw1-_maxds);straw2<=straw1+_maxds;++straw2)
+        {
+          auto ikey = std::lower_bound(keys.begin(),keys.end(),HitKey{uint16_t(straw2),time1-_maxdt-ttol,0});
+          for (;ikey != keys.end() && ikey->straw == straw2 && ikey->time <= time1+_maxdt+ttol;++ikey)
+          {
+            // only hits later in the processing order are partners, as in a sequential scan
+            if (ikey->pos <= ip || isUsed[ikey->pos]) continue;
+            const ComboHit& hit2 = (*chcolOrig)[order[ikey->pos]];
+            if ( _testflag && (!hit2.flag().hasAllProperties(_shsel) || hit2.flag().hasAnyProperty(_shmask)) ) continue;
+
+            float dt = fabs(time1 - ikey->time);
+            if (dt > _maxdt) continue;
+
+            float wderr = sqrtf(hit1.wireErr2() + hit2.wireErr2());
+            float wdchi = fabs(hit1.wireDist() - hit2.wireDist())/wderr;
+            if (wdchi > _maxwdchi) continue;
+
+            partners.push_back(ikey->pos);
+          }
+        }
+        // add partners in processing order
+        std::sort(partners.begin(),partners.end());
+        for (auto jp : partners)
+        {
+          bool ok = combohit.addIndex(order[jp]);
+          if (!ok) std::cout << "CombineStrawHits past limit" << std::endl;
+          isUsed[jp]= true;
+        }
 
-        float wderr = sqrtf(hit1.wireErr2() + hit2.wireErr2());
-        float wdchi = fabs(hit1.wireDist() - hit2.wireDist())/wderr;
-        if (wdchi > _maxwdchi) continue;
+        if (combohit.nCombo() > 1) combineHits(chcolOrig, combohit);
 
-        bool ok = combohit.addIndex(jch);
-        if (!ok) std::cout << "CombineStrawHits past limit" << std::endl;
-        isUsed[jch]= true;
+        float r2     = combohit.pos().Perp2();
+        bool goodrad = r2 < _maxR2 && r2 > _minR2;
+        if (goodrad) combohit._flag.merge(StrawHitFlag::radsel);
+        if (!_testrad || goodrad) chcol.push_back(std::move(combohit));
       }
-
-      if (combohit.nCombo() > 1) combineHits(chcolOrig, combohit);
-
-      float r2     = combohit.pos().Perp2();
-      bool goodrad = r2 < _maxR2 && r2 > _minR2;
-      if (goodrad) combohit._flag.merge(StrawHitFlag::radsel);
-      if (!_testrad || goodrad) chcol.push_back(std::move(combohit));
+      pbegin = pend;
     }
   }
 
@@ -4,6 +4,7 @@
 #include "art_root_io/TFileService.h"
 #include "canvas/Utilities/InputTag.h"
 #include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
 #include "fhiclcpp/types/Sequence.h"
 
 #include "Offline/ConditionsService/inc/ConditionsHandle.hh"
@@ -13,11 +14,13 @@
 #include "Offline/RecoDataProducts/inc/StrawHit.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
 #include "Offline/RecoDataProducts/inc/BkgCluster.hh"
 #include "Offline/RecoDataProducts/inc/BkgClusterHit.hh"
 #include "Offline/RecoDataProducts/inc/BkgQual.hh"
 
-#include "Offline/Mu2eUtilities/inc/MVATools.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
+#include "Offline/TrkHitReco/inc/BkgClusterQuality.hh"
 #include "Offline/TrkHitReco/inc/TNTClusterer.hh"
 #include "Offline/TrkHitReco/inc/ScanClusterer.hh"
 
@@ -38,6 +41,7 @@ namespace mu2e
         using Comment = fhicl::Comment;
         fhicl::Atom<art::InputTag>            comboHitCollection{   Name("ComboHitCollection"),   Comment("ComboHit collection name") };
         fhicl::Atom<art::InputTag>            strawHitCollection{   Name("StrawHitCollection"),   Comment("StrawHit collection name") };
+        fhicl::OptionalAtom<art::InputTag>    comboHitStrawIndex{   Name("ComboHitStrawIndex"),   Comment("StrawHit index of the ComboHit collection; made here if absent") };
         fhicl::Atom<unsigned>                 minActiveHits{        Name("MinActiveHits"),        Comment("Minumim number of active hits in a cluster") };
         fhicl::Atom<unsigned>                 minNPlanes{           Name("MinNPlanes"),           Comment("Minumim number of planes in a cluster") };
         fhicl::Atom<float>                    clusterPositionError{ Name("ClusterPositionError"), Comment("Cluster poisiton error") };
@@ -64,25 +68,20 @@ namespace mu2e
     private:
       const art::ProductToken<ComboHitCollection> chtoken_;
       const art::ProductToken<StrawHitCollection> shtoken_;
-      unsigned                                    minnhits_;
-      unsigned                                    minnp_;
+      art::InputTag                               chsitag_;
       bool                                        filter_, flagch_, flagsh_;
       bool                                        savebkg_;
-      StrawHitFlag                                bkgmsk_, stereo_;
+      StrawHitFlag                                bkgmsk_;
       BkgClusterer*                               clusterer_;
       float                                       cperr2_;
       float                                       bkgMVAcut_;
-      MVATools                                    bkgMVA_;
+      BkgClusterQuality                           quality_;
       int const                                   debug_;
       int const                                   printfreq_;
       int                                         iev_;
 
       void classifyCluster(BkgClusterCollection& bkgccolFast, BkgClusterCollection& bkgccol, BkgQualCollection& bkgqcol,
           StrawHitFlagCollection& chfcol, const ComboHitCollection& chcol) const;
-      void fillBkgQual(    const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
-      void fillMVA(        BkgQual& cqual) const;
-      void countHits(      const BkgCluster& cluster, unsigned& nactive, unsigned& nstereo, const ComboHitCollection& chcol) const;
-      void countPlanes(    const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const;
       int  findClusterIdx( BkgClusterCollection& bkgccol, unsigned ich) const;
   };
 
@@ -91,22 +90,20 @@ namespace mu2e
     art::EDProducer{config},
     chtoken_{     consumes<ComboHitCollection>(config().comboHitCollection()) },
     shtoken_{     consumes<StrawHitCollection>(config().strawHitCollection()) },
-    minnhits_(    config().minActiveHits() ),
-    minnp_(       config().minNPlanes()),
     filter_(      config().filterOutput()),
     flagch_(      config().flagComboHits()),
     flagsh_(      config().flagStrawHits()),
     savebkg_(     config().saveBkgClusters()),
     bkgmsk_(      config().backgroundMask()),
-    stereo_(      config().stereoSelection()),
     bkgMVAcut_(   config().bkgMVAcut()),
-    bkgMVA_(      config().bkgMVA()),
+    quality_(     config().minActiveHits(), config().minNPlanes(), StrawHitFlag(config().stereoSelection()), config().bkgMVA()),
     debug_(       config().debugLevel()),
     printfreq_(   config().printFrequency()),
     iev_(0)
     {
-      // Must call consumesMany because fillStrawHitIndices calls getManyByType.
+      // Must call consumesMany because the StrawHit index looks the parent collections up with getMany.
       consumesMany<ComboHitCollection>();
+      if (config().comboHitStrawIndex(chsitag_)) consumes<ComboHitStrawIndex>(chsitag_);
 
       if (flagch_) produces<StrawHitFlagCollection>("ComboHits");
       if (flagsh_) produces<StrawHitFlagCollection>("StrawHits");
@@ -138,7 +135,7 @@ namespace mu2e
   void FlagBkgHits::beginJob()
   {
     clusterer_->init();
-    bkgMVA_.initMVA();
+    quality_.init();
   }
 
 
@@ -205,22 +202,33 @@ namespace mu2e
       event.put(std::move(chcolFilter));
     }
 
-    //produce StrawHit flags
-    // Note: fillStrawHitIndices is quite slow and should be improved
+    //produce StrawHit flags, using the flattened StrawHit index of the ComboHits
     if (flagsh_)
     {
+      MU2E_PROFILE_SCOPE("FlagBkgHits::flagStrawHits");
       auto shH = event.getValidHandle(shtoken_);
       const StrawHitCollection* shcol  = shH.product();
 
       unsigned nsh = shcol->size();
       auto shfcol  = std::make_unique<StrawHitFlagCollection>(nsh);
-      std::vector<std::vector<StrawHitIndex> > shids;
-      chcol.fillStrawHitIndices(event,shids);
+      std::unique_ptr<ComboHitStrawIndex> localindex;
+      const ComboHitStrawIndex* shindex(0);
+      if (!chsitag_.empty())
+      {
+        shindex = event.getValidHandle<ComboHitStrawIndex>(chsitag_).product();
+        if (shindex->collection() != chH.id())
+          throw cet::exception("RECO")<<"FlagBkgHits: StrawHit index " << chsitag_ << " is not for the input ComboHits" << std::endl;
+      }
+      else
+      {
+        localindex = std::make_unique<ComboHitStrawIndex>(event,chcol,chH.id());
+        shindex = localindex.get();
+      }
       for (size_t ich = 0;ich < nch;++ich)
       {
         StrawHitFlag flag = chfcol[ich];
         flag.merge(chcol[ich].flag());
-        for(auto ish : shids[ich]) (*shfcol)[ish] = flag;
+        for(auto ish : shindex->strawHits(ich)) (*shfcol)[ish] = flag;
       }
 
       event.put(std::move(shfcol),"StrawHits");
@@ -261,8 +269,8 @@ namespace mu2e
     for (auto& cluster : bkgccol)
     {
       BkgQual cqual;
-      fillBkgQual(cluster, cqual, chcol);
-      fillMVA(cqual);
+      quality_.fillBkgQual(cluster, cqual, chcol);
+      quality_.fillMVA(cqual);
 
       StrawHitFlag flag(StrawHitFlag::bkgclust);
       if (cqual.MVAOutput() > bkgMVAcut_)
@@ -277,109 +285,6 @@ namespace mu2e
   }
 
 
-  //--------------------------------------------------------------------------------------------------------------
-  void FlagBkgHits::fillBkgQual(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const
-  {
-    unsigned nactive, nstereo;
-    countHits(cluster, nactive, nstereo,chcol);
-    cqual.setMVAStatus(MVAStatus::unset);
-
-    if (nactive < minnhits_) return;
-    countPlanes(cluster,cqual,chcol);
-
-    cqual[BkgQual::hrho]  = 0;
-    cqual[BkgQual::shrho] = 0;
-    cqual[BkgQual::nhits] = nactive;
-    cqual[BkgQual::sfrac] = static_cast<float>(nstereo)/nactive;
-    cqual[BkgQual::crho] = sqrtf(cluster.pos().perp2());
-
-    if (cqual[BkgQual::np] >= minnp_)
-    {
-      std::vector<float> hz;
-      for (const auto& chit : cluster.hits()) hz.push_back(chcol[chit].pos().z());
-
-      // find the min, max and largest gap from the sorted Z positions
-      std::sort(hz.begin(),hz.end());
-      float zgap = 0.0;
-      for (unsigned iz=1;iz<hz.size();++iz) zgap=std::max(zgap,hz[iz]-hz[iz-1]);
-      cqual[BkgQual::zmin] = hz.front();
-      cqual[BkgQual::zmax] = hz.back();
-      cqual[BkgQual::zgap] = zgap;
-
-      cqual.setMVAStatus(MVAStatus::filled);
-    }
-    else
-    {
-      cqual[BkgQual::zmin]  = -1.0;
-      cqual[BkgQual::zmax]  = -1.0;
-      cqual[BkgQual::zgap]  = -1.0;
-    }
-  }
-
-
-  //----------------------------------------------
-  void FlagBkgHits::fillMVA(BkgQual& cqual) const
-  {
-    if (cqual.status() == MVAStatus::unset) return;
-
-    std::vector<float> mvavars(7,0.0);
-    mvavars[0] = cqual.varValue(BkgQual::crho);
-    mvavars[1] = cqual.varValue(BkgQual::zmin);
-    mvavars[2] = cqual.varValue(BkgQual::zmax);
-    mvavars[3] = cqual.varValue(BkgQual::zgap);
-    mvavars[4] = cqual.varValue(BkgQual::np);
-    mvavars[5] = cqual.varValue(BkgQual::npfrac);
-    mvavars[6] = cqual.varValue(BkgQual::nhits);
-    float mvaout = bkgMVA_.evalMVA(mvavars);
-
-    cqual.setMVAValue(mvaout);
-    cqual.setMVAStatus(MVAStatus::calculated);
-  }
-
-
-
-  //-------------------------------------------------------------------------------------------------------------
-  void FlagBkgHits::countPlanes(const BkgCluster& cluster, BkgQual& cqual, const ComboHitCollection& chcol) const
-  {
-    std::array<int,StrawId::_nplanes> hitplanes{0};
-    for (const auto& chit : cluster.hits())
-    {
-      const ComboHit& ch = chcol[chit];
-      hitplanes[ch.strawId().plane()] += ch.nStrawHits();
-    }
-
-    unsigned ipmin(0),ipmax(StrawId::_nplanes-1);
-    while (hitplanes[ipmin]==0) ++ipmin;
-    while (hitplanes[ipmax]==0) --ipmax;
-
-    unsigned npexp(0),np(0),nphits(0);
-    for(unsigned ip = ipmin; ip <= ipmax; ++ip)
-    {
-      npexp++; // should use TTracker to see if plane is physically present FIXME!
-      if (hitplanes[ip]> 0)++np;
-      nphits += hitplanes[ip];
-    }
-
-    cqual[BkgQual::np]     = np;
-    cqual[BkgQual::npexp]  = npexp;
-    cqual[BkgQual::npfrac] = static_cast<float>(np)/static_cast<float>(npexp);
-    cqual[BkgQual::nphits] = static_cast<float>(nphits)/static_cast<float>(np);
-  }
-
-
-  //----------------------------------------------------------------------------------------------------------------------------------
-  void FlagBkgHits::countHits(const BkgCluster& cluster, unsigned& nactive, unsigned& nstereo, const ComboHitCollection& chcol) const
-  {
-    nactive = nstereo = 0;
-    for (const auto& chit : cluster.hits())
-    {
-      const ComboHit& ch = chcol[chit];
-      nactive += ch.nStrawHits();
-      if (ch.flag().hasAnyProperty(stereo_)) nstereo += ch.nStrawHits();
-    }
-  }
-
-
   //----------------------------------------------------------------------------------
   int FlagBkgHits::findClusterIdx(BkgClusterCollection& bkgccol, unsigned ich) const
   {
@@ -0,0 +1,101 @@
+//
+// Record the inputs of the reconstruction kernels (ComboHits, straw digi waveforms and calorimeter
+// digis) of a real job, to be replayed by the kernelBenchmark executable outside of art.  See
+// TrkHitReco/inc/KernelInputs.hh.  Leave a collection tag empty to skip it.  The conditions the
+// kernels need are recorded at the first run: the tracker straws with the ComboHits, the straw
+// response with the waveforms and the calorimeter pulse shape with the digis.
+//
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Principal/Run.h"
+#include "canvas/Utilities/InputTag.h"
+#include "fhiclcpp/types/Atom.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+#include "Offline/GeometryService/inc/GeomHandle.hh"
+#include "Offline/Mu2eUtilities/inc/CaloPulseShape.hh"
+#include "Offline/ProditionsService/inc/ProditionsHandle.hh"
+#include "Offline/TrackerGeom/inc/Tracker.hh"
+#include "Offline/TrkHitReco/inc/KernelInputs.hh"
+
+#include "TH1F.h"
+
+#include <memory>
+#include <string>
+
+namespace mu2e
+{
+
+  class KernelInputRecorder : public art::EDAnalyzer
+  {
+    public:
+
+      struct Config
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Atom<art::InputTag>  comboHitCollection{  Name("ComboHitCollection"),  Comment("ComboHits to record, empty to skip"),"" };
+        fhicl::Atom<art::InputTag>  strawWaveforms{      Name("StrawDigiADCWaveformCollection"), Comment("Straw digi waveforms to record, empty to skip"),"" };
+        fhicl::Atom<art::InputTag>  caloDigiCollection{  Name("CaloDigiCollection"),  Comment("Calorimeter digis to record, empty to skip"),"" };
+        fhicl::Atom<double>         caloDigiSampling{    Name("CaloDigiSampling"),    Comment("Calorimeter ADC sampling period (ns)") };
+        fhicl::Atom<std::string>    fileName{            Name("FileName"),            Comment("Output file") };
+        fhicl::Atom<int>            compressionSettings{ Name("CompressionSettings"), Comment("100*algorithm + level, as TFile::SetCompressionSettings"),505 };
+      };
+
+      explicit KernelInputRecorder(const art::EDAnalyzer::Table<Config>& config);
+      void beginRun(const art::Run& run) override;
+      void analyze(const art::Event& event) override;
+      void endJob() override;
+
+    private:
+      art::InputTag                      chTag_;
+      art::InputTag                      swTag_;
+      art::InputTag                      cdTag_;
+      std::string                        fileName_;
+      std::unique_ptr<KernelInputWriter> writer_;
+      ProditionsHandle<StrawResponse>    strawResponse_h_;
+      bool                               conditionsWritten_ = false;
+  };
+
+  KernelInputRecorder::KernelInputRecorder(const art::EDAnalyzer::Table<Config>& config) :
+    art::EDAnalyzer{config},
+    chTag_(   config().comboHitCollection()),
+    swTag_(   config().strawWaveforms()),
+    cdTag_(   config().caloDigiCollection()),
+    fileName_(config().fileName()),
+    writer_(  std::make_unique<KernelInputWriter>(fileName_,config().caloDigiSampling(),config().compressionSettings()))
+  {
+    if (!chTag_.empty()) consumes<ComboHitCollection>(chTag_);
+    if (!swTag_.empty()) consumes<StrawDigiADCWaveformCollection>(swTag_);
+    if (!cdTag_.empty()) consumes<CaloDigiCollection>(cdTag_);
+  }
+
+  // the replay has one set of conditions, those of the first run
+  void KernelInputRecorder::beginRun(const art::Run& run)
+  {
+    if (conditionsWritten_) return;
+    conditionsWritten_ = true;
+    if (!chTag_.empty()) writer_->writeStraws(GeomHandle<Tracker>()->straws());
+    if (!swTag_.empty()) writer_->writeStrawResponse(strawResponse_h_.get(run.id()));
+    if (!cdTag_.empty()) writer_->writeCaloPulseShape(*CaloPulseShape::pulseHistogram());
+  }
+
+  void KernelInputRecorder::analyze(const art::Event& event)
+  {
+    const ComboHitCollection* chcol = chTag_.empty() ? nullptr : event.getValidHandle<ComboHitCollection>(chTag_).product();
+    const StrawDigiADCWaveformCollection* swcol = swTag_.empty() ? nullptr : event.getValidHandle<StrawDigiADCWaveformCollection>(swTag_).product();
+    const CaloDigiCollection* cdcol = cdTag_.empty() ? nullptr : event.getValidHandle<CaloDigiCollection>(cdTag_).product();
+    writer_->write(event.run(),event.subRun(),event.event(),chcol,swcol,cdcol);
+  }
+
+  void KernelInputRecorder::endJob()
+  {
+    writer_->close();
+    mf::LogInfo("KernelInputRecorder") << "Recorded " << writer_->events() << " events in " << fileName_ << ": "
+                                       << writer_->storedBytes() << " bytes, " << writer_->rawBytes() << " uncompressed";
+  }
+
+}
+
+DEFINE_ART_MODULE(mu2e::KernelInputRecorder);
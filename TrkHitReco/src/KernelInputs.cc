@@ -0,0 +1,377 @@
+#include "Offline/TrkHitReco/inc/KernelInputs.hh"
+
+#include "cetlib_except/exception.h"
+
+#include "TH1.h"
+
+#include <limits>
+
+namespace mu2e {
+
+  namespace {
+    // bump when the tables change
+    const uint32_t kernelInputsVersion = 2;
+
+    const std::vector<std::string> comboHitFloats = {"x","y","z","wdirX","wdirY","wdirZ","sdirX","sdirY","sdirZ",
+                                                     "wres","tres","wdist","time","edep","qual","dtime","dtimeres",
+                                                     "totCal","totHV","ptime","pathlength","hphi","xyWeight","zphiWeight"};
+    const std::vector<std::string> comboHitInts   = {"flag","sid","maskLevel","tend","nCombo","nStrawHits"};
+    const std::vector<std::string> strawResponseDoubles = {"adcPeriod","adcLSB","analogNoiseThresh","analogNoiseADC",
+                                                           "currentToVoltageThresh","currentToVoltageADC",
+                                                           "saturationVoltage","adcPedestal","pmpEnergyScale"};
+    const std::vector<std::string> strawResponseInts    = {"maxADC","nADCPreSamples"};
+    // as in GeometrySnapshot
+    const std::vector<std::string> strawDoubles = {"wireX","wireY","wireZ","strawX","strawY","strawZ",
+                                                   "wireDirX","wireDirY","wireDirZ","strawDirX","strawDirY","strawDirZ",
+                                                   "halfLength"};
+
+    // StrawHitFlag has no access to its bits, go through the legal ones
+    const std::vector<StrawHitFlagDetail::bit_type>& flagBits()
+    {
+      static const std::vector<StrawHitFlagDetail::bit_type> bits = [](){
+        std::vector<StrawHitFlagDetail::bit_type> result;
+        for (const auto& nameMask : StrawHitFlagDetail::bitNames())
+          for (unsigned ibit=0; ibit<32; ++ibit)
+            if (nameMask.second == (1u<<ibit)) result.push_back(static_cast<StrawHitFlagDetail::bit_type>(ibit));
+        return result;
+      }();
+      return bits;
+    }
+
+    uint32_t packFlag(const StrawHitFlag& flag)
+    {
+      uint32_t packed(0);
+      for (auto bit : flagBits()) if (flag.hasAllProperties(StrawHitFlag(bit))) packed |= 1u<<bit;
+      return packed;
+    }
+
+    StrawHitFlag unpackFlag(uint32_t packed)
+    {
+      StrawHitFlag flag;
+      for (auto bit : flagBits()) if (packed & (1u<<bit)) flag.merge(bit);
+      return flag;
+    }
+
+    template<class T> std::vector<std::vector<T>> readColumns(const ColumnarReader& reader, const std::string& table,
+                                                              const std::vector<std::string>& names)
+    {
+      std::vector<std::vector<T>> columns;
+      for (const auto& name : names) columns.push_back(reader.column<T>(table,name));
+      return columns;
+    }
+  }
+
+  //================================================================
+  KernelInputWriter::KernelInputWriter(const std::string& filename, double caloDigiSampling, int compressionSettings) :
+    file_(filename,compressionSettings)
+  {
+    auto& setup = file_.addTable("setup");
+    setup.addColumn("version",          ColumnType::UInt32);
+    setup.addColumn("caloDigiSampling", ColumnType::Float64);
+    setup.fill<uint32_t>(0,kernelInputsVersion);
+    setup.fill<double>(1,caloDigiSampling);
+    setup.endRow();
+
+    events_ = &file_.addTable("events");
+    for (const auto& name : {"run","subRun","event","nComboHits","nStrawWaveforms","nCaloDigis"}) events_->addColumn(name,ColumnType::UInt32);
+
+    comboHits_ = &file_.addTable("comboHits");
+    for (const auto& name : comboHitFloats) comboHits_->addColumn(name,ColumnType::Float32);
+    for (const auto& name : comboHitInts)   comboHits_->addColumn(name,ColumnType::UInt32);
+
+    strawWaveforms_ = &file_.addTable("strawWaveforms");
+    strawWaveforms_->addColumn("nSamples",ColumnType::UInt32);
+
+    strawSamples_ = &file_.addTable("strawSamples");
+    strawSamples_->addColumn("adc",ColumnType::UInt32);
+
+    caloDigis_ = &file_.addTable("caloDigis");
+    for (const auto& name : {"SiPMID","t0","peakpos","nSamples"}) caloDigis_->addColumn(name,ColumnType::Int32);
+
+    caloSamples_ = &file_.addTable("caloSamples");
+    caloSamples_->addColumn("adc",ColumnType::Int32);
+
+    caloPulseAxis_ = &file_.addTable("caloPulseAxis");
+    caloPulseAxis_->addColumn("min",ColumnType::Float64);
+    caloPulseAxis_->addColumn("max",ColumnType::Float64);
+
+    caloPulseShape_ = &file_.addTable("caloPulseShape");
+    caloPulseShape_->addColumn("content",ColumnType::Float64);
+
+    strawResponse_ = &file_.addTable("strawResponse");
+    for (const auto& name : strawResponseDoubles) strawResponse_->addColumn(name,ColumnType::Float64);
+    for (const auto& name : strawResponseInts)    strawResponse_->addColumn(name,ColumnType::UInt32);
+
+    straws_ = &file_.addTable("straws");
+    straws_->addColumn("sid",ColumnType::UInt32);
+    for (const auto& name : strawDoubles) straws_->addColumn(name,ColumnType::Float64);
+  }
+
+  void KernelInputWriter::write(uint32_t run, uint32_t subRun, uint32_t event, const ComboHitCollection* comboHits,
+                                const StrawDigiADCWaveformCollection* strawWaveforms, const CaloDigiCollection* caloDigis)
+  {
+    const uint32_t nch = comboHits ? comboHits->size() : 0;
+    const uint32_t nsw = strawWaveforms ? strawWaveforms->size() : 0;
+    const uint32_t ncd = caloDigis ? caloDigis->size() : 0;
+    events_->fill<uint32_t>(0,run);
+    events_->fill<uint32_t>(1,subRun);
+    events_->fill<uint32_t>(2,event);
+    events_->fill<uint32_t>(3,nch);
+    events_->fill<uint32_t>(4,nsw);
+    events_->fill<uint32_t>(5,ncd);
+    events_->endRow();
+
+    for (uint32_t ich=0; ich<nch; ++ich)
+    {
+      const ComboHit& ch = (*comboHits)[ich];
+      const float floats[] = {ch._pos.x(), ch._pos.y(), ch._pos.z(), ch._wdir.x(), ch._wdir.y(), ch._wdir.z(),
+                              ch._sdir.x(), ch._sdir.y(), ch._sdir.z(), ch._wres, ch._tres, ch._wdist,
+                              ch._time, ch._edep, ch._qual, ch._dtime, ch._dtimeres,
+                              ch._tot[StrawEnd::cal], ch._tot[StrawEnd::hv], ch._ptime, ch._pathlength, ch._hphi,
+                              ch._xyWeight, ch._zphiWeight};
+      const uint32_t ints[] = {packFlag(ch._flag), ch._sid.asUint16(), static_cast<uint32_t>(ch._mask.level()),
+                               static_cast<uint32_t>(ch._tend.end()), ch._ncombo, ch._nsh};
+      std::size_t icol(0);
+      for (float value : floats)  comboHits_->fill<float>(icol++,value);
+      for (uint32_t value : ints) comboHits_->fill<uint32_t>(icol++,value);
+      comboHits_->endRow();
+    }
+
+    for (uint32_t isw=0; isw<nsw; ++isw)
+    {
+      const auto& adcs = (*strawWaveforms)[isw].samples();
+      strawWaveforms_->fill<uint32_t>(0,adcs.size());
+      strawWaveforms_->endRow();
+      for (auto adc : adcs)
+      {
+        strawSamples_->fill<uint32_t>(0,adc);
+        strawSamples_->endRow();
+      }
+    }
+
+    for (uint32_t icd=0; icd<ncd; ++icd)
+    {
+      const CaloDigi& digi = (*caloDigis)[icd];
+      caloDigis_->fill<int32_t>(0,digi.SiPMID());
+      caloDigis_->fill<int32_t>(1,digi.t0());
+      caloDigis_->fill<int32_t>(2,digi.peakpos());
+      caloDigis_->fill<int32_t>(3,digi.waveform().size());
+      caloDigis_->endRow();
+      for (int adc : digi.waveform())
+      {
+        caloSamples_->fill<int32_t>(0,adc);
+        caloSamples_->endRow();
+      }
+    }
+  }
+
+  void KernelInputWriter::writeCaloPulseShape(const TH1& pulseShape)
+  {
+    caloPulseAxis_->fill<double>(0,pulseShape.GetXaxis()->GetXmin());
+    caloPulseAxis_->fill<double>(1,pulseShape.GetXaxis()->GetXmax());
+    caloPulseAxis_->endRow();
+    for (int ibin=1; ibin<=pulseShape.GetNbinsX(); ++ibin)
+    {
+      caloPulseShape_->fill<double>(0,pulseShape.GetBinContent(ibin));
+      caloPulseShape_->endRow();
+    }
+  }
+
+  void KernelInputWriter::writeStrawResponse(const StrawResponse& srep)
+  {
+    const double doubles[] = {srep.adcPeriod(), srep.adcLSB(),
+                              srep.analogNoise(StrawElectronics::thresh), srep.analogNoise(StrawElectronics::adc),
+                              srep.currentToVoltage(StrawElectronics::thresh), srep.currentToVoltage(StrawElectronics::adc),
+                              srep.saturatedResponse(std::numeric_limits<double>::max()), srep.ADCPedestal(),
+                              srep.peakMinusPedestalEnergyScale()};
+    std::size_t icol(0);
+    for (double value : doubles) strawResponse_->fill<double>(icol++,value);
+    strawResponse_->fill<uint32_t>(icol++,srep.maxADC());
+    strawResponse_->fill<uint32_t>(icol++,srep.nADCPreSamples());
+    strawResponse_->endRow();
+  }
+
+  void KernelInputWriter::writeStraws(const GeometrySnapshot::StrawCollection& straws)
+  {
+    for (const auto& straw : straws)
+    {
+      straws_->fill<uint32_t>(0,straw.id().asUint16());
+      std::size_t icol(1);
+      for (const auto& v : {straw.wirePosition(), straw.strawPosition(), straw.wireDirection(), straw.strawDirection()})
+      {
+        straws_->fill<double>(icol++,v.x());
+        straws_->fill<double>(icol++,v.y());
+        straws_->fill<double>(icol++,v.z());
+      }
+      straws_->fill<double>(icol,straw.halfLength());
+      straws_->endRow();
+    }
+  }
+
+  void KernelInputWriter::close()
+  {
+    file_.close();
+  }
+
+  //================================================================
+  KernelInputs readKernelInputs(const std::string& filename)
+  {
+    ColumnarReader reader(filename);
+    KernelInputs inputs;
+
+    auto version = reader.column<uint32_t>("setup","version");
+    if (version.size() != 1 || version[0] != kernelInputsVersion)
+      throw cet::exception("KERNELINPUTS") << "readKernelInputs: " << filename << " has version "
+                                           << (version.empty() ? 0 : version[0]) << ", expected " << kernelInputsVersion << "\n";
+    inputs.caloDigiSampling = reader.column<double>("setup","caloDigiSampling").at(0);
+
+    if (reader.rows("caloPulseAxis") == 1)
+    {
+      inputs.caloPulseMin   = reader.column<double>("caloPulseAxis","min")[0];
+      inputs.caloPulseMax   = reader.column<double>("caloPulseAxis","max")[0];
+      inputs.caloPulseShape = reader.column<double>("caloPulseShape","content");
+    }
+
+    if (reader.rows("strawResponse") == 1)
+    {
+      auto d = readColumns<double>  (reader,"strawResponse",strawResponseDoubles);
+      auto i = readColumns<uint32_t>(reader,"strawResponse",strawResponseInts);
+      auto& srep = *(inputs.strawResponse = std::make_unique<RecordedStrawResponse>());
+      srep.adcPeriod         = d[0][0];
+      srep.adcLSB            = d[1][0];
+      srep.analogNoise       = {d[2][0], d[3][0]};
+      srep.currentToVoltage  = {d[4][0], d[5][0]};
+      srep.saturationVoltage = d[6][0];
+      srep.adcPedestal       = d[7][0];
+      srep.pmpEnergyScale    = d[8][0];
+      srep.maxADC            = i[0][0];
+      srep.nADCPreSamples    = i[1][0];
+    }
+
+    if (reader.rows("straws") > 0)
+    {
+      auto sids = reader.column<uint32_t>("straws","sid");
+      auto d    = readColumns<double>(reader,"straws",strawDoubles);
+      inputs.straws = std::make_unique<GeometrySnapshot::StrawCollection>();
+      if (sids.size() != inputs.straws->size())
+        throw cet::exception("KERNELINPUTS") << "readKernelInputs: " << filename << " has " << sids.size()
+                                             << " straws, expected " << inputs.straws->size() << "\n";
+      for (std::size_t is=0; is<sids.size(); ++is)
+      {
+        auto v = [&](std::size_t icol) { return CLHEP::Hep3Vector(d[icol][is],d[icol+1][is],d[icol+2][is]); };
+        (*inputs.straws)[is] = Straw(StrawId(static_cast<uint16_t>(sids[is])),v(0),v(3),v(6),v(9),d[12][is]);
+      }
+    }
+
+    auto eventInts = readColumns<uint32_t>(reader,"events",{"run","subRun","event","nComboHits","nStrawWaveforms","nCaloDigis"});
+    auto chFloats  = readColumns<float>   (reader,"comboHits",comboHitFloats);
+    auto chInts    = readColumns<uint32_t>(reader,"comboHits",comboHitInts);
+    auto swInts    = reader.column<uint32_t>("strawWaveforms","nSamples");
+    auto swAdcs    = reader.column<uint32_t>("strawSamples","adc");
+    auto cdInts    = readColumns<int32_t> (reader,"caloDigis",{"SiPMID","t0","peakpos","nSamples"});
+    auto adcs      = reader.column<int32_t>("caloSamples","adc");
+
+    std::size_t ich(0), isw(0), iswsample(0), icd(0), isample(0);
+    inputs.events.resize(eventInts[0].size());
+    for (std::size_t iev=0; iev<inputs.events.size(); ++iev)
+    {
+      RecordedEvent& event = inputs.events[iev];
+      event.run    = eventInts[0][iev];
+      event.subRun = eventInts[1][iev];
+      event.event  = eventInts[2][iev];
+      const uint32_t nch(eventInts[3][iev]), nsw(eventInts[4][iev]), ncd(eventInts[5][iev]);
+      if (ich+nch > reader.rows("comboHits") || isw+nsw > swInts.size() || icd+ncd > reader.rows("caloDigis"))
+        throw cet::exception("KERNELINPUTS") << "readKernelInputs: " << filename << " is inconsistent at event " << iev << "\n";
+
+      event.comboHits.reserve(nch);
+      for (uint32_t i=0; i<nch; ++i, ++ich)
+      {
+        ComboHit ch;
+        auto f = [&](std::size_t icol) { return chFloats[icol][ich]; };
+        ch._pos.SetXYZ(f(0),f(1),f(2));
+        ch._wdir.SetXYZ(f(3),f(4),f(5));
+        ch._sdir.SetXYZ(f(6),f(7),f(8));
+        ch._wres       = f(9);
+        ch._tres       = f(10);
+        ch._wdist      = f(11);
+        ch._time       = f(12);
+        ch._edep       = f(13);
+        ch._qual       = f(14);
+        ch._dtime      = f(15);
+        ch._dtimeres   = f(16);
+        ch._tot[StrawEnd::cal] = f(17);
+        ch._tot[StrawEnd::hv]  = f(18);
+        ch._ptime      = f(19);
+        ch._pathlength = f(20);
+        ch._hphi       = f(21);
+        ch._xyWeight   = f(22);
+        ch._zphiWeight = f(23);
+        ch._flag   = unpackFlag(chInts[0][ich]);
+        ch._sid    = StrawId(static_cast<uint16_t>(chInts[1][ich]));
+        ch._mask   = StrawIdMask(static_cast<StrawIdMask::Level>(static_cast<int32_t>(chInts[2][ich])));
+        ch._tend   = StrawEnd(static_cast<StrawEnd::End>(chInts[3][ich]));
+        ch._ncombo = chInts[4][ich];
+        ch._nsh    = chInts[5][ich];
+        event.comboHits.push_back(ch);
+      }
+
+      event.strawWaveforms.reserve(nsw);
+      for (uint32_t i=0; i<nsw; ++i, ++isw)
+      {
+        const std::size_t nsamples = swInts[isw];
+        if (iswsample+nsamples > swAdcs.size())
+          throw cet::exception("KERNELINPUTS") << "readKernelInputs: " << filename << " is missing straw samples\n";
+        TrkTypes::ADCWaveform waveform(swAdcs.begin()+iswsample, swAdcs.begin()+iswsample+nsamples);
+        iswsample += nsamples;
+        event.strawWaveforms.emplace_back(waveform);
+      }
+
+      event.caloDigis.reserve(ncd);
+      for (uint32_t i=0; i<ncd; ++i, ++icd)
+      {
+        const std::size_t nsamples = cdInts[3][icd];
+        if (isample+nsamples > adcs.size())
+          throw cet::exception("KERNELINPUTS") << "readKernelInputs: " << filename << " is missing calorimeter samples\n";
+        std::vector<int> waveform(adcs.begin()+isample, adcs.begin()+isample+nsamples);
+        isample += nsamples;
+        event.caloDigis.emplace_back(cdInts[0][icd],cdInts[1][icd],waveform,cdInts[2][icd]);
+      }
+    }
+    return inputs;
+  }
+
+  //================================================================
+  // StrawElectronics and StrawResponse are built by their makers from fcl or the database, with
+  // the tracker geometry; here only the members read by PeakFit, PeakFitFunction and
+  // PeakFitTemplate are set, the others are zero or empty
+  StrawResponse::cptr_t makeStrawResponse(const RecordedStrawResponse& r)
+  {
+    auto electronics = std::make_shared<StrawElectronics>(false, 0.0, 0.0, r.saturationVoltage, 0.0, r.adcLSB,
+        r.maxADC, 0, r.nADCPreSamples, r.adcPeriod, 0.0, 0, 0.0, 0, 0.0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0, 0.0, 0,
+        std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{},
+        std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{},
+        std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{},
+        0.0, 0.0, 0.0, 0.0, 0.0, 0.0);
+    std::array<double,StrawId::_nustraws> pmpEnergyScale;
+    pmpEnergyScale.fill(r.pmpEnergyScale);
+    std::array<double,StrawId::_nustraws> strawHalfvp{};
+    return std::make_shared<StrawResponse>(nullptr, electronics, nullptr,
+        0, 0.0, std::vector<double>{}, std::vector<double>{}, 0.0, std::vector<double>{}, std::vector<double>{},
+        false, false, 0, 0.0, 0, 0.0, std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, false,
+        std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{}, std::vector<double>{},
+        0.0, false, 0.0, 0.0, 0.0, false, 0.0,
+        pmpEnergyScale, 0.0, 0.0, r.analogNoise, r.currentToVoltage, r.saturationVoltage, r.adcPedestal,
+        r.pmpEnergyScale, strawHalfvp, false, false, std::array<double,3>{});
+  }
+
+  //================================================================
+  // the Tracker maker also sets the straw dimensions and the G4 volumes, which the
+  // reconstruction kernels do not use: they are left zero and null
+  std::unique_ptr<Tracker> makeTracker(const GeometrySnapshot::StrawCollection& straws)
+  {
+    Tracker::PEType planesExist;
+    planesExist.fill(true);
+    return std::make_unique<Tracker>(straws, StrawProperties{}, nullptr, planesExist);
+  }
+
+}
@@ -0,0 +1,61 @@
+//
+// Build the flattened StrawHit/StrawDigi index of a ComboHitCollection once per event, so that
+// downstream modules (background flagging, truth matching, diagnostics) look the straw hits of
+// a ComboHit up as an array slice instead of recursing through the parent collections.
+//
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "canvas/Utilities/InputTag.h"
+#include "fhiclcpp/types/Atom.h"
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitStrawIndex.hh"
+
+#include <iostream>
+
+namespace mu2e
+{
+
+  class MakeComboHitStrawIndex : public art::EDProducer
+  {
+    public:
+
+      struct Config
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Atom<art::InputTag>            comboHitCollection{   Name("ComboHitCollection"),   Comment("ComboHit collection name") };
+        fhicl::Atom<int>                      debugLevel{           Name("DebugLevel"),           Comment("Debug"),0 };
+      };
+
+      explicit MakeComboHitStrawIndex(const art::EDProducer::Table<Config>& config);
+      void produce(art::Event& event) override;
+
+    private:
+      const art::ProductToken<ComboHitCollection>     chtoken_;
+      int const                                       debug_;
+  };
+
+  MakeComboHitStrawIndex::MakeComboHitStrawIndex(const art::EDProducer::Table<Config>& config) :
+    EDProducer{config},
+    chtoken_{  consumes<ComboHitCollection>(config().comboHitCollection()) },
+    debug_(    config().debugLevel())
+  {
+    // the parent collections are found with getMany
+    consumesMany<ComboHitCollection>();
+    produces<ComboHitStrawIndex>();
+  }
+
+  void MakeComboHitStrawIndex::produce(art::Event& event)
+  {
+    auto chH = event.getValidHandle(chtoken_);
+    auto index = std::make_unique<ComboHitStrawIndex>(event, *chH, chH.id());
+    if (debug_ > 0)
+      std::cout << "MakeComboHitStrawIndex: " << index->nHits() << " ComboHits, "
+                << index->nStrawHits() << " StrawHits" << std::endl;
+    event.put(std::move(index));
+  }
+}
+
+DEFINE_ART_MODULE(mu2e::MakeComboHitStrawIndex);
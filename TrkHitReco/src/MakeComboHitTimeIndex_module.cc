@@ -0,0 +1,94 @@
+//
+// Build the time index of a flagged ComboHitCollection, once per event, for the time
+// cluster finders (TimeClusterFinder, TimeAndPhiClusterFinder, CalTimePeakFinder,
+// TZClusterFinder).  One time-sorted list is made for every requested hit selection, plus
+// one for all the hits.
+//
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Core/EDProducer.h"
+#include "canvas/Utilities/InputTag.h"
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
+
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
+#include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mu2e
+{
+
+  class MakeComboHitTimeIndex : public art::EDProducer
+  {
+    public:
+
+      struct Selection
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Sequence<std::string>          hsel{                 Name("HitSelectionBits"),     Comment("HitSelectionBits") };
+        fhicl::Sequence<std::string>          hbkg{                 Name("HitBackgroundBits"),    Comment("HitBackgroundBits") };
+      };
+
+      struct Config
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Atom<art::InputTag>            comboHitCollection{   Name("ComboHitCollection"),   Comment("ComboHit collection name") };
+        fhicl::Atom<art::InputTag>            strawHitFlagCollection{ Name("StrawHitFlagCollection"), Comment("StrawHitFlag collection name") };
+        fhicl::Sequence<fhicl::Table<Selection>> selections{        Name("Selections"),           Comment("Hit selections to index") };
+        fhicl::Atom<int>                      debugLevel{           Name("DebugLevel"),           Comment("Debug"),0 };
+      };
+
+      explicit MakeComboHitTimeIndex(const art::EDProducer::Table<Config>& config);
+      void produce(art::Event& event) override;
+
+    private:
+      const art::ProductToken<ComboHitCollection>     chtoken_;
+      const art::ProductToken<StrawHitFlagCollection> shftoken_;
+      std::vector<StrawHitFlag>                       hsel_, hbkg_;
+      int const                                       debug_;
+  };
+
+  MakeComboHitTimeIndex::MakeComboHitTimeIndex(const art::EDProducer::Table<Config>& config) :
+    EDProducer{config},
+    chtoken_{  consumes<ComboHitCollection>(config().comboHitCollection()) },
+    shftoken_{ consumes<StrawHitFlagCollection>(config().strawHitFlagCollection()) },
+    debug_(    config().debugLevel())
+  {
+    // the unselected list comes first
+    hsel_.emplace_back();
+    hbkg_.emplace_back();
+    for (const auto& sel : config().selections()) {
+      hsel_.emplace_back(sel.hsel());
+      hbkg_.emplace_back(sel.hbkg());
+    }
+    produces<ComboHitTimeIndex>();
+  }
+
+  void MakeComboHitTimeIndex::produce(art::Event& event)
+  {
+    const auto& chcol  = *event.getValidHandle(chtoken_);
+    const auto& shfcol = *event.getValidHandle(shftoken_);
+    if (shfcol.size() != chcol.size())
+      throw cet::exception("RECO")<<"MakeComboHitTimeIndex: inconsistent flag collection length " << std::endl;
+
+    auto index = std::make_unique<ComboHitTimeIndex>(chcol, &shfcol, hsel_, hbkg_);
+    if (debug_ > 0) {
+      for (unsigned isel=0; isel<index->nSelections(); ++isel) {
+        auto range = index->range(isel);
+        std::cout << "MakeComboHitTimeIndex selection " << isel << " : " << range.second-range.first
+                  << " hits, " << index->nStrawHits(range) << " straw hits" << std::endl;
+      }
+    }
+    event.put(std::move(index));
+  }
+}
+
+DEFINE_ART_MODULE(mu2e::MakeComboHitTimeIndex);
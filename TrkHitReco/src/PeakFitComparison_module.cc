@@ -0,0 +1,163 @@
+//
+// Compare the template waveform fit (PeakFitTemplate) with the ROOT TF1 fit (PeakFitRoot) on
+// the digi waveforms of a job: both fitters are built from the same PeakFit configuration, and
+// every waveform is fit by both.  Histograms the charge, time and chisquared differences and the
+// time per fit, and prints the mean times, the speedup and the residuals at endJob.
+//
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Run.h"
+#include "art_root_io/TFileService.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/DelegatedParameter.h"
+
+#include "Offline/ProditionsService/inc/ProditionsHandle.hh"
+#include "Offline/RecoDataProducts/inc/StrawDigi.hh"
+#include "Offline/TrackerConditions/inc/StrawResponse.hh"
+#include "Offline/TrkHitReco/inc/PeakFitRoot.hh"
+#include "Offline/TrkHitReco/inc/PeakFitTemplate.hh"
+
+#include "TH1F.h"
+#include "TH2F.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+
+namespace mu2e
+{
+
+  class PeakFitComparison : public art::EDAnalyzer
+  {
+    public:
+
+      struct Config
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Atom<art::InputTag>      sdadcTag{ Name("StrawDigiADCWaveformCollectionTag"), Comment("StrawDigiADCWaveformCollection producer") };
+        fhicl::DelegatedParameter       peakFit{  Name("PeakFit"),                           Comment("Configuration of both fits") };
+        fhicl::Atom<unsigned>           maxFits{  Name("MaxFits"),                           Comment("Stop fitting after this many waveforms, 0 for all"),0 };
+        fhicl::Atom<int>                diag{     Name("diagLevel"),                         Comment("Print the fits of each waveform if > 0"),0 };
+      };
+
+      explicit PeakFitComparison(const art::EDAnalyzer::Table<Config>& config);
+      void beginJob() override;
+      void beginRun(const art::Run& run) override;
+      void analyze(const art::Event& event) override;
+      void endJob() override;
+
+    private:
+      art::ProductToken<StrawDigiADCWaveformCollection> sdadcToken_;
+      fhicl::ParameterSet                               pfitConfig_;
+      unsigned                                          maxFits_;
+      int                                               diag_;
+
+      ProditionsHandle<StrawResponse>                   strawResponse_h_;
+      const StrawResponse*                              srep_ = nullptr;
+      std::unique_ptr<TrkHitReco::PeakFitRoot>          rootFit_;
+      std::unique_ptr<TrkHitReco::PeakFitTemplate>      templateFit_;
+
+      unsigned  nfits_ = 0, nbothOK_ = 0;
+      double    rootus_ = 0, templateus_ = 0;
+      double    sumdq_ = 0, sumdq2_ = 0, sumdt_ = 0, sumdt2_ = 0;
+      unsigned  nbetter_ = 0;
+
+      TH1F *dq_, *dt_, *dchi2_, *rootTime_, *templateTime_, *status_;
+      TH2F *qq_;
+  };
+
+  PeakFitComparison::PeakFitComparison(const art::EDAnalyzer::Table<Config>& config) :
+    art::EDAnalyzer{config},
+    sdadcToken_{consumes<StrawDigiADCWaveformCollection>(config().sdadcTag())},
+    pfitConfig_(config().peakFit.get<fhicl::ParameterSet>()),
+    maxFits_(config().maxFits()),
+    diag_(config().diag())
+  {}
+
+  void PeakFitComparison::beginJob()
+  {
+    art::ServiceHandle<art::TFileService> tfs;
+    dq_           = tfs->make<TH1F>("dq",          "Template - ROOT charge;#Delta Q",200,-0.5,0.5);
+    dt_           = tfs->make<TH1F>("dt",          "Template - ROOT time;#Delta t (ns)",200,-10.0,10.0);
+    dchi2_        = tfs->make<TH1F>("dchi2",       "Template - ROOT #chi^{2};#Delta#chi^{2}",200,-10.0,10.0);
+    rootTime_     = tfs->make<TH1F>("rootTime",    "ROOT fit time;#mus",200,0.0,2000.0);
+    templateTime_ = tfs->make<TH1F>("templateTime","Template fit time;#mus",200,0.0,500.0);
+    status_       = tfs->make<TH1F>("status",      "Fit status, ROOT + 10*template",40,-20.5,19.5);
+    qq_           = tfs->make<TH2F>("qq",          "Fit charge;ROOT;Template",100,0.0,10.0,100,0.0,10.0);
+  }
+
+  void PeakFitComparison::beginRun(const art::Run& run)
+  {
+    // both fitters sample the response, rebuild them when it changes
+    auto const& srep = strawResponse_h_.get(run.id());
+    if (srep_ == &srep) return;
+    srep_        = &srep;
+    rootFit_     = std::make_unique<TrkHitReco::PeakFitRoot>(srep,pfitConfig_);
+    templateFit_ = std::make_unique<TrkHitReco::PeakFitTemplate>(srep,pfitConfig_);
+  }
+
+  void PeakFitComparison::analyze(const art::Event& event)
+  {
+    auto const& sdadccol = *event.getValidHandle(sdadcToken_);
+    for (auto const& wf : sdadccol)
+    {
+      if (maxFits_ > 0 && nfits_ >= maxFits_) return;
+      auto const& adc = wf.samples();
+      if (adc.size() > TrkHitReco::PeakFitTemplate::maxSamples) continue;
+
+      TrkHitReco::PeakFitParams rootParams, templateParams;
+      auto start = std::chrono::steady_clock::now();
+      rootFit_->process(adc,rootParams);
+      auto middle = std::chrono::steady_clock::now();
+      templateFit_->process(adc,templateParams);
+      auto end = std::chrono::steady_clock::now();
+      const double rootus     = std::chrono::duration<double,std::micro>(middle-start).count();
+      const double templateus = std::chrono::duration<double,std::micro>(end-middle).count();
+      ++nfits_;
+      rootus_     += rootus;
+      templateus_ += templateus;
+      rootTime_->Fill(rootus);
+      templateTime_->Fill(templateus);
+      status_->Fill(rootParams._status + 10*templateParams._status);
+      if (diag_ > 0) std::cout << "PeakFitComparison ROOT Q = " << rootParams._charge << " t = " << rootParams._time
+                               << " chi2 = " << rootParams._chi2 << " template Q = " << templateParams._charge
+                               << " t = " << templateParams._time << " chi2 = " << templateParams._chi2 << std::endl;
+
+      // PeakFitRoot reports the TFitResult status, 0 for success
+      if (rootParams._status != 0 || templateParams._status < 0) continue;
+      ++nbothOK_;
+      const double dq = templateParams._charge - rootParams._charge;
+      const double dt = templateParams._time - rootParams._time;
+      const double dchi2 = templateParams._chi2 - rootParams._chi2;
+      sumdq_ += dq; sumdq2_ += dq*dq;
+      sumdt_ += dt; sumdt2_ += dt*dt;
+      if (dchi2 < 0.0) ++nbetter_;
+      dq_->Fill(dq);
+      dt_->Fill(dt);
+      dchi2_->Fill(dchi2);
+      qq_->Fill(rootParams._charge,templateParams._charge);
+    }
+  }
+
+  void PeakFitComparison::endJob()
+  {
+    if (nfits_ == 0)
+    {
+      std::cout << "PeakFitComparison: no waveforms fit" << std::endl;
+      return;
+    }
+    std::cout << "PeakFitComparison: " << nfits_ << " waveforms, ROOT fit " << rootus_/nfits_ << " us, template fit "
+              << templateus_/nfits_ << " us per waveform, speedup " << (templateus_ > 0.0 ? rootus_/templateus_ : 0.0) << std::endl;
+    if (nbothOK_ == 0) return;
+    const double mdq = sumdq_/nbothOK_, mdt = sumdt_/nbothOK_;
+    std::cout << "PeakFitComparison: " << nbothOK_ << " waveforms fit by both, template - ROOT charge " << mdq
+              << " rms " << std::sqrt(std::max(0.0,sumdq2_/nbothOK_-mdq*mdq)) << ", time " << mdt << " rms "
+              << std::sqrt(std::max(0.0,sumdt2_/nbothOK_-mdt*mdt)) << " ns, template chisquared lower for "
+              << nbetter_ << std::endl;
+  }
+}
+
+DEFINE_ART_MODULE(mu2e::PeakFitComparison);
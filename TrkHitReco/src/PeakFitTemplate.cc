@@ -0,0 +1,367 @@
+// fit waveform with a sampled pulse template, without ROOT
+#include "Offline/TrkHitReco/inc/PeakFitTemplate.hh"
+#include "Offline/TrkHitReco/inc/PeakFitFunction.hh"
+#include "cetlib_except/exception.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+namespace mu2e {
+
+  namespace TrkHitReco {
+
+    namespace {
+      // solve the symmetric positive definite n x n system a x = b by Cholesky decomposition,
+      // using the lower triangle of a; the solution replaces b.  Returns false if a is not positive definite
+      template<size_t N> bool choleskySolve(double a[N][N], double b[N], size_t n)
+      {
+        for (size_t j=0;j<n;++j)
+        {
+          double d = a[j][j];
+          for (size_t k=0;k<j;++k) d -= a[j][k]*a[j][k];
+          if (d <= 0.0) return false;
+          a[j][j] = std::sqrt(d);
+          for (size_t i=j+1;i<n;++i)
+          {
+            double s = a[i][j];
+            for (size_t k=0;k<j;++k) s -= a[i][k]*a[j][k];
+            a[i][j] = s/a[j][j];
+          }
+        }
+        for (size_t i=0;i<n;++i)
+        {
+          double s = b[i];
+          for (size_t k=0;k<i;++k) s -= a[i][k]*b[k];
+          b[i] = s/a[i][i];
+        }
+        for (size_t i=n;i-->0;)
+        {
+          double s = b[i];
+          for (size_t k=i+1;k<n;++k) s -= a[k][i]*b[k];
+          b[i] = s/a[i][i];
+        }
+        return true;
+      }
+    }
+
+    PeakFitTemplate::PeakFitTemplate(const StrawResponse& srep, const fhicl::ParameterSet& pset) :
+      PeakFit(srep,pset),
+      _truncateADC(pset.get<bool>(      "TruncateADC",true)),
+      _floatPedestal(pset.get<bool>(    "FloatPedestal",true)),
+      _floatWidth(pset.get<bool>(       "FloatWidth",true)),
+      _earlyPeak(pset.get<bool>(        "EarlyPeak",false)),
+      _latePeak(pset.get<bool>(         "LatePeak",false)),
+      _maxIter(pset.get<unsigned>(      "MaxNewtonIterations",20)),
+      _tolerance(pset.get<double>(      "NewtonTolerance",0.01)),
+      _scanStep(pset.get<double>(       "ScanStep",4.0)),
+      _widthScanStep(pset.get<double>(  "WidthScanStep",4.0)),
+      _debug(pset.get<int>(             "debugLevel",0)),
+      _period(srep.adcPeriod()),
+      _dt(pset.get<double>(             "TemplateTimeStep",0.1)),
+      _dw(pset.get<double>(             "TemplateWidthStep",0.5))
+    {
+      if (_dt <= 0.0 || _dw <= 0.0 || _scanStep <= 0.0 || _widthScanStep <= 0.0)
+        throw cet::exception("RECO")<<"PeakFitTemplate: template and scan steps must be positive" << std::endl;
+
+      const double pednoise = srep.analogNoise(StrawElectronics::adc)/srep.adcLSB();
+      _invsigma2 = 1.0/(pednoise*pednoise);
+      // as PeakFitFunction::truncateResponse
+      _saturation = std::min(srep.saturatedResponse(std::numeric_limits<double>::max())/srep.adcLSB() + srep.ADCPedestal(),
+                             double(srep.maxADC()));
+
+      // parameter limits as in PeakFitFunction::createTF1; fixed parameters have equal limits
+      const double ped = srep.ADCPedestal();
+      _ampmin[pedestalAmp] = _floatPedestal ? std::max(0.0,ped-5.0*pednoise) : ped;
+      _ampmax[pedestalAmp] = _floatPedestal ? ped+5.0*pednoise : ped;
+      _ampmin[mainAmp]     = 0.0;  _ampmax[mainAmp]  = 10.0;
+      _ampmin[earlyAmp]    = 0.0;  _ampmax[earlyAmp] = _earlyPeak ? 1.0 : 0.0;
+      _ampmin[lateAmp]     = 0.0;  _ampmax[lateAmp]  = _latePeak ? 10.0 : 0.0;
+      _parmin[peakTime]    = 0.0;  _parmax[peakTime] = 80.0;
+      _parmin[peakWidth]   = 0.0;  _parmax[peakWidth] = _floatWidth ? 30.0 : 0.0;
+      _parmin[lateDelay]   = _latePeak ? 20.0 : 0.0; _parmax[lateDelay] = _latePeak ? 70.0 : 0.0;
+      for (size_t ipar=0;ipar<nNonlinear;++ipar) _dpar[ipar] = 0.05;
+
+      // sample the model once
+      PeakFitFunction shape(srep);
+      _tmin = -_parmax[peakWidth];
+      const double tmax = maxSamples*_period - _parmin[peakTime];
+      _nt = size_t(std::ceil((tmax-_tmin)/_dt)) + 2;
+      _nw = _floatWidth ? size_t(std::ceil(_parmax[peakWidth]/_dw)) + 2 : 1;
+      _template.resize(_nw*_nt);
+      for (size_t iw=0;iw<_nw;++iw)
+        for (size_t it=0;it<_nt;++it)
+        {
+          const double t = _tmin + it*_dt;
+          _template[iw*_nt+it] = (iw == 0) ? shape.unConvolvedSinglePeak(t) : shape.convolvedSinglePeak(t,iw*_dw);
+        }
+      for (size_t i=0;i<maxSamples;++i) _earlyShape[i] = shape.earlyPeak(i*_period,1.0);
+
+      if (_debug>0) std::cout << "PeakFitTemplate: " << _nw << " x " << _nt << " template, saturation at "
+                              << _saturation << " ADC" << std::endl;
+    }
+
+    double PeakFitTemplate::pulse(double t, double width) const
+    {
+      const double ft = (t-_tmin)/_dt;
+      if (ft <= 0.0) return 0.0;
+      const size_t it = std::min(size_t(ft),_nt-2);
+      const double ut = std::min(ft-it,1.0);
+      if (_nw == 1) return _template[it] + ut*(_template[it+1]-_template[it]);
+
+      const double fw = std::max(width,0.0)/_dw;
+      const size_t iw = std::min(size_t(fw),_nw-2);
+      const double uw = std::min(fw-iw,1.0);
+      const float* r0 = &_template[iw*_nt];
+      const float* r1 = r0 + _nt;
+      const double v0 = r0[it] + ut*(r0[it+1]-r0[it]);
+      const double v1 = r1[it] + ut*(r1[it+1]-r1[it]);
+      return v0 + uw*(v1-v0);
+    }
+
+    double PeakFitTemplate::profile(Data const& data, const double par[nNonlinear], double amp[nAmplitudes]) const
+    {
+      Samples basis[nAmplitudes];
+      for (size_t i=0;i<data.n;++i)
+      {
+        const double t = i*_period;
+        basis[pedestalAmp][i] = 1.0;
+        basis[mainAmp][i]     = pulse(t-par[peakTime],par[peakWidth]);
+        basis[earlyAmp][i]    = _earlyPeak ? _earlyShape[i] : 0.0;
+        basis[lateAmp][i]     = _latePeak ? pulse(t-par[peakTime]-par[lateDelay],par[peakWidth]) : 0.0;
+      }
+
+      // bounded linear least squares by active set: solve for the free amplitudes, fix the one
+      // furthest outside its limits at the limit, and repeat
+      bool fixed[nAmplitudes];
+      for (size_t k=0;k<nAmplitudes;++k)
+      {
+        fixed[k] = !(_ampmax[k] > _ampmin[k]);
+        amp[k]   = _ampmin[k];
+      }
+      for (size_t ipass=0;ipass<nAmplitudes;++ipass)
+      {
+        size_t idx[nAmplitudes], m(0);
+        for (size_t k=0;k<nAmplitudes;++k) if (!fixed[k]) idx[m++] = k;
+        if (m == 0) break;
+
+        double a[nAmplitudes][nAmplitudes] = {}, b[nAmplitudes] = {}, diag[nAmplitudes];
+        for (size_t i=0;i<data.n;++i)
+        {
+          if (data.use[i] == 0.0) continue;
+          double r = data.y[i];
+          for (size_t k=0;k<nAmplitudes;++k) if (fixed[k]) r -= amp[k]*basis[k][i];
+          for (size_t p=0;p<m;++p)
+          {
+            b[p] += basis[idx[p]][i]*r;
+            for (size_t q=0;q<=p;++q) a[p][q] += basis[idx[p]][i]*basis[idx[q]][i];
+          }
+        }
+        for (size_t p=0;p<m;++p) diag[p] = a[p][p];
+        if (!choleskySolve<nAmplitudes>(a,b,m))
+        {
+          // degenerate, eg the pulse is outside the waveform: drop the weakest component
+          const size_t k = idx[std::min_element(diag,diag+m) - diag];
+          fixed[k] = true;
+          amp[k] = _ampmin[k];
+          continue;
+        }
+
+        double worst(0.0);
+        size_t kworst(nAmplitudes);
+        for (size_t p=0;p<m;++p)
+        {
+          const size_t k = idx[p];
+          amp[k] = b[p];
+          const double violation = std::max(_ampmin[k]-b[p],b[p]-_ampmax[k]);
+          if (violation > worst) { worst = violation; kworst = k; }
+        }
+        if (kworst == nAmplitudes) break;
+        fixed[kworst] = true;
+        amp[kworst] = std::min(std::max(amp[kworst],_ampmin[kworst]),_ampmax[kworst]);
+      }
+      for (size_t k=0;k<nAmplitudes;++k) amp[k] = std::min(std::max(amp[k],_ampmin[k]),_ampmax[k]);
+
+      double chi2(0.0);
+      for (size_t i=0;i<data.n;++i)
+      {
+        double r = data.y[i];
+        for (size_t k=0;k<nAmplitudes;++k) r -= amp[k]*basis[k][i];
+        chi2 += data.use[i]*r*r;
+      }
+      return chi2*_invsigma2;
+    }
+
+    void PeakFitTemplate::process(TrkTypes::ADCWaveform const& adcData, PeakFitParams & fit) const
+    {
+      if (adcData.size() > maxSamples)
+        throw cet::exception("RECO")<<"PeakFitTemplate: waveform of " << adcData.size() << " samples, at most "
+                                    << maxSamples << " are supported" << std::endl;
+
+      Data data;
+      data.n = adcData.size();
+      unsigned nused(0);
+      for (size_t i=0;i<data.n;++i)
+      {
+        data.y[i]   = adcData[i];
+        data.use[i] = (_truncateADC && adcData[i] >= _saturation) ? 0.0 : 1.0;
+        if (data.use[i] > 0.0) ++nused;
+      }
+
+      fit = PeakFitParams();
+      unsigned nfree(0);
+      const std::pair<PeakFitParams::paramIndex,bool> params[] = {
+        {PeakFitParams::earlyCharge, _ampmax[earlyAmp] > _ampmin[earlyAmp]},
+        {PeakFitParams::pedestal,    _ampmax[pedestalAmp] > _ampmin[pedestalAmp]},
+        {PeakFitParams::time,        true},
+        {PeakFitParams::charge,      true},
+        {PeakFitParams::width,       _parmax[peakWidth] > _parmin[peakWidth]},
+        {PeakFitParams::lateShift,   _parmax[lateDelay] > _parmin[lateDelay]},
+        {PeakFitParams::lateCharge,  _ampmax[lateAmp] > _ampmin[lateAmp]}};
+      for (auto const& param : params)
+        if (param.second) { fit.freeParam(param.first); ++nfree; }
+      if (nused <= nfree)
+      {
+        fit._pedestal = _ampmin[pedestalAmp];
+        fit._status = -1;
+        return;
+      }
+
+      // coarse scans, starting from the values of PeakFit::initializeFit.  Time and width are
+      // strongly correlated and the chisquared can be flat in the width over a large range, so they
+      // are scanned together; the late peak delay is scanned next.
+      size_t freepar[nNonlinear], nnl(0);
+      for (size_t ipar=0;ipar<nNonlinear;++ipar) if (_parmax[ipar] > _parmin[ipar]) freepar[nnl++] = ipar;
+      double par[nNonlinear] = {30.0, std::min(7.0,_parmax[peakWidth]), _latePeak ? 50.0 : 0.0};
+      double amp[nAmplitudes], trialAmp[nAmplitudes], x[nNonlinear];
+      double chi2 = profile(data,par,amp);
+      std::copy(par,par+nNonlinear,x);
+      for (x[peakWidth]=_parmin[peakWidth]; x[peakWidth]<=_parmax[peakWidth]+1e-6; x[peakWidth]+=_widthScanStep)
+        for (x[peakTime]=_parmin[peakTime]; x[peakTime]<=_parmax[peakTime]+1e-6; x[peakTime]+=_scanStep)
+        {
+          double c = profile(data,x,trialAmp);
+          if (c < chi2)
+          {
+            chi2 = c;
+            std::copy(x,x+nNonlinear,par);
+            std::copy(trialAmp,trialAmp+nAmplitudes,amp);
+          }
+        }
+      if (_latePeak)
+      {
+        std::copy(par,par+nNonlinear,x);
+        for (x[lateDelay]=_parmin[lateDelay]; x[lateDelay]<=_parmax[lateDelay]+1e-6; x[lateDelay]+=_scanStep)
+        {
+          double c = profile(data,x,trialAmp);
+          if (c < chi2)
+          {
+            chi2 = c;
+            par[lateDelay] = x[lateDelay];
+            std::copy(trialAmp,trialAmp+nAmplitudes,amp);
+          }
+        }
+      }
+
+      // bounded Newton search on the profiled chisquared, with finite difference derivatives.
+      // Parameters at a limit and pushed outside of it are left out of the step.
+      int status(1);
+      unsigned iter(0);
+      for (;iter<_maxIter;++iter)
+      {
+        double grad[nNonlinear], hess[nNonlinear][nNonlinear], fplus[nNonlinear], fminus[nNonlinear];
+        std::copy(par,par+nNonlinear,x);
+        for (size_t a=0;a<nnl;++a)
+        {
+          const size_t ia = freepar[a];
+          const double h = _dpar[ia];
+          x[ia] = par[ia]+h; fplus[a]  = profile(data,x,trialAmp);
+          x[ia] = par[ia]-h; fminus[a] = profile(data,x,trialAmp);
+          x[ia] = par[ia];
+          grad[a]    = (fplus[a]-fminus[a])/(2.0*h);
+          hess[a][a] = (fplus[a]-2.0*chi2+fminus[a])/(h*h);
+          for (size_t b=0;b<a;++b)
+          {
+            const size_t ib = freepar[b];
+            const double k = _dpar[ib];
+            double f[4];
+            const double sa[4] = {1,1,-1,-1}, sb[4] = {1,-1,1,-1};
+            for (size_t is=0;is<4;++is)
+            {
+              x[ia] = par[ia]+sa[is]*h; x[ib] = par[ib]+sb[is]*k;
+              f[is] = profile(data,x,trialAmp);
+            }
+            x[ia] = par[ia]; x[ib] = par[ib];
+            hess[a][b] = (f[0]-f[1]-f[2]+f[3])/(4.0*h*k);
+          }
+        }
+
+        size_t active[nNonlinear], na(0);
+        for (size_t a=0;a<nnl;++a)
+        {
+          const size_t ia = freepar[a];
+          const bool atmin = par[ia] <= _parmin[ia] && grad[a] > 0.0;
+          const bool atmax = par[ia] >= _parmax[ia] && grad[a] < 0.0;
+          if (!atmin && !atmax) active[na++] = a;
+        }
+        if (na == 0) { status = 0; break; }
+
+        double h[nNonlinear][nNonlinear], step[nNonlinear];
+        for (size_t p=0;p<na;++p)
+        {
+          step[p] = -grad[active[p]];
+          for (size_t q=0;q<=p;++q) h[p][q] = hess[active[p]][active[q]];
+        }
+        if (!choleskySolve<nNonlinear>(h,step,na))
+        {
+          // not a minimum yet: steepest descent
+          double norm(0.0);
+          for (size_t p=0;p<na;++p) norm += grad[active[p]]*grad[active[p]];
+          norm = std::sqrt(norm);
+          if (norm == 0.0) { status = 0; break; }
+          for (size_t p=0;p<na;++p) step[p] = -grad[active[p]]*_scanStep/norm;
+        }
+        // keep the step within the scan resolution
+        for (size_t p=0;p<na;++p) step[p] = std::min(std::max(step[p],-_scanStep),_scanStep);
+
+        // backtrack until the chisquared decreases
+        bool improved(false);
+        double maxmove(0.0);
+        for (double lambda=1.0; lambda>1e-3; lambda *= 0.5)
+        {
+          std::copy(par,par+nNonlinear,x);
+          maxmove = 0.0;
+          for (size_t p=0;p<na;++p)
+          {
+            const size_t ia = freepar[active[p]];
+            x[ia] = std::min(std::max(par[ia]+lambda*step[p],_parmin[ia]),_parmax[ia]);
+            maxmove = std::max(maxmove,std::abs(x[ia]-par[ia]));
+          }
+          const double c = profile(data,x,trialAmp);
+          if (c < chi2)
+          {
+            improved = true;
+            chi2 = c;
+            std::copy(x,x+nNonlinear,par);
+            std::copy(trialAmp,trialAmp+nAmplitudes,amp);
+            break;
+          }
+        }
+        if (!improved || maxmove < _tolerance) { status = 0; break; }
+      }
+
+      fit._pedestal    = amp[pedestalAmp];
+      fit._charge      = amp[mainAmp];
+      fit._earlyCharge = amp[earlyAmp];
+      fit._lateCharge  = amp[lateAmp];
+      fit._time        = par[peakTime];
+      fit._width       = par[peakWidth];
+      fit._lateShift   = par[lateDelay];
+      fit._chi2        = chi2;
+      fit._ndf         = nused - nfree;
+      fit._status      = status;
+      if (_debug>0) std::cout << "PeakFitTemplate charge = " << fit._charge << " time = " << fit._time << " chi2 = " << chi2
+                              << " iterations = " << iter << " status = " << status << std::endl;
+    }
+  }
+}
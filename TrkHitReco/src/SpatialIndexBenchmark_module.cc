@@ -0,0 +1,178 @@
+//
+// Scaling benchmark of the spatial indices (GeneralUtilities KDTree / SpatialGrid) on synthetic
+// tracker hits: k nearest neighbors in (x,y) by brute force, k-d tree and grid, and the TNT
+// background clustering, for each requested number of hits.  Everything is done at beginJob,
+// run it with an EmptyEvent source.  The hits are a mix of compact low-energy electron
+// clusters and uniform background over the tracker annulus and the digitization window.
+//
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Principal/Event.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
+
+#include "Offline/GeneralUtilities/inc/KNearestNeighbors.hh"
+#include "Offline/GeneralUtilities/inc/SpatialGrid.hh"
+#include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/TrkHitReco/inc/TNTClusterer.hh"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace mu2e
+{
+
+  class SpatialIndexBenchmark : public art::EDAnalyzer
+  {
+    public:
+
+      struct Config
+      {
+        using Name = fhicl::Name;
+        using Comment = fhicl::Comment;
+        fhicl::Sequence<unsigned>             nHits{                Name("NHits"),                Comment("Numbers of hits to benchmark") };
+        fhicl::Atom<unsigned>                 nNeighbors{           Name("NNeighbors"),           Comment("Number of neighbors for the kNN search"),8 };
+        fhicl::Atom<unsigned>                 maxBruteForce{        Name("MaxBruteForce"),        Comment("Largest number of hits for the brute force kNN"),20000 };
+        fhicl::Atom<float>                    clusterFraction{      Name("ClusterFraction"),      Comment("Fraction of the hits in compact clusters"),0.5 };
+        fhicl::Atom<unsigned>                 repeat{               Name("Repeat"),               Comment("Repetitions of each measurement, the fastest is reported"),3 };
+        fhicl::Atom<unsigned>                 seed{                 Name("Seed"),                 Comment("Random seed of the hit generation"),12345 };
+        fhicl::Table<TNTClusterer::Config>    TNTClustering{        Name("TNTClustering"),        Comment("TNT Clusterer config") };
+      };
+
+      explicit SpatialIndexBenchmark(const art::EDAnalyzer::Table<Config>& config);
+      void beginJob() override;
+      void analyze(const art::Event&) override {}
+
+    private:
+      void generate(unsigned nhits, ComboHitCollection& chcol);
+      template<class F> double time(F&& f) const;
+
+      std::vector<unsigned> nhits_;
+      unsigned              nnb_, maxbf_;
+      float                 clfrac_;
+      unsigned              repeat_;
+      std::mt19937          engine_;
+      TNTClusterer          tnt_;
+  };
+
+  SpatialIndexBenchmark::SpatialIndexBenchmark(const art::EDAnalyzer::Table<Config>& config) :
+    art::EDAnalyzer{config},
+    nhits_(   config().nHits()),
+    nnb_(     config().nNeighbors()),
+    maxbf_(   config().maxBruteForce()),
+    clfrac_(  config().clusterFraction()),
+    repeat_(  std::max(1u,config().repeat())),
+    engine_(  config().seed()),
+    tnt_(     config().TNTClustering())
+  {}
+
+  // fastest of repeat_ calls, in ms
+  template<class F> double SpatialIndexBenchmark::time(F&& f) const
+  {
+    double best(0);
+    for (unsigned irep=0; irep<repeat_; ++irep)
+    {
+      auto start = std::chrono::steady_clock::now();
+      f();
+      double ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+      if (irep == 0 || ms < best) best = ms;
+    }
+    return best;
+  }
+
+  void SpatialIndexBenchmark::generate(unsigned nhits, ComboHitCollection& chcol)
+  {
+    std::uniform_real_distribution<float> flat(0.0,1.0);
+    std::normal_distribution<float>       gauss(0.0,1.0);
+    const float rmin(380.0), rmax(700.0), tmin(400.0), tmax(1700.0);
+    chcol.clear();
+    chcol.reserve(nhits);
+    XYZVectorF cpos;
+    float ctime(0);
+    unsigned nleft(0);
+    for (unsigned ihit=0; ihit<nhits; ++ihit)
+    {
+      // clusters of ~5 hits within a few mm and ns, the rest uniform
+      bool clustered = flat(engine_) < clfrac_;
+      if (clustered && nleft == 0)
+      {
+        float r   = std::sqrt(rmin*rmin + flat(engine_)*(rmax*rmax-rmin*rmin));
+        float phi = 2.0*M_PI*flat(engine_);
+        cpos  = XYZVectorF(r*std::cos(phi),r*std::sin(phi),0.0);
+        ctime = tmin + flat(engine_)*(tmax-tmin);
+        nleft = 5;
+      }
+      ComboHit ch;
+      if (clustered)
+      {
+        ch._pos  = cpos + XYZVectorF(3.0*gauss(engine_),3.0*gauss(engine_),0.0);
+        ch._time = ctime + 2.0*gauss(engine_);
+        --nleft;
+      }
+      else
+      {
+        float r   = std::sqrt(rmin*rmin + flat(engine_)*(rmax*rmax-rmin*rmin));
+        float phi = 2.0*M_PI*flat(engine_);
+        ch._pos  = XYZVectorF(r*std::cos(phi),r*std::sin(phi),0.0);
+        ch._time = tmin + flat(engine_)*(tmax-tmin);
+      }
+      float wphi = M_PI*flat(engine_);
+      ch._wdir   = XYZVectorF(std::cos(wphi),std::sin(wphi),0.0);
+      ch._wres   = 30.0;
+      ch._tres   = 5.0;
+      ch._ncombo = 1;
+      ch._nsh    = 1;
+      ch._pind[0] = ihit;
+      chcol.push_back(ch);
+    }
+  }
+
+  void SpatialIndexBenchmark::beginJob()
+  {
+    tnt_.init();
+    std::cout << "SpatialIndexBenchmark: fastest of " << repeat_ << " runs, ms; kNN with k = " << nnb_ << " in (x,y)" << std::endl;
+    std::cout << std::setw(8) << "nhits" << std::setw(14) << "kNN brute" << std::setw(14) << "kNN kdtree"
+              << std::setw(14) << "kNN grid" << std::setw(14) << "TNT" << std::setw(12) << "clusters" << std::endl;
+
+    ComboHitCollection chcol;
+    for (auto nhits : nhits_)
+    {
+      generate(nhits,chcol);
+      std::vector<const ComboHit*> group;
+      for (const auto& ch : chcol) group.push_back(&ch);
+
+      auto xy = [](const ComboHit* ch){ return std::array<double,2>{{ch->pos().x(),ch->pos().y()}}; };
+      auto dist = [](const ComboHit* a, const ComboHit* b){ return std::sqrt((a->pos()-b->pos()).perp2()); };
+
+      double tbrute(-1);
+      if (nhits <= maxbf_) tbrute = time([&](){ KNearestNeighbors<const ComboHit*> knn(nnb_,group,dist); });
+      double tkd = time([&](){ auto knn = KNearestNeighbors<const ComboHit*>::euclidean(nnb_,group,xy); });
+      double tgrid = time([&](){
+        // cells holding a few hits each on average
+        unsigned ncell = std::max(1u,unsigned(std::sqrt(nhits/4.0)));
+        SpatialGrid<2> grid({{-700.0,-700.0}},{{1400.0/ncell,1400.0/ncell}},{{ncell,ncell}});
+        for (unsigned ihit=0; ihit<nhits; ++ihit) grid.insert(ihit,xy(group[ihit]));
+        std::vector<SpatialGrid<2>::Neighbor> neighbors;
+        for (unsigned ihit=0; ihit<nhits; ++ihit) grid.nearest(xy(group[ihit]),nnb_,neighbors,ihit);
+      });
+      BkgClusterCollection preclusters, clusters;
+      double ttnt = time([&](){
+        preclusters.clear(); clusters.clear();
+        tnt_.findClusters(preclusters,clusters,chcol,0);
+      });
+
+      std::cout << std::setw(8) << nhits << std::fixed << std::setprecision(2);
+      if (tbrute >= 0) std::cout << std::setw(14) << tbrute;
+      else             std::cout << std::setw(14) << "-";
+      std::cout << std::setw(14) << tkd << std::setw(14) << tgrid << std::setw(14) << ttnt
+                << std::setw(12) << clusters.size() << std::endl;
+    }
+  }
+}
+
+DEFINE_ART_MODULE(mu2e::SpatialIndexBenchmark);
@@ -5,6 +5,7 @@
 
 #include "Offline/DataProducts/inc/StrawEnd.hh"
 
+#include <iostream>
 #include <numeric>
 
 #include "Offline/TrkHitReco/inc/StrawHitRecoUtils.hh"
@@ -110,12 +111,12 @@ namespace mu2e {
     } else if (_fittype == mu2e::TrkHitReco::FitType::firmwarepmp){
       float charge = peakMinusPedFirmware(sid, pmp);
       energy = srep.ionizationEnergy(charge);
-    } else {
-      //mu2e::TrkHitReco::PeakFitParams params;
-      //_pfit->process(waveform,params);
-      //energy = srep.ionizationEnergy(params._charge/srep.strawGain());
-      //if (_printLevel > 1) std::cout << "Fit status = " << params._status << " NDF = " << params._ndf << " chisquared " << params._chi2
-      //  << " Fit charge = " << params._charge << " Fit time = " << params._time << std::endl;
+    } else if (_pfit != nullptr){
+      mu2e::TrkHitReco::PeakFitParams params;
+      _pfit->process(waveform,params);
+      energy = srep.ionizationEnergy(params._charge/srep.strawGain());
+      if (_diagLevel > 1) std::cout << "Fit status = " << params._status << " NDF = " << params._ndf << " chisquared " << params._chi2
+        << " Fit charge = " << params._charge << " Fit time = " << params._time << std::endl;
     }
     // energy selection
     if( energy > _maxE || energy < _minE ) {
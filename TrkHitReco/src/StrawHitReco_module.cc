@@ -12,6 +12,7 @@
 #include "Offline/GeometryService/inc/DetectorSystem.hh"
 #include "art_root_io/TFileService.h"
 #include "art/Framework/Principal/Run.h"
+#include "fhiclcpp/types/OptionalDelegatedParameter.h"
 
 // conditions
 #include "Offline/ProditionsService/inc/ProditionsHandle.hh"
@@ -28,7 +29,9 @@
 #include "Offline/TrkHitReco/inc/PeakFitRoot.hh"
 #include "Offline/TrkHitReco/inc/PeakFitFunction.hh"
 #include "Offline/TrkHitReco/inc/ComboPeakFitRoot.hh"
+#include "Offline/TrkHitReco/inc/PeakFitTemplate.hh"
 #include "Offline/TrkHitReco/inc/StrawHitRecoUtils.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 
 #include "Offline/RecoDataProducts/inc/ProtonBunchTime.hh"
 #include "Offline/DataProducts/inc/StrawEnd.hh"
@@ -72,6 +75,7 @@ namespace mu2e {
         fhicl::Atom<art::InputTag> sdadcTag{ Name("StrawDigiADCWaveformCollectionTag"), Comment("StrawDigiADCWaveformCollection producer")};
         fhicl::Atom<art::InputTag> cccTag{ Name("CaloClusterCollectionTag"), Comment("CaloClusterCollection producer")};
         fhicl::Atom<art::InputTag> pbttoken{ Name("ProtonBunchTimeTag"), Comment("ProtonBunchTime producer")};
+        fhicl::OptionalDelegatedParameter peakFit{ Name("PeakFit"), Comment("Waveform fit configuration, see PeakFitTemplate")};
   };
 
   using Parameters = art::EDProducer::Table<Config>;
@@ -108,6 +112,8 @@ namespace mu2e {
   art::ProductToken<CaloClusterCollection> const _ccctoken;
   art::ProductToken<ProtonBunchTime> const _pbttoken; // name of the module that makes eventwindowmarkers
   std::unique_ptr<TrkHitReco::PeakFit> _pfit; // peak fitting algorithm
+  fhicl::ParameterSet _peakFitConfig; // peak fitting configuration
+  const StrawResponse* _pfitResponse = nullptr; // response the fitter was built with
   // diagnostic
   TH1F* _maxiter;
   // helper function
@@ -143,6 +149,8 @@ StrawHitReco::StrawHitReco(Parameters const& config) :
   produces<ComboHitCollection>();
   produces<IntensityInfoTrackerHits>();
 
+  config().peakFit.get_if_present(_peakFitConfig);
+
   if (_writesh) produces<StrawHitCollection>();
   if (_printLevel > 0) std::cout << "In StrawHitReco constructor " << std::endl;
 }
@@ -168,14 +176,21 @@ void StrawHitReco::beginRun(art::Run& run)
     _invgain[i] = srep.adcLSB()*srep.peakMinusPedestalEnergyScale(dummyId)/srep.strawGain();
   }
 
-  // Detailed histogram-based waveform fits are no longer supported TODO!
-  if (_fittype != TrkHitReco::FitType::peakminusped && _fittype != TrkHitReco::FitType::peakminuspedavg && _fittype != TrkHitReco::FitType::firmwarepmp)
+  // Detailed histogram-based waveform fits are no longer supported, the template fit replaces them
+  if (_fittype == TrkHitReco::FitType::templatefit){
+    // the fitter samples the response, rebuild it when the response changes
+    if (_pfit == nullptr || _pfitResponse != &srep){
+      _pfit = std::make_unique<TrkHitReco::PeakFitTemplate>(srep,_peakFitConfig);
+      _pfitResponse = &srep;
+    }
+  } else if (_fittype != TrkHitReco::FitType::peakminusped && _fittype != TrkHitReco::FitType::peakminuspedavg && _fittype != TrkHitReco::FitType::firmwarepmp)
     throw cet::exception("RECO")<<"TrkHitReco: Peak fit " << _fittype << " not implemented " <<  std::endl;
 }
 
 //------------------------------------------------------------------------------------------
 void StrawHitReco::produce(art::Event& event)
 {
+  MU2E_PROFILE_SCOPE("StrawHitReco::produce");
   if (_printLevel > 0) std::cout << "In StrawHitReco produce " << std::endl;
 
   const Tracker& tt = _alignedTracker_h.get(event.id());
@@ -185,6 +200,7 @@ void StrawHitReco::produce(art::Event& event)
   auto const& srep = _strawResponse_h.get(event.id());
   auto sdH = event.getValidHandle(_sdctoken);
   const StrawDigiCollection& sdcol(*sdH);
+  MU2E_PROFILE_COUNT("StrawHitReco::digis",sdcol.size());
 
   const StrawDigiADCWaveformCollection *sdadccol(0);
   if (_fittype != TrkHitReco::FitType::firmwarepmp) {
@@ -220,7 +236,7 @@ void StrawHitReco::produce(art::Event& event)
 
   mu2e::StrawHitRecoUtils shrUtils(pbtOffset, _fittype, _npre, _invnpre, _invgainAvg, _invgain,
       _diagLevel, _maxiter, _mask, nplanes, npanels, _writesh, _minT, _maxT, _minE, _maxE, _filter, _flagXT,
-      _ctE, _ctMinT, _ctMaxT, _usecc, _clusterDt, sdcol.size());
+      _ctE, _ctMinT, _ctMaxT, _usecc, _clusterDt, sdcol.size(), _pfit.get());
 
   for (size_t isd=0;isd<sdcol.size();++isd) {
     const StrawDigi& digi = sdcol[isd];
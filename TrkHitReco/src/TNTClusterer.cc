@@ -7,6 +7,8 @@ namespace mu2e
 {
   TNTClusterer::TNTClusterer(const Config& config) :
     hitDtIdx_(),
+    clusterIndex_({0.0f,0.0f,0.0f},{1.0f,1.0f,1.0f},{numXYBuckets,numXYBuckets,numBuckets}),
+    candidates_(),
     dhit_       (config.hitDistance()),
     dseed_      (config.seedDistance()),
     dd_         (config.clusterDiameter()),
@@ -28,6 +30,7 @@ namespace mu2e
 
     dd2_      = dd_*dd_;
     maxwt_    = 1.0f/minerr;
+    md_       = maxdist;
     md2_      = maxdist*maxdist;
     trms2inv_ = 1.0f/trms/trms;
   }
@@ -52,6 +55,12 @@ namespace mu2e
     hitDtIdx_.clear();
     for (int i=0;i<=ditime;++i) {hitDtIdx_.push_back(i); if (i>0) hitDtIdx_.push_back(-i);}
 
+    //the clusters are indexed in the same time buckets, and in x-y buckets covering the hits
+    float xymax(1.0f);
+    for (const auto& ch : chcol) xymax = std::max(xymax,std::max(std::abs(ch.pos().x()),std::abs(ch.pos().y())));
+    float xybin = 2.0f*xymax/float(numXYBuckets);
+    clusterIndex_.reset({-xymax,-xymax,0.0f},{xybin,xybin,tbin});
+
     //Two stage clustering
     initClu(chcol, postFilterClusters, BkgHits);
     clusterAlgo(chcol, postFilterClusters, BkgHits, tbin);
@@ -86,15 +95,12 @@ namespace mu2e
   //----------------------------------------------------------------------------------------------------------------------
   void TNTClusterer::clusterAlgo(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, std::vector<BkgHit>& BkgHits, float tbin)
   {
-    arrayVecBkg hitIndex;
-    for (auto& vec : hitIndex) vec.reserve(16);
-
     unsigned niter(0);
     float odist(2.0f*maxDistSum_),tdist(0.0f);
     while (std::abs(odist - tdist) > maxDistSum_ && niter < maxNiter_)
     {
       ++niter;
-      formClusters(chcol, clusters,tbin,  BkgHits, hitIndex);
+      formClusters(chcol, clusters,tbin,  BkgHits);
 
       odist = tdist;
       tdist = 0.0f;
@@ -107,10 +113,12 @@ namespace mu2e
   //-------------------------------------------------------------------------------------------------------------------
   // loop over hits, re-affect them to their original cluster if they are still within the radius, otherwise look at
   // candidate clusters to check if they could be added. If not, make a new cluster.
-  // to speed up, do not update clusters who haven't changed and keep a list of clusters within a given time window
+  // to speed up, do not update clusters who haven't changed and index the clusters in time and x-y buckets. Only clusters
+  // within MaxDistance in x-y can be closer than SeedDistance, so the candidates of a time bucket are those of the x-y
+  // buckets overlapping that square, visited in cluster order as when the whole time bucket was scanned.
   //
   unsigned TNTClusterer::formClusters(const ComboHitCollection& chcol, std::vector<BkgCluster>& clusters, float tbin,
-      std::vector<BkgHit>& BkgHits, arrayVecBkg& hitIndex)
+      std::vector<BkgHit>& BkgHits)
   {
     unsigned nchanged(0);
     for (auto& cluster : clusters) cluster.clearHits();
@@ -129,11 +137,18 @@ namespace mu2e
       int minc(-1);
       float mindist(dseed_+1.0f);
       int itime = int(chcol[hit.chidx_].correctedTime()/tbin);
+      const auto& hpos = chcol[hit.chidx_].pos();
+      int ixmin = clusterIndex_.bin(0,hpos.x()-md_), ixmax = clusterIndex_.bin(0,hpos.x()+md_);
+      int iymin = clusterIndex_.bin(1,hpos.y()-md_), iymax = clusterIndex_.bin(1,hpos.y()+md_);
 
       for (auto i : hitDtIdx_)
       {
         if (itime+i >= numBuckets || itime+i<0) continue;
-        for (const auto& ic : hitIndex[itime+i])
+        candidates_.clear();
+        clusterIndex_.forEachInCells({ixmin,iymin,itime+i},{ixmax,iymax,itime+i},
+            [this](const ClusterGrid::Entry& entry){candidates_.push_back(entry.id);});
+        std::sort(candidates_.begin(),candidates_.end());
+        for (const auto& ic : candidates_)
         {
           float dist = distance(clusters[ic],chcol[hit.chidx_]);
           if (dist < mindist) {mindist = dist; minc = ic;}
@@ -152,8 +167,7 @@ namespace mu2e
         minc = clusters.size();
         clusters.emplace_back(BkgCluster(chcol[hit.chidx_].pos(),chcol[hit.chidx_].correctedTime()));
         clusters[minc].addHit(ihit);
-        int itimeClu  = int(chcol[hit.chidx_].correctedTime()/tbin);
-        hitIndex[itimeClu].emplace_back(minc);
+        clusterIndex_.insert(minc,{hpos.x(),hpos.y(),chcol[hit.chidx_].correctedTime()});
       }
       else
       {
@@ -185,7 +199,7 @@ namespace mu2e
 
 
     //update cluster, hit distance and maps
-    for (auto& vec: hitIndex) vec.clear();
+    clusterIndex_.clear();
 
     for (unsigned ic=0;ic<clusters.size();++ic)
     {
@@ -201,8 +215,7 @@ namespace mu2e
           for (auto& hit : cluster.hits()) BkgHits[hit].distance_ = distance(cluster,chcol[BkgHits[hit].chidx_]);
       }
 
-      int itimeClu  = int(cluster.time()/tbin);
-      hitIndex[itimeClu].emplace_back(ic);
+      clusterIndex_.insert(ic,{cluster.pos().x(),cluster.pos().y(),cluster.time()});
     }
 
     return nchanged;
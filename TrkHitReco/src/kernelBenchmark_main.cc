@@ -0,0 +1,368 @@
+// Replay the recorded inputs of a real job (see TrkHitReco/inc/KernelInputs.hh and the
+// KernelInputRecorder module) through reconstruction kernels outside of art, and report the
+// distribution of the time per event of each kernel: after the warm-up passes over the events,
+// every event of every timed pass is one sample.  A kernel whose median is above its reference
+// by more than the tolerance is reported as a regression, and the exit status is 3.
+//
+// The kernels are the hit clusterings (TNTClusterer, ScanClusterer), the background cluster MVA
+// (BkgMVA, on the TNTClusterer clusters, which are found untimed), the template waveform fit of
+// the straw digis (PeakFitTemplate, with the recorded straw response), the calorimeter
+// waveform processors (CaloRawWFProcessor, CaloTemplateWFProcessor with the recorded pulse shape)
+// and the delta electron finder (DeltaFinderAlg, with a Tracker built from the recorded straws).
+//
+// The helix fit (RobustHelixFit) is not replayed: it fits the hits of a time cluster, ordered by
+// the RobustHelixFinder module, and neither the time clusters nor that ordering are recorded.
+//
+// Usage:
+//   kernelBenchmark -c <config.fcl> <inputs.col>
+//
+// The configuration file is looked up in FHICL_FILE_PATH, see TrkHitReco/fcl/kernelBenchmark.fcl.
+//
+
+#include "Offline/CaloReco/inc/CaloRawWFProcessor.hh"
+#include "Offline/CaloReco/inc/CaloTemplateWFProcessor.hh"
+#include "Offline/CalPatRec/inc/DeltaFinderAlg.hh"
+#include "Offline/GeneralUtilities/inc/ParameterSetFromFile.hh"
+#include "Offline/TrkHitReco/inc/BkgClusterQuality.hh"
+#include "Offline/TrkHitReco/inc/KernelInputs.hh"
+#include "Offline/TrkHitReco/inc/PeakFitTemplate.hh"
+#include "Offline/TrkHitReco/inc/ScanClusterer.hh"
+#include "Offline/TrkHitReco/inc/TNTClusterer.hh"
+
+#include "cetlib_except/exception.h"
+#include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalDelegatedParameter.h"
+#include "fhiclcpp/types/OptionalTable.h"
+#include "fhiclcpp/types/Sequence.h"
+#include "fhiclcpp/types/Table.h"
+#include "fhiclcpp/types/Tuple.h"
+
+#include "TH1F.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+  // as FlagBkgHits
+  struct BkgMVAConfig
+  {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+    fhicl::Table<mu2e::MVATools::Config>  bkgMVA{          Name("BkgMVA"),          Comment("MVA Configuration") };
+    fhicl::Atom<float>                    bkgMVAcut{       Name("BkgMVACut"),       Comment("Bkg MVA cut") };
+    fhicl::Atom<unsigned>                 minActiveHits{   Name("MinActiveHits"),   Comment("Minumim number of active hits in a cluster") };
+    fhicl::Atom<unsigned>                 minNPlanes{      Name("MinNPlanes"),      Comment("Minumim number of planes in a cluster") };
+    fhicl::Sequence<std::string>          stereoSelection{ Name("StereoSelection"), Comment("Stereo hit selection mask") };
+  };
+
+  struct Config
+  {
+    using Name = fhicl::Name;
+    using Comment = fhicl::Comment;
+    fhicl::Atom<unsigned>                                       warmup{            Name("warmup"),            Comment("Untimed passes over the events"),1 };
+    fhicl::Atom<unsigned>                                       repetitions{       Name("repetitions"),       Comment("Timed passes over the events"),10 };
+    fhicl::Sequence<std::string>                                kernels{           Name("kernels"),           Comment("Kernels to run: TNTClusterer, ScanClusterer, BkgMVA, PeakFitTemplate, "
+                                                                                                                       "CaloRawWFProcessor, CaloTemplateWFProcessor, DeltaFinderAlg") };
+    fhicl::OptionalTable<mu2e::TNTClusterer::Config>            tntClustering{     Name("TNTClustering"),     Comment("TNTClusterer config") };
+    fhicl::OptionalTable<mu2e::ScanClusterer::Config>           scanClustering{    Name("ScanClustering"),    Comment("ScanClusterer config") };
+    fhicl::OptionalTable<BkgMVAConfig>                          bkgMVA{            Name("BkgMVA"),            Comment("Background cluster MVA config, the clusters are found with TNTClustering") };
+    fhicl::OptionalDelegatedParameter                           peakFit{           Name("PeakFit"),           Comment("PeakFitTemplate config") };
+    fhicl::OptionalTable<mu2e::CaloRawWFProcessor::Config>      rawProcessor{      Name("RawProcessor"),      Comment("CaloRawWFProcessor config") };
+    fhicl::OptionalTable<mu2e::CaloTemplateWFProcessor::Config> templateProcessor{ Name("TemplateProcessor"), Comment("CaloTemplateWFProcessor config") };
+    fhicl::OptionalDelegatedParameter                           deltaFinder{       Name("DeltaFinder"),       Comment("DeltaFinderAlg config, as DeltaFinder finderParameters") };
+    fhicl::Sequence<fhicl::Tuple<std::string,double>>         referenceP50{   Name("referenceP50"),   Comment("Reference median time per event (us) of each kernel"),
+                                                                              std::vector<std::tuple<std::string,double>>{} };
+    fhicl::Atom<double>                                       tolerance{      Name("tolerance"),      Comment("Allowed fractional increase of the median over the reference"),0.2 };
+  };
+
+  // A kernel processes one event and returns the number of objects it found, which is
+  // summed over the events as a check that the replay does what the job did
+  struct Kernel
+  {
+    std::string                                                      name;
+    std::function<std::size_t(const mu2e::RecordedEvent&, unsigned)> run;
+  };
+
+  struct Result
+  {
+    std::string         name;
+    std::vector<double> samples;   // us per event
+    std::size_t         outputs = 0;
+  };
+
+  void usage() {
+    std::cerr<<"Usage: kernelBenchmark -c <config.fcl> <inputs.col>\n";
+  }
+
+  // nearest rank percentile of sorted samples
+  double percentile(const std::vector<double>& sorted, double p) {
+    if(sorted.empty()) return 0;
+    std::size_t rank = std::ceil(p*sorted.size());
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank,1)) - 1];
+  }
+
+  template<class ALGO> Kernel clusterer(const std::string& name, const typename ALGO::Config& config) {
+    auto algo = std::make_shared<ALGO>(config);
+    algo->init();
+    return Kernel{name, [algo](const mu2e::RecordedEvent& event, unsigned iev) {
+      mu2e::BkgClusterCollection preFilterClusters, clusters;
+      algo->findClusters(preFilterClusters, clusters, event.comboHits, iev);
+      return clusters.size();
+    }};
+  }
+
+  // the clusters and their quality variables are computed here, only the MVA is timed
+  Kernel bkgMVA(const BkgMVAConfig& config, const mu2e::TNTClusterer::Config& clustering, const mu2e::KernelInputs& inputs) {
+    auto quality = std::make_shared<mu2e::BkgClusterQuality>(config.minActiveHits(), config.minNPlanes(),
+                                                             mu2e::StrawHitFlag(config.stereoSelection()), config.bkgMVA());
+    quality->init();
+    mu2e::TNTClusterer clusterer(clustering);
+    clusterer.init();
+    auto quals = std::make_shared<std::vector<std::vector<mu2e::BkgQual>>>(inputs.events.size());
+    for(unsigned iev=0; iev<inputs.events.size(); ++iev) {
+      const auto& chcol = inputs.events[iev].comboHits;
+      mu2e::BkgClusterCollection preFilterClusters, clusters;
+      clusterer.findClusters(preFilterClusters, clusters, chcol, iev);
+      for(const auto& cluster : clusters) {
+        (*quals)[iev].emplace_back();
+        quality->fillBkgQual(cluster, (*quals)[iev].back(), chcol);
+      }
+    }
+    const float cut = config.bkgMVAcut();
+    return Kernel{"BkgMVA", [quality, quals, cut](const mu2e::RecordedEvent&, unsigned iev) {
+      std::size_t nbkg(0);
+      for(auto& cqual : (*quals)[iev]) {
+        quality->fillMVA(cqual);
+        if(cqual.MVAOutput() > cut) ++nbkg;
+      }
+      return nbkg;
+    }};
+  }
+
+  // the waveforms longer than the template fit takes are skipped, as in PeakFitComparison
+  Kernel peakFitTemplate(const fhicl::ParameterSet& config, const mu2e::RecordedStrawResponse& recorded) {
+    auto srep = mu2e::makeStrawResponse(recorded);
+    auto fit = std::make_shared<mu2e::TrkHitReco::PeakFitTemplate>(*srep, config);
+    return Kernel{"PeakFitTemplate", [srep, fit](const mu2e::RecordedEvent& event, unsigned) {
+      std::size_t nfits(0);
+      for(const auto& wf : event.strawWaveforms) {
+        if(wf.samples().size() > mu2e::TrkHitReco::PeakFitTemplate::maxSamples) continue;
+        mu2e::TrkHitReco::PeakFitParams params;
+        fit->process(wf.samples(), params);
+        if(params._status >= 0) ++nfits;
+      }
+      return nfits;
+    }};
+  }
+
+  Kernel caloProcessor(const std::string& name, std::shared_ptr<mu2e::CaloWaveformProcessor> algo, double digiSampling) {
+    // as CaloRecoDigiMaker
+    return Kernel{name, [algo, digiSampling](const mu2e::RecordedEvent& event, unsigned) {
+      std::size_t npeaks(0);
+      std::vector<double> x, y;
+      for(const auto& digi : event.caloDigis) {
+        x.clear(); y.clear();
+        for(std::size_t i=0; i<digi.waveform().size(); ++i) {
+          x.push_back(digi.t0() + (i+0.5)*digiSampling);
+          y.push_back(digi.waveform()[i]);
+        }
+        algo->reset();
+        algo->extract(x, y);
+        npeaks += algo->nPeaks();
+      }
+      return npeaks;
+    }};
+  }
+
+  // as DeltaFinder, the output is the number of delta candidates whose hits the module flags
+  Kernel deltaFinder(const fhicl::ParameterSet& config, const mu2e::GeometrySnapshot::StrawCollection& straws) {
+    std::shared_ptr<const mu2e::Tracker> tracker = mu2e::makeTracker(straws);
+    auto data = std::make_shared<mu2e::DeltaFinderTypes::Data_t>();
+    data->InitGeometry(tracker.get());
+    auto finder = std::make_shared<mu2e::DeltaFinderAlg>(fhicl::Table<mu2e::DeltaFinderAlg::Config>{config, std::set<std::string>{}}, data.get());
+    return Kernel{"DeltaFinderAlg", [tracker, data, finder](const mu2e::RecordedEvent& event, unsigned) {
+      data->InitEvent(nullptr, 0);
+      data->chcol       = &event.comboHits;
+      data->_nComboHits = event.comboHits.size();
+      data->_nStrawHits = 0;
+      for(const auto& ch : event.comboHits) data->_nStrawHits += ch.nStrawHits();
+      finder->run();
+      std::size_t ndeltas(0);
+      for(int i=0; i<data->nDeltaCandidates(); ++i) {
+        const mu2e::DeltaCandidate* dc = data->deltaCandidate(i);
+        if(dc->Active() != 0 && dc->Mask() == 0) ++ndeltas;
+      }
+      return ndeltas;
+    }};
+  }
+
+  std::vector<Kernel> makeKernels(const Config& config, const mu2e::KernelInputs& inputs) {
+    std::vector<Kernel> kernels;
+    for(const auto& name : config.kernels()) {
+      if(name == "TNTClusterer") {
+        mu2e::TNTClusterer::Config c;
+        if(!config.tntClustering(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: TNTClusterer needs a TNTClustering table\n";
+        kernels.push_back(clusterer<mu2e::TNTClusterer>(name, c));
+      }
+      else if(name == "ScanClusterer") {
+        mu2e::ScanClusterer::Config c;
+        if(!config.scanClustering(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: ScanClusterer needs a ScanClustering table\n";
+        kernels.push_back(clusterer<mu2e::ScanClusterer>(name, c));
+      }
+      else if(name == "CaloRawWFProcessor") {
+        mu2e::CaloRawWFProcessor::Config c;
+        if(!config.rawProcessor(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: CaloRawWFProcessor needs a RawProcessor table\n";
+        auto algo = std::make_shared<mu2e::CaloRawWFProcessor>(c);
+        algo->initialize();
+        kernels.push_back(caloProcessor(name, algo, inputs.caloDigiSampling));
+      }
+      else if(name == "CaloTemplateWFProcessor") {
+        mu2e::CaloTemplateWFProcessor::Config c;
+        if(!config.templateProcessor(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: CaloTemplateWFProcessor needs a TemplateProcessor table\n";
+        if(inputs.caloPulseShape.empty()) throw cet::exception("BADINPUT")<<"kernelBenchmark: CaloTemplateWFProcessor needs the recorded calorimeter pulse shape\n";
+        TH1F pulseShape("caloPulseShape", "", inputs.caloPulseShape.size(), inputs.caloPulseMin, inputs.caloPulseMax);
+        pulseShape.SetDirectory(0);
+        for(std::size_t i=0; i<inputs.caloPulseShape.size(); ++i) pulseShape.SetBinContent(i+1, inputs.caloPulseShape[i]);
+        auto algo = std::make_shared<mu2e::CaloTemplateWFProcessor>(c);
+        algo->initialize(pulseShape);
+        kernels.push_back(caloProcessor(name, algo, inputs.caloDigiSampling));
+      }
+      else if(name == "BkgMVA") {
+        BkgMVAConfig c;
+        mu2e::TNTClusterer::Config clustering;
+        if(!config.bkgMVA(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: BkgMVA needs a BkgMVA table\n";
+        if(!config.tntClustering(clustering)) throw cet::exception("CONFIG")<<"kernelBenchmark: BkgMVA needs a TNTClustering table\n";
+        kernels.push_back(bkgMVA(c, clustering, inputs));
+      }
+      else if(name == "PeakFitTemplate") {
+        fhicl::ParameterSet c;
+        config.peakFit.get_if_present(c);
+        if(!inputs.strawResponse) throw cet::exception("BADINPUT")<<"kernelBenchmark: PeakFitTemplate needs the recorded straw response\n";
+        kernels.push_back(peakFitTemplate(c, *inputs.strawResponse));
+      }
+      else if(name == "DeltaFinderAlg") {
+        fhicl::ParameterSet c;
+        if(!config.deltaFinder.get_if_present(c)) throw cet::exception("CONFIG")<<"kernelBenchmark: DeltaFinderAlg needs a DeltaFinder table\n";
+        if(!inputs.straws) throw cet::exception("BADINPUT")<<"kernelBenchmark: DeltaFinderAlg needs the recorded straws\n";
+        kernels.push_back(deltaFinder(c, *inputs.straws));
+      }
+      else {
+        throw cet::exception("CONFIG")<<"kernelBenchmark: unknown kernel "<<name<<"\n";
+      }
+    }
+    return kernels;
+  }
+
+  Result benchmark(const Kernel& kernel, const mu2e::KernelInputs& inputs, unsigned warmup, unsigned repetitions) {
+    Result result;
+    result.name = kernel.name;
+    result.samples.reserve(repetitions*inputs.events.size());
+    for(unsigned ipass=0; ipass<warmup+repetitions; ++ipass) {
+      const bool timed = ipass >= warmup;
+      for(unsigned iev=0; iev<inputs.events.size(); ++iev) {
+        auto start = std::chrono::steady_clock::now();
+        std::size_t n = kernel.run(inputs.events[iev], iev);
+        double us = std::chrono::duration<double,std::micro>(std::chrono::steady_clock::now()-start).count();
+        if(timed) {
+          result.samples.push_back(us);
+          if(ipass == warmup) result.outputs += n;
+        }
+      }
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    return result;
+  }
+
+  int run(const std::string& configFile, const std::string& inputFile) {
+    mu2e::ParameterSetFromFile pset(configFile);
+    fhicl::Table<Config> table{pset.pSet(), std::set<std::string>{}};
+    const Config& config = table();
+
+    auto start = std::chrono::steady_clock::now();
+    auto inputs = mu2e::readKernelInputs(inputFile);
+    double readms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+    std::size_t nch(0), nsw(0), ncd(0);
+    for(const auto& event : inputs.events) {
+      nch += event.comboHits.size();
+      nsw += event.strawWaveforms.size();
+      ncd += event.caloDigis.size();
+    }
+    std::cout<<"kernelBenchmark: "<<inputs.events.size()<<" events, "<<nch<<" ComboHits, "<<nsw<<" straw waveforms, "
+             <<ncd<<" calo digis from "<<inputFile<<" read in "<<std::fixed<<std::setprecision(1)<<readms<<" ms"<<std::endl;
+    std::cout<<"kernelBenchmark: recorded conditions:"<<(inputs.straws ? " straws" : "")
+             <<(inputs.strawResponse ? " straw response" : "")<<(inputs.caloPulseShape.empty() ? "" : " calo pulse shape")<<std::endl;
+    if(inputs.events.empty()) throw cet::exception("BADINPUT")<<"kernelBenchmark: no events in "<<inputFile<<"\n";
+
+    std::map<std::string,double> references;
+    for(const auto& ref : config.referenceP50()) references[std::get<0>(ref)] = std::get<1>(ref);
+
+    const unsigned warmup(config.warmup()), repetitions(std::max(1u,config.repetitions()));
+    std::cout<<"time per event in us, "<<warmup<<" warm-up and "<<repetitions<<" timed passes"<<std::endl;
+    std::cout<<std::left<<std::setw(20)<<"kernel"<<std::right<<std::setw(10)<<"mean"<<std::setw(10)<<"p50"
+             <<std::setw(10)<<"p90"<<std::setw(10)<<"p99"<<std::setw(10)<<"max"<<std::setw(14)<<"outputs/event"
+             <<std::setw(12)<<"ref p50"<<std::endl;
+
+    int status(0);
+    for(const auto& kernel : makeKernels(config, inputs)) {
+      Result result = benchmark(kernel, inputs, warmup, repetitions);
+      const auto& s = result.samples;
+      const double mean = std::accumulate(s.begin(), s.end(), 0.0)/s.size();
+      const double p50 = percentile(s, 0.5);
+      std::cout<<std::left<<std::setw(20)<<result.name<<std::right<<std::fixed<<std::setprecision(1)
+               <<std::setw(10)<<mean<<std::setw(10)<<p50<<std::setw(10)<<percentile(s, 0.9)
+               <<std::setw(10)<<percentile(s, 0.99)<<std::setw(10)<<s.back()
+               <<std::setw(14)<<double(result.outputs)/inputs.events.size();
+      auto ref = references.find(result.name);
+      if(ref != references.end()) {
+        std::cout<<std::setw(12)<<ref->second;
+        if(p50 > ref->second*(1.0 + config.tolerance())) {
+          std::cout<<"  REGRESSION";
+          status = 3;
+        }
+      }
+      std::cout<<std::endl;
+    }
+    return status;
+  }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+  std::string config;
+  std::vector<std::string> inputs;
+  for(int i=1; i<argc; ++i) {
+    const std::string arg(argv[i]);
+    if     (arg == "-c" && i+1 < argc) config = argv[++i];
+    else if(arg == "-h" || arg == "--help") { usage(); return 0; }
+    else if(arg.rfind("-", 0) == 0) { usage(); return 1; }
+    else inputs.push_back(arg);
+  }
+  if(config.empty() || inputs.size() != 1) {
+    usage();
+    return 1;
+  }
+
+  try {
+    return run(config, inputs[0]);
+  }
+  catch(const cet::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 2;
+  }
+  catch(const std::exception& e) {
+    std::cerr<<e.what()<<std::endl;
+    return 2;
+  }
+}
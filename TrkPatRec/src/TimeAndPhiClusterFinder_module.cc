@@ -10,6 +10,7 @@
 #include "art/Framework/Core/EDProducer.h"
 #include "canvas/Utilities/InputTag.h"
 #include "fhiclcpp/types/Atom.h"
+#include "fhiclcpp/types/OptionalAtom.h"
 #include "fhiclcpp/types/Sequence.h"
 #include "fhiclcpp/types/Table.h"
 
@@ -18,6 +19,7 @@
 #include "Offline/Mu2eUtilities/inc/MVATools.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
@@ -61,6 +63,7 @@ namespace mu2e {
           fhicl::Atom<art::InputTag>              comboHitCollection     {Name("ComboHitCollection"),     Comment("ComboHit collection {Name") };
           fhicl::Atom<art::InputTag>              strawHitFlagCollection {Name("StrawHitFlagCollection"), Comment("StrawHitFlag collection {Name") };
           fhicl::Atom<art::InputTag>              caloClusterCollection  {Name("CaloClusterCollection"),  Comment("Calo cluster collection {Name") };
+          fhicl::OptionalAtom<art::InputTag>      hitTimeIndex           {Name("HitTimeIndex"),           Comment("ComboHitTimeIndex of the ComboHit collection, built here if not set") };
           fhicl::Table<MVATools::Config>          MVATime                {Name("MVATime"),                Comment("MVA for time cluster cleaning") };
           fhicl::Sequence<std::string>            hsel                   {Name("HitSelectionBits"),       Comment("HitSelectionBits") };
           fhicl::Sequence<std::string>            hbkg                   {Name("HitBackgroundBits"),      Comment("HitBackgroundBits") };
@@ -96,6 +99,8 @@ namespace mu2e {
       const art::ProductToken<ComboHitCollection>     chToken_;
       const art::ProductToken<StrawHitFlagCollection> shfToken_;
       const art::ProductToken<CaloClusterCollection>  ccToken_;
+      art::InputTag                                   htiTag_;
+      bool                                            useHTI_;
       MVATools                                        MVATime_;
       StrawHitFlag                                    hsel_, hbkg_;
       bool                                            testflag_;
@@ -118,12 +123,13 @@ namespace mu2e {
 
 
       void findClusters           (const art::Handle<CaloClusterCollection>& ccH, const ComboHitCollection& chcol,
-                                   const StrawHitFlagCollection& shfcol, TimeClusterCollection& tccol);
+                                   const StrawHitFlagCollection& shfcol, const ComboHitTimeIndex& hti,
+                                   unsigned isel, TimeClusterCollection& tccol);
       void findTimePeaks          (const art::Handle<CaloClusterCollection>& ccH, const ComboHitCollection& chcol,
-                                   const StrawHitFlagCollection& shfcol, TimePhiCandidateCollection& timeCandidates);
-      void assignHits1            (const ComboHitCollection& chcol, const std::vector<unsigned>& chCood,
+                                   const ComboHitTimeIndex& hti, unsigned isel, TimePhiCandidateCollection& timeCandidates);
+      void assignHits1            (const ComboHitCollection& chcol, const ComboHitTimeIndex& hti, unsigned isel,
                                    float timePeakLow, float timePeakHigh, TimePhiCandidate& tc);
-      void assignHits2            (const ComboHitCollection& chcol, const std::vector<unsigned>& chCood,
+      void assignHits2            (const ComboHitCollection& chcol, const ComboHitTimeIndex& hti, unsigned isel,
                                    const std::vector<float>& timePeaks, unsigned ipeak, TimePhiCandidate& tc);
       void addCalo                (const art::Handle<CaloClusterCollection>& ccH, std::vector<unsigned>& timeHist, float tmin);
       void addCaloPtr             (const art::Handle<CaloClusterCollection>& ccH,  TimePhiCandidate& tc, float time);
@@ -151,6 +157,7 @@ namespace mu2e {
     chToken_             {consumes<ComboHitCollection>      (config().comboHitCollection())     },
     shfToken_            {mayConsume<StrawHitFlagCollection>(config().strawHitFlagCollection()) },
     ccToken_             {mayConsume<CaloClusterCollection> (config().caloClusterCollection())  },
+    useHTI_              (config().hitTimeIndex(htiTag_)),
     MVATime_             (config().MVATime()),
     hsel_                (config().hsel()),
     hbkg_                (config().hbkg()),
@@ -173,6 +180,7 @@ namespace mu2e {
     diagTool_(),
     data_()
     {
+       if (useHTI_) consumes<ComboHitTimeIndex>(htiTag_);
        produces<TimeClusterCollection>();
 
        if (algoAssignHits_ !=1 && algoAssignHits_ !=2)
@@ -211,10 +219,25 @@ namespace mu2e {
       if (testflag_ && shfcol.size() != chcol.size())
         throw cet::exception("RECO")<<"TimeAndPhiClusterFinder: inconsistent flag collection length " << std::endl;
 
+      // time-sorted selected hits, shared with the other time cluster finders if available
+      const StrawHitFlag hsel = testflag_ ? hsel_ : StrawHitFlag();
+      const StrawHitFlag hbkg = testflag_ ? hbkg_ : StrawHitFlag();
+      ComboHitTimeIndex localhti;
+      const ComboHitTimeIndex* hti(&localhti);
+      int isel(0);
+      if (useHTI_) {
+        hti  = event.getValidHandle<ComboHitTimeIndex>(htiTag_).product();
+        isel = hti->findSelection(hsel,hbkg);
+        if (hti->nHits() != chcol.size() || isel < 0)
+          throw cet::exception("RECO")<<"TimeAndPhiClusterFinder: time index " << htiTag_ << " does not match the hit collection or selection" << std::endl;
+      } else {
+        localhti = ComboHitTimeIndex(chcol, testflag_ ? &shfcol : nullptr, {hsel}, {hbkg});
+      }
+
       if (diag_) {data_.reset(); data_.event_=&event; data_.chcol_ = &chcol;}
 
       std::unique_ptr<TimeClusterCollection> tccol(new TimeClusterCollection);
-      findClusters(ccH, chcol, shfcol, *tccol);
+      findClusters(ccH, chcol, shfcol, *hti, isel, *tccol);
 
       if (diag_) diagTool_->fillHistograms(&data_);
       event.put(std::move(tccol));
@@ -223,12 +246,13 @@ namespace mu2e {
 
   //----------------------------------------------------------ch----------------------------------------------------
   void TimeAndPhiClusterFinder::findClusters(const art::Handle<CaloClusterCollection>& ccH, const ComboHitCollection& chcol,
-                                             const StrawHitFlagCollection& shfcol,          TimeClusterCollection& tccol)
+                                             const StrawHitFlagCollection& shfcol,          const ComboHitTimeIndex& hti,
+                                             unsigned isel,                                  TimeClusterCollection& tccol)
   {
       // Find time peaks
       std::vector<TimePhiCandidate> timeCandidates;
       timeCandidates.reserve(64);
-      findTimePeaks(ccH, chcol, shfcol, timeCandidates);
+      findTimePeaks(ccH, chcol, hti, isel, timeCandidates);
 
 
       // Refine time peaks and create split phi clusters
@@ -259,28 +283,19 @@ namespace mu2e {
   //--------------------------------------------------------------------------------------------------------------
 
   void TimeAndPhiClusterFinder::findTimePeaks(const art::Handle<CaloClusterCollection>& ccH, const ComboHitCollection& chcol,
-                                              const StrawHitFlagCollection& shfcol, TimePhiCandidateCollection& timeCandidates)
+                                              const ComboHitTimeIndex& hti, unsigned isel, TimePhiCandidateCollection& timeCandidates)
   {
-      // Select good hits and sort them by time
-      std::vector<unsigned> chGood;
-      chGood.reserve(chcol.size());
-      for (size_t ich=0; ich<chcol.size();++ich){
-          if (!testflag_ || goodHit(shfcol[ich])) chGood.emplace_back(ich);
-      }
-      auto sortFcn = [&chcol](unsigned i1, unsigned i2){return chcol[i1].correctedTime() < chcol[i2].correctedTime();};
-      sort(chGood.begin(),chGood.end(),sortFcn);
-
+      // Good hits are sorted by time in the index
+      const auto good = hti.range(isel);
+      if (good.first == good.second) return;
 
       // Fill the time histogram with hit corrected times (add buffer to hist boundaries). Add calo hits if requested
-      float tmax     = chcol[chGood.back()].correctedTime() + 4*maxTimeDT_;
-      float tmin     = std::max(0.0f, chcol[chGood.front()].correctedTime() - 4*maxTimeDT_);
+      float tmax     = hti.time(good.second-1) + 4*maxTimeDT_;
+      float tmin     = std::max(0.0f, hti.time(good.first) - 4*maxTimeDT_);
       unsigned nbins = unsigned((tmax-tmin)/tbin_);
 
-      std::vector<unsigned> timeHist(nbins,0);
-      for (auto ich : chGood){
-          unsigned ibin = unsigned((chcol[ich].correctedTime() - tmin)/tbin_);
-          timeHist[ibin] += chcol[ich].nStrawHits();
-      }
+      std::vector<unsigned> timeHist;
+      hti.histogram(isel, tmin, tbin_, nbins, timeHist);
       if (usecc_) addCalo(ccH, timeHist, tmin);
 
       // Scan for local maxima (algorithm basd on maximum in sub-array with queue)
@@ -305,8 +320,8 @@ namespace mu2e {
       //Create time cluster candidates
       for (size_t i=0;i<timePeaks.size();++i){
            TimePhiCandidate tc;
-           if (algoAssignHits_ == 1) assignHits1(chcol,chGood, timePeaks[i]- maxTimeDT_, timePeaks[i]+maxTimeDT_, tc);
-           else                      assignHits2(chcol,chGood, timePeaks, i, tc);
+           if (algoAssignHits_ == 1) assignHits1(chcol,hti,isel, timePeaks[i]- maxTimeDT_, timePeaks[i]+maxTimeDT_, tc);
+           else                      assignHits2(chcol,hti,isel, timePeaks, i, tc);
 
            if (tc.nsh_ < minNSHits_) continue;
 
@@ -318,29 +333,24 @@ namespace mu2e {
 
   //--------------------------------------------------------------------------------------------------------------
   // Assign hits to timeCandidates to maximize efficiency - hits can be assigned to several timeCandidates.
-  // Note: hits must be time ordered
-  void TimeAndPhiClusterFinder::assignHits1(const ComboHitCollection& chcol, const std::vector<unsigned>& chGood,
+  void TimeAndPhiClusterFinder::assignHits1(const ComboHitCollection& chcol, const ComboHitTimeIndex& hti, unsigned isel,
                                             float timePeakLow, float timePeakHigh, TimePhiCandidate& tc)
   {
-      for (const auto& ich : chGood){
-          float time = chcol[ich].correctedTime();
-          if (time < timePeakLow) continue;
-          if (time > timePeakHigh) break;
-          tc.strawIdx_.emplace_back(ich);
-          tc.nsh_ += chcol.at(ich).nStrawHits();
-      }
+      const auto entries = hti.window(isel, timePeakLow, timePeakHigh);
+      for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) tc.strawIdx_.emplace_back(hti.hit(ientry));
+      tc.nsh_ += hti.nStrawHits(entries);
   }
 
   //--------------------------------------------------------------------------------------------------------------
   // Assign hits to time clusters to maximize purity - hits are assigned to closest timeCandidates
-  // use the fact that TimeClusters are time ordered.  Note: hits must be time ordered
-  void TimeAndPhiClusterFinder::assignHits2(const ComboHitCollection& chcol, const std::vector<unsigned>& chGood,
+  // use the fact that TimeClusters are time ordered.
+  void TimeAndPhiClusterFinder::assignHits2(const ComboHitCollection& chcol, const ComboHitTimeIndex& hti, unsigned isel,
                                             const std::vector<float>& timePeaks, unsigned ipeak, TimePhiCandidate& tc)
   {
-      for (const auto& ich : chGood){
-          float time = chcol[ich].correctedTime();
-          if (time < timePeaks[ipeak] - maxTimeDT_) continue;
-          if (time > timePeaks[ipeak] + maxTimeDT_) break;
+      const auto entries = hti.window(isel, timePeaks[ipeak] - maxTimeDT_, timePeaks[ipeak] + maxTimeDT_);
+      for (unsigned ientry=entries.first; ientry<entries.second; ++ientry){
+          unsigned ich = hti.hit(ientry);
+          float time = hti.time(ientry);
 
           // Check if the previous peak or next peak is a better match
           float dt = abs(chcol[ich].correctedTime()-timePeaks[ipeak]);
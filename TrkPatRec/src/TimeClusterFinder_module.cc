@@ -7,16 +7,19 @@
 // framework
 #include "art/Framework/Principal/Event.h"
 #include "fhiclcpp/ParameterSet.h"
+#include "fhiclcpp/types/OptionalAtom.h"
 #include "fhiclcpp/types/Sequence.h"
 #include "art/Framework/Principal/Handle.h"
 #include "art/Framework/Core/EDProducer.h"
 #include "art_root_io/TFileService.h"
 // Mu2e
 #include "Offline/GeneralUtilities/inc/Angles.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 #include "Offline/Mu2eUtilities/inc/MVATools.hh"
 #include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
 // data
 #include "Offline/RecoDataProducts/inc/ComboHit.hh"
+#include "Offline/RecoDataProducts/inc/ComboHitTimeIndex.hh"
 #include "Offline/RecoDataProducts/inc/StrawHitFlag.hh"
 #include "Offline/RecoDataProducts/inc/TimeCluster.hh"
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
@@ -77,6 +80,7 @@ namespace mu2e {
         fhicl::Atom<art::InputTag>              comboHitCollection     {Name("ComboHitCollection"),     Comment("ComboHit collection {Name") };
         fhicl::Atom<art::InputTag>              strawHitFlagCollection {Name("StrawHitFlagCollection"), Comment("StrawHitFlag collection {Name") };
         fhicl::Atom<art::InputTag>              caloClusterCollection  {Name("CaloClusterCollection"),  Comment("Calo cluster collection {Name") };
+        fhicl::OptionalAtom<art::InputTag>      hitTimeIndex           {Name("HitTimeIndex"),           Comment("ComboHitTimeIndex of the ComboHit collection, built here if not set") };
         fhicl::Table<MVATools::Config>          tcMVA                  {Name("ClusterMVA"),             Comment("MVA for time cluster cleaning") };
         fhicl::Table<MVATools::Config>          tcCaloMVA              {Name("ClusterCaloMVA"),         Comment("MVA for time clsuter cleaning with calo") };
         fhicl::Sequence<std::string>            hsel                   {Name("HitSelectionBits"),       Comment("HitSelectionBits") };
@@ -122,6 +126,11 @@ namespace mu2e {
       const StrawHitFlagCollection* _shfcol;
       const ComboHitCollection*     _chcol;
       const CaloClusterCollection*  _cccol;
+      art::InputTag                 _htiTag;
+      bool                          _useHTI;
+      const ComboHitTimeIndex*      _hti;
+      ComboHitTimeIndex             _localhti;
+      unsigned                      _isel;  // hit selection in the time index
       StrawHitFlag                  _hsel;
       StrawHitFlag                  _hbkg;
       MVATools                      _tcMVA;
@@ -143,7 +152,8 @@ namespace mu2e {
       int                           _npeak;
       int                           _printfreq;
       int                           _debug;
-      TH1F                          _timespec;
+      std::vector<float>            _timespec;  // straw hits per time bin in [_tmin,_tmax)
+      float                         _tspecbin;
       TimeCluMVA                    _pmva; // input variables to TMVA for cluster cleaning
 
 
@@ -160,6 +170,7 @@ namespace mu2e {
       void findPeaks(TimeClusterCollection& seeds);
       void assignHits(TimeClusterCollection& tccol );
       bool goodHit(const StrawHitFlag& flag) const;
+      ComboHitTimeIndex::Range timeWindow(float tmin, float tmax) const;
   };
 
 
@@ -168,6 +179,7 @@ namespace mu2e {
     _chToken      { consumes<ComboHitCollection>(      config().comboHitCollection()) },
     _shfToken     { mayConsume<StrawHitFlagCollection>(config().strawHitFlagCollection()) },
     _ccToken      { mayConsume<CaloClusterCollection>( config().caloClusterCollection()) },
+    _useHTI       ( config().hitTimeIndex(_htiTag)),
     _hsel         ( config().hsel()),
     _hbkg         ( config().hbkg()),
     _tcMVA        ( config().tcMVA()),
@@ -196,7 +208,9 @@ namespace mu2e {
     _debug        ( config().debugLevel())
     {
       unsigned nbins = (unsigned)rint((_tmax-_tmin)/_tbin);
-      _timespec = TH1F("timespec","time spectrum",nbins,_tmin,_tmax);
+      _timespec.resize(nbins);
+      _tspecbin = (_tmax-_tmin)/nbins;
+      if (_useHTI) consumes<ComboHitTimeIndex>(_htiTag);
       produces<TimeClusterCollection>();
     }
 
@@ -215,6 +229,7 @@ namespace mu2e {
 
   //--------------------------------------------------------------------------------------------------------------
   void TimeClusterFinder::produce(art::Event & event ){
+    MU2E_PROFILE_SCOPE("TimeClusterFinder::produce");
     _iev = event.id().event();
 
     if (_debug > 0 && (_iev%_printfreq)==0) std::cout<<"TimeClusterFinder: event="<<_iev<<std::endl;
@@ -235,6 +250,21 @@ namespace mu2e {
         throw cet::exception("RECO")<<"TimeClusterFinder: inconsistent flag collection length " << endl;
     }
 
+    // time-sorted selected hits, shared with the other time cluster finders if available
+    const StrawHitFlag hsel = _testflag ? _hsel : StrawHitFlag();
+    const StrawHitFlag hbkg = _testflag ? _hbkg : StrawHitFlag();
+    if (_useHTI) {
+      _hti = event.getValidHandle<ComboHitTimeIndex>(_htiTag).product();
+      int isel = _hti->findSelection(hsel,hbkg);
+      if (_hti->nHits() != _chcol->size() || isel < 0)
+        throw cet::exception("RECO")<<"TimeClusterFinder: time index " << _htiTag << " does not match the hit collection or selection" << endl;
+      _isel = isel;
+    } else {
+      _localhti = ComboHitTimeIndex(*_chcol, _testflag ? _shfcol : nullptr, {hsel}, {hbkg});
+      _hti  = &_localhti;
+      _isel = 0;
+    }
+
     std::unique_ptr<TimeClusterCollection> tccol(new TimeClusterCollection);
     // If requested, use calo clusters to for time cluster seeds
     if (_usecc) findCaloSeeds(*tccol,ccH);
@@ -285,12 +315,12 @@ namespace mu2e {
     // debug test of histogram
     if (_debug > 2) {
       art::ServiceHandle<art::TFileService> tfs;
-      TH1F* tspec = tfs->make<TH1F>(_timespec);
       char name[40];
       char title[100];
       snprintf(name,40,"tspec_%i",_iev);
       snprintf(title,100,"time spectrum event %i;nsec",_iev);
-      tspec->SetNameTitle(name,title);
+      TH1F* tspec = tfs->make<TH1F>(name,title,_timespec.size(),_tmin,_tmax);
+      for (unsigned ibin=0; ibin<_timespec.size(); ++ibin) tspec->SetBinContent(ibin+1,_timespec[ibin]);
     }
   }
 
@@ -307,62 +337,82 @@ namespace mu2e {
   }
 
   //--------------------------------------------------------------------------------------------------------------
+  // entries of the time index whose time (corrected for the time of flight) can be in [tmin,tmax]
+  ComboHitTimeIndex::Range TimeClusterFinder::timeWindow(float tmin, float tmax) const {
+    if (!_ttcalc.useTOTdrift() || _hti->range(_isel).first == _hti->range(_isel).second) return _hti->range(_isel);
+    float tof1 = _ttcalc.timeOfFlightTimeOffset(_hti->zmin(_isel),_pitch);
+    float tof2 = _ttcalc.timeOfFlightTimeOffset(_hti->zmax(_isel),_pitch);
+    static const float margin(1.0); // float rounding
+    return _hti->window(_isel, tmin + std::min(tof1,tof2) - margin, tmax + std::max(tof1,tof2) + margin);
+  }
+
   void TimeClusterFinder::fillTimeSpectrum() {
-    _timespec.Reset();
-    for (unsigned istr=0; istr<_chcol->size();++istr) {
-      if (_testflag && !goodHit((*_shfcol)[istr])) continue;
-      ComboHit const& ch = (*_chcol)[istr];
-      float time = _ttcalc.comboHitTime((*_chcol)[istr],_pitch);
-      _timespec.Fill(time,ch.nStrawHits());
+    std::fill(_timespec.begin(),_timespec.end(),0.0);
+    auto entries = _hti->range(_isel);
+    for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) {
+      ComboHit const& ch = (*_chcol)[_hti->hit(ientry)];
+      float time = _ttcalc.comboHitTime(ch,_pitch);
+      if (time < _tmin || time >= _tmax) continue;
+      unsigned ibin = std::min(unsigned((time-_tmin)/_tspecbin), unsigned(_timespec.size()-1));
+      _timespec[ibin] += ch.nStrawHits();
     }
   }
 
   void TimeClusterFinder::assignHits(TimeClusterCollection& tccol ) {
+    if (tccol.empty()) return;
+    // only the hits within the widest seed window can be assigned
+    float tlo(1e10), thi(-1e10);
+    for (auto const& tc : tccol) {
+      tlo = std::min(tlo, float(tc._t0._t0 - _maxdt - tc._t0._t0err));
+      thi = std::max(thi, float(tc._t0._t0 + _maxdt + tc._t0._t0err));
+    }
     // assign hits to the closest time peak
-    for(size_t istr=0; istr<_chcol->size(); ++istr) {
-      if ((!_testflag) || goodHit((*_shfcol)[istr])) {
-        ComboHit const& ch =(*_chcol)[istr];
-        float time = _ttcalc.comboHitTime(ch,_pitch);
-        float mindt(1e5);
-        auto besttc = tccol.end();
-        // find the closest seed (if any)
-        for (auto itc = tccol.begin(); itc != tccol.end(); ++itc) {
-          float dt = fabs(time - itc->_t0._t0);
-          // make an absolute cut, including error on the cluster t0
-          if (dt < _maxdt+itc->_t0._t0err && dt < mindt){
-            mindt = dt;
-            besttc = itc;
-          }
+    auto entries = timeWindow(tlo,thi);
+    for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) {
+      StrawHitIndex istr = _hti->hit(ientry);
+      ComboHit const& ch =(*_chcol)[istr];
+      float time = _ttcalc.comboHitTime(ch,_pitch);
+      float mindt(1e5);
+      auto besttc = tccol.end();
+      // find the closest seed (if any)
+      for (auto itc = tccol.begin(); itc != tccol.end(); ++itc) {
+        float dt = fabs(time - itc->_t0._t0);
+        // make an absolute cut, including error on the cluster t0
+        if (dt < _maxdt+itc->_t0._t0err && dt < mindt){
+          mindt = dt;
+          besttc = itc;
         }
-        if(besttc != tccol.end())
-          besttc->_strawHitIdxs.push_back(istr);
       }
+      if(besttc != tccol.end())
+        besttc->_strawHitIdxs.push_back(istr);
     }
+    // keep the hits in collection order, the medians of initCluster depend on it
+    for (auto& tc : tccol) std::sort(tc._strawHitIdxs.begin(),tc._strawHitIdxs.end());
   }
 
   //--------------------------------------------------------------------------------------------------------------
   void TimeClusterFinder::findPeaks(TimeClusterCollection& tccol) {
-    int nbins = _timespec.GetNbinsX()+1;
+    int nbins = _timespec.size();
     std::vector<bool> alreadyUsed(nbins,false);
-    // blank out bins around input times (from calo clusters)
+    // blank out bins around input times (from calo clusters), -1 and nbins are the under and overflow
     for(auto const& tc : tccol ){
-      int ibin = _timespec.FindBin(tc._t0._t0);
-      for(int jbin = std::max(1,ibin-_npeak);jbin < std::min(nbins,ibin+_npeak+1); ++jbin)
+      int ibin = tc._t0._t0 < _tmin ? -1 : std::min(nbins, int((tc._t0._t0-_tmin)/_tspecbin));
+      for(int jbin = std::max(0,ibin-_npeak);jbin < std::min(nbins,ibin+_npeak+1); ++jbin)
         alreadyUsed[jbin] = true;
     }
     // loop over spectrum to find peaks
     std::vector<BinContent> bcv;
-    for (int ibin=1;ibin < nbins; ++ibin)
-      if (_timespec.GetBinContent(ibin) >= _ymin) bcv.push_back(make_pair(_timespec.GetBinContent(ibin),ibin));
-    std::sort(bcv.begin(),bcv.end(),[](const BinContent& x, const BinContent& y){return x.first > y.first;});
+    for (int ibin=0;ibin < nbins; ++ibin)
+      if (_timespec[ibin] >= _ymin) bcv.push_back(make_pair(_timespec[ibin],ibin));
+    std::stable_sort(bcv.begin(),bcv.end(),[](const BinContent& x, const BinContent& y){return x.first > y.first;});
 
     for (const auto& bc : bcv) {
       if (alreadyUsed[bc.second]) continue;
       float nsh(0.0);
       float t0(0.0);
-      for (int ibin = std::max(1,bc.second-_npeak);ibin < std::min(nbins,bc.second+_npeak+1); ++ibin) {
-        nsh += _timespec.GetBinContent(ibin);
-        t0 += _timespec.GetBinCenter(ibin)*_timespec.GetBinContent(ibin);
+      for (int ibin = std::max(0,bc.second-_npeak);ibin < std::min(nbins,bc.second+_npeak+1); ++ibin) {
+        nsh += _timespec[ibin];
+        t0 += (_tmin + (ibin+0.5)*_tspecbin)*_timespec[ibin];
         alreadyUsed[ibin] = true;
       }
       t0 /= nsh;
@@ -450,32 +500,36 @@ namespace mu2e {
     while (changed) {
       changed = false;
       float pphi = polyAtan2(tc._pos.y(), tc._pos.x());
-      for(size_t ich=0;ich < _chcol->size(); ++ich){
-        if ((!_testflag) || goodHit((*_shfcol)[ich])) {
-          if(std::find(tc._strawHitIdxs.begin(),tc._strawHitIdxs.end(),ich) == tc._strawHitIdxs.end()){
-            ComboHit const& ch = (*_chcol)[ich];
-            float cht = _ttcalc.comboHitTime(ch,_pitch);
-            _pmva._dt = fabs(cht - tc._t0._t0);
-            if(_pmva._dt < _maxdt+tc._t0._t0err){
-              float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
-              float dphi = fabs(Angles::deltaPhi(phi,pphi));
-              if(dphi < _maxdPhi){
-                _pmva._dphi = dphi;
-                _pmva._rho = ch.pos().Perp2();
-                _pmva._nsh = ch.nStrawHits();
-                _pmva._plane = ch.strawId().plane();
-                _pmva._werr = ch.wireRes();
-                _pmva._wdist = fabs(ch.wireDist());
-
-                float mvaout(-1.0);
-                if (tc.hasCaloCluster())
-                  mvaout = _tcCaloMVA.evalMVA(_pmva._pars);
-                else
-                  mvaout = _tcMVA.evalMVA(_pmva._pars);
-                if (mvaout > _minaddmva) {
-                  addHit(tc,ich);
-                  changed = true;
-                }
+      // candidates in time, taken in collection order as the cluster is updated at each addition
+      auto entries = timeWindow(tc._t0._t0 - _maxdt - tc._t0._t0err, tc._t0._t0 + _maxdt + tc._t0._t0err);
+      std::vector<StrawHitIndex> candidates;
+      candidates.reserve(entries.second-entries.first);
+      for (unsigned ientry=entries.first; ientry<entries.second; ++ientry) candidates.push_back(_hti->hit(ientry));
+      std::sort(candidates.begin(),candidates.end());
+      for(StrawHitIndex ich : candidates){
+        if(std::find(tc._strawHitIdxs.begin(),tc._strawHitIdxs.end(),ich) == tc._strawHitIdxs.end()){
+          ComboHit const& ch = (*_chcol)[ich];
+          float cht = _ttcalc.comboHitTime(ch,_pitch);
+          _pmva._dt = fabs(cht - tc._t0._t0);
+          if(_pmva._dt < _maxdt+tc._t0._t0err){
+            float phi = polyAtan2(ch.pos().y(), ch.pos().x());//ch.phi();
+            float dphi = fabs(Angles::deltaPhi(phi,pphi));
+            if(dphi < _maxdPhi){
+              _pmva._dphi = dphi;
+              _pmva._rho = ch.pos().Perp2();
+              _pmva._nsh = ch.nStrawHits();
+              _pmva._plane = ch.strawId().plane();
+              _pmva._werr = ch.wireRes();
+              _pmva._wdist = fabs(ch.wireDist());
+
+              float mvaout(-1.0);
+              if (tc.hasCaloCluster())
+                mvaout = _tcCaloMVA.evalMVA(_pmva._pars);
+              else
+                mvaout = _tcMVA.evalMVA(_pmva._pars);
+              if (mvaout > _minaddmva) {
+                addHit(tc,ich);
+                changed = true;
               }
             }
           }
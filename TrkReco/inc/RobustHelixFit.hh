@@ -109,6 +109,11 @@ namespace mu2e
         fhicl::Atom<int> initFZFrequencyArraySize{fhicl::Name("initFZFrequencyArraySize"), fhicl::Comment("init FZ frequency array size")};
         fhicl::Atom<int> initFZFrequencyNMaxPeaks{fhicl::Name("initFZFrequencyNMaxPeaks"), fhicl::Comment("init FZ frequency number of max peaks")};
         fhicl::Atom<float> initFZFrequencyTolerance{fhicl::Name("initFZFrequencyTolerance"), fhicl::Comment("init FZ frequency tolerance")};
+        fhicl::Atom<bool> TripleSampling{fhicl::Name("TripleSampling"), fhicl::Comment("sample random triplets in the median circle fit when there are more triplets than TripleSamplingMaxTries"), false};
+        fhicl::Atom<unsigned> TripleSamplingMaxTries{fhicl::Name("TripleSamplingMaxTries"), fhicl::Comment("maximum number of sampled triplets"), 20000};
+        fhicl::Atom<unsigned> TripleSamplingCheck{fhicl::Name("TripleSamplingCheck"), fhicl::Comment("number of accepted triplets between convergence checks"), 50};
+        fhicl::Atom<float> TripleSamplingTolerance{fhicl::Name("TripleSamplingTolerance"), fhicl::Comment("change in the median center (mm) below which the sampling has converged"), 1.0};
+        fhicl::Atom<unsigned> TripleSamplingSeed{fhicl::Name("TripleSamplingSeed"), fhicl::Comment("base seed of the triplet sampler; the seed of a fit also depends on its hits"), 5489};
       };
 
       explicit RobustHelixFit(const Config& config);
@@ -155,6 +160,8 @@ namespace mu2e
       void fitHelix(RobustHelixFinderData& helixData, bool forceTargetCon, bool useTripletAreaWt=false);
       void fitCircleAGE(RobustHelixFinderData& helixData);
       void fitCircleMean(RobustHelixFinderData& helixData);
+      bool tripleCircle(XYWVec const& wp1, XYWVec const& wp2, XYWVec const& wp3, float dist2ij,
+          bool forceTargetCon, bool useTripleAreaWt, float& cx, float& cy, float& rho, float& wt) const;
       void findAGE(RobustHelixFinderData  const& helixData, XYZVectorF const& center,float& rmed, float& age);
       void fillSums(RobustHelixFinderData const& helixData, XYZVectorF const& center,float rmed,AGESums& sums);
       void forceTargetInter(XYZVectorF& center, float& radius);
@@ -210,6 +217,9 @@ namespace mu2e
       Helicity _helicity; // helicity value to look for.  This defines the sign of dphi/dz
       TH1F _hphi;
       unsigned _ntripleMin, _ntripleMax;
+      bool     _tripleSampling; // sample triples instead of enumerating them all
+      unsigned _tripleMaxTries, _tripleCheck, _tripleSeed;
+      float    _tripleTol2; // squared center convergence tolerance
       bool     _use_initFZ_from_dzFrequency;
       float    _initFZFrequencyNSigma;
       int      _initFZFrequencyBinsToIntegrate;
@@ -54,6 +54,8 @@ namespace mu2e
       double strawHitTimeErr() const { return _shErr; }
       double trkToCaloTimeOffset() const { return _caloTimeOffset; }
       double caloClusterTimeErr() const { return _caloTimeErr; }
+      // comboHitTime is the corrected time minus the time of flight
+      bool   useTOTdrift() const { return _useTOTdrift; }
       // same for a ComboHit
       double comboHitTime(ComboHit const& ch,double pitch);
       // calculate the t0 for a calo cluster.
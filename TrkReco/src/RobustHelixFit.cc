@@ -15,6 +15,7 @@
 #include "Offline/RecoDataProducts/inc/CaloCluster.hh"
 
 #include "Offline/Mu2eUtilities/inc/polyAtan2.hh"
+#include "Offline/GeneralUtilities/inc/Profiler.hh"
 
 // root
 // #include "TH1F.h"
@@ -23,6 +24,8 @@
 //c++
 #include <vector>
 #include <utility>
+#include <algorithm>
+#include <random>
 #include <string>
 #include <cmath>
 
@@ -81,6 +84,11 @@ namespace mu2e
     _hphi("hphi","phi value",_nphibins,-_phifactor*CLHEP::pi,_phifactor*CLHEP::pi),
     _ntripleMin(config.ntripleMin()),
     _ntripleMax(config.ntripleMax()),
+    _tripleSampling(config.TripleSampling()),
+    _tripleMaxTries(config.TripleSamplingMaxTries()),
+    _tripleCheck(std::max(1u,config.TripleSamplingCheck())),
+    _tripleSeed(config.TripleSamplingSeed()),
+    _tripleTol2(config.TripleSamplingTolerance()*config.TripleSamplingTolerance()),
     _use_initFZ_from_dzFrequency(config.use_initFZ_from_dzFrequency()),
     _initFZMinL(config.initFZMinLambda()),
     _initFZMaxL(config.initFZMaxLambda()),
@@ -108,6 +116,7 @@ namespace mu2e
 
 
   void RobustHelixFit::fitHelix(RobustHelixFinderData& HelixData, bool forceTargetCon, bool useTripletAreaWt) {
+    MU2E_PROFILE_SCOPE("RobustHelixFit::fitHelix");
     HelixData._hseed._status.clear(TrkFitFlag::helixOK);
 
     fitCircle(HelixData, forceTargetCon, useTripletAreaWt);
@@ -132,6 +141,7 @@ namespace mu2e
   }
 
   void RobustHelixFit::fitCircle(RobustHelixFinderData& HelixData, bool forceTargetCon, bool useTripleAreaWt) {
+    MU2E_PROFILE_SCOPE("RobustHelixFit::fitCircle");
     HelixData._hseed._status.clear(TrkFitFlag::circleOK);
 
     // if required, initialize
@@ -925,6 +935,7 @@ bool RobustHelixFit::initFZ_from_dzFrequency(RobustHelixFinderData& HelixData, i
 
 
 void RobustHelixFit::fitFZ(RobustHelixFinderData& HelixData) {
+  MU2E_PROFILE_SCOPE("RobustHelixFit::fitFZ");
   // if required, initialize
   HelixData._hseed._status.clear(TrkFitFlag::phizOK);
   if (!HelixData._hseed._status.hasAllProperties(TrkFitFlag::phizInit))
@@ -1097,6 +1108,62 @@ void RobustHelixFit::fitFZ_2(RobustHelixFinderData& HelixData, int UseInteligent
   }
 }
 
+// circle through a triple of hits, subject to the triplet and circle cuts.  dist2ij is the
+// squared distance between the first 2 points, which the caller has already tested
+bool RobustHelixFit::tripleCircle(XYWVec const& wposP1, XYWVec const& wposP2, XYWVec const& wposP3, float dist2ij,
+    bool forceTargetCon, bool useTripleAreaWt, float& cx, float& cy, float& rho, float& wt) const
+{
+  const float mind2 = _mindist*_mindist;
+  const float maxd2 = _maxdist*_maxdist;
+
+  float dist2ik = (wposP1-wposP3).Mag2();
+  float dist2jk = (wposP2-wposP3).Mag2();
+  if (dist2ik < mind2 || dist2jk < mind2 ||
+      dist2ik > maxd2 || dist2jk > maxd2)   return false;
+
+  // Heron's formula
+  float area2 = (dist2ij*dist2jk + dist2ik*dist2jk + dist2ij*dist2ik) - 0.5*(dist2ij*dist2ij + dist2jk*dist2jk + dist2ik*dist2ik);
+  if(area2 < _minarea2)              return false;
+  // this effectively measures the slope difference
+  float delta = (wposP3.x() - wposP2.x())*(wposP2.y() - wposP1.y()) -
+    (wposP2.x() - wposP1.x())*(wposP3.y() - wposP2.y());
+
+  float ri2 = wposP1.Mag2();
+  float rj2 = wposP2.Mag2();
+  float rk2 = wposP3.Mag2();
+
+  // find circle center for this triple
+  cx = 0.5* (
+      (wposP3.y() - wposP2.y())*ri2 +
+      (wposP1.y() - wposP3.y())*rj2 +
+      (wposP2.y() - wposP1.y())*rk2 ) / delta;
+  cy = -0.5* (
+      (wposP3.x() - wposP2.x())*ri2 +
+      (wposP1.x() - wposP3.x())*rj2 +
+      (wposP2.x() - wposP1.x())*rk2 ) / delta;
+  XYVec cent(cx,cy);
+  rho = sqrtf((wposP1-cent).Mag2());
+  float rc = sqrtf(cent.Mag2());
+  float rmin = fabs(rc-rho);
+  float rmax = rc+rho;
+
+  // test circle parameters for this triple: should be inside the tracker,
+  // optionally consistent with the target
+  if (rc > _rcmin && rc < _rcmax &&
+      rho > _rmin && rho < _rmax && rmax < _trackerradius &&
+      //        ( !_targetcon || rmin < _targetradius) )
+      ( !forceTargetCon || rmin < _targetradius) )
+  {
+    if (!useTripleAreaWt){
+      wt  = cbrtf(wposP1.weight()*wposP2.weight()*wposP3.weight());
+    } else{
+      wt = area2;
+    }
+    return true;
+  }
+  return false;
+}
+
 // simple median fit.  No initialization required
 void RobustHelixFit::fitCircleMedian(RobustHelixFinderData& HelixData, bool forceTargetCon, bool useTripleAreaWt)
 {
@@ -1106,93 +1173,79 @@ void RobustHelixFit::fitCircleMedian(RobustHelixFinderData& HelixData, bool forc
   // ComboHitCollection& hhits = HelixData._hseed._hhits;
   RobustHelix* rhel         = &HelixData._hseed._helix;
   MedianCalculator   accx(_ntripleMax), accy(_ntripleMax), accr(_ntripleMax);
-  // loop over all triples
   unsigned      ntriple(0);
 
-  ComboHit*     hitP1(0), *hitP2(0), *hitP3(0);
-  int           facezP1(-1), facezP2(-1), facezP3(-1);
+  ComboHit*     hitP1(0);
   int           nHits(HelixData._chHitsToProcess.size());
+  float         cx, cy, trho, wt;
 
-  for (int f1=0; f1<nHits-2; ++f1){
-    hitP1 = &HelixData._chHitsToProcess[f1];
-    if (!use(*hitP1) )                          continue;
-    XYWVec& wposP1 = HelixData._chHitsWPos[f1];
-    facezP1 = wposP1.face();
-    float   ri2    = wposP1.Mag2();
-
-    for (int f2=f1+1; f2<nHits-1; ++f2){
-      hitP2 = &HelixData._chHitsToProcess[f2];
-      XYWVec& wposP2  = HelixData._chHitsWPos[f2];
-      facezP2 = wposP2.face();
-      if (!use(*hitP2) || (facezP1 == facezP2)) continue;
-
-      float   dist2ij = (wposP1 - wposP2).Mag2();
-      if (dist2ij < mind2 || dist2ij > maxd2) continue;
-
-      float rj2 = wposP2.Mag2();
-
-      for (int f3=f2+1; f3<nHits; ++f3){
-        hitP3 = &HelixData._chHitsToProcess[f3];
-        XYWVec& wposP3 = HelixData._chHitsWPos[f3];
-        facezP3 = wposP3.face();
-        if (!use(*hitP3) || (facezP2 == facezP3) ) continue;
-
-        float dist2ik = (wposP1-wposP3).Mag2();
-        float dist2jk = (wposP2-wposP3).Mag2();
-        if (dist2ik < mind2 || dist2jk < mind2 ||
-            dist2ik > maxd2 || dist2jk > maxd2)   continue;
-
-        // Heron's formula
-        float area2 = (dist2ij*dist2jk + dist2ik*dist2jk + dist2ij*dist2ik) - 0.5*(dist2ij*dist2ij + dist2jk*dist2jk + dist2ik*dist2ik);
-        if(area2 < _minarea2)              continue;
-        // this effectively measures the slope difference
-        float delta = (wposP3.x() - wposP2.x())*(wposP2.y() - wposP1.y()) -
-          (wposP2.x() - wposP1.x())*(wposP3.y() - wposP2.y());
-
-        float rk2 = wposP3.Mag2();
-
-        // find circle center for this triple
-        float cx = 0.5* (
-            (wposP3.y() - wposP2.y())*ri2 +
-            (wposP1.y() - wposP3.y())*rj2 +
-            (wposP2.y() - wposP1.y())*rk2 ) / delta;
-        float cy = -0.5* (
-            (wposP3.x() - wposP2.x())*ri2 +
-            (wposP1.x() - wposP3.x())*rj2 +
-            (wposP2.x() - wposP1.x())*rk2 ) / delta;
-        XYVec cent(cx,cy);
-        float rho = sqrtf((wposP1-cent).Mag2());
-        float rc = sqrtf(cent.Mag2());
-        float rmin = fabs(rc-rho);
-        float rmax = rc+rho;
-
-        // test circle parameters for this triple: should be inside the tracker,
-        // optionally consistent with the target
-        if (rc > _rcmin && rc < _rcmax &&
-            rho > _rmin && rho < _rmax && rmax < _trackerradius &&
-            //        ( !_targetcon || rmin < _targetradius) )
-          ( !forceTargetCon || rmin < _targetradius) )
-
-          {
-            ++ntriple;
-
-            float wt(0);
-            if (!useTripleAreaWt){
-              wt  = cbrtf(wposP1.weight()*wposP2.weight()*wposP3.weight());
-            } else{
-              wt = area2;
-            }
-
-            accx.push(cx,wt);
-            accy.push(cy,wt);
-            if(_tripler) accr.push(rho,wt);
-            if (ntriple>_ntripleMax) {
-              f1=nHits-2; f2=nHits-1; f3=nHits;
-            }
-          }
-      }//end loop for f3 Faces
-    }//end loop for f2 Faces
-  }//end loop for f1 Faces
+  std::vector<int> usable;
+  usable.reserve(nHits);
+  for (int f=0; f<nHits; ++f){
+    if (use(HelixData._chHitsToProcess[f])) usable.push_back(f);
+  }
+  double nu = usable.size();
+
+  if (_tripleSampling && nu*(nu-1)*(nu-2)/6 > _tripleMaxTries) {
+    // sample random triples: the enumeration would be too long, and stopping it
+    // at _ntripleMax would bias the fit towards the first hits.  The seed
+    // depends only on the hits, so the result is reproducible
+    uint32_t seed = _tripleSeed;
+    for (int f : usable) seed = seed*31 + HelixData._chHitsToProcess[f].strawId().asUint16();
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<size_t> flat(0,usable.size()-1);
+    XYVec lastCenter(0,0);
+    unsigned nstable(0);
+    for (unsigned itry=0; itry<_tripleMaxTries && ntriple<=_ntripleMax; ++itry){
+      int f[3] = {usable[flat(engine)], usable[flat(engine)], usable[flat(engine)]};
+      std::sort(f,f+3);
+      if (f[0] == f[1] || f[1] == f[2])                       continue;
+      XYWVec& wposP1 = HelixData._chHitsWPos[f[0]];
+      XYWVec& wposP2 = HelixData._chHitsWPos[f[1]];
+      XYWVec& wposP3 = HelixData._chHitsWPos[f[2]];
+      if (wposP1.face() == wposP2.face() || wposP2.face() == wposP3.face()) continue;
+      float dist2ij = (wposP1 - wposP2).Mag2();
+      if (dist2ij < mind2 || dist2ij > maxd2)                  continue;
+      if (!tripleCircle(wposP1,wposP2,wposP3,dist2ij,forceTargetCon,useTripleAreaWt,cx,cy,trho,wt)) continue;
+
+      ++ntriple;
+      accx.push(cx,wt);
+      accy.push(cy,wt);
+      if(_tripler) accr.push(trho,wt);
+
+      // stop once the median center is stable over 2 consecutive checks
+      if (ntriple > _ntripleMin && ntriple%_tripleCheck == 0){
+        XYVec center(accx.weightedMedian(),accy.weightedMedian());
+        nstable = ((center-lastCenter).Mag2() < _tripleTol2) ? nstable+1 : 0;
+        if (nstable >= 2) break;
+        lastCenter = center;
+      }
+    }
+  } else {
+    // loop over all triples, up to _ntripleMax accepted ones
+    for (size_t i1=0; i1+2<usable.size() && ntriple<=_ntripleMax; ++i1){
+      XYWVec& wposP1 = HelixData._chHitsWPos[usable[i1]];
+
+      for (size_t i2=i1+1; i2+1<usable.size() && ntriple<=_ntripleMax; ++i2){
+        XYWVec& wposP2  = HelixData._chHitsWPos[usable[i2]];
+        if (wposP1.face() == wposP2.face()) continue;
+
+        float   dist2ij = (wposP1 - wposP2).Mag2();
+        if (dist2ij < mind2 || dist2ij > maxd2) continue;
+
+        for (size_t i3=i2+1; i3<usable.size() && ntriple<=_ntripleMax; ++i3){
+          XYWVec& wposP3 = HelixData._chHitsWPos[usable[i3]];
+          if (wposP2.face() == wposP3.face()) continue;
+          if (!tripleCircle(wposP1,wposP2,wposP3,dist2ij,forceTargetCon,useTripleAreaWt,cx,cy,trho,wt)) continue;
+
+          ++ntriple;
+          accx.push(cx,wt);
+          accy.push(cy,wt);
+          if(_tripler) accr.push(trho,wt);
+        }//end loop for f3 Faces
+      }//end loop for f2 Faces
+    }//end loop for f1 Faces
+  }
 
   // median calculation needs a reasonable number of points to function
   if (ntriple > _ntripleMin)